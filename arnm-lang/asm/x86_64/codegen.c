@@ -17,6 +17,9 @@ typedef struct {
     IrModule* mod;
     FILE* out;
     IrFunction* cur_fn;
+    int spill_size;         /* Bytes of vreg spill slots */
+    int alloca_offset;      /* Bytes of ALLOCA slots handed out so far */
+    int label_counter;      /* Local labels of inline vector code and bounds checks */
 } X86Context;
 
 /* ============================================================
@@ -47,6 +50,22 @@ static void get_label(char* buffer, const char* fn_name, int block_id) {
  * Emitters
  * ============================================================ */
 
+/* ALLOCA slot size: 32 bytes for a SIMD vector, 16 otherwise */
+static int alloca_size(IrInstr* instr) {
+    return instr->op1.type.kind == IR_VEC ? 32 : 16;
+}
+
+/* Total ALLOCA bytes, so their slots can live in the fixed frame */
+static int count_alloca_bytes(IrFunction* fn) {
+    int bytes = 0;
+    for (IrBlock* b = fn->entry; b; b = b->next) {
+        for (IrInstr* i = b->head; i; i = i->next) {
+            if (i->op == IR_ALLOCA) bytes += alloca_size(i);
+        }
+    }
+    return bytes;
+}
+
 static void emit_prologue(X86Context* ctx, IrFunction* fn) {
     const char* name = strcmp(fn->name, "main") == 0 ? "_arnm_main" : fn->name;
     
@@ -56,18 +75,31 @@ static void emit_prologue(X86Context* ctx, IrFunction* fn) {
     fprintf(ctx->out, "\tpushq %%rbp\n");
     fprintf(ctx->out, "\tmovq %%rsp, %%rbp\n");
     
-    int stack_size = (fn->vreg_counter + 32) * 8; 
+    /*
+     * Frame = spill slots + one fixed slot per ALLOCA (16 bytes, 32 for
+     * a vector). ALLOCAs get a fixed slot instead of adjusting %rsp, so
+     * a `let` inside a loop body does not grow the stack on every
+     * iteration.
+     */
+    ctx->spill_size = (fn->vreg_counter + 32) * 8;
+    ctx->alloca_offset = 0;
+    int stack_size = ctx->spill_size + count_alloca_bytes(fn);
     if (stack_size % 16 != 0) stack_size += 8;
     
     fprintf(ctx->out, "\t# Stack size: %d, Param count: %zu\n", stack_size, fn->param_count);
     fprintf(ctx->out, "\tsubq $%d, %%rsp\n", stack_size); 
     
-    /* Move arguments from registers to stack slots (VAR_0, VAR_1...) */
+    /* Move arguments from registers to stack slots (VAR_0, VAR_1...); f64 arrive in %xmm */
     const char* arg_regs[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
-    for (size_t i = 0; i < fn->param_count && i < 6; i++) {
+    size_t gp = 0, sse = 0;
+    for (size_t i = 0; i < fn->param_count; i++) {
         /* VAR_i maps to -(i+1)*8(%rbp) */
         int offset = (i + 1) * 8;
-        fprintf(ctx->out, "\tmovq %s, -%d(%%rbp)\n", arg_regs[i], offset);
+        if (fn->param_types && fn->param_types[i].kind == IR_F64) {
+            if (sse < 8) fprintf(ctx->out, "\tmovq %%xmm%zu, -%d(%%rbp)\n", sse++, offset);
+        } else if (gp < 6) {
+            fprintf(ctx->out, "\tmovq %s, -%d(%%rbp)\n", arg_regs[gp++], offset);
+        }
     } 
 }
 
@@ -77,6 +109,80 @@ static void emit_epilogue(X86Context* ctx) {
     fprintf(ctx->out, "\tret\n");
 }
 
+static bool is_f64(IrValue val) {
+    return val.type.kind == IR_F64;
+}
+
+/* f64 arithmetic: operands through %rax/%r11 into %xmm0/%xmm1 */
+static void emit_float_binary(X86Context* ctx, const char* op1, const char* op2,
+                              const char* dest, const char* mnemonic) {
+    fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
+    fprintf(ctx->out, "\tmovq %s, %%r11\n", op2);
+    fprintf(ctx->out, "\tmovq %%rax, %%xmm0\n");
+    fprintf(ctx->out, "\tmovq %%r11, %%xmm1\n");
+    fprintf(ctx->out, "\t%s %%xmm1, %%xmm0\n", mnemonic);
+    fprintf(ctx->out, "\tmovq %%xmm0, %s\n", dest);
+}
+
+/*
+ * arnm_{f32x8,f64x4,i32x8}_op with a constant operator, inline: one
+ * 256-bit AVX operation when the runtime selected its AVX2 kernels,
+ * else two 128-bit SSE2 halves. Returns false for what SSE2 has no
+ * single instruction for (i32x8 multiply and divide); those call the
+ * runtime.
+ */
+static bool emit_inline_vector_op(X86Context* ctx, IrInstr* instr) {
+    static const char* const avx[3][4] = {
+        { "vaddps", "vsubps", "vmulps", "vdivps" },
+        { "vaddpd", "vsubpd", "vmulpd", "vdivpd" },
+        { "vpaddd", "vpsubd", NULL, NULL },
+    };
+    if (instr->op1.kind != VAL_GLOBAL || instr->arg_count != 4 ||
+        instr->args[3].kind != VAL_CONST) {
+        return false;
+    }
+    const char* name = instr->op1.storage.global.name;
+    int type;
+    if (strcmp(name, "arnm_f32x8_op") == 0) type = 0;
+    else if (strcmp(name, "arnm_f64x4_op") == 0) type = 1;
+    else if (strcmp(name, "arnm_i32x8_op") == 0) type = 2;
+    else return false;
+    
+    uint64_t op = instr->args[3].storage.constant.as.i;
+    if (op > 3 || !avx[type][op]) return false;
+    const char* vop = avx[type][op];
+    const char* sop = vop + 1;              /* addps, paddd, ... */
+    
+    char dst[64], a[64], b[64];
+    get_operand(instr->args[0], dst);
+    get_operand(instr->args[1], a);
+    get_operand(instr->args[2], b);
+    int id = ctx->label_counter++;
+    FILE* out = ctx->out;
+    
+    fprintf(out, "\tmovq %s, %%rax\n", a);
+    fprintf(out, "\tmovq %s, %%r11\n", b);
+    fprintf(out, "\tmovq %s, %%rdx\n", dst);
+    fprintf(out, "\tcmpb $0, arnm_simd_avx2(%%rip)\n");
+    fprintf(out, "\tje .Lvec_sse_%d\n", id);
+    fprintf(out, "\tvmovups (%%rax), %%ymm0\n");
+    fprintf(out, "\t%s (%%r11), %%ymm0, %%ymm0\n", vop);
+    fprintf(out, "\tvmovups %%ymm0, (%%rdx)\n");
+    fprintf(out, "\tvzeroupper\n");
+    fprintf(out, "\tjmp .Lvec_done_%d\n", id);
+    fprintf(out, ".Lvec_sse_%d:\n", id);
+    fprintf(out, "\tmovups (%%rax), %%xmm0\n");
+    fprintf(out, "\tmovups 16(%%rax), %%xmm1\n");
+    fprintf(out, "\tmovups (%%r11), %%xmm2\n");
+    fprintf(out, "\tmovups 16(%%r11), %%xmm3\n");
+    fprintf(out, "\t%s %%xmm2, %%xmm0\n", sop);
+    fprintf(out, "\t%s %%xmm3, %%xmm1\n", sop);
+    fprintf(out, "\tmovups %%xmm0, (%%rdx)\n");
+    fprintf(out, "\tmovups %%xmm1, 16(%%rdx)\n");
+    fprintf(out, ".Lvec_done_%d:\n", id);
+    return true;
+}
+
 static void emit_instr(X86Context* ctx, IrInstr* instr) {
     char op1[64], op2[64], dest[64];
     
@@ -93,54 +199,73 @@ static void emit_instr(X86Context* ctx, IrInstr* instr) {
             break;
             
         case IR_ALLOCA:
-            fprintf(ctx->out, "\tsubq $16, %%rsp\n"); 
-            fprintf(ctx->out, "\tmovq %%rsp, %%rax\n");
-            fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
+            {
+                ctx->alloca_offset += alloca_size(instr);
+                int offset = ctx->spill_size + ctx->alloca_offset;
+                fprintf(ctx->out, "\tleaq -%d(%%rbp), %%rax\n", offset);
+                fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
+            }
             break;
             
         case IR_LOAD:
             fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
-            fprintf(ctx->out, "\tmovq (%%rax), %%rbx\n"); 
-            fprintf(ctx->out, "\tmovq %%rbx, %s\n", dest);
+            fprintf(ctx->out, "\tmovq (%%rax), %%r11\n"); 
+            fprintf(ctx->out, "\tmovq %%r11, %s\n", dest);
             break;
             
         case IR_STORE:
             fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
-            fprintf(ctx->out, "\tmovq %s, %%rbx\n", op2);
-            fprintf(ctx->out, "\tmovq %%rax, (%%rbx)\n");
+            fprintf(ctx->out, "\tmovq %s, %%r11\n", op2);
+            fprintf(ctx->out, "\tmovq %%rax, (%%r11)\n");
             break;
 
         case IR_ADD:
+            if (is_f64(instr->result)) {
+                emit_float_binary(ctx, op1, op2, dest, "addsd");
+                break;
+            }
             fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
             fprintf(ctx->out, "\taddq %s, %%rax\n", op2); 
             fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
             break;
             
         case IR_SUB:
+            if (is_f64(instr->result)) {
+                emit_float_binary(ctx, op1, op2, dest, "subsd");
+                break;
+            }
             fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
             fprintf(ctx->out, "\tsubq %s, %%rax\n", op2);
             fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
             break;
             
         case IR_MUL:
+            if (is_f64(instr->result)) {
+                emit_float_binary(ctx, op1, op2, dest, "mulsd");
+                break;
+            }
             fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
             fprintf(ctx->out, "\timulq %s, %%rax\n", op2);
             fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
             break;
             
         case IR_DIV:
+            if (is_f64(instr->result)) {
+                emit_float_binary(ctx, op1, op2, dest, "divsd");
+                break;
+            }
             fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
             fprintf(ctx->out, "\tcqo\n"); 
-            fprintf(ctx->out, "\tmovq %s, %%rbx\n", op2);
-            fprintf(ctx->out, "\tidivq %%rbx\n");
+            fprintf(ctx->out, "\tmovq %s, %%r11\n", op2);
+            fprintf(ctx->out, "\tidivq %%r11\n");
             fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
             break;
 
         case IR_MOD:
             fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
             fprintf(ctx->out, "\tcqo\n"); 
-            fprintf(ctx->out, "\tmovq %s, %%rbx\n", op2);
-            fprintf(ctx->out, "\tidivq %%rbx\n");
+            fprintf(ctx->out, "\tmovq %s, %%r11\n", op2);
+            fprintf(ctx->out, "\tidivq %%r11\n");
             fprintf(ctx->out, "\tmovq %%rdx, %s\n", dest); /* Remainder in rdx */
             break;
             
@@ -157,6 +282,32 @@ static void emit_instr(X86Context* ctx, IrInstr* instr) {
             break;
             
         case IR_EQ: case IR_NE: case IR_LT: case IR_GT: case IR_LE: case IR_GE:
+            if (is_f64(instr->op1) || is_f64(instr->op2)) {
+                /* ucomisd sets CF/ZF like an unsigned compare, and PF when unordered */
+                fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
+                fprintf(ctx->out, "\tmovq %s, %%r11\n", op2);
+                fprintf(ctx->out, "\tmovq %%rax, %%xmm0\n");
+                fprintf(ctx->out, "\tmovq %%r11, %%xmm1\n");
+                switch (instr->op) {
+                    case IR_EQ:
+                        fprintf(ctx->out, "\tucomisd %%xmm1, %%xmm0\n");
+                        fprintf(ctx->out, "\tsete %%al\n\tsetnp %%cl\n\tandb %%cl, %%al\n");
+                        break;
+                    case IR_NE:
+                        fprintf(ctx->out, "\tucomisd %%xmm1, %%xmm0\n");
+                        fprintf(ctx->out, "\tsetne %%al\n\tsetp %%cl\n\torb %%cl, %%al\n");
+                        break;
+                    /* a < b as b > a, so NaN (CF=ZF=1) compares false */
+                    case IR_LT: fprintf(ctx->out, "\tucomisd %%xmm0, %%xmm1\n\tseta %%al\n"); break;
+                    case IR_LE: fprintf(ctx->out, "\tucomisd %%xmm0, %%xmm1\n\tsetae %%al\n"); break;
+                    case IR_GT: fprintf(ctx->out, "\tucomisd %%xmm1, %%xmm0\n\tseta %%al\n"); break;
+                    case IR_GE: fprintf(ctx->out, "\tucomisd %%xmm1, %%xmm0\n\tsetae %%al\n"); break;
+                    default: break;
+                }
+                fprintf(ctx->out, "\tmovzbl %%al, %%eax\n");
+                fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
+                break;
+            }
             fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
             fprintf(ctx->out, "\tcmpq %s, %%rax\n", op2);
             switch (instr->op) {
@@ -205,6 +356,9 @@ static void emit_instr(X86Context* ctx, IrInstr* instr) {
         case IR_RET:
             if (instr->op1.kind != VAL_UNDEF) {
                 fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
+                if (ctx->cur_fn->ret_type.kind == IR_F64) {
+                    fprintf(ctx->out, "\tmovq %%rax, %%xmm0\n");
+                }
             }
             emit_epilogue(ctx);
             break;
@@ -212,11 +366,21 @@ static void emit_instr(X86Context* ctx, IrInstr* instr) {
         case IR_CALL:
         case IR_SPAWN:
             {
+                if (instr->op == IR_CALL && emit_inline_vector_op(ctx, instr)) break;
+                
+                /* SysV: f64 arguments take %xmm0-7, the rest the integer registers */
                 const char* regs[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
-                for (size_t i = 0; i < instr->arg_count && i < 6; i++) {
+                size_t gp = 0, sse = 0;
+                for (size_t i = 0; i < instr->arg_count; i++) {
                     char arg_op[64];
                     get_operand(instr->args[i], arg_op);
-                    fprintf(ctx->out, "\tmovq %s, %s\n", arg_op, regs[i]);
+                    if (is_f64(instr->args[i])) {
+                        if (sse >= 8) continue;
+                        fprintf(ctx->out, "\tmovq %s, %%rax\n", arg_op);
+                        fprintf(ctx->out, "\tmovq %%rax, %%xmm%zu\n", sse++);
+                    } else if (gp < 6) {
+                        fprintf(ctx->out, "\tmovq %s, %s\n", arg_op, regs[gp++]);
+                    }
                 }
                 
                 if (instr->op1.kind == VAL_GLOBAL) {
@@ -237,7 +401,16 @@ static void emit_instr(X86Context* ctx, IrInstr* instr) {
                 
                 if (instr->result.kind != VAL_UNDEF) {
                     get_operand(instr->result, dest);
-                    fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
+                    if (is_f64(instr->result)) {
+                        fprintf(ctx->out, "\tmovq %%xmm0, %s\n", dest);
+                    } else {
+                        /* The runtime's int32_t results leave the upper half of %rax undefined */
+                        if (instr->result.type.kind == IR_I32 && instr->op1.kind == VAL_GLOBAL &&
+                            strncmp(instr->op1.storage.global.name, "arnm_", 5) == 0) {
+                            fprintf(ctx->out, "\tmovslq %%eax, %%rax\n");
+                        }
+                        fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
+                    }
                 }
             }
             break;
@@ -270,6 +443,38 @@ static void emit_instr(X86Context* ctx, IrInstr* instr) {
              }
              break;
 
+        /* Array headers are { data, len }, both 8 bytes */
+        case IR_ARRAY_DATA:
+            fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
+            fprintf(ctx->out, "\tmovq (%%rax), %%r11\n");
+            fprintf(ctx->out, "\tmovq %%r11, %s\n", dest);
+            break;
+
+        case IR_ARRAY_LEN:
+            fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
+            fprintf(ctx->out, "\tmovq 8(%%rax), %%r11\n");
+            fprintf(ctx->out, "\tmovq %%r11, %s\n", dest);
+            break;
+
+        case IR_ELEM_PTR:
+            fprintf(ctx->out, "\tmovq %s, %%rax\n", op1);
+            fprintf(ctx->out, "\tmovq %s, %%r11\n", op2);
+            fprintf(ctx->out, "\tleaq (%%rax,%%r11,8), %%rax\n");
+            fprintf(ctx->out, "\tmovq %%rax, %s\n", dest);
+            break;
+
+        case IR_BOUNDS_CHECK: {
+            /* Unsigned, so a negative index fails too */
+            int id = ctx->label_counter++;
+            fprintf(ctx->out, "\tmovq %s, %%rdi\n", op1);
+            fprintf(ctx->out, "\tmovq %s, %%rsi\n", op2);
+            fprintf(ctx->out, "\tcmpq %%rsi, %%rdi\n");
+            fprintf(ctx->out, "\tjb .Lbounds_ok_%d\n", id);
+            fprintf(ctx->out, "\tcall arnm_panic_bounds\n");
+            fprintf(ctx->out, ".Lbounds_ok_%d:\n", id);
+            break;
+        }
+
         default:
             fprintf(ctx->out, "\t# Unimplemented instr %d\n", instr->op);
             break;
@@ -46,6 +46,9 @@ typedef enum {
     AST_CONTINUE_STMT,
     AST_SPAWN_STMT,
     AST_RECEIVE_STMT,
+    AST_SELECT_STMT,
+    AST_PARALLEL_STMT,
+    AST_AWAIT_STMT,
     
     /* Expressions */
     AST_IDENT_EXPR,
@@ -58,7 +61,8 @@ typedef enum {
     AST_UNARY_EXPR,
     AST_BINARY_EXPR,
     AST_CALL_EXPR,
-    AST_INDEX_EXPR,
+    AST_INDEX_EXPR,       /* a[i], or a slice a[lo..hi] */
+    AST_ARRAY_EXPR,       /* [a, b, c] or [x; n] */
     AST_FIELD_EXPR,
     AST_SEND_EXPR,        /* message send: expr ! expr */
     AST_SPAWN_EXPR,       /* spawn expression */
@@ -70,6 +74,7 @@ typedef enum {
     AST_TYPE_ARRAY,
     AST_TYPE_FN,
     AST_TYPE_OPTIONAL,
+    AST_TYPE_GENERIC,
 } AstNodeKind;
 
 /* ============================================================
@@ -171,9 +176,18 @@ typedef struct {
 typedef struct {
     AstCommon   common;
     AstExpr*    object;
-    AstExpr*    index;
+    AstExpr*    index;      /* Slice start when is_slice (NULL for 0) */
+    AstExpr*    end;        /* Slice end (NULL for the length) */
+    bool        is_slice;
 } AstIndexExpr;
 
+typedef struct {
+    AstCommon   common;
+    AstExpr**   elems;
+    size_t      elem_count;
+    AstExpr*    repeat_count;   /* [elems[0]; repeat_count] when non-NULL */
+} AstArrayExpr;
+
 typedef struct {
     AstCommon   common;
     AstExpr*    object;
@@ -195,6 +209,7 @@ typedef struct {
 typedef struct {
     AstCommon   common;
     AstExpr*    expr;       /* Expression to spawn */
+    bool        joinable;   /* Set by sema when the handle is awaited */
 } AstSpawnExpr;
 
 /* Unified expression type (tagged union) */
@@ -213,6 +228,7 @@ struct AstExpr {
         AstBinaryExpr       binary;
         AstCallExpr         call;
         AstIndexExpr        index;
+        AstArrayExpr        array;
         AstFieldExpr        field;
         AstSendExpr         send;
         AstSpawnExpr        spawn_expr;
@@ -280,6 +296,12 @@ typedef struct {
     AstExpr*    expr;       /* Expression to spawn */
 } AstSpawnStmt;
 
+/* await p; -- park until the process p exits */
+typedef struct {
+    AstCommon   common;
+    AstExpr*    process;
+} AstAwaitStmt;
+
 /* Receive arm: pattern => block */
 typedef struct {
     const char* pattern;    /* Pattern to match (simplified for now) */
@@ -293,6 +315,40 @@ typedef struct {
     size_t      arm_count;
 } AstReceiveStmt;
 
+/* Channel arms per select (the runtime's compiled select takes four) */
+#define SELECT_MAX_CHANNELS 4
+
+/* Select arm: name := channel => block, or receive name => block (mailbox) */
+typedef struct {
+    const char* binding;    /* Variable bound to the value or message tag */
+    uint32_t    binding_len;
+    AstExpr*    channel;    /* NULL for the mailbox arm */
+    AstBlock*   body;
+} SelectArm;
+
+typedef struct {
+    AstCommon   common;
+    SelectArm*  arms;
+    size_t      arm_count;
+} AstSelectStmt;
+
+/*
+ * parallel for i in lo..hi { body }
+ * parallel reduce(op) acc for i in lo..hi { body }
+ * The body becomes a function run over chunks of the range.
+ */
+typedef struct {
+    AstCommon   common;
+    const char* var_name;
+    uint32_t    var_name_len;
+    AstExpr*    lo;
+    AstExpr*    hi;
+    AstBlock*   body;
+    const char* acc_name;       /* reduce: accumulator (NULL for a plain for) */
+    uint32_t    acc_name_len;
+    BinaryOp    reduce_op;      /* reduce: BINARY_ADD or BINARY_MUL */
+} AstParallelStmt;
+
 /* Unified statement type (tagged union) */
 struct AstStmt {
     AstNodeKind kind;
@@ -307,6 +363,9 @@ struct AstStmt {
         AstLoopStmt     loop_stmt;
         AstSpawnStmt    spawn_stmt;
         AstReceiveStmt  receive_stmt;
+        AstSelectStmt   select_stmt;
+        AstParallelStmt parallel_stmt;
+        AstAwaitStmt    await_stmt;
         AstCommon       break_stmt;
         AstCommon       continue_stmt;
     } as;
@@ -340,6 +399,15 @@ typedef struct {
     AstType*    inner;
 } AstTypeOptional;
 
+/* Name<T, ...>: the collection types */
+typedef struct {
+    AstCommon   common;
+    const char* name;
+    uint32_t    name_len;
+    AstType**   args;
+    size_t      arg_count;
+} AstTypeGeneric;
+
 struct AstType {
     AstNodeKind kind;
     union {
@@ -347,6 +415,7 @@ struct AstType {
         AstTypeArray    array;
         AstTypeFn       fn;
         AstTypeOptional optional;
+        AstTypeGeneric  generic;
     } as;
 };
 
@@ -0,0 +1,10 @@
+#ifndef ARNM_CODEGEN_C_H
+#define ARNM_CODEGEN_C_H
+
+#include "ir.h"
+#include <stdio.h>
+
+/* Emit portable C11 for the given IR module, calling libarnm's public API */
+void c_emit(IrModule* mod, FILE* out);
+
+#endif /* ARNM_CODEGEN_C_H */
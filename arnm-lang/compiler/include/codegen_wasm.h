@@ -0,0 +1,16 @@
+#ifndef ARNM_CODEGEN_WASM_H
+#define ARNM_CODEGEN_WASM_H
+
+#include "ir.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+/*
+ * Emit a binary wasm32 module for the given IR module. Runtime calls are
+ * imported from "arnm" (see wasm/arnm_runtime.js); _arnm_main, memory
+ * and the function table are exported. Returns false, after printing a
+ * diagnostic to stderr, if a function's control flow is irreducible.
+ */
+bool wasm_emit(IrModule* mod, FILE* out);
+
+#endif /* ARNM_CODEGEN_WASM_H */
@@ -31,6 +31,7 @@ typedef enum {
     IR_F64,
     IR_PTR,
     IR_PROCESS,
+    IR_VEC,         /* 32-byte SIMD vector; values are its address */
     IR_BAD
 } IrTypeKind;
 
@@ -100,6 +101,12 @@ typedef enum {
     IR_RECEIVE,     /* %r = receive */
     IR_SELF,        /* %r = self */
     
+    /* Arrays: values are the address of a read-only {data, len} header */
+    IR_ARRAY_DATA,  /* %r = array_data %arr (ptr to 8-byte element slots) */
+    IR_ARRAY_LEN,   /* %r = array_len %arr (i32) */
+    IR_ELEM_PTR,    /* %r = elem_ptr %data, %idx */
+    IR_BOUNDS_CHECK,/* bounds_check %idx, %len (panics unless 0 <= idx < len) */
+    
     /* Misc */
     IR_MOV          /* %r = %v (virtual move, mainly for phi resolution) */
 } IrOpcode;
@@ -183,6 +190,10 @@ IrInstr* ir_build_alloca(IrFunction* fn, IrBlock* block, IrType type);
 IrInstr* ir_build_store(IrBlock* block, IrValue val, IrValue ptr);
 IrInstr* ir_build_load(IrFunction* fn, IrBlock* block, IrType type, IrValue ptr);
 IrInstr* ir_build_field_ptr(IrFunction* fn, IrBlock* block, IrValue ptr, int index);
+IrInstr* ir_build_array_data(IrFunction* fn, IrBlock* block, IrValue arr);
+IrInstr* ir_build_array_len(IrFunction* fn, IrBlock* block, IrValue arr);
+IrInstr* ir_build_elem_ptr(IrFunction* fn, IrBlock* block, IrValue data, IrValue idx);
+IrInstr* ir_build_bounds_check(IrBlock* block, IrValue idx, IrValue len);
 IrInstr* ir_build_call(IrFunction* fn, IrBlock* block, const char* callee_name, IrValue* args, size_t arg_count, IrType ret_type);
 IrInstr* ir_build_br(IrBlock* block, IrValue cond, IrBlock* then_bb, IrBlock* else_bb);
 IrInstr* ir_build_jmp(IrBlock* block, IrBlock* dest);
@@ -190,15 +201,23 @@ IrInstr* ir_build_cmp(IrFunction* fn, IrBlock* block, IrOpcode op, IrValue lhs,
 IrInstr* ir_build_constants_i32(int32_t val);
 IrInstr* ir_build_cmp(IrFunction* fn, IrBlock* block, IrOpcode op, IrValue lhs, IrValue rhs);
 
+/* Editing */
+IrInstr* ir_instr_copy(IrBlock* block, const IrInstr* src);
+void     ir_instr_remove(IrBlock* block, IrInstr* inst);
+void     ir_block_remove(IrFunction* fn, IrBlock* block);
+
 /* Helpers */
 IrValue ir_val_var(uint32_t id, IrType type);
 IrValue ir_val_const_i32(int32_t i);
 IrValue ir_val_const_bool(bool b);
+IrValue ir_val_const_f64(double f);
 IrType  ir_type_i32(void);
 IrType  ir_type_i64(void);
+IrType  ir_type_f64(void);
 IrType  ir_type_bool(void);
 IrType  ir_type_void(void);
 IrType  ir_type_ptr(void); /* New helper */
+IrType  ir_type_vec(void);
 
 void ir_dump_module(IrModule* mod);
 
@@ -0,0 +1,23 @@
+/*
+ * ARNm Compiler - IR Optimization Interface
+ *
+ * Target-independent passes over the IR, run between irgen and codegen.
+ */
+
+#ifndef ARNM_OPT_H
+#define ARNM_OPT_H
+
+#include "ir.h"
+
+/*
+ * Removes array bounds checks that loop counters prove redundant, and
+ * versions loops whose checks only need a single test on entry. From
+ * -O2, unrolls loops whose bodies have no branches; at -O3, f64 loops
+ * over arrays are vectorized first.
+ *
+ * @param mod       Module to rewrite in place
+ * @param opt_level The -O level, 0-3
+ */
+void ir_optimize(IrModule* mod, int opt_level);
+
+#endif /* ARNM_OPT_H */
@@ -20,6 +20,12 @@ typedef struct {
     Span        span;
 } SemaError;
 
+/* A collection type made at a use site, checked once inference is done */
+typedef struct {
+    Type*       type;
+    Span        span;
+} SemaCollection;
+
 typedef struct {
     TypeArena   type_arena;
     SymbolTable symbols;
@@ -30,8 +36,15 @@ typedef struct {
     /* Current context */
     Type*       current_fn_return;  /* Expected return type */
     bool        in_loop;            /* For break/continue */
+    uint32_t    loop_depth;         /* Enclosing loops, for await */
     bool        in_actor;           /* For self access */
+    bool        in_parallel;        /* Body runs on worker threads: no return/receive */
     Type*       cur_actor;          /* Current actor type */
+    
+    /* Collections whose key and element types are checked at the end */
+    SemaCollection* collections;
+    size_t      collection_count;
+    size_t      collection_cap;
 } SemaContext;
 
 /* ============================================================
@@ -38,6 +38,9 @@ typedef struct Symbol {
     Span            def_span;       /* Definition location */
     bool            is_mutable;
     bool            is_defined;     /* False for forward declarations */
+    struct AstExpr* spawn_init;     /* let p = spawn ...: the spawn, for await */
+    uint32_t        loop_depth;     /* Loops enclosing the definition */
+    bool            awaited;
     struct Symbol*  next;           /* Hash chain */
 } Symbol;
 
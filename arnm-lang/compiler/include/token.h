@@ -31,6 +31,7 @@ typedef enum {
     /* Keywords - Declarations */
     TOK_FN,             /* fn */
     TOK_ACTOR,          /* actor */
+    TOK_AWAIT,          /* await */
     TOK_LET,            /* let */
     TOK_MUT,            /* mut */
     TOK_CONST,          /* const */
@@ -49,6 +50,8 @@ typedef enum {
     /* Keywords - Concurrency */
     TOK_SPAWN,          /* spawn */
     TOK_RECEIVE,        /* receive */
+    TOK_SELECT,         /* select */
+    TOK_PARALLEL,       /* parallel */
     TOK_SELF,           /* self */
 
     /* Keywords - Types & Ownership */
@@ -34,10 +34,16 @@ typedef enum {
     TYPE_CHAR,          /* char */
     TYPE_FN,            /* fn(T...) -> R */
     TYPE_ACTOR,         /* actor type */
-    TYPE_ARRAY,         /* [T] */
+    TYPE_ARRAY,         /* T[N] / T[] */
     TYPE_OPTIONAL,      /* T? */
     TYPE_PROCESS,       /* Process handle (spawn result) */
     TYPE_STRUCT,        /* struct */
+    TYPE_F32X8,         /* f32x8: 8 x f32 SIMD vector */
+    TYPE_I32X8,         /* i32x8: 8 x i32 SIMD vector */
+    TYPE_F64X4,         /* f64x4: 4 x f64 SIMD vector */
+    TYPE_VEC,           /* vec<T>: growable vector */
+    TYPE_MAP,           /* map<K, V>: hash map */
+    TYPE_DEQUE,         /* deque<T>: double-ended queue */
     TYPE_ERROR,         /* Type error placeholder */
 } TypeKind;
 
@@ -92,11 +98,19 @@ typedef struct {
     size_t      field_count;
 } TypeActor;
 
-/* Array type */
+/* Array type: length is the static element count of a fixed-size
+ * array, or -1 for a slice whose length is only known at runtime */
 typedef struct {
     Type*   element_type;
+    int64_t length;
 } TypeArray;
 
+/* vec, map and deque: key_type is NULL except in a map */
+typedef struct {
+    Type*   key_type;
+    Type*   element_type;
+} TypeCollection;
+
 /* Struct type */
 typedef struct {
     const char* name;
@@ -119,6 +133,7 @@ struct Type {
         TypeActor   actor;      /* TYPE_ACTOR */
         TypeStruct  struct_type;/* TYPE_STRUCT */
         TypeArray   array;      /* TYPE_ARRAY */
+        TypeCollection collection; /* TYPE_VEC, TYPE_MAP, TYPE_DEQUE */
         TypeOptional optional;  /* TYPE_OPTIONAL */
     } as;
 };
@@ -153,6 +168,9 @@ Type* type_f32(TypeArena* arena);
 Type* type_f64(TypeArena* arena);
 Type* type_string(TypeArena* arena);
 Type* type_char(TypeArena* arena);
+Type* type_f32x8(TypeArena* arena);
+Type* type_i32x8(TypeArena* arena);
+Type* type_f64x4(TypeArena* arena);
 Type* type_error(TypeArena* arena);
 
 /* Fresh type variable */
@@ -161,7 +179,9 @@ Type* type_var(TypeArena* arena);
 /* Compound types */
 Type* type_fn(TypeArena* arena, Type** params, size_t param_count, Type* ret);
 Type* type_array(TypeArena* arena, Type* elem);
+Type* type_array_sized(TypeArena* arena, Type* elem, int64_t length);
 Type* type_optional(TypeArena* arena, Type* inner);
+Type* type_collection(TypeArena* arena, TypeKind kind, Type* key, Type* elem);
 Type* type_process(TypeArena* arena, Type* actor_type);
 Type* type_actor(TypeArena* arena, const char* name, uint32_t name_len);
 Type* type_struct(TypeArena* arena, const char* name, uint32_t name_len);
@@ -182,6 +202,12 @@ bool type_unify(Type* a, Type* b);
 /* Check if type contains unbound variables */
 bool type_has_free_vars(Type* type);
 
+/* True for the SIMD vector types */
+bool type_is_vector(Type* type);
+
+/* True for vec, map and deque */
+bool type_is_collection(Type* type);
+
 /* Apply permission to type */
 Type* type_with_perm(TypeArena* arena, Type* type, Permission perm);
 
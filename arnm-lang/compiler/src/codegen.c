@@ -1,304 +1,813 @@
 /*
  * ARNm Compiler - LLVM Code Generation Implementation
+ *
+ * The ARNm IR is loosely typed: the x86 backend treats every value as a
+ * 64-bit slot, so irgen freely passes an i32 where a pointer is expected
+ * and relabels types at call sites. LLVM is strict, so this emitter
+ * records the type each virtual register is defined with and inserts a
+ * conversion wherever a use expects something else.
  */
 
 #include "../include/codegen.h"
 #include <stdlib.h>
 #include <string.h>
 
-static void emit_type(FILE* out, IrType type) {
-    switch (type.kind) {
-        case IR_VOID: fprintf(out, "void"); break;
-        case IR_BOOL: fprintf(out, "i1"); break;
-        case IR_I8:   fprintf(out, "i8"); break;
-        case IR_I32:  fprintf(out, "i32"); break;
-        case IR_I64:  fprintf(out, "i64"); break;
-        case IR_F64:  fprintf(out, "double"); break;
-        case IR_PTR:  fprintf(out, "ptr"); break;
-        default:      fprintf(out, "void"); break;
+/* ============================================================
+ * Runtime Signatures
+ * ============================================================ */
+
+#define MAX_SIG_PARAMS 5
+
+typedef struct {
+    const char* name;
+    const char* attrs;              /* Return attributes, "" for none */
+    int         group;              /* Function attribute group, see codegen_emit */
+    IrTypeKind  ret;
+    IrTypeKind  params[MAX_SIG_PARAMS];
+    size_t      param_count;
+} RuntimeSig;
+
+static const RuntimeSig runtime_sigs[] = {
+    { "arnm_spawn",              "",               0, IR_PTR,  { IR_PTR, IR_PTR, IR_I64 }, 3 },
+    { "arnm_spawn_joinable",     "",               0, IR_PTR,  { IR_PTR, IR_PTR, IR_I64 }, 3 },
+    { "arnm_join_proc",          "",               0, IR_I32,  { IR_PTR }, 1 },
+    { "arnm_send",               "",               0, IR_I32,  { IR_PTR, IR_I64, IR_PTR, IR_I64 }, 4 },
+    { "arnm_receive",            "nonnull ",       0, IR_PTR,  { 0 }, 0 },
+    { "arnm_receive_idle",       "nonnull ",       0, IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_message_free",       "",               0, IR_VOID, { IR_PTR }, 1 },
+    { "arnm_self",               "nonnull ",       1, IR_PTR,  { 0 }, 0 },
+    { "arnm_panic_nomatch",      "",               2, IR_VOID, { 0 }, 0 },
+    { "arnm_panic_bounds",       "",               2, IR_VOID, { IR_I64, IR_I64 }, 2 },
+    { "arnm_array_new",          "noalias nonnull ", 0, IR_PTR, { IR_I64 }, 1 },
+    { "arnm_array_slice",        "noalias nonnull ", 0, IR_PTR, { IR_PTR, IR_I64, IR_I64 }, 3 },
+    { "arnm_array_aliased",      "",               0, IR_I32,  { IR_PTR, IR_PTR }, 2 },
+    { "arnm_vec_new",            "noalias nonnull ", 0, IR_PTR,  { 0 }, 0 },
+    { "arnm_vec_len",            "",                0, IR_I32,  { IR_PTR }, 1 },
+    { "arnm_vec_push",           "nonnull ",        0, IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_vec_pop",            "nonnull ",        0, IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_vec_at",             "nonnull ",        0, IR_PTR,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_map_new",            "noalias nonnull ", 0, IR_PTR,  { 0 }, 0 },
+    { "arnm_map_len",            "",                0, IR_I32,  { IR_PTR }, 1 },
+    { "arnm_map_slot",           "nonnull ",        0, IR_PTR,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_map_at",             "nonnull ",        0, IR_PTR,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_map_has",            "",                0, IR_I32,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_map_remove",         "",                0, IR_I32,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_deque_new",          "noalias nonnull ", 0, IR_PTR,  { 0 }, 0 },
+    { "arnm_deque_len",          "",                0, IR_I32,  { IR_PTR }, 1 },
+    { "arnm_deque_push_back",    "nonnull ",        0, IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_deque_push_front",   "nonnull ",        0, IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_deque_pop_back",     "nonnull ",        0, IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_deque_pop_front",    "nonnull ",        0, IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_deque_at",           "nonnull ",        0, IR_PTR,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_print_int",          "",               0, IR_VOID, { IR_I32 }, 1 },
+    { "arnm_print_f64",          "",               0, IR_VOID, { IR_F64 }, 1 },
+    { "arnm_channel_create",     "noalias ",       0, IR_PTR,  { IR_I64 }, 1 },
+    { "arnm_channel_send",       "",               0, IR_BOOL, { IR_PTR, IR_PTR }, 2 },
+    { "arnm_channel_close",      "",               0, IR_VOID, { IR_PTR }, 1 },
+    { "arnm_select_recv4",       "",               0, IR_I64,  { IR_PTR, IR_PTR, IR_PTR, IR_PTR, IR_I64 }, 5 },
+    { "arnm_select_value",       "",               0, IR_I64,  { 0 }, 0 },
+    { "arnm_parallel_for",       "",               0, IR_VOID, { IR_I64, IR_I64, IR_PTR, IR_PTR }, 4 },
+    { "arnm_parallel_reduce_op", "",               0, IR_I64,  { IR_I64, IR_I64, IR_PTR, IR_PTR, IR_I64 }, 5 },
+    { "arnm_alloc",              "noalias ",       0, IR_PTR,  { IR_I64, IR_PTR }, 2 },
+    { "arnm_release",            "",               0, IR_VOID, { IR_PTR }, 1 },
+    { "arnm_f32x8_splat",        "",               0, IR_VOID, { IR_PTR, IR_F64 }, 2 },
+    { "arnm_f32x8_get",          "",               0, IR_F64,  { IR_PTR, IR_I32 }, 2 },
+    { "arnm_f32x8_set",          "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_F64 }, 4 },
+    { "arnm_f32x8_op",           "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, 4 },
+    { "arnm_f32x8_reduce",       "",               0, IR_F64,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_f32x8_shuffle",      "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, 3 },
+    { "arnm_i32x8_splat",        "",               0, IR_VOID, { IR_PTR, IR_I32 }, 2 },
+    { "arnm_i32x8_get",          "",               0, IR_I32,  { IR_PTR, IR_I32 }, 2 },
+    { "arnm_i32x8_set",          "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_I32 }, 4 },
+    { "arnm_i32x8_op",           "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, 4 },
+    { "arnm_i32x8_reduce",       "",               0, IR_I32,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_i32x8_shuffle",      "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, 3 },
+    { "arnm_f64x4_splat",        "",               0, IR_VOID, { IR_PTR, IR_F64 }, 2 },
+    { "arnm_f64x4_get",          "",               0, IR_F64,  { IR_PTR, IR_I32 }, 2 },
+    { "arnm_f64x4_set",          "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_F64 }, 4 },
+    { "arnm_f64x4_op",           "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, 4 },
+    { "arnm_f64x4_reduce",       "",               0, IR_F64,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_f64x4_shuffle",      "",               0, IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, 3 },
+};
+
+#define RUNTIME_SIG_COUNT (sizeof(runtime_sigs) / sizeof(runtime_sigs[0]))
+
+/* Callees that were neither defined nor known; declared after the functions */
+#define MAX_EXTERNS 64
+
+typedef struct {
+    const char* name;
+    IrInstr*    call;               /* First call site, for the types */
+} ExternDecl;
+
+typedef struct {
+    FILE*       out;
+    IrModule*   mod;
+    IrFunction* fn;
+    IrType*     vreg_types;         /* Type each vreg is defined with */
+    bool*       self_ptrs;          /* Vregs holding arnm_self() */
+    uint32_t    vreg_count;
+    uint32_t    tmp_counter;        /* Conversion temporaries (%t<N>) */
+    ExternDecl  externs[MAX_EXTERNS];
+    size_t      extern_count;
+} LlvmContext;
+
+/* ============================================================
+ * Types and Names
+ * ============================================================ */
+
+/* Everything is a first-class value in LLVM; collapse the IR-only kinds */
+static IrTypeKind norm_kind(IrTypeKind kind) {
+    switch (kind) {
+        case IR_PROCESS:
+        case IR_VEC:     return IR_PTR;
+        case IR_VOID:
+        case IR_BAD:     return IR_I64;
+        default:         return kind;
+    }
+}
+
+static const char* type_name(IrTypeKind kind) {
+    switch (kind) {
+        case IR_VOID: return "void";
+        case IR_BOOL: return "i1";
+        case IR_I8:   return "i8";
+        case IR_I32:  return "i32";
+        case IR_I64:  return "i64";
+        case IR_F64:  return "double";
+        case IR_PTR:
+        case IR_PROCESS: return "ptr";
+        default:      return "i64";
     }
 }
 
-static void emit_val(FILE* out, IrValue val) {
+static int int_bits(IrTypeKind kind) {
+    switch (kind) {
+        case IR_BOOL: return 1;
+        case IR_I8:   return 8;
+        case IR_I32:  return 32;
+        case IR_I64:  return 64;
+        default:      return 0;
+    }
+}
+
+/* Source-level names that the runtime spells differently */
+static const char* symbol_name(const char* name) {
+    if (strcmp(name, "main") == 0) return "_arnm_main";
+    if (strcmp(name, "print") == 0) return "arnm_print_int";
+    return name;
+}
+
+static const RuntimeSig* find_runtime(const char* name) {
+    for (size_t i = 0; i < RUNTIME_SIG_COUNT; i++) {
+        if (strcmp(runtime_sigs[i].name, name) == 0) return &runtime_sigs[i];
+    }
+    return NULL;
+}
+
+static IrFunction* find_function(IrModule* mod, const char* name) {
+    for (IrFunction* fn = mod->funcs; fn; fn = fn->next) {
+        if (strcmp(fn->name, name) == 0) return fn;
+    }
+    return NULL;
+}
+
+static void block_label(char* buf, size_t n, IrBlock* block) {
+    if (block->label) snprintf(buf, n, "%s_%d", block->label, block->id);
+    else snprintf(buf, n, "b%d", block->id);
+}
+
+/* ============================================================
+ * Operands
+ * ============================================================ */
+
+static IrTypeKind defined_kind(LlvmContext* ctx, IrValue val) {
+    if (val.kind == VAL_VAR && val.storage.id < ctx->vreg_count &&
+        ctx->vreg_types[val.storage.id].kind != IR_VOID) {
+        return ctx->vreg_types[val.storage.id].kind;
+    }
+    if (val.kind == VAL_GLOBAL) return IR_PTR;
+    return norm_kind(val.type.kind);
+}
+
+static void const_text(char* buf, size_t n, IrValue val, IrTypeKind want) {
+    int64_t v = (int64_t)val.storage.constant.as.i;
+    if (val.type.kind == IR_BOOL) v = val.storage.constant.as.b ? 1 : 0;
+    if (val.type.kind == IR_I32) v = (int32_t)v;
+
+    switch (want) {
+        case IR_BOOL: snprintf(buf, n, "%s", v ? "true" : "false"); break;
+        case IR_I8:   snprintf(buf, n, "%d", (int8_t)v); break;
+        case IR_I32:  snprintf(buf, n, "%d", (int32_t)v); break;
+        case IR_F64:
+            /* Hex is the only exact double spelling LLVM takes */
+            if (val.type.kind == IR_F64) snprintf(buf, n, "0x%016lX", (unsigned long)val.storage.constant.as.i);
+            else snprintf(buf, n, "%ld.0", (long)v);
+            break;
+        case IR_PTR:
+            if (v == 0) snprintf(buf, n, "null");
+            else snprintf(buf, n, "inttoptr (i64 %ld to ptr)", (long)v);
+            break;
+        default:      snprintf(buf, n, "%ld", (long)v); break;
+    }
+}
+
+/* Emit a conversion of `src` (of kind `from`) to `to`; returns the temp id */
+static uint32_t emit_convert(LlvmContext* ctx, const char* src, IrTypeKind from, IrTypeKind to) {
+    FILE* out = ctx->out;
+    int fb = int_bits(from), tb = int_bits(to);
+    uint32_t t = ctx->tmp_counter++;
+
+    if (fb && tb) {
+        if (tb == 1) {
+            fprintf(out, "  %%t%u = icmp ne %s %s, 0\n", t, type_name(from), src);
+        } else if (tb > fb) {
+            fprintf(out, "  %%t%u = %s %s %s to %s\n", t, fb == 1 ? "zext" : "sext",
+                    type_name(from), src, type_name(to));
+        } else {
+            fprintf(out, "  %%t%u = trunc %s %s to %s\n", t, type_name(from), src, type_name(to));
+        }
+    } else if (fb && to == IR_PTR) {
+        if (fb != 64) {
+            fprintf(out, "  %%t%u = %s %s %s to i64\n", t, fb == 1 ? "zext" : "sext", type_name(from), src);
+            fprintf(out, "  %%t%u = inttoptr i64 %%t%u to ptr\n", t + 1, t);
+            t = ctx->tmp_counter++;
+        } else {
+            fprintf(out, "  %%t%u = inttoptr i64 %s to ptr\n", t, src);
+        }
+    } else if (from == IR_PTR && tb) {
+        if (tb == 1) {
+            fprintf(out, "  %%t%u = icmp ne ptr %s, null\n", t, src);
+        } else {
+            fprintf(out, "  %%t%u = ptrtoint ptr %s to %s\n", t, src, type_name(to));
+        }
+    } else if (fb && to == IR_F64) {
+        fprintf(out, "  %%t%u = sitofp %s %s to double\n", t, type_name(from), src);
+    } else if (from == IR_F64 && tb) {
+        fprintf(out, "  %%t%u = fptosi double %s to %s\n", t, src, type_name(to));
+    } else {
+        /* ptr <-> double never happens in generated code; keep the module valid */
+        fprintf(out, "  %%t%u = freeze %s undef\n", t, type_name(to));
+    }
+    return t;
+}
+
+/*
+ * Render `val` as an operand of kind `want` into `buf`, emitting any
+ * conversion it needs first.
+ */
+static void operand(LlvmContext* ctx, IrValue val, IrTypeKind want, char* buf, size_t n) {
+    want = norm_kind(want);
     switch (val.kind) {
-        case VAL_VAR:   fprintf(out, "%%%u", val.storage.id); break;
-        case VAL_CONST: fprintf(out, "%lu", val.storage.constant.as.i); break;
-        case VAL_GLOBAL: fprintf(out, "@%s", val.storage.global.name); break;
-        case VAL_UNDEF: fprintf(out, "undef"); break;
-        default: break;
+        case VAL_CONST:
+            const_text(buf, n, val, want);
+            return;
+        case VAL_UNDEF:
+            snprintf(buf, n, "%s", want == IR_PTR ? "null" : want == IR_F64 ? "0.0" :
+                                   want == IR_BOOL ? "false" : "0");
+            return;
+        case VAL_GLOBAL: {
+            const char* name = symbol_name(val.storage.global.name);
+            if (want == IR_PTR) {
+                snprintf(buf, n, "@%s", name);
+            } else {
+                snprintf(buf, n, "ptrtoint (ptr @%s to %s)", name, type_name(want));
+            }
+            return;
+        }
+        case VAL_VAR: {
+            char src[32];
+            snprintf(src, sizeof(src), "%%v%u", val.storage.id);
+            IrTypeKind have = defined_kind(ctx, val);
+            if (have == want) {
+                snprintf(buf, n, "%s", src);
+            } else {
+                snprintf(buf, n, "%%t%u", emit_convert(ctx, src, have, want));
+            }
+            return;
+        }
+    }
+}
+
+/* ============================================================
+ * Function Pre-pass
+ * ============================================================ */
+
+static IrTypeKind call_ret_kind(LlvmContext* ctx, IrInstr* inst) {
+    if (inst->op1.kind == VAL_GLOBAL) {
+        const char* name = symbol_name(inst->op1.storage.global.name);
+        const RuntimeSig* sig = find_runtime(name);
+        if (sig) return sig->ret;
+        IrFunction* callee = find_function(ctx->mod, inst->op1.storage.global.name);
+        if (callee) return callee->ret_type.kind == IR_VOID ? IR_VOID : norm_kind(callee->ret_type.kind);
     }
+    return inst->type.kind == IR_VOID ? IR_VOID : norm_kind(inst->type.kind);
 }
 
-static void emit_instr(FILE* out, IrInstr* inst) {
+static IrTypeKind result_kind(LlvmContext* ctx, IrInstr* inst) {
     switch (inst->op) {
-        case IR_RET:
-            fprintf(out, "  ret ");
-            if (inst->op1.kind != VAL_UNDEF) {
-                emit_type(out, inst->op1.type);
-                fprintf(out, " ");
-                emit_val(out, inst->op1);
-            } else {
-                fprintf(out, "void");
+        case IR_ALLOCA:
+        case IR_FIELD_PTR:
+            return IR_PTR;
+        case IR_EQ: case IR_NE: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+            return IR_BOOL;
+        case IR_CALL:
+        case IR_SPAWN:
+            return call_ret_kind(ctx, inst);
+        case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD: {
+            IrTypeKind k = norm_kind(inst->type.kind);
+            return (k == IR_PTR || k == IR_BOOL) ? IR_I64 : k;
+        }
+        case IR_MOV:
+            return defined_kind(ctx, inst->op1);
+        default:
+            return norm_kind(inst->type.kind);
+    }
+}
+
+static void scan_function(LlvmContext* ctx, IrFunction* fn) {
+    ctx->fn = fn;
+    ctx->tmp_counter = 0;
+    ctx->vreg_count = fn->vreg_counter;
+    ctx->vreg_types = calloc(fn->vreg_counter + 1, sizeof(IrType));
+    ctx->self_ptrs = calloc(fn->vreg_counter + 1, sizeof(bool));
+
+    for (size_t i = 0; i < fn->param_count && i < fn->vreg_counter; i++) {
+        ctx->vreg_types[i].kind = fn->param_types ? norm_kind(fn->param_types[i].kind) : IR_I32;
+    }
+
+    /* Definitions come before uses in layout order except across back edges */
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if (inst->result.kind == VAL_VAR && inst->result.storage.id < fn->vreg_counter) {
+                IrTypeKind k = result_kind(ctx, inst);
+                if (k != IR_VOID) ctx->vreg_types[inst->result.storage.id].kind = k;
             }
-            fprintf(out, "\n");
-            break;
-            
+            if (inst->op == IR_CALL && inst->op1.kind == VAL_GLOBAL &&
+                inst->result.kind == VAL_VAR && inst->result.storage.id < fn->vreg_counter &&
+                strcmp(inst->op1.storage.global.name, "arnm_self") == 0) {
+                ctx->self_ptrs[inst->result.storage.id] = true;
+            }
+        }
+    }
+}
+
+/* ============================================================
+ * Instructions
+ * ============================================================ */
+
+static bool is_terminator(IrOpcode op) {
+    return op == IR_RET || op == IR_BR || op == IR_JMP;
+}
+
+static void emit_binary(LlvmContext* ctx, IrInstr* inst, const char* opcode) {
+    IrTypeKind k = ctx->vreg_types[inst->result.storage.id].kind;
+    char a[96], b[96], fop[8];
+    if (k == IR_F64) {
+        /* add -> fadd, sdiv -> fdiv, srem -> frem */
+        bool sign = strcmp(opcode, "sdiv") == 0 || strcmp(opcode, "srem") == 0;
+        snprintf(fop, sizeof(fop), "f%s", sign ? opcode + 1 : opcode);
+        opcode = fop;
+    }
+    operand(ctx, inst->op1, k, a, sizeof(a));
+    operand(ctx, inst->op2, k, b, sizeof(b));
+    fprintf(ctx->out, "  %%v%u = %s %s %s, %s\n", inst->result.storage.id, opcode, type_name(k), a, b);
+}
+
+/*
+ * arnm_{f32x8,f64x4,i32x8}_op with a constant operator as one LLVM
+ * vector operation, which the optimizer can keep in registers. i32x8
+ * division, where a zero divisor gives 0, still calls the runtime.
+ */
+static bool emit_inline_vector_op(LlvmContext* ctx, IrInstr* inst) {
+    static const char* const ops[3][4] = {
+        { "fadd", "fsub", "fmul", "fdiv" },
+        { "fadd", "fsub", "fmul", "fdiv" },
+        { "add", "sub", "mul", NULL },
+    };
+    static const char* const vec_types[3] = { "<8 x float>", "<4 x double>", "<8 x i32>" };
+    static const int aligns[3] = { 4, 8, 4 };
+    if (inst->op1.kind != VAL_GLOBAL || inst->arg_count != 4 ||
+        inst->args[3].kind != VAL_CONST) {
+        return false;
+    }
+    const char* name = inst->op1.storage.global.name;
+    int type;
+    if (strcmp(name, "arnm_f32x8_op") == 0) type = 0;
+    else if (strcmp(name, "arnm_f64x4_op") == 0) type = 1;
+    else if (strcmp(name, "arnm_i32x8_op") == 0) type = 2;
+    else return false;
+
+    uint64_t op = inst->args[3].storage.constant.as.i;
+    if (op > 3 || !ops[type][op]) return false;
+
+    char dst[96], a[96], b[96];
+    operand(ctx, inst->args[0], IR_PTR, dst, sizeof(dst));
+    operand(ctx, inst->args[1], IR_PTR, a, sizeof(a));
+    operand(ctx, inst->args[2], IR_PTR, b, sizeof(b));
+    const char* vt = vec_types[type];
+    int align = aligns[type];
+    uint32_t t = ctx->tmp_counter;
+    ctx->tmp_counter += 3;
+    fprintf(ctx->out, "  %%t%u = load %s, ptr %s, align %d\n", t, vt, a, align);
+    fprintf(ctx->out, "  %%t%u = load %s, ptr %s, align %d\n", t + 1, vt, b, align);
+    fprintf(ctx->out, "  %%t%u = %s %s %%t%u, %%t%u\n", t + 2, ops[type][op], vt, t, t + 1);
+    fprintf(ctx->out, "  store %s %%t%u, ptr %s, align %d\n", vt, t + 2, dst, align);
+    return true;
+}
+
+static void emit_call(LlvmContext* ctx, IrInstr* inst) {
+    FILE* out = ctx->out;
+    if (inst->op == IR_CALL && emit_inline_vector_op(ctx, inst)) return;
+    IrTypeKind ret = call_ret_kind(ctx, inst);
+
+    /* Parameter kinds come from the callee, not from the call site */
+    IrTypeKind params[16];
+    size_t nargs = inst->arg_count < 16 ? inst->arg_count : 16;
+    const RuntimeSig* sig = NULL;
+    IrFunction* callee = NULL;
+    const char* name = NULL;
+
+    if (inst->op1.kind == VAL_GLOBAL) {
+        name = symbol_name(inst->op1.storage.global.name);
+        sig = find_runtime(name);
+        if (!sig) callee = find_function(ctx->mod, inst->op1.storage.global.name);
+    }
+
+    for (size_t i = 0; i < nargs; i++) {
+        if (sig && i < sig->param_count) params[i] = sig->params[i];
+        else if (callee && i < callee->param_count && callee->param_types)
+            params[i] = norm_kind(callee->param_types[i].kind);
+        else if (inst->args[i].kind == VAL_GLOBAL) params[i] = IR_PTR;
+        else params[i] = norm_kind(inst->args[i].type.kind);
+    }
+    if (sig) nargs = sig->param_count < nargs ? sig->param_count : nargs;
+    if (callee) nargs = callee->param_count < nargs ? callee->param_count : nargs;
+
+    if (name && !sig && !callee) {
+        bool seen = false;
+        for (size_t i = 0; i < ctx->extern_count; i++) {
+            if (strcmp(ctx->externs[i].name, name) == 0) seen = true;
+        }
+        if (!seen && ctx->extern_count < MAX_EXTERNS) {
+            ctx->externs[ctx->extern_count].name = name;
+            ctx->externs[ctx->extern_count].call = inst;
+            ctx->extern_count++;
+        }
+    }
+
+    char args[16][96];
+    for (size_t i = 0; i < nargs; i++) {
+        operand(ctx, inst->args[i], params[i], args[i], sizeof(args[i]));
+    }
+    char target[96];
+    if (name) snprintf(target, sizeof(target), "@%s", name);
+    else operand(ctx, inst->op1, IR_PTR, target, sizeof(target));
+
+    fprintf(out, "  ");
+    if (ret != IR_VOID && inst->result.kind == VAL_VAR) {
+        fprintf(out, "%%v%u = ", inst->result.storage.id);
+    }
+    fprintf(out, "call %s %s(", type_name(ret), target);
+    for (size_t i = 0; i < nargs; i++) {
+        fprintf(out, "%s%s %s", i ? ", " : "", type_name(params[i]), args[i]);
+    }
+    fprintf(out, ")\n");
+}
+
+static void emit_instr(LlvmContext* ctx, IrInstr* inst) {
+    FILE* out = ctx->out;
+    char a[96], b[96], l1[64], l2[64];
+
+    switch (inst->op) {
         case IR_ALLOCA:
-            /* %result = alloca <type> */
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = alloca ");
-            /* Type is stored in op1.type */
-            emit_type(out, inst->op1.type); /* The allocated type */
-            fprintf(out, "\n");
-            break;
-            
-        case IR_STORE:
-            /* store <ty> <val>, ptr <ptr> */
-            fprintf(out, "  store ");
-            emit_type(out, inst->op1.type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ptr ");
-            emit_val(out, inst->op2);
-            fprintf(out, "\n");
+            /* Hoisted into the entry block by emit_function */
             break;
-            
-        case IR_LOAD:
-            /* %result = load <ty>, ptr <ptr> */
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = load ");
-            emit_type(out, inst->type);
-            fprintf(out, ", ptr ");
-            emit_val(out, inst->op1);
-            fprintf(out, "\n");
+
+        case IR_RET: {
+            IrType ret = ctx->fn->ret_type;
+            if (ret.kind == IR_VOID) {
+                fprintf(out, "  ret void\n");
+            } else {
+                operand(ctx, inst->op1, ret.kind, a, sizeof(a));
+                fprintf(out, "  ret %s %s\n", type_name(norm_kind(ret.kind)), a);
+            }
             break;
-            
-        case IR_ADD:
-            /* %res = add <ty> <op1>, <op2> */
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = add ");
-            emit_type(out, inst->type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ");
-            emit_val(out, inst->op2);
-            fprintf(out, "\n");
+        }
+
+        case IR_STORE: {
+            IrTypeKind k = inst->op1.kind == VAL_VAR ? defined_kind(ctx, inst->op1)
+                                                     : norm_kind(inst->op1.type.kind);
+            operand(ctx, inst->op1, k, a, sizeof(a));
+            operand(ctx, inst->op2, IR_PTR, b, sizeof(b));
+            fprintf(out, "  store %s %s, ptr %s\n", type_name(k), a, b);
             break;
-            
-        case IR_SUB:
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = sub ");
-            emit_type(out, inst->type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ");
-            emit_val(out, inst->op2);
+        }
+
+        case IR_LOAD: {
+            IrTypeKind k = ctx->vreg_types[inst->result.storage.id].kind;
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            fprintf(out, "  %%v%u = load %s, ptr %s", inst->result.storage.id, type_name(k), a);
+            /*
+             * The first word of the process is its actor state, allocated
+             * at spawn and never moved: loads of it can be hoisted and CSEd.
+             */
+            if (k == IR_PTR && inst->op1.kind == VAL_VAR && inst->op1.storage.id < ctx->vreg_count &&
+                ctx->self_ptrs[inst->op1.storage.id]) {
+                fprintf(out, ", !nonnull !0, !invariant.load !0, !noundef !0");
+            }
             fprintf(out, "\n");
             break;
-            
-        case IR_MUL:
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = mul ");
-            emit_type(out, inst->type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ");
-            emit_val(out, inst->op2);
-            fprintf(out, "\n");
+        }
+
+        case IR_FIELD_PTR:
+            /* Fields are 8-byte slots, matching the x86 backend and spawn sizes */
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            fprintf(out, "  %%v%u = getelementptr inbounds i8, ptr %s, i64 %ld\n",
+                    inst->result.storage.id, a, (long)(int64_t)inst->op2.storage.constant.as.i * 8);
             break;
-            
-        case IR_DIV:
-            /* Signed division */
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = sdiv ");
-            emit_type(out, inst->type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ");
-            emit_val(out, inst->op2);
-            fprintf(out, "\n");
+
+        /*
+         * Array headers are written once by the runtime before the value
+         * escapes to us, so both words are invariant loads; the length
+         * (low half of an i64) is in [0, INT32_MAX].
+         */
+        case IR_ARRAY_DATA:
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            fprintf(out, "  %%v%u = load ptr, ptr %s, !nonnull !0, !invariant.load !0, !noundef !0\n",
+                    inst->result.storage.id, a);
             break;
-            
-        case IR_MOD:
-            /* Signed remainder */
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = srem ");
-            emit_type(out, inst->type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ");
-            emit_val(out, inst->op2);
-            fprintf(out, "\n");
+
+        case IR_ARRAY_LEN: {
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            uint32_t t = ctx->tmp_counter++;
+            fprintf(out, "  %%t%u = getelementptr inbounds i8, ptr %s, i64 8\n", t, a);
+            fprintf(out, "  %%v%u = load i32, ptr %%t%u, !range !1, !invariant.load !0, !noundef !0\n",
+                    inst->result.storage.id, t);
             break;
-            
-        case IR_AND:
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = and ");
-            emit_type(out, inst->type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ");
-            emit_val(out, inst->op2);
-            fprintf(out, "\n");
+        }
+
+        case IR_ELEM_PTR: {
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            operand(ctx, inst->op2, IR_I64, b, sizeof(b));
+            uint32_t t = ctx->tmp_counter++;
+            fprintf(out, "  %%t%u = shl nsw i64 %s, 3\n", t, b);
+            fprintf(out, "  %%v%u = getelementptr inbounds i8, ptr %s, i64 %%t%u\n",
+                    inst->result.storage.id, a, t);
             break;
-            
-        case IR_OR:
-            fprintf(out, "  ");
-            emit_val(out, inst->result);
-            fprintf(out, " = or ");
-            emit_type(out, inst->type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ");
-            emit_val(out, inst->op2);
-            fprintf(out, "\n");
+        }
+
+        case IR_BOUNDS_CHECK: {
+            /* One unsigned compare covers negative indices too */
+            operand(ctx, inst->op1, IR_I64, a, sizeof(a));
+            operand(ctx, inst->op2, IR_I64, b, sizeof(b));
+            uint32_t t = ctx->tmp_counter++;
+            fprintf(out, "  %%t%u = icmp uge i64 %s, %s\n", t, a, b);
+            fprintf(out, "  br i1 %%t%u, label %%bounds.fail%u, label %%bounds.ok%u\n", t, t, t);
+            fprintf(out, "bounds.fail%u:\n", t);
+            fprintf(out, "  call void @arnm_panic_bounds(i64 %s, i64 %s)\n", a, b);
+            fprintf(out, "  unreachable\n");
+            fprintf(out, "bounds.ok%u:\n", t);
             break;
-            
-        case IR_EQ: case IR_NE: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
-            /* %r = icmp eq i32 %op1, %op2 */
-            fprintf(out, "  ");
-            if (inst->result.kind != VAL_UNDEF) {
-                emit_val(out, inst->result);
-                fprintf(out, " = ");
-            }
-            fprintf(out, "icmp ");
-            switch(inst->op) {
-                case IR_EQ: fprintf(out, "eq "); break;
-                case IR_NE: fprintf(out, "ne "); break;
-                case IR_LT: fprintf(out, "slt "); break; /* Signed comparison for now */
-                case IR_LE: fprintf(out, "sle "); break;
-                case IR_GT: fprintf(out, "sgt "); break;
-                case IR_GE: fprintf(out, "sge "); break;
+        }
+
+        case IR_ADD: emit_binary(ctx, inst, "add"); break;
+        case IR_SUB: emit_binary(ctx, inst, "sub"); break;
+        case IR_MUL: emit_binary(ctx, inst, "mul"); break;
+        case IR_DIV: emit_binary(ctx, inst, "sdiv"); break;
+        case IR_MOD: emit_binary(ctx, inst, "srem"); break;
+        case IR_AND: emit_binary(ctx, inst, "and"); break;
+        case IR_OR:  emit_binary(ctx, inst, "or"); break;
+
+        case IR_EQ: case IR_NE: case IR_LT: case IR_LE: case IR_GT: case IR_GE: {
+            const char* pred = "eq";
+            switch (inst->op) {
+                case IR_NE: pred = "ne"; break;
+                case IR_LT: pred = "slt"; break;
+                case IR_LE: pred = "sle"; break;
+                case IR_GT: pred = "sgt"; break;
+                case IR_GE: pred = "sge"; break;
                 default: break;
             }
-            emit_type(out, inst->op1.type); /* Operand types */
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", ");
-            emit_val(out, inst->op2);
-            fprintf(out, "\n");
+            /* Compare at the wider of the two operand types */
+            IrTypeKind k1 = defined_kind(ctx, inst->op1);
+            IrTypeKind k2 = defined_kind(ctx, inst->op2);
+            if (k1 == IR_F64 || k2 == IR_F64) {
+                /* Ordered except !=, which must hold for NaN */
+                static const char* const fpreds[] = { "oeq", "une", "olt", "ole", "ogt", "oge" };
+                operand(ctx, inst->op1, IR_F64, a, sizeof(a));
+                operand(ctx, inst->op2, IR_F64, b, sizeof(b));
+                fprintf(out, "  %%v%u = fcmp %s double %s, %s\n", inst->result.storage.id,
+                        fpreds[inst->op - IR_EQ], a, b);
+                break;
+            }
+            IrTypeKind k = k1;
+            if (inst->op1.kind == VAL_CONST) k = k2;
+            else if (inst->op2.kind != VAL_CONST && k1 != k2) {
+                k = (k1 == IR_PTR || k2 == IR_PTR) ? IR_PTR
+                  : int_bits(k1) >= int_bits(k2) ? k1 : k2;
+            }
+            operand(ctx, inst->op1, k, a, sizeof(a));
+            operand(ctx, inst->op2, k, b, sizeof(b));
+            fprintf(out, "  %%v%u = icmp %s %s %s, %s\n", inst->result.storage.id, pred, type_name(k), a, b);
             break;
+        }
 
         case IR_CALL:
-            /* call <ret_ty> @name(<args>) */
-            fprintf(out, "  ");
-            if (inst->type.kind != IR_VOID) {
-                emit_val(out, inst->result);
-                fprintf(out, " = ");
-            }
-            fprintf(out, "call ");
-            emit_type(out, inst->type);
-            fprintf(out, " @%s(", inst->op1.storage.global.name);
-            for (size_t i = 0; i < inst->arg_count; i++) {
-                if (i > 0) fprintf(out, ", ");
-                emit_type(out, inst->args[i].type);
-                fprintf(out, " ");
-                emit_val(out, inst->args[i]);
-            }
-            fprintf(out, ")\n");
+        case IR_SPAWN:
+            emit_call(ctx, inst);
             break;
-            
+
         case IR_BR:
-            /* br i1 %cond, label %then, label %else */
-            fprintf(out, "  br ");
-            emit_type(out, inst->op1.type);
-            fprintf(out, " ");
-            emit_val(out, inst->op1);
-            fprintf(out, ", label ");
-            if (inst->target1->label) fprintf(out, "%%%s_%d", inst->target1->label, inst->target1->id);
-            else fprintf(out, "%%b%d", inst->target1->id);
-            fprintf(out, ", label ");
-            if (inst->target2->label) fprintf(out, "%%%s_%d", inst->target2->label, inst->target2->id);
-            else fprintf(out, "%%b%d", inst->target2->id);
-            fprintf(out, "\n");
+            operand(ctx, inst->op1, IR_BOOL, a, sizeof(a));
+            block_label(l1, sizeof(l1), inst->target1);
+            block_label(l2, sizeof(l2), inst->target2);
+            fprintf(out, "  br i1 %s, label %%%s, label %%%s\n", a, l1, l2);
             break;
-            
+
         case IR_JMP:
-            /* br label %dest */
-            fprintf(out, "  br label ");
-            if (inst->target1->label) fprintf(out, "%%%s_%d", inst->target1->label, inst->target1->id);
-            else fprintf(out, "%%b%d", inst->target1->id);
-            fprintf(out, "\n");
+            block_label(l1, sizeof(l1), inst->target1);
+            fprintf(out, "  br label %%%s\n", l1);
+            break;
+
+        case IR_MOV: {
+            /* No copies in SSA; a select on a constant folds away */
+            IrTypeKind k = ctx->vreg_types[inst->result.storage.id].kind;
+            operand(ctx, inst->op1, k, a, sizeof(a));
+            fprintf(out, "  %%v%u = select i1 true, %s %s, %s %s\n",
+                    inst->result.storage.id, type_name(k), a, type_name(k), a);
+            break;
+        }
+
+        default:
+            /* Actor ops are lowered to runtime calls by irgen */
             break;
-            
-        default: break;
     }
 }
 
-static void emit_block(FILE* out, IrBlock* block) {
-    /* Always include block ID to ensure unique labels */
-    if (block->label) {
-        fprintf(out, "%s_%d:\n", block->label, block->id);
-    } else {
-        fprintf(out, "b%d:\n", block->id);
+/* ============================================================
+ * Blocks and Functions
+ * ============================================================ */
+
+static bool targets_entry(IrFunction* fn) {
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if ((inst->op == IR_JMP || inst->op == IR_BR) &&
+                (inst->target1 == fn->entry || inst->target2 == fn->entry)) {
+                return true;
+            }
+        }
     }
-    
+    return false;
+}
+
+/* Instructions up to the first terminator, then the implicit fall-through */
+static void emit_block_body(LlvmContext* ctx, IrBlock* block) {
+    FILE* out = ctx->out;
+
+    /* Anything after the first terminator is dead and not valid LLVM */
     IrInstr* inst = block->head;
-    while (inst) {
-        emit_instr(out, inst);
+    bool terminated = false;
+    while (inst && !terminated) {
+        emit_instr(ctx, inst);
+        terminated = is_terminator(inst->op);
         inst = inst->next;
     }
-}
+    if (terminated) return;
 
-static void emit_function(FILE* out, IrFunction* fn) {
-    fprintf(out, "define ");
-    emit_type(out, fn->ret_type);
-    
-    if (strcmp(fn->name, "main") == 0) {
-         fprintf(out, " @_arnm_main(");
+    /* The x86 backend falls through to the next block in layout */
+    IrType ret = ctx->fn->ret_type;
+    if (block->next) {
+        char label[64];
+        block_label(label, sizeof(label), block->next);
+        fprintf(out, "  br label %%%s\n", label);
+    } else if (ret.kind == IR_VOID) {
+        fprintf(out, "  ret void\n");
     } else {
-         fprintf(out, " @%s(", fn->name);
+        IrValue zero = { .kind = VAL_UNDEF };
+        char a[32];
+        operand(ctx, zero, ret.kind, a, sizeof(a));
+        fprintf(out, "  ret %s %s\n", type_name(norm_kind(ret.kind)), a);
     }
-    
+}
+
+static void emit_function(LlvmContext* ctx, IrFunction* fn) {
+    FILE* out = ctx->out;
+    scan_function(ctx, fn);
+
+    const char* ret = fn->ret_type.kind == IR_VOID ? "void" : type_name(norm_kind(fn->ret_type.kind));
+    fprintf(out, "define %s @%s(", ret, symbol_name(fn->name));
     for (size_t i = 0; i < fn->param_count; i++) {
-        if (i > 0) fprintf(out, ", ");
-        if (fn->param_types) {
-            emit_type(out, fn->param_types[i]);
-        } else {
-             fprintf(out, "i32");
+        IrTypeKind k = fn->param_types ? norm_kind(fn->param_types[i].kind) : IR_I32;
+        /*
+         * Pointer parameters are an outlined parallel body's private frame
+         * or array headers, which are never written, so noalias holds
+         */
+        fprintf(out, "%s%s%s %%v%zu", i ? ", " : "", type_name(k),
+                k == IR_PTR ? " noalias nonnull" : "", i);
+    }
+    fprintf(out, ") #0 {\n");
+
+    if (!fn->entry) {
+        fprintf(out, "entry:\n  unreachable\n}\n\n");
+        return;
+    }
+
+    /*
+     * Every alloca goes in the entry block so mem2reg can promote it;
+     * irgen places them where the `let` is, which may be inside a loop.
+     * LLVM's entry block cannot be a branch target, so a loop back to
+     * ours gets a separate prologue.
+     */
+    char label[64];
+    bool split = targets_entry(fn);
+    block_label(label, sizeof(label), fn->entry);
+    fprintf(out, "%s:\n", split ? "prologue" : label);
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if (inst->op == IR_ALLOCA && inst->result.kind == VAL_VAR) {
+                if (inst->op1.type.kind == IR_VEC) {
+                    fprintf(out, "  %%v%u = alloca [4 x i64], align 32\n", inst->result.storage.id);
+                    continue;
+                }
+                IrTypeKind k = norm_kind(inst->op1.type.kind);
+                /* Slots are 8 bytes wide whatever is stored in them */
+                if (int_bits(k) && int_bits(k) < 64) k = IR_I64;
+                fprintf(out, "  %%v%u = alloca %s, align 8\n", inst->result.storage.id, type_name(k));
+            }
         }
-        /* Optionally verify implicit %0, %1 matches vreg counter logic */
     }
-    
-    fprintf(out, ") {\n");
-    
-    IrBlock* blk = fn->entry;
-    while (blk) {
-        emit_block(out, blk);
-        blk = blk->next;
+    if (split) fprintf(out, "  br label %%%s\n%s:\n", label, label);
+
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        if (blk != fn->entry) {
+            block_label(label, sizeof(label), blk);
+            fprintf(out, "%s:\n", label);
+        }
+        emit_block_body(ctx, blk);
     }
-    
+
     fprintf(out, "}\n\n");
+
+    free(ctx->vreg_types);
+    free(ctx->self_ptrs);
+    ctx->vreg_types = NULL;
+    ctx->self_ptrs = NULL;
 }
 
+/* ============================================================
+ * Module
+ * ============================================================ */
+
 bool codegen_emit(IrModule* mod, FILE* out) {
     if (!mod || !out) return false;
-    
+
+    LlvmContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.out = out;
+    ctx.mod = mod;
+
     /* Header */
     fprintf(out, "; Generated by ARNm Compiler\n");
-    fprintf(out, "target datalayout = \"e-m:e-i64:64-f80:128-n8:16:32:64-S128\"\n");
+    fprintf(out, "target datalayout = \"e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-f80:128-n8:16:32:64-S128\"\n");
     fprintf(out, "target triple = \"x86_64-pc-linux-gnu\"\n\n");
-    
+
     /* Runtime declarations */
-    fprintf(out, "declare ptr @arnm_spawn(ptr, ptr)\n");
-    fprintf(out, "declare void @arnm_send(ptr, i32, ptr, i64)\n");
-    fprintf(out, "declare ptr @arnm_receive(ptr)\n");
-    fprintf(out, "declare ptr @arnm_self()\n");
-    fprintf(out, "declare void @arnm_panic_nomatch()\n\n");
+    for (size_t i = 0; i < RUNTIME_SIG_COUNT; i++) {
+        const RuntimeSig* sig = &runtime_sigs[i];
+        if (find_function(mod, sig->name)) continue;
+        fprintf(out, "declare %s%s @%s(", sig->attrs, type_name(sig->ret), sig->name);
+        for (size_t p = 0; p < sig->param_count; p++) {
+            fprintf(out, "%s%s", p ? ", " : "", type_name(sig->params[p]));
+        }
+        fprintf(out, ") #%d\n", sig->group);
+    }
+    fprintf(out, "\n");
 
     IrFunction* fn = mod->funcs;
     while (fn) {
-        emit_function(out, fn);
+        emit_function(&ctx, fn);
         fn = fn->next;
     }
-    
+
+    /* Anything else called but not defined here, typed from its first call */
+    for (size_t i = 0; i < ctx.extern_count; i++) {
+        IrInstr* call = ctx.externs[i].call;
+        IrTypeKind ret = call->type.kind == IR_VOID ? IR_VOID : norm_kind(call->type.kind);
+        fprintf(out, "declare %s @%s(", type_name(ret), ctx.externs[i].name);
+        for (size_t p = 0; p < call->arg_count; p++) {
+            IrTypeKind k = call->args[p].kind == VAL_GLOBAL ? IR_PTR : norm_kind(call->args[p].type.kind);
+            fprintf(out, "%s%s", p ? ", " : "", type_name(k));
+        }
+        fprintf(out, ") #0\n");
+    }
+
+    /* #1: arnm_self is fixed for the life of the calling process */
+    fprintf(out, "\nattributes #0 = { nounwind }\n");
+    fprintf(out, "attributes #1 = { nounwind readnone willreturn }\n");
+    fprintf(out, "attributes #2 = { noreturn nounwind }\n");
+    fprintf(out, "!0 = !{}\n");
+    fprintf(out, "!1 = !{i32 0, i32 -2147483648}\n");
+
     return true;
 }
@@ -0,0 +1,705 @@
+/*
+ * ARNm Compiler - Portable C Code Generator
+ *
+ * Lowers the IR to C11 for the system C compiler: one typed local per
+ * virtual register, blocks as labels joined by goto, and allocas that
+ * never escape as plain locals so the C compiler keeps them in
+ * registers. Like the LLVM emitter, conversions are inserted wherever a
+ * value is used at a type other than the one it was defined with; the
+ * output is meant to be built with -fwrapv -fno-strict-aliasing, which
+ * matches the 64-bit slot semantics of the x86 backend.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "../include/codegen_c.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================
+ * Runtime Signatures
+ * ============================================================ */
+
+#define MAX_SIG_PARAMS 5
+
+typedef struct {
+    const char* name;
+    IrTypeKind  ret;
+    IrTypeKind  params[MAX_SIG_PARAMS];
+    const char* casts[MAX_SIG_PARAMS];  /* C parameter type where void* won't convert */
+    size_t      param_count;
+} CRuntimeSig;
+
+static const CRuntimeSig c_runtime_sigs[] = {
+    { "arnm_spawn",              IR_PTR,  { IR_PTR, IR_PTR, IR_I64 }, { "void (*)(void*)" }, 3 },
+    { "arnm_spawn_joinable",     IR_PTR,  { IR_PTR, IR_PTR, IR_I64 }, { "void (*)(void*)" }, 3 },
+    { "arnm_join_proc",          IR_I32,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_send",               IR_I32,  { IR_PTR, IR_I64, IR_PTR, IR_I64 }, { 0 }, 4 },
+    { "arnm_receive",            IR_PTR,  { 0 }, { 0 }, 0 },
+    { "arnm_receive_idle",       IR_PTR,  { IR_PTR }, { "void (*)(void*)" }, 1 },
+    { "arnm_message_free",       IR_VOID, { IR_PTR }, { 0 }, 1 },
+    { "arnm_self",               IR_PTR,  { 0 }, { 0 }, 0 },
+    { "arnm_panic_nomatch",      IR_VOID, { 0 }, { 0 }, 0 },
+    { "arnm_panic_bounds",       IR_VOID, { IR_I64, IR_I64 }, { 0 }, 2 },
+    { "arnm_array_new",          IR_PTR,  { IR_I64 }, { 0 }, 1 },
+    { "arnm_array_slice",        IR_PTR,  { IR_PTR, IR_I64, IR_I64 }, { 0 }, 3 },
+    { "arnm_array_aliased",      IR_I32,  { IR_PTR, IR_PTR }, { 0 }, 2 },
+    { "arnm_vec_new",            IR_PTR,  { 0 }, { 0 }, 0 },
+    { "arnm_vec_len",            IR_I32,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_vec_push",           IR_PTR,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_vec_pop",            IR_PTR,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_vec_at",             IR_PTR,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_map_new",            IR_PTR,  { 0 }, { 0 }, 0 },
+    { "arnm_map_len",            IR_I32,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_map_slot",           IR_PTR,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_map_at",             IR_PTR,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_map_has",            IR_I32,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_map_remove",         IR_I32,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_deque_new",          IR_PTR,  { 0 }, { 0 }, 0 },
+    { "arnm_deque_len",          IR_I32,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_deque_push_back",    IR_PTR,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_deque_push_front",   IR_PTR,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_deque_pop_back",     IR_PTR,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_deque_pop_front",    IR_PTR,  { IR_PTR }, { 0 }, 1 },
+    { "arnm_deque_at",           IR_PTR,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_print_int",          IR_VOID, { IR_I32 }, { 0 }, 1 },
+    { "arnm_print_f64",          IR_VOID, { IR_F64 }, { 0 }, 1 },
+    { "arnm_channel_create",     IR_PTR,  { IR_I64 }, { 0 }, 1 },
+    { "arnm_channel_send",       IR_BOOL, { IR_PTR, IR_PTR }, { 0 }, 2 },
+    { "arnm_channel_close",      IR_VOID, { IR_PTR }, { 0 }, 1 },
+    { "arnm_select_recv4",       IR_I64,  { IR_PTR, IR_PTR, IR_PTR, IR_PTR, IR_I64 }, { 0 }, 5 },
+    { "arnm_select_value",       IR_I64,  { 0 }, { 0 }, 0 },
+    { "arnm_parallel_for",       IR_VOID, { IR_I64, IR_I64, IR_PTR, IR_PTR }, { 0, 0, "ArnmForBody" }, 4 },
+    { "arnm_parallel_reduce_op", IR_I64,  { IR_I64, IR_I64, IR_PTR, IR_PTR, IR_I64 }, { 0, 0, "ArnmReduceBody" }, 5 },
+    { "arnm_alloc",              IR_PTR,  { IR_I64, IR_PTR }, { 0, "ArnmDestructor" }, 2 },
+    { "arnm_release",            IR_VOID, { IR_PTR }, { 0 }, 1 },
+    { "arnm_f32x8_splat",        IR_VOID, { IR_PTR, IR_F64 }, { 0 }, 2 },
+    { "arnm_f32x8_get",          IR_F64,  { IR_PTR, IR_I32 }, { 0 }, 2 },
+    { "arnm_f32x8_set",          IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_F64 }, { 0 }, 4 },
+    { "arnm_f32x8_op",           IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, { 0 }, 4 },
+    { "arnm_f32x8_reduce",       IR_F64,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_f32x8_shuffle",      IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, { 0 }, 3 },
+    { "arnm_i32x8_splat",        IR_VOID, { IR_PTR, IR_I32 }, { 0 }, 2 },
+    { "arnm_i32x8_get",          IR_I32,  { IR_PTR, IR_I32 }, { 0 }, 2 },
+    { "arnm_i32x8_set",          IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_I32 }, { 0 }, 4 },
+    { "arnm_i32x8_op",           IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, { 0 }, 4 },
+    { "arnm_i32x8_reduce",       IR_I32,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_i32x8_shuffle",      IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, { 0 }, 3 },
+    { "arnm_f64x4_splat",        IR_VOID, { IR_PTR, IR_F64 }, { 0 }, 2 },
+    { "arnm_f64x4_get",          IR_F64,  { IR_PTR, IR_I32 }, { 0 }, 2 },
+    { "arnm_f64x4_set",          IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_F64 }, { 0 }, 4 },
+    { "arnm_f64x4_op",           IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, { 0 }, 4 },
+    { "arnm_f64x4_reduce",       IR_F64,  { IR_PTR, IR_I64 }, { 0 }, 2 },
+    { "arnm_f64x4_shuffle",      IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, { 0 }, 3 },
+};
+
+#define C_RUNTIME_SIG_COUNT (sizeof(c_runtime_sigs) / sizeof(c_runtime_sigs[0]))
+
+/* Callees neither defined in the module nor part of the runtime */
+#define MAX_EXTERNS 64
+
+typedef struct {
+    FILE*       out;
+    IrModule*   mod;
+    IrFunction* fn;
+    IrTypeKind* kinds;              /* Type each vreg is defined with (IR_VOID = none) */
+    bool*       allocas;            /* Vreg is an alloca */
+    bool*       escapes;            /* Alloca whose address is used beyond load/store */
+    IrTypeKind* slot_kinds;         /* Type of the local backing each alloca */
+    uint32_t    vreg_count;
+    IrInstr*    externs[MAX_EXTERNS];  /* First call to each, for the types */
+    size_t      extern_count;
+} CContext;
+
+/* ============================================================
+ * Types and Names
+ * ============================================================ */
+
+static IrTypeKind c_norm(IrTypeKind kind) {
+    switch (kind) {
+        case IR_PROCESS:
+        case IR_VEC:     return IR_PTR;
+        case IR_VOID:
+        case IR_BAD:     return IR_I64;
+        default:         return kind;
+    }
+}
+
+static const char* c_type(IrTypeKind kind) {
+    switch (kind) {
+        case IR_VOID: return "void";
+        case IR_BOOL: return "bool";
+        case IR_I8:   return "int8_t";
+        case IR_I32:  return "int32_t";
+        case IR_I64:  return "int64_t";
+        case IR_F64:  return "double";
+        case IR_PTR:
+        case IR_PROCESS: return "void*";
+        default:      return "int64_t";
+    }
+}
+
+static bool is_int(IrTypeKind kind) {
+    return kind == IR_BOOL || kind == IR_I8 || kind == IR_I32 || kind == IR_I64;
+}
+
+static const CRuntimeSig* find_sig(const char* name) {
+    for (size_t i = 0; i < C_RUNTIME_SIG_COUNT; i++) {
+        if (strcmp(c_runtime_sigs[i].name, name) == 0) return &c_runtime_sigs[i];
+    }
+    return NULL;
+}
+
+static IrFunction* find_fn(IrModule* mod, const char* name) {
+    for (IrFunction* fn = mod->funcs; fn; fn = fn->next) {
+        if (strcmp(fn->name, name) == 0) return fn;
+    }
+    return NULL;
+}
+
+/*
+ * Module functions get a prefix so ARNm names can't collide with C
+ * keywords or the runtime; main keeps the name crt0 calls.
+ */
+static void fn_name(char* buf, size_t n, const char* name) {
+    if (strcmp(name, "main") == 0) snprintf(buf, n, "_arnm_main");
+    else snprintf(buf, n, "fn_%s", name);
+}
+
+/* A callee or function reference as spelled in C */
+static void symbol(CContext* ctx, char* buf, size_t n, const char* name) {
+    if (find_fn(ctx->mod, name)) fn_name(buf, n, name);
+    else if (strcmp(name, "print") == 0) snprintf(buf, n, "arnm_print_int");
+    else snprintf(buf, n, "%s", name);
+}
+
+/* ============================================================
+ * Operands
+ * ============================================================ */
+
+static IrTypeKind def_kind(CContext* ctx, IrValue val) {
+    if (val.kind == VAL_VAR && val.storage.id < ctx->vreg_count && ctx->kinds[val.storage.id] != IR_VOID) {
+        return ctx->kinds[val.storage.id];
+    }
+    if (val.kind == VAL_GLOBAL) return IR_PTR;
+    return c_norm(val.type.kind);
+}
+
+/* Convert the C expression `src` of kind `from` to kind `to` */
+static void convert(char* buf, size_t n, const char* src, IrTypeKind from, IrTypeKind to) {
+    if (from == to) {
+        snprintf(buf, n, "%s", src);
+    } else if (to == IR_BOOL) {
+        snprintf(buf, n, "(%s != %s)", src, from == IR_PTR ? "NULL" : "0");
+    } else if (to == IR_PTR) {
+        snprintf(buf, n, is_int(from) ? "(void*)(intptr_t)(%s)" : "(void*)(intptr_t)(int64_t)(%s)", src);
+    } else if (from == IR_PTR) {
+        snprintf(buf, n, "(%s)(intptr_t)(%s)", c_type(to), src);
+    } else {
+        snprintf(buf, n, "(%s)(%s)", c_type(to), src);
+    }
+}
+
+static void operand(CContext* ctx, IrValue val, IrTypeKind want, char* buf, size_t n) {
+    want = c_norm(want);
+    char src[160];
+    switch (val.kind) {
+        case VAL_CONST: {
+            int64_t v = (int64_t)val.storage.constant.as.i;
+            if (val.type.kind == IR_BOOL) v = val.storage.constant.as.b ? 1 : 0;
+            if (val.type.kind == IR_I32) v = (int32_t)v;
+            if (want == IR_PTR) {
+                if (v == 0) snprintf(buf, n, "NULL");
+                else snprintf(buf, n, "(void*)(intptr_t)INT64_C(%ld)", (long)v);
+            } else if (want == IR_BOOL) {
+                snprintf(buf, n, "%s", v ? "true" : "false");
+            } else if (want == IR_F64 && val.type.kind == IR_F64) {
+                /* Keep it a double literal: 1.0 / 3.0 must not divide as int */
+                int len = snprintf(buf, n, "%.17g", val.storage.constant.as.f);
+                if (!strpbrk(buf, ".e") && len > 0 && (size_t)len + 2 < n) strcat(buf, ".0");
+            } else if (want == IR_I64) {
+                if (v == INT64_MIN) snprintf(buf, n, "INT64_MIN");
+                else snprintf(buf, n, "INT64_C(%ld)", (long)v);
+            } else if ((int32_t)v == INT32_MIN) {
+                snprintf(buf, n, "(%s)INT32_MIN", c_type(want));
+            } else {
+                snprintf(buf, n, "(%s)%d", c_type(want), (int32_t)v);
+            }
+            return;
+        }
+        case VAL_UNDEF:
+            snprintf(buf, n, "%s", want == IR_PTR ? "NULL" : "0");
+            return;
+        case VAL_GLOBAL: {
+            char name[128];
+            symbol(ctx, name, sizeof(name), val.storage.global.name);
+            snprintf(src, sizeof(src), "(void*)%s", name);
+            convert(buf, n, src, IR_PTR, want);
+            return;
+        }
+        case VAL_VAR:
+            snprintf(src, sizeof(src), "v%u", val.storage.id);
+            convert(buf, n, src, def_kind(ctx, val), want);
+            return;
+    }
+}
+
+/* ============================================================
+ * Function Pre-pass
+ * ============================================================ */
+
+static IrTypeKind call_kind(CContext* ctx, IrInstr* inst) {
+    if (inst->op1.kind == VAL_GLOBAL) {
+        const char* name = inst->op1.storage.global.name;
+        const CRuntimeSig* sig = find_sig(strcmp(name, "print") == 0 ? "arnm_print_int" : name);
+        if (sig) return sig->ret;
+        IrFunction* callee = find_fn(ctx->mod, name);
+        if (callee) return callee->ret_type.kind == IR_VOID ? IR_VOID : c_norm(callee->ret_type.kind);
+    }
+    return inst->type.kind == IR_VOID ? IR_VOID : c_norm(inst->type.kind);
+}
+
+static IrTypeKind def_result(CContext* ctx, IrInstr* inst) {
+    switch (inst->op) {
+        case IR_ALLOCA:
+        case IR_FIELD_PTR:
+            return IR_PTR;
+        case IR_EQ: case IR_NE: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+            return IR_BOOL;
+        case IR_CALL:
+        case IR_SPAWN:
+            return call_kind(ctx, inst);
+        case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD: {
+            IrTypeKind k = c_norm(inst->type.kind);
+            return (k == IR_PTR || k == IR_BOOL) ? IR_I64 : k;
+        }
+        case IR_MOV:
+            return def_kind(ctx, inst->op1);
+        default:
+            return c_norm(inst->type.kind);
+    }
+}
+
+static void mark_escape(CContext* ctx, IrValue val) {
+    if (val.kind == VAL_VAR && val.storage.id < ctx->vreg_count && ctx->allocas[val.storage.id]) {
+        ctx->escapes[val.storage.id] = true;
+    }
+}
+
+static void scan(CContext* ctx, IrFunction* fn) {
+    uint32_t n = fn->vreg_counter + 1;
+    ctx->fn = fn;
+    ctx->vreg_count = fn->vreg_counter;
+    ctx->kinds = calloc(n, sizeof(IrTypeKind));
+    ctx->allocas = calloc(n, sizeof(bool));
+    ctx->escapes = calloc(n, sizeof(bool));
+    ctx->slot_kinds = calloc(n, sizeof(IrTypeKind));
+
+    for (size_t i = 0; i < fn->param_count && i < fn->vreg_counter; i++) {
+        ctx->kinds[i] = fn->param_types ? c_norm(fn->param_types[i].kind) : IR_I32;
+    }
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if (inst->result.kind != VAL_VAR || inst->result.storage.id >= fn->vreg_counter) continue;
+            uint32_t id = inst->result.storage.id;
+            IrTypeKind k = def_result(ctx, inst);
+            if (k != IR_VOID) ctx->kinds[id] = k;
+            if (inst->op == IR_ALLOCA) {
+                ctx->allocas[id] = true;
+                ctx->slot_kinds[id] = inst->op1.type.kind == IR_VEC ? IR_VEC : c_norm(inst->op1.type.kind);
+            }
+        }
+    }
+
+    /* Anything but the address operand of a load or store lets the slot escape */
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if (inst->op != IR_LOAD) mark_escape(ctx, inst->op1);
+            if (inst->op != IR_STORE) mark_escape(ctx, inst->op2);
+            for (size_t i = 0; i < inst->arg_count; i++) mark_escape(ctx, inst->args[i]);
+        }
+    }
+}
+
+static void scan_free(CContext* ctx) {
+    free(ctx->kinds);
+    free(ctx->allocas);
+    free(ctx->escapes);
+    free(ctx->slot_kinds);
+    ctx->kinds = NULL;
+    ctx->allocas = NULL;
+    ctx->escapes = NULL;
+    ctx->slot_kinds = NULL;
+}
+
+/* A non-escaping alloca addressed by `ptr`, or -1 */
+static int64_t local_slot(CContext* ctx, IrValue ptr) {
+    if (ptr.kind == VAL_VAR && ptr.storage.id < ctx->vreg_count &&
+        ctx->allocas[ptr.storage.id] && !ctx->escapes[ptr.storage.id]) {
+        return ptr.storage.id;
+    }
+    return -1;
+}
+
+/* ============================================================
+ * Instructions
+ * ============================================================ */
+
+static bool is_terminator(IrOpcode op) {
+    return op == IR_RET || op == IR_BR || op == IR_JMP;
+}
+
+static void emit_binary(CContext* ctx, IrInstr* inst, const char* op) {
+    IrTypeKind k = ctx->kinds[inst->result.storage.id];
+    char a[256], b[256];
+    operand(ctx, inst->op1, k, a, sizeof(a));
+    operand(ctx, inst->op2, k, b, sizeof(b));
+    fprintf(ctx->out, "    v%u = (%s)(%s %s %s);\n", inst->result.storage.id, c_type(k), a, op, b);
+}
+
+/*
+ * arnm_<vec>_op with a constant operator as a lane loop the C compiler
+ * turns into vector code. Lanes are read before any is written, as in
+ * the runtime. i32x8 division keeps its zero-divisor rule out of line.
+ */
+static bool emit_inline_vector_op(CContext* ctx, IrInstr* inst) {
+    static const char ops[4] = { '+', '-', '*', '/' };
+    static const char* const vec_types[3] = { "ArnmF32x8", "ArnmF64x4", "ArnmI32x8" };
+    static const int lanes[3] = { 8, 4, 8 };
+    if (inst->op1.kind != VAL_GLOBAL || inst->arg_count != 4 ||
+        inst->args[3].kind != VAL_CONST) {
+        return false;
+    }
+    const char* name = inst->op1.storage.global.name;
+    int type;
+    if (strcmp(name, "arnm_f32x8_op") == 0) type = 0;
+    else if (strcmp(name, "arnm_f64x4_op") == 0) type = 1;
+    else if (strcmp(name, "arnm_i32x8_op") == 0) type = 2;
+    else return false;
+
+    uint64_t op = inst->args[3].storage.constant.as.i;
+    if (op > 3 || (type == 2 && op == 3)) return false;
+
+    char dst[256], a[256], b[256];
+    operand(ctx, inst->args[0], IR_PTR, dst, sizeof(dst));
+    operand(ctx, inst->args[1], IR_PTR, a, sizeof(a));
+    operand(ctx, inst->args[2], IR_PTR, b, sizeof(b));
+    const char* vt = vec_types[type];
+    fprintf(ctx->out, "    { %s t; for (int k = 0; k < %d; k++) "
+            "t.lane[k] = ((const %s*)%s)->lane[k] %c ((const %s*)%s)->lane[k]; *(%s*)%s = t; }\n",
+            vt, lanes[type], vt, a, ops[op], vt, b, vt, dst);
+    return true;
+}
+
+static void emit_call(CContext* ctx, IrInstr* inst) {
+    FILE* out = ctx->out;
+    if (inst->op == IR_CALL && emit_inline_vector_op(ctx, inst)) return;
+    IrTypeKind ret = call_kind(ctx, inst);
+    const CRuntimeSig* sig = NULL;
+    IrFunction* callee = NULL;
+    char target[512];
+    size_t nargs = inst->arg_count;
+
+    if (inst->op1.kind == VAL_GLOBAL) {
+        const char* name = inst->op1.storage.global.name;
+        sig = find_sig(strcmp(name, "print") == 0 ? "arnm_print_int" : name);
+        callee = sig ? NULL : find_fn(ctx->mod, name);
+        symbol(ctx, target, sizeof(target), name);
+        if (sig && sig->param_count < nargs) nargs = sig->param_count;
+        if (callee && callee->param_count < nargs) nargs = callee->param_count;
+
+        if (!sig && !callee) {
+            bool seen = false;
+            for (size_t i = 0; i < ctx->extern_count; i++) {
+                if (strcmp(ctx->externs[i]->op1.storage.global.name, name) == 0) seen = true;
+            }
+            if (!seen && ctx->extern_count < MAX_EXTERNS) ctx->externs[ctx->extern_count++] = inst;
+        }
+    } else {
+        /* Indirect call through a pointer: type the callee from the call site */
+        char fp[256];
+        operand(ctx, inst->op1, IR_PTR, fp, sizeof(fp));
+        size_t used = (size_t)snprintf(target, sizeof(target), "((%s (*)(", c_type(ret));
+        for (size_t i = 0; i < nargs && used < sizeof(target); i++) {
+            used += (size_t)snprintf(target + used, sizeof(target) - used, "%s%s", i ? ", " : "",
+                                     c_type(c_norm(inst->args[i].type.kind)));
+        }
+        if (used < sizeof(target)) {
+            snprintf(target + used, sizeof(target) - used, "%s))%s)", nargs ? "" : "void", fp);
+        }
+    }
+
+    fprintf(out, "    ");
+    if (ret != IR_VOID && inst->result.kind == VAL_VAR) fprintf(out, "v%u = ", inst->result.storage.id);
+    fprintf(out, "%s(", target);
+    for (size_t i = 0; i < nargs; i++) {
+        IrTypeKind want;
+        if (sig) want = sig->params[i];
+        else if (callee && callee->param_types) want = c_norm(callee->param_types[i].kind);
+        else want = def_kind(ctx, inst->args[i]);
+
+        char arg[256];
+        operand(ctx, inst->args[i], want, arg, sizeof(arg));
+        if (sig && sig->casts[i]) fprintf(out, "%s(%s)(%s)", i ? ", " : "", sig->casts[i], arg);
+        else fprintf(out, "%s%s", i ? ", " : "", arg);
+    }
+    fprintf(out, ");\n");
+}
+
+static void emit_instr(CContext* ctx, IrInstr* inst) {
+    FILE* out = ctx->out;
+    char a[256], b[256];
+
+    switch (inst->op) {
+        case IR_ALLOCA:
+            /* Declared at the top of the function */
+            break;
+
+        case IR_RET:
+            if (ctx->fn->ret_type.kind == IR_VOID) {
+                fprintf(out, "    return;\n");
+            } else {
+                operand(ctx, inst->op1, ctx->fn->ret_type.kind, a, sizeof(a));
+                fprintf(out, "    return %s;\n", a);
+            }
+            break;
+
+        case IR_STORE: {
+            IrTypeKind k = inst->op1.kind == VAL_VAR ? def_kind(ctx, inst->op1) : c_norm(inst->op1.type.kind);
+            int64_t slot = local_slot(ctx, inst->op2);
+            if (slot >= 0) {
+                operand(ctx, inst->op1, ctx->slot_kinds[slot], a, sizeof(a));
+                fprintf(out, "    s%ld = %s;\n", (long)slot, a);
+            } else {
+                operand(ctx, inst->op1, k, a, sizeof(a));
+                operand(ctx, inst->op2, IR_PTR, b, sizeof(b));
+                fprintf(out, "    *(%s*)(%s) = %s;\n", c_type(k), b, a);
+            }
+            break;
+        }
+
+        case IR_LOAD: {
+            IrTypeKind k = ctx->kinds[inst->result.storage.id];
+            int64_t slot = local_slot(ctx, inst->op1);
+            if (slot >= 0) {
+                char src[32];
+                snprintf(src, sizeof(src), "s%ld", (long)slot);
+                convert(a, sizeof(a), src, ctx->slot_kinds[slot], k);
+                fprintf(out, "    v%u = %s;\n", inst->result.storage.id, a);
+            } else {
+                operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+                fprintf(out, "    v%u = *(%s*)(%s);\n", inst->result.storage.id, c_type(k), a);
+            }
+            break;
+        }
+
+        case IR_FIELD_PTR:
+            /* Fields are 8-byte slots, matching the other backends */
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            fprintf(out, "    v%u = (int64_t*)(%s) + %ld;\n", inst->result.storage.id, a,
+                    (long)(int64_t)inst->op2.storage.constant.as.i);
+            break;
+
+        /* Array headers are { void* data; int64_t len; }, lengths fit an int32_t */
+        case IR_ARRAY_DATA:
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            fprintf(out, "    v%u = *(void**)(%s);\n", inst->result.storage.id, a);
+            break;
+
+        case IR_ARRAY_LEN:
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            fprintf(out, "    v%u = (int32_t)((int64_t*)(%s))[1];\n", inst->result.storage.id, a);
+            break;
+
+        case IR_ELEM_PTR:
+            operand(ctx, inst->op1, IR_PTR, a, sizeof(a));
+            operand(ctx, inst->op2, IR_I64, b, sizeof(b));
+            fprintf(out, "    v%u = (int64_t*)(%s) + %s;\n", inst->result.storage.id, a, b);
+            break;
+
+        case IR_BOUNDS_CHECK:
+            /* One unsigned compare covers negative indices too */
+            operand(ctx, inst->op1, IR_I64, a, sizeof(a));
+            operand(ctx, inst->op2, IR_I64, b, sizeof(b));
+            fprintf(out, "    if ((uint64_t)(%s) >= (uint64_t)(%s)) arnm_panic_bounds(%s, %s);\n", a, b, a, b);
+            break;
+
+        case IR_ADD: emit_binary(ctx, inst, "+"); break;
+        case IR_SUB: emit_binary(ctx, inst, "-"); break;
+        case IR_MUL: emit_binary(ctx, inst, "*"); break;
+        case IR_DIV: emit_binary(ctx, inst, "/"); break;
+        case IR_MOD: emit_binary(ctx, inst, "%"); break;
+        case IR_AND: emit_binary(ctx, inst, "&"); break;
+        case IR_OR:  emit_binary(ctx, inst, "|"); break;
+
+        case IR_EQ: case IR_NE: case IR_LT: case IR_LE: case IR_GT: case IR_GE: {
+            const char* op = "==";
+            switch (inst->op) {
+                case IR_NE: op = "!="; break;
+                case IR_LT: op = "<"; break;
+                case IR_LE: op = "<="; break;
+                case IR_GT: op = ">"; break;
+                case IR_GE: op = ">="; break;
+                default: break;
+            }
+            /* Pointers compare as pointers, doubles as doubles, everything else as int64_t */
+            IrTypeKind k1 = def_kind(ctx, inst->op1), k2 = def_kind(ctx, inst->op2);
+            IrTypeKind k = (k1 == IR_PTR && (k2 == IR_PTR || inst->op2.kind == VAL_CONST)) ? IR_PTR : IR_I64;
+            if (k1 == IR_F64 || k2 == IR_F64) k = IR_F64;
+            operand(ctx, inst->op1, k, a, sizeof(a));
+            operand(ctx, inst->op2, k, b, sizeof(b));
+            fprintf(out, "    v%u = %s %s %s;\n", inst->result.storage.id, a, op, b);
+            break;
+        }
+
+        case IR_CALL:
+        case IR_SPAWN:
+            emit_call(ctx, inst);
+            break;
+
+        case IR_BR:
+            operand(ctx, inst->op1, IR_BOOL, a, sizeof(a));
+            fprintf(out, "    if (%s) goto L%d; else goto L%d;\n", a, inst->target1->id, inst->target2->id);
+            break;
+
+        case IR_JMP:
+            fprintf(out, "    goto L%d;\n", inst->target1->id);
+            break;
+
+        case IR_MOV:
+            operand(ctx, inst->op1, ctx->kinds[inst->result.storage.id], a, sizeof(a));
+            fprintf(out, "    v%u = %s;\n", inst->result.storage.id, a);
+            break;
+
+        default:
+            /* Actor ops are lowered to runtime calls by irgen */
+            break;
+    }
+}
+
+/* ============================================================
+ * Functions
+ * ============================================================ */
+
+static void emit_signature(CContext* ctx, IrFunction* fn, bool named) {
+    FILE* out = ctx->out;
+    char name[160];
+    fn_name(name, sizeof(name), fn->name);
+    const char* ret = fn->ret_type.kind == IR_VOID ? "void" : c_type(c_norm(fn->ret_type.kind));
+
+    fprintf(out, "%s%s %s(", strcmp(fn->name, "main") == 0 ? "" : "static ", ret, name);
+    if (fn->param_count == 0) fprintf(out, "void");
+    for (size_t i = 0; i < fn->param_count; i++) {
+        IrTypeKind k = fn->param_types ? c_norm(fn->param_types[i].kind) : IR_I32;
+        /*
+         * Pointer parameters are an outlined parallel body's private frame,
+         * a vector the callee only reads to take its own copy, or an array
+         * header, which is never written
+         */
+        fprintf(out, "%s%s%s", i ? ", " : "", c_type(k), k == IR_PTR ? " restrict" : "");
+        if (named) fprintf(out, " v%zu", i);
+    }
+    fprintf(out, ")");
+}
+
+static void emit_function(CContext* ctx, IrFunction* fn) {
+    FILE* out = ctx->out;
+    scan(ctx, fn);
+
+    emit_signature(ctx, fn, true);
+    fprintf(out, " {\n");
+
+    /* Locals: one per vreg, one per alloca slot */
+    for (uint32_t id = (uint32_t)fn->param_count; id < fn->vreg_counter; id++) {
+        if (ctx->allocas[id] && ctx->slot_kinds[id] == IR_VEC) {
+            fprintf(out, "    _Alignas(32) int64_t s%u[4] = { 0 };\n", id);
+            fprintf(out, "    void* v%u = s%u;\n", id, id);
+        } else if (ctx->allocas[id]) {
+            /* Escaping slots are 8 bytes wide whatever is stored in them */
+            IrTypeKind k = ctx->escapes[id] ? IR_I64 : ctx->slot_kinds[id];
+            fprintf(out, "    %s s%u = 0;\n", c_type(k), id);
+            if (ctx->escapes[id]) fprintf(out, "    void* v%u = &s%u;\n", id, id);
+        } else if (ctx->kinds[id] != IR_VOID) {
+            fprintf(out, "    %s v%u;\n", c_type(ctx->kinds[id]), id);
+        }
+    }
+
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        fprintf(out, "L%d:;\n", blk->id);
+
+        IrInstr* inst = blk->head;
+        bool terminated = false;
+        while (inst && !terminated) {
+            emit_instr(ctx, inst);
+            terminated = is_terminator(inst->op);
+            inst = inst->next;
+        }
+        if (terminated) continue;
+
+        /* The x86 backend falls through to the next block in layout */
+        if (blk->next) {
+            fprintf(out, "    goto L%d;\n", blk->next->id);
+        } else if (fn->ret_type.kind == IR_VOID) {
+            fprintf(out, "    return;\n");
+        } else {
+            fprintf(out, "    return 0;\n");
+        }
+    }
+    fprintf(out, "}\n\n");
+
+    scan_free(ctx);
+}
+
+/* ============================================================
+ * Public API
+ * ============================================================ */
+
+void c_emit(IrModule* mod, FILE* out) {
+    CContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.out = out;
+    ctx.mod = mod;
+
+    fprintf(out, "/* Generated by ARNm Compiler */\n");
+    fprintf(out, "#include \"arnm.h\"\n");
+    fprintf(out, "#include \"sync.h\"\n\n");
+
+    /* Same facts the LLVM backend declares: the process is fixed, panics don't return */
+    fprintf(out, "ArnmProcess* arnm_self(void) __attribute__((const));\n");
+    fprintf(out, "void arnm_panic_nomatch(void) __attribute__((noreturn));\n");
+    fprintf(out, "void arnm_panic_bounds(int64_t, int64_t) __attribute__((noreturn));\n\n");
+
+    /* Prototypes first: functions refer to each other in any order */
+    for (IrFunction* fn = mod->funcs; fn; fn = fn->next) {
+        emit_signature(&ctx, fn, false);
+        fprintf(out, ";\n");
+    }
+    fprintf(out, "\n");
+
+    /*
+     * Externs are only known once their calls are emitted, so the bodies
+     * go to a buffer and the declarations ahead of them.
+     */
+    char* body = NULL;
+    size_t body_len = 0;
+    FILE* mem = open_memstream(&body, &body_len);
+    if (!mem) return;
+    ctx.out = mem;
+    for (IrFunction* fn = mod->funcs; fn; fn = fn->next) {
+        emit_function(&ctx, fn);
+    }
+    fclose(mem);
+
+    for (size_t i = 0; i < ctx.extern_count; i++) {
+        IrInstr* call = ctx.externs[i];
+        fprintf(out, "extern %s %s(", call->type.kind == IR_VOID ? "void" : c_type(c_norm(call->type.kind)),
+                call->op1.storage.global.name);
+        if (call->arg_count == 0) fprintf(out, "void");
+        for (size_t a = 0; a < call->arg_count; a++) {
+            fprintf(out, "%s%s", a ? ", " : "", c_type(def_kind(&ctx, call->args[a])));
+        }
+        fprintf(out, ");\n");
+    }
+    if (ctx.extern_count) fprintf(out, "\n");
+    fwrite(body, 1, body_len, out);
+    free(body);
+}
@@ -0,0 +1,1498 @@
+/*
+ * ARNm Compiler - WebAssembly Code Generator
+ *
+ * Emits a binary wasm32 module straight from the IR, for the browser
+ * playground and headless runs under node. Virtual registers become wasm
+ * locals, as do allocas that never escape; the rest get 8-byte slots on
+ * a shadow stack in linear memory. Structured control flow is rebuilt
+ * from the CFG along the dominator tree (Ramsey, "Beyond Relooper"):
+ * loop headers open a `loop`, blocks with several forward predecessors
+ * are reached by `br` out of an enclosing `block`, and everything else
+ * is emitted inline at its only predecessor. irgen only produces
+ * reducible graphs, which is all this handles.
+ *
+ * Runtime calls are imported from the "arnm" module provided by
+ * wasm/arnm_runtime.js. Functions referenced as values (spawn entries,
+ * restart points, parallel bodies) sit in the exported table behind an
+ * adapter with one uniform (i64, i64, i64) -> i64 signature, so the shim
+ * can call any of them without knowing their types. Pointers are i32 in
+ * registers and 8 bytes in memory, matching the field layout of the
+ * native backends.
+ */
+
+#include "../include/codegen_wasm.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================
+ * Binary Encoding
+ * ============================================================ */
+
+#define WASM_I32 0x7F
+#define WASM_I64 0x7E
+#define WASM_F64 0x7C
+
+#define OP_UNREACHABLE  0x00
+#define OP_BLOCK        0x02
+#define OP_LOOP         0x03
+#define OP_IF           0x04
+#define OP_ELSE         0x05
+#define OP_END          0x0B
+#define OP_BR           0x0C
+#define OP_RETURN       0x0F
+#define OP_CALL         0x10
+#define OP_CALL_IND     0x11
+#define OP_DROP         0x1A
+#define OP_LOCAL_GET    0x20
+#define OP_LOCAL_SET    0x21
+#define OP_LOCAL_TEE    0x22
+#define OP_GLOBAL_GET   0x23
+#define OP_GLOBAL_SET   0x24
+#define OP_I32_LOAD     0x28
+#define OP_I64_LOAD     0x29
+#define OP_F64_LOAD     0x2B
+#define OP_I32_LOAD8_S  0x2C
+#define OP_I32_LOAD8_U  0x2D
+#define OP_I32_STORE    0x36
+#define OP_I64_STORE    0x37
+#define OP_F64_STORE    0x39
+#define OP_I32_STORE8   0x3A
+#define OP_I32_CONST    0x41
+#define OP_I64_CONST    0x42
+#define OP_F64_CONST    0x44
+#define OP_I32_NE       0x47
+#define OP_I64_NE       0x52
+#define OP_I64_GE_U     0x5A
+#define OP_F64_NE       0x62
+#define OP_I32_ADD      0x6A
+#define OP_I32_SUB      0x6B
+#define OP_I32_SHL      0x74
+#define OP_I32_WRAP     0xA7
+#define OP_I64_EXT_S    0xAC
+#define OP_I64_EXT_U    0xAD
+#define OP_F64_CONV_I32 0xB7
+#define OP_F64_CONV_I64 0xB9
+#define OP_I32_EXT8_S   0xC0
+#define OP_PREFIX_FC    0xFC
+#define BLOCK_EMPTY     0x40
+
+/* Shadow stack grows down from the top of the first page; the heap follows */
+#define WASM_STACK_TOP  65536
+#define WASM_MIN_PAGES  2
+
+typedef struct {
+    uint8_t* data;
+    size_t   len;
+    size_t   cap;
+    bool     oom;
+} WasmBuf;
+
+static void buf_bytes(WasmBuf* b, const void* src, size_t n) {
+    if (b->oom) return;
+    if (b->len + n > b->cap) {
+        size_t cap = b->cap ? b->cap * 2 : 256;
+        while (cap < b->len + n) cap *= 2;
+        uint8_t* data = realloc(b->data, cap);
+        if (!data) {
+            b->oom = true;
+            return;
+        }
+        b->data = data;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->len, src, n);
+    b->len += n;
+}
+
+static void buf_byte(WasmBuf* b, uint8_t v) {
+    buf_bytes(b, &v, 1);
+}
+
+static void buf_u32(WasmBuf* b, uint32_t v) {
+    do {
+        uint8_t byte = v & 0x7F;
+        v >>= 7;
+        buf_byte(b, v ? byte | 0x80 : byte);
+    } while (v);
+}
+
+static void buf_s64(WasmBuf* b, int64_t v) {
+    for (;;) {
+        uint8_t byte = v & 0x7F;
+        v >>= 7;    /* Arithmetic shift on every supported compiler */
+        if ((v == 0 && !(byte & 0x40)) || (v == -1 && (byte & 0x40))) {
+            buf_byte(b, byte);
+            return;
+        }
+        buf_byte(b, byte | 0x80);
+    }
+}
+
+static void buf_f64(WasmBuf* b, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    for (int i = 0; i < 8; i++) buf_byte(b, (uint8_t)(bits >> (8 * i)));
+}
+
+static void buf_name(WasmBuf* b, const char* s) {
+    size_t n = strlen(s);
+    buf_u32(b, (uint32_t)n);
+    buf_bytes(b, s, n);
+}
+
+/* Append `body` as section `id` and release it */
+static void buf_section(WasmBuf* out, uint8_t id, WasmBuf* body) {
+    buf_byte(out, id);
+    buf_u32(out, (uint32_t)body->len);
+    buf_bytes(out, body->data, body->len);
+    out->oom |= body->oom;
+    free(body->data);
+    memset(body, 0, sizeof(*body));
+}
+
+/* ============================================================
+ * Runtime Imports
+ * ============================================================ */
+
+#define MAX_WASM_PARAMS 16
+
+typedef struct {
+    const char* name;
+    IrTypeKind  ret;
+    IrTypeKind  params[MAX_WASM_PARAMS];
+    size_t      param_count;
+} WasmRuntimeSig;
+
+static const WasmRuntimeSig wasm_runtime_sigs[] = {
+    { "arnm_spawn",              IR_PTR,  { IR_PTR, IR_PTR, IR_I64 }, 3 },
+    { "arnm_spawn_joinable",     IR_PTR,  { IR_PTR, IR_PTR, IR_I64 }, 3 },
+    { "arnm_join_proc",          IR_I32,  { IR_PTR }, 1 },
+    { "arnm_send",               IR_I32,  { IR_PTR, IR_I64, IR_PTR, IR_I64 }, 4 },
+    { "arnm_receive",            IR_PTR,  { 0 }, 0 },
+    { "arnm_receive_idle",       IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_message_free",       IR_VOID, { IR_PTR }, 1 },
+    { "arnm_self",               IR_PTR,  { 0 }, 0 },
+    { "arnm_panic_nomatch",      IR_VOID, { 0 }, 0 },
+    { "arnm_panic_bounds",       IR_VOID, { IR_I64, IR_I64 }, 2 },
+    { "arnm_array_new",          IR_PTR,  { IR_I64 }, 1 },
+    { "arnm_array_slice",        IR_PTR,  { IR_PTR, IR_I64, IR_I64 }, 3 },
+    { "arnm_array_aliased",      IR_I32,  { IR_PTR, IR_PTR }, 2 },
+    { "arnm_vec_new",            IR_PTR,  { 0 }, 0 },
+    { "arnm_vec_len",            IR_I32,  { IR_PTR }, 1 },
+    { "arnm_vec_push",           IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_vec_pop",            IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_vec_at",             IR_PTR,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_map_new",            IR_PTR,  { 0 }, 0 },
+    { "arnm_map_len",            IR_I32,  { IR_PTR }, 1 },
+    { "arnm_map_slot",           IR_PTR,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_map_at",             IR_PTR,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_map_has",            IR_I32,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_map_remove",         IR_I32,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_deque_new",          IR_PTR,  { 0 }, 0 },
+    { "arnm_deque_len",          IR_I32,  { IR_PTR }, 1 },
+    { "arnm_deque_push_back",    IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_deque_push_front",   IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_deque_pop_back",     IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_deque_pop_front",    IR_PTR,  { IR_PTR }, 1 },
+    { "arnm_deque_at",           IR_PTR,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_print_int",          IR_VOID, { IR_I32 }, 1 },
+    { "arnm_print_f64",          IR_VOID, { IR_F64 }, 1 },
+    { "arnm_channel_create",     IR_PTR,  { IR_I64 }, 1 },
+    { "arnm_channel_send",       IR_BOOL, { IR_PTR, IR_PTR }, 2 },
+    { "arnm_channel_close",      IR_VOID, { IR_PTR }, 1 },
+    { "arnm_select_recv4",       IR_I64,  { IR_PTR, IR_PTR, IR_PTR, IR_PTR, IR_I64 }, 5 },
+    { "arnm_select_value",       IR_I64,  { 0 }, 0 },
+    { "arnm_parallel_for",       IR_VOID, { IR_I64, IR_I64, IR_PTR, IR_PTR }, 4 },
+    { "arnm_parallel_reduce_op", IR_I64,  { IR_I64, IR_I64, IR_PTR, IR_PTR, IR_I64 }, 5 },
+    { "arnm_alloc",              IR_PTR,  { IR_I64, IR_PTR }, 2 },
+    { "arnm_release",            IR_VOID, { IR_PTR }, 1 },
+    { "arnm_f32x8_splat",        IR_VOID, { IR_PTR, IR_F64 }, 2 },
+    { "arnm_f32x8_get",          IR_F64,  { IR_PTR, IR_I32 }, 2 },
+    { "arnm_f32x8_set",          IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_F64 }, 4 },
+    { "arnm_f32x8_op",           IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, 4 },
+    { "arnm_f32x8_reduce",       IR_F64,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_f32x8_shuffle",      IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, 3 },
+    { "arnm_i32x8_splat",        IR_VOID, { IR_PTR, IR_I32 }, 2 },
+    { "arnm_i32x8_get",          IR_I32,  { IR_PTR, IR_I32 }, 2 },
+    { "arnm_i32x8_set",          IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_I32 }, 4 },
+    { "arnm_i32x8_op",           IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, 4 },
+    { "arnm_i32x8_reduce",       IR_I32,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_i32x8_shuffle",      IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, 3 },
+    { "arnm_f64x4_splat",        IR_VOID, { IR_PTR, IR_F64 }, 2 },
+    { "arnm_f64x4_get",          IR_F64,  { IR_PTR, IR_I32 }, 2 },
+    { "arnm_f64x4_set",          IR_VOID, { IR_PTR, IR_PTR, IR_I32, IR_F64 }, 4 },
+    { "arnm_f64x4_op",           IR_VOID, { IR_PTR, IR_PTR, IR_PTR, IR_I64 }, 4 },
+    { "arnm_f64x4_reduce",       IR_F64,  { IR_PTR, IR_I64 }, 2 },
+    { "arnm_f64x4_shuffle",      IR_VOID, { IR_PTR, IR_PTR, IR_PTR }, 3 },
+};
+
+#define WASM_RUNTIME_SIG_COUNT (sizeof(wasm_runtime_sigs) / sizeof(wasm_runtime_sigs[0]))
+
+/* Arguments the shim passes to a table entry */
+#define ADAPTER_PARAMS 3
+
+#define MAX_TYPES   256
+#define MAX_IMPORTS 64
+
+typedef struct {
+    uint8_t params[MAX_WASM_PARAMS];
+    size_t  param_count;
+    uint8_t result;                 /* 0 = none */
+} WasmType;
+
+typedef struct {
+    const char* module;
+    const char* name;
+    uint32_t    type;
+    IrTypeKind  ret;
+    IrTypeKind  params[MAX_WASM_PARAMS];
+    size_t      param_count;
+} WasmImport;
+
+typedef struct {
+    IrModule*    mod;
+    WasmType     types[MAX_TYPES];
+    size_t       type_count;
+    WasmImport   imports[MAX_IMPORTS];
+    size_t       import_count;
+    IrFunction** funcs;             /* Module functions in index order */
+    size_t       func_count;
+    IrFunction** refs;              /* Taken as values: table slot i + 1 */
+    size_t       ref_count;
+    uint32_t     adapter_type;
+    bool         failed;
+} WasmModuleCtx;
+
+/* Label a `br` can target, innermost last */
+typedef enum {
+    LABEL_LOOP,                     /* Branch goes back to `block`'s header */
+    LABEL_BLOCK,                    /* Branch continues at merge node `block` */
+    LABEL_IF
+} WasmLabelKind;
+
+typedef struct {
+    WasmLabelKind kind;
+    int           block;
+} WasmLabel;
+
+typedef struct {
+    WasmModuleCtx* m;
+    IrFunction*    fn;
+    WasmBuf*       code;
+
+    IrTypeKind*    kinds;           /* Type each vreg is defined with (IR_VOID = none) */
+    bool*          allocas;
+    bool*          escapes;         /* Alloca whose address is used beyond load/store */
+    IrTypeKind*    slot_kinds;
+    uint32_t*      locals;          /* Wasm local for each vreg, UINT32_MAX if none */
+    uint32_t       vreg_count;
+    uint32_t       frame_local;
+    uint32_t       frame_size;
+
+    /* CFG, indexed by block id */
+    IrBlock**      blocks;
+    int            block_count;
+    int*           rpo;             /* Reverse postorder number, -1 if unreachable */
+    int*           order;           /* Reachable block ids in reverse postorder */
+    int            reachable;
+    int*           idom;
+    int*           forward_preds;
+    bool*          loop_header;
+    WasmLabel*     labels;
+    size_t         label_count;
+} WasmFnCtx;
+
+/* ============================================================
+ * Types and Names
+ * ============================================================ */
+
+static IrTypeKind w_norm(IrTypeKind kind) {
+    switch (kind) {
+        case IR_PROCESS:
+        case IR_VEC:     return IR_PTR;
+        case IR_VOID:
+        case IR_BAD:     return IR_I64;
+        default:         return kind;
+    }
+}
+
+/* Bytes an escaping alloca takes in the frame: 32 for a vector, 8 otherwise */
+static uint32_t slot_size(IrTypeKind slot_kind) {
+    return slot_kind == IR_VEC ? 32 : 8;
+}
+
+static uint8_t valtype(IrTypeKind kind) {
+    switch (w_norm(kind)) {
+        case IR_I64: return WASM_I64;
+        case IR_F64: return WASM_F64;
+        default:     return WASM_I32;
+    }
+}
+
+static bool is_narrow(IrTypeKind kind) {
+    return valtype(kind) == WASM_I32;
+}
+
+static const WasmRuntimeSig* find_sig(const char* name) {
+    if (strcmp(name, "print") == 0) name = "arnm_print_int";
+    for (size_t i = 0; i < WASM_RUNTIME_SIG_COUNT; i++) {
+        if (strcmp(wasm_runtime_sigs[i].name, name) == 0) return &wasm_runtime_sigs[i];
+    }
+    return NULL;
+}
+
+/* Function index of a module function, or -1 */
+static int64_t find_fn(WasmModuleCtx* m, const char* name) {
+    for (size_t i = 0; i < m->func_count; i++) {
+        if (strcmp(m->funcs[i]->name, name) == 0) return (int64_t)(m->import_count + i);
+    }
+    return -1;
+}
+
+static WasmImport* find_import(WasmModuleCtx* m, const char* name) {
+    const WasmRuntimeSig* sig = find_sig(name);
+    if (sig) name = sig->name;
+    for (size_t i = 0; i < m->import_count; i++) {
+        if (strcmp(m->imports[i].name, name) == 0) return &m->imports[i];
+    }
+    return NULL;
+}
+
+/* Table slot of a function taken as a value; 0 (null) if it has none */
+static uint32_t ref_slot(WasmModuleCtx* m, const char* name) {
+    for (size_t i = 0; i < m->ref_count; i++) {
+        if (strcmp(m->refs[i]->name, name) == 0) return (uint32_t)(i + 1);
+    }
+    return 0;
+}
+
+static uint32_t intern_type(WasmModuleCtx* m, const uint8_t* params, size_t n, uint8_t result) {
+    for (size_t i = 0; i < m->type_count; i++) {
+        WasmType* t = &m->types[i];
+        if (t->param_count == n && t->result == result && memcmp(t->params, params, n) == 0) {
+            return (uint32_t)i;
+        }
+    }
+    if (m->type_count == MAX_TYPES) {
+        m->failed = true;
+        return 0;
+    }
+    WasmType* t = &m->types[m->type_count];
+    memcpy(t->params, params, n);
+    t->param_count = n;
+    t->result = result;
+    return (uint32_t)m->type_count++;
+}
+
+static uint32_t sig_type(WasmModuleCtx* m, const IrTypeKind* params, size_t n, IrTypeKind ret) {
+    uint8_t vt[MAX_WASM_PARAMS];
+    if (n > MAX_WASM_PARAMS) n = MAX_WASM_PARAMS;
+    for (size_t i = 0; i < n; i++) vt[i] = valtype(params[i]);
+    return intern_type(m, vt, n, ret == IR_VOID ? 0 : valtype(ret));
+}
+
+static IrTypeKind fn_param_kind(IrFunction* fn, size_t i) {
+    return fn->param_types ? w_norm(fn->param_types[i].kind) : IR_I32;
+}
+
+static uint32_t fn_type(WasmModuleCtx* m, IrFunction* fn) {
+    IrTypeKind params[MAX_WASM_PARAMS];
+    size_t n = fn->param_count < MAX_WASM_PARAMS ? fn->param_count : MAX_WASM_PARAMS;
+    for (size_t i = 0; i < n; i++) params[i] = fn_param_kind(fn, i);
+    IrTypeKind ret = fn->ret_type.kind == IR_VOID ? IR_VOID : w_norm(fn->ret_type.kind);
+    return sig_type(m, params, n, ret);
+}
+
+/* ============================================================
+ * Operands
+ * ============================================================ */
+
+static void emit_local(WasmBuf* code, uint8_t op, uint32_t index) {
+    buf_byte(code, op);
+    buf_u32(code, index);
+}
+
+static void emit_i32(WasmBuf* code, int32_t v) {
+    buf_byte(code, OP_I32_CONST);
+    buf_s64(code, v);
+}
+
+static void emit_zero(WasmBuf* code, IrTypeKind kind) {
+    switch (valtype(kind)) {
+        case WASM_I64: buf_byte(code, OP_I64_CONST); buf_s64(code, 0); break;
+        case WASM_F64: buf_byte(code, OP_F64_CONST); buf_f64(code, 0.0); break;
+        default:       emit_i32(code, 0); break;
+    }
+}
+
+/* Convert the value on top of the stack from kind `from` to kind `to` */
+static void emit_convert(WasmBuf* code, IrTypeKind from, IrTypeKind to) {
+    from = w_norm(from);
+    to = w_norm(to);
+    if (from == to) return;
+
+    if (to == IR_BOOL) {
+        emit_zero(code, from);
+        buf_byte(code, valtype(from) == WASM_I64 ? OP_I64_NE : valtype(from) == WASM_F64 ? OP_F64_NE : OP_I32_NE);
+        return;
+    }
+
+    switch (valtype(from)) {
+        case WASM_I32:
+            if (to == IR_I64) {
+                buf_byte(code, (from == IR_BOOL || from == IR_PTR) ? OP_I64_EXT_U : OP_I64_EXT_S);
+            } else if (to == IR_F64) {
+                buf_byte(code, OP_F64_CONV_I32);
+            } else if (to == IR_I8 && from != IR_BOOL) {
+                buf_byte(code, OP_I32_EXT8_S);
+            }
+            break;
+        case WASM_I64:
+            if (to == IR_F64) {
+                buf_byte(code, OP_F64_CONV_I64);
+            } else {
+                buf_byte(code, OP_I32_WRAP);
+                if (to == IR_I8) buf_byte(code, OP_I32_EXT8_S);
+            }
+            break;
+        case WASM_F64:
+            /* Saturating truncation: out-of-range values clamp instead of trapping */
+            buf_byte(code, OP_PREFIX_FC);
+            buf_u32(code, to == IR_I64 ? 6 : 2);
+            if (to == IR_I8) buf_byte(code, OP_I32_EXT8_S);
+            break;
+    }
+}
+
+static IrTypeKind def_kind(WasmFnCtx* ctx, IrValue val) {
+    if (val.kind == VAL_VAR && val.storage.id < ctx->vreg_count && ctx->kinds[val.storage.id] != IR_VOID) {
+        return ctx->kinds[val.storage.id];
+    }
+    if (val.kind == VAL_GLOBAL) return IR_PTR;
+    return w_norm(val.type.kind);
+}
+
+/* Push `val` converted to kind `want` */
+static void operand(WasmFnCtx* ctx, IrValue val, IrTypeKind want) {
+    WasmBuf* code = ctx->code;
+    want = w_norm(want);
+    switch (val.kind) {
+        case VAL_CONST: {
+            int64_t v = (int64_t)val.storage.constant.as.i;
+            if (val.type.kind == IR_BOOL) v = val.storage.constant.as.b ? 1 : 0;
+            if (val.type.kind == IR_I32) v = (int32_t)v;
+            if (val.type.kind == IR_F64) {
+                if (want == IR_F64) {
+                    buf_byte(code, OP_F64_CONST);
+                    buf_f64(code, val.storage.constant.as.f);
+                    return;
+                }
+                v = (int64_t)val.storage.constant.as.f;
+            }
+            switch (want) {
+                case IR_F64:  buf_byte(code, OP_F64_CONST); buf_f64(code, (double)v); break;
+                case IR_I64:  buf_byte(code, OP_I64_CONST); buf_s64(code, v); break;
+                case IR_BOOL: emit_i32(code, v != 0); break;
+                case IR_I8:   emit_i32(code, (int8_t)v); break;
+                default:      emit_i32(code, (int32_t)v); break;
+            }
+            return;
+        }
+        case VAL_UNDEF:
+            emit_zero(code, want);
+            return;
+        case VAL_GLOBAL:
+            emit_i32(code, (int32_t)ref_slot(ctx->m, val.storage.global.name));
+            emit_convert(code, IR_PTR, want);
+            return;
+        case VAL_VAR: {
+            uint32_t id = val.storage.id;
+            if (id >= ctx->vreg_count || ctx->locals[id] == UINT32_MAX) {
+                emit_zero(code, want);
+                return;
+            }
+            emit_local(code, OP_LOCAL_GET, ctx->locals[id]);
+            emit_convert(code, def_kind(ctx, val), want);
+            return;
+        }
+    }
+}
+
+/* Pop the value on top of the stack into the result of `inst` */
+static void emit_result(WasmFnCtx* ctx, IrInstr* inst) {
+    if (inst->result.kind == VAL_VAR && inst->result.storage.id < ctx->vreg_count &&
+        ctx->locals[inst->result.storage.id] != UINT32_MAX) {
+        emit_local(ctx->code, OP_LOCAL_SET, ctx->locals[inst->result.storage.id]);
+    } else {
+        buf_byte(ctx->code, OP_DROP);
+    }
+}
+
+/* ============================================================
+ * Function Pre-pass
+ * ============================================================ */
+
+static bool is_terminator(IrOpcode op) {
+    return op == IR_RET || op == IR_BR || op == IR_JMP;
+}
+
+static IrTypeKind call_kind(WasmModuleCtx* m, IrInstr* inst) {
+    if (inst->op1.kind == VAL_GLOBAL) {
+        const char* name = inst->op1.storage.global.name;
+        const WasmRuntimeSig* sig = find_sig(name);
+        if (sig) return sig->ret;
+        int64_t idx = find_fn(m, name);
+        if (idx >= 0) {
+            IrFunction* callee = m->funcs[idx - (int64_t)m->import_count];
+            return callee->ret_type.kind == IR_VOID ? IR_VOID : w_norm(callee->ret_type.kind);
+        }
+    }
+    return inst->type.kind == IR_VOID ? IR_VOID : w_norm(inst->type.kind);
+}
+
+static IrTypeKind def_result(WasmFnCtx* ctx, IrInstr* inst) {
+    switch (inst->op) {
+        case IR_ALLOCA:
+        case IR_FIELD_PTR:
+            return IR_PTR;
+        case IR_EQ: case IR_NE: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+            return IR_BOOL;
+        case IR_CALL:
+        case IR_SPAWN:
+            return call_kind(ctx->m, inst);
+        case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV: case IR_MOD: {
+            IrTypeKind k = w_norm(inst->type.kind);
+            return (k == IR_PTR || k == IR_BOOL) ? IR_I64 : k;
+        }
+        case IR_MOV:
+            return def_kind(ctx, inst->op1);
+        default:
+            return w_norm(inst->type.kind);
+    }
+}
+
+static void mark_escape(WasmFnCtx* ctx, IrValue val) {
+    if (val.kind == VAL_VAR && val.storage.id < ctx->vreg_count && ctx->allocas[val.storage.id]) {
+        ctx->escapes[val.storage.id] = true;
+    }
+}
+
+static void scan(WasmFnCtx* ctx, IrFunction* fn) {
+    uint32_t n = fn->vreg_counter + 1;
+    ctx->fn = fn;
+    ctx->vreg_count = fn->vreg_counter;
+    ctx->kinds = calloc(n, sizeof(IrTypeKind));
+    ctx->allocas = calloc(n, sizeof(bool));
+    ctx->escapes = calloc(n, sizeof(bool));
+    ctx->slot_kinds = calloc(n, sizeof(IrTypeKind));
+    ctx->locals = malloc(n * sizeof(uint32_t));
+
+    for (size_t i = 0; i < fn->param_count && i < fn->vreg_counter; i++) {
+        ctx->kinds[i] = fn_param_kind(fn, i);
+    }
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if (inst->result.kind != VAL_VAR || inst->result.storage.id >= fn->vreg_counter) continue;
+            uint32_t id = inst->result.storage.id;
+            IrTypeKind k = def_result(ctx, inst);
+            if (k != IR_VOID) ctx->kinds[id] = k;
+            if (inst->op == IR_ALLOCA) {
+                ctx->allocas[id] = true;
+                ctx->slot_kinds[id] = inst->op1.type.kind == IR_VEC ? IR_VEC : w_norm(inst->op1.type.kind);
+            }
+        }
+    }
+
+    /* Anything but the address operand of a load or store lets the slot escape */
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if (inst->op != IR_LOAD) mark_escape(ctx, inst->op1);
+            if (inst->op != IR_STORE) mark_escape(ctx, inst->op2);
+            for (size_t i = 0; i < inst->arg_count; i++) mark_escape(ctx, inst->args[i]);
+        }
+    }
+}
+
+/* A non-escaping alloca addressed by `ptr`, or -1 */
+static int64_t local_slot(WasmFnCtx* ctx, IrValue ptr) {
+    if (ptr.kind == VAL_VAR && ptr.storage.id < ctx->vreg_count &&
+        ctx->allocas[ptr.storage.id] && !ctx->escapes[ptr.storage.id]) {
+        return ptr.storage.id;
+    }
+    return -1;
+}
+
+/* ============================================================
+ * Control Flow Graph
+ * ============================================================ */
+
+static IrInstr* block_terminator(IrBlock* blk) {
+    for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+        if (is_terminator(inst->op)) return inst;
+    }
+    return NULL;
+}
+
+/* Successor ids; a block without a terminator falls through in layout */
+static int successors(IrBlock* blk, int out[2]) {
+    IrInstr* term = block_terminator(blk);
+    int n = 0;
+    if (!term) {
+        if (blk->next) out[n++] = blk->next->id;
+    } else if (term->op == IR_JMP) {
+        if (term->target1) out[n++] = term->target1->id;
+    } else if (term->op == IR_BR) {
+        if (term->target1) out[n++] = term->target1->id;
+        if (term->target2) out[n++] = term->target2->id;
+    }
+    return n;
+}
+
+static int intersect(WasmFnCtx* ctx, int a, int b) {
+    while (a != b) {
+        while (ctx->rpo[a] > ctx->rpo[b]) a = ctx->idom[a];
+        while (ctx->rpo[b] > ctx->rpo[a]) b = ctx->idom[b];
+    }
+    return a;
+}
+
+static bool dominates(WasmFnCtx* ctx, int a, int b) {
+    int entry = ctx->order[0];
+    for (;;) {
+        if (b == a) return true;
+        if (b == entry) return false;
+        b = ctx->idom[b];
+    }
+}
+
+/*
+ * Number reachable blocks in reverse postorder, compute dominators
+ * (Cooper, Harvey and Kennedy) and classify edges. Returns false if a
+ * back edge targets a block that doesn't dominate its source.
+ */
+static bool analyze_cfg(WasmFnCtx* ctx) {
+    IrFunction* fn = ctx->fn;
+    int n = (int)fn->block_counter;
+    ctx->block_count = n;
+    ctx->blocks = calloc((size_t)n + 1, sizeof(IrBlock*));
+    ctx->rpo = malloc(((size_t)n + 1) * sizeof(int));
+    ctx->order = malloc(((size_t)n + 1) * sizeof(int));
+    ctx->idom = malloc(((size_t)n + 1) * sizeof(int));
+    ctx->forward_preds = calloc((size_t)n + 1, sizeof(int));
+    ctx->loop_header = calloc((size_t)n + 1, sizeof(bool));
+    ctx->labels = malloc(((size_t)n * 3 + 4) * sizeof(WasmLabel));
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        if (blk->id >= 0 && blk->id < n) ctx->blocks[blk->id] = blk;
+    }
+    for (int i = 0; i < n; i++) ctx->rpo[i] = -1;
+
+    /* Iterative depth-first search for the postorder */
+    int* stack = malloc(((size_t)n + 1) * sizeof(int));
+    int* next_succ = calloc((size_t)n + 1, sizeof(int));
+    bool* seen = calloc((size_t)n + 1, sizeof(bool));
+    int depth = 0, post_count = 0;
+    stack[depth++] = fn->entry->id;
+    seen[fn->entry->id] = true;
+    while (depth > 0) {
+        int b = stack[depth - 1];
+        int succ[2];
+        int count = successors(ctx->blocks[b], succ);
+        if (next_succ[b] < count) {
+            int s = succ[next_succ[b]++];
+            if (!seen[s]) {
+                seen[s] = true;
+                stack[depth++] = s;
+            }
+        } else {
+            ctx->order[post_count++] = b;   /* Postorder for now */
+            depth--;
+        }
+    }
+    for (int i = 0; i < post_count / 2; i++) {
+        int t = ctx->order[i];
+        ctx->order[i] = ctx->order[post_count - 1 - i];
+        ctx->order[post_count - 1 - i] = t;
+    }
+    ctx->reachable = post_count;
+    for (int i = 0; i < post_count; i++) ctx->rpo[ctx->order[i]] = i;
+    free(stack);
+    free(next_succ);
+    free(seen);
+
+    /* Dominators: iterate to a fixed point over reverse postorder */
+    for (int i = 0; i < n; i++) ctx->idom[i] = -1;
+    int entry = ctx->order[0];
+    ctx->idom[entry] = entry;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < post_count; i++) {
+            int p = ctx->order[i];
+            int succ[2];
+            int count = successors(ctx->blocks[p], succ);
+            for (int k = 0; k < count; k++) {
+                int s = succ[k];
+                if (s == entry || ctx->idom[p] < 0) continue;
+                int updated = ctx->idom[s] < 0 ? p : intersect(ctx, p, ctx->idom[s]);
+                if (updated != ctx->idom[s]) {
+                    ctx->idom[s] = updated;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    /* Edges to an earlier block are back edges; everything else counts toward merges */
+    for (int i = 0; i < post_count; i++) {
+        int p = ctx->order[i];
+        int succ[2];
+        int count = successors(ctx->blocks[p], succ);
+        for (int k = 0; k < count; k++) {
+            int s = succ[k];
+            if (ctx->rpo[s] > ctx->rpo[p]) {
+                ctx->forward_preds[s]++;
+            } else {
+                if (!dominates(ctx, s, p)) return false;
+                ctx->loop_header[s] = true;
+            }
+        }
+    }
+    return true;
+}
+
+/* ============================================================
+ * Instructions
+ * ============================================================ */
+
+static void emit_memarg(WasmBuf* code, uint32_t align_log2) {
+    buf_u32(code, align_log2);
+    buf_u32(code, 0);
+}
+
+/* Load a `kind` value from the address on the stack */
+static void emit_load(WasmBuf* code, IrTypeKind kind) {
+    switch (w_norm(kind)) {
+        case IR_BOOL: buf_byte(code, OP_I32_LOAD8_U); emit_memarg(code, 0); break;
+        case IR_I8:   buf_byte(code, OP_I32_LOAD8_S); emit_memarg(code, 0); break;
+        case IR_I32:  buf_byte(code, OP_I32_LOAD); emit_memarg(code, 2); break;
+        case IR_F64:  buf_byte(code, OP_F64_LOAD); emit_memarg(code, 3); break;
+        case IR_PTR:
+            /* Pointers occupy a full 8-byte slot in memory */
+            buf_byte(code, OP_I64_LOAD);
+            emit_memarg(code, 3);
+            buf_byte(code, OP_I32_WRAP);
+            break;
+        default:      buf_byte(code, OP_I64_LOAD); emit_memarg(code, 3); break;
+    }
+}
+
+/* Kind a `kind` value is stored as in memory */
+static IrTypeKind store_kind(IrTypeKind kind) {
+    kind = w_norm(kind);
+    return kind == IR_PTR ? IR_I64 : kind;
+}
+
+static void emit_store(WasmBuf* code, IrTypeKind kind) {
+    switch (store_kind(kind)) {
+        case IR_BOOL:
+        case IR_I8:  buf_byte(code, OP_I32_STORE8); emit_memarg(code, 0); break;
+        case IR_I32: buf_byte(code, OP_I32_STORE); emit_memarg(code, 2); break;
+        case IR_F64: buf_byte(code, OP_F64_STORE); emit_memarg(code, 3); break;
+        default:     buf_byte(code, OP_I64_STORE); emit_memarg(code, 3); break;
+    }
+}
+
+static void emit_epilogue(WasmFnCtx* ctx) {
+    if (!ctx->frame_size) return;
+    emit_local(ctx->code, OP_LOCAL_GET, ctx->frame_local);
+    emit_i32(ctx->code, (int32_t)ctx->frame_size);
+    buf_byte(ctx->code, OP_I32_ADD);
+    emit_local(ctx->code, OP_GLOBAL_SET, 0);
+}
+
+static void emit_return(WasmFnCtx* ctx, IrValue val) {
+    if (ctx->fn->ret_type.kind != IR_VOID) operand(ctx, val, ctx->fn->ret_type.kind);
+    emit_epilogue(ctx);
+    buf_byte(ctx->code, OP_RETURN);
+}
+
+/*
+ * Arithmetic in the result's kind. Narrow kinds compute in i32 and i8
+ * results are re-extended; f64 has no remainder, so MOD goes via i64.
+ */
+static void emit_arith(WasmFnCtx* ctx, IrInstr* inst, uint8_t op32, uint8_t op64, uint8_t opf64) {
+    IrTypeKind k = ctx->kinds[inst->result.storage.id];
+    IrTypeKind ck = k;
+    if (k == IR_F64 && !opf64) ck = IR_I64;
+
+    operand(ctx, inst->op1, ck);
+    operand(ctx, inst->op2, ck);
+    buf_byte(ctx->code, ck == IR_F64 ? opf64 : ck == IR_I64 ? op64 : op32);
+    if (ck == IR_I8) buf_byte(ctx->code, OP_I32_EXT8_S);
+    emit_convert(ctx->code, ck, k);
+    emit_result(ctx, inst);
+}
+
+static void emit_compare(WasmFnCtx* ctx, IrInstr* inst) {
+    /* Indexed by op - IR_EQ: EQ, NE, LT, LE, GT, GE */
+    static const uint8_t ops_i32[]  = { 0x46, 0x47, 0x48, 0x4C, 0x4A, 0x4E };
+    static const uint8_t ops_ptr[]  = { 0x46, 0x47, 0x49, 0x4D, 0x4B, 0x4F };
+    static const uint8_t ops_i64[]  = { 0x51, 0x52, 0x53, 0x57, 0x55, 0x59 };
+    static const uint8_t ops_f64[]  = { 0x61, 0x62, 0x63, 0x65, 0x64, 0x66 };
+    int idx = (int)inst->op - (int)IR_EQ;
+
+    /* Same choices as the C backend, but 32-bit operands stay 32-bit */
+    IrTypeKind k1 = def_kind(ctx, inst->op1), k2 = def_kind(ctx, inst->op2);
+    IrTypeKind k;
+    const uint8_t* ops;
+    if (k1 == IR_F64 || k2 == IR_F64) {
+        k = IR_F64;
+        ops = ops_f64;
+    } else if (k1 == IR_PTR && (k2 == IR_PTR || inst->op2.kind == VAL_CONST)) {
+        k = IR_PTR;
+        ops = ops_ptr;
+    } else if (is_narrow(k1) && is_narrow(k2) && k1 != IR_PTR && k2 != IR_PTR) {
+        k = IR_I32;
+        ops = ops_i32;
+    } else {
+        k = IR_I64;
+        ops = ops_i64;
+    }
+    operand(ctx, inst->op1, k);
+    operand(ctx, inst->op2, k);
+    buf_byte(ctx->code, ops[idx]);
+    emit_convert(ctx->code, IR_BOOL, ctx->kinds[inst->result.storage.id]);
+    emit_result(ctx, inst);
+}
+
+static void emit_call(WasmFnCtx* ctx, IrInstr* inst) {
+    WasmModuleCtx* m = ctx->m;
+    WasmBuf* code = ctx->code;
+    IrTypeKind ret = call_kind(m, inst);
+    IrTypeKind callee_params[MAX_WASM_PARAMS];
+
+    if (inst->op1.kind == VAL_GLOBAL) {
+        const char* name = inst->op1.storage.global.name;
+        const IrTypeKind* params;
+        size_t param_count;
+        uint32_t index;
+        int64_t fn_index = find_fn(m, name);
+        WasmImport* imp = find_sig(name) || fn_index < 0 ? find_import(m, name) : NULL;
+
+        if (imp) {
+            params = imp->params;
+            param_count = imp->param_count;
+            index = (uint32_t)(imp - m->imports);
+        } else if (fn_index >= 0) {
+            IrFunction* callee = m->funcs[fn_index - (int64_t)m->import_count];
+            param_count = callee->param_count < MAX_WASM_PARAMS ? callee->param_count : MAX_WASM_PARAMS;
+            for (size_t i = 0; i < param_count; i++) callee_params[i] = fn_param_kind(callee, i);
+            params = callee_params;
+            index = (uint32_t)fn_index;
+        } else {
+            return;
+        }
+
+        /* Missing arguments are zero, extra ones dropped, as in the native ABI */
+        for (size_t i = 0; i < param_count; i++) {
+            if (i < inst->arg_count) operand(ctx, inst->args[i], params[i]);
+            else emit_zero(code, params[i]);
+        }
+        buf_byte(code, OP_CALL);
+        buf_u32(code, index);
+    } else {
+        /* Indirect calls go through the table adapters */
+        for (size_t i = 0; i < ADAPTER_PARAMS; i++) {
+            if (i < inst->arg_count) operand(ctx, inst->args[i], IR_I64);
+            else emit_zero(code, IR_I64);
+        }
+        operand(ctx, inst->op1, IR_PTR);
+        buf_byte(code, OP_CALL_IND);
+        buf_u32(code, m->adapter_type);
+        buf_byte(code, 0);
+        if (ret == IR_VOID) buf_byte(code, OP_DROP);
+        else emit_convert(code, IR_I64, ret);
+    }
+
+    if (ret != IR_VOID) emit_result(ctx, inst);
+}
+
+static void emit_instr(WasmFnCtx* ctx, IrInstr* inst) {
+    WasmBuf* code = ctx->code;
+
+    switch (inst->op) {
+        case IR_ALLOCA:
+            /* Set up in the prologue */
+            break;
+
+        case IR_STORE: {
+            int64_t slot = local_slot(ctx, inst->op2);
+            if (slot >= 0) {
+                operand(ctx, inst->op1, ctx->slot_kinds[slot]);
+                emit_local(code, OP_LOCAL_SET, ctx->locals[slot]);
+            } else {
+                IrTypeKind k = inst->op1.kind == VAL_VAR ? def_kind(ctx, inst->op1) : w_norm(inst->op1.type.kind);
+                operand(ctx, inst->op2, IR_PTR);
+                operand(ctx, inst->op1, store_kind(k));
+                emit_store(code, k);
+            }
+            break;
+        }
+
+        case IR_LOAD: {
+            IrTypeKind k = ctx->kinds[inst->result.storage.id];
+            int64_t slot = local_slot(ctx, inst->op1);
+            if (slot >= 0) {
+                emit_local(code, OP_LOCAL_GET, ctx->locals[slot]);
+                emit_convert(code, ctx->slot_kinds[slot], k);
+            } else {
+                operand(ctx, inst->op1, IR_PTR);
+                emit_load(code, k);
+            }
+            emit_result(ctx, inst);
+            break;
+        }
+
+        case IR_FIELD_PTR: {
+            /* Fields are 8-byte slots, matching the other backends */
+            int64_t index = (int64_t)inst->op2.storage.constant.as.i;
+            operand(ctx, inst->op1, IR_PTR);
+            if (index) {
+                emit_i32(code, (int32_t)(index * 8));
+                buf_byte(code, OP_I32_ADD);
+            }
+            emit_result(ctx, inst);
+            break;
+        }
+
+        /* Array headers are { data, len } in two 8-byte words */
+        case IR_ARRAY_DATA:
+            operand(ctx, inst->op1, IR_PTR);
+            emit_load(code, IR_PTR);
+            emit_result(ctx, inst);
+            break;
+
+        case IR_ARRAY_LEN:
+            /* The low half of the length word; lengths fit an i32 */
+            operand(ctx, inst->op1, IR_PTR);
+            buf_byte(code, OP_I32_LOAD);
+            buf_u32(code, 2);
+            buf_u32(code, 8);
+            emit_result(ctx, inst);
+            break;
+
+        case IR_ELEM_PTR:
+            operand(ctx, inst->op1, IR_PTR);
+            operand(ctx, inst->op2, IR_I32);
+            emit_i32(code, 3);
+            buf_byte(code, OP_I32_SHL);
+            buf_byte(code, OP_I32_ADD);
+            emit_result(ctx, inst);
+            break;
+
+        case IR_BOUNDS_CHECK: {
+            /* One unsigned compare covers negative indices too */
+            WasmImport* panic = find_import(ctx->m, "arnm_panic_bounds");
+            operand(ctx, inst->op1, IR_I64);
+            operand(ctx, inst->op2, IR_I64);
+            buf_byte(code, OP_I64_GE_U);
+            buf_byte(code, OP_IF);
+            buf_byte(code, BLOCK_EMPTY);
+            if (panic) {
+                operand(ctx, inst->op1, IR_I64);
+                operand(ctx, inst->op2, IR_I64);
+                buf_byte(code, OP_CALL);
+                buf_u32(code, (uint32_t)(panic - ctx->m->imports));
+            }
+            buf_byte(code, OP_UNREACHABLE);
+            buf_byte(code, OP_END);
+            break;
+        }
+
+        case IR_ADD: emit_arith(ctx, inst, 0x6A, 0x7C, 0xA0); break;
+        case IR_SUB: emit_arith(ctx, inst, 0x6B, 0x7D, 0xA1); break;
+        case IR_MUL: emit_arith(ctx, inst, 0x6C, 0x7E, 0xA2); break;
+        case IR_DIV: emit_arith(ctx, inst, 0x6D, 0x7F, 0xA3); break;
+        case IR_MOD: emit_arith(ctx, inst, 0x6F, 0x81, 0); break;
+        case IR_AND: emit_arith(ctx, inst, 0x71, 0x83, 0); break;
+        case IR_OR:  emit_arith(ctx, inst, 0x72, 0x84, 0); break;
+
+        case IR_EQ: case IR_NE: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+            emit_compare(ctx, inst);
+            break;
+
+        case IR_CALL:
+        case IR_SPAWN:
+            emit_call(ctx, inst);
+            break;
+
+        case IR_MOV:
+            operand(ctx, inst->op1, ctx->kinds[inst->result.storage.id]);
+            emit_result(ctx, inst);
+            break;
+
+        default:
+            /* Terminators are handled by the structurer; actor ops are calls by now */
+            break;
+    }
+}
+
+/* ============================================================
+ * Structured Control Flow
+ * ============================================================ */
+
+static void do_tree(WasmFnCtx* ctx, int x);
+
+static void push_label(WasmFnCtx* ctx, WasmLabelKind kind, int block) {
+    ctx->labels[ctx->label_count++] = (WasmLabel){ kind, block };
+}
+
+/* `br` to the label for `block`, counting outward from the innermost */
+static void emit_br(WasmFnCtx* ctx, WasmLabelKind kind, int block) {
+    for (size_t i = ctx->label_count; i-- > 0;) {
+        if (ctx->labels[i].kind == kind && ctx->labels[i].block == block) {
+            buf_byte(ctx->code, OP_BR);
+            buf_u32(ctx->code, (uint32_t)(ctx->label_count - 1 - i));
+            return;
+        }
+    }
+    buf_byte(ctx->code, OP_UNREACHABLE);
+}
+
+static void do_branch(WasmFnCtx* ctx, int from, int to) {
+    if (ctx->rpo[to] <= ctx->rpo[from]) {
+        emit_br(ctx, LABEL_LOOP, to);
+    } else if (ctx->forward_preds[to] >= 2) {
+        emit_br(ctx, LABEL_BLOCK, to);
+    } else {
+        do_tree(ctx, to);
+    }
+}
+
+static void emit_node(WasmFnCtx* ctx, int x) {
+    IrBlock* blk = ctx->blocks[x];
+    IrInstr* inst = blk->head;
+    while (inst && !is_terminator(inst->op)) {
+        emit_instr(ctx, inst);
+        inst = inst->next;
+    }
+
+    if (!inst) {
+        /* The x86 backend falls through to the next block in layout */
+        if (blk->next) do_branch(ctx, x, blk->next->id);
+        else emit_return(ctx, (IrValue){ .kind = VAL_UNDEF });
+        return;
+    }
+
+    switch (inst->op) {
+        case IR_RET:
+            emit_return(ctx, inst->op1);
+            break;
+        case IR_JMP:
+            do_branch(ctx, x, inst->target1->id);
+            break;
+        case IR_BR:
+            operand(ctx, inst->op1, IR_BOOL);
+            buf_byte(ctx->code, OP_IF);
+            buf_byte(ctx->code, BLOCK_EMPTY);
+            push_label(ctx, LABEL_IF, x);
+            do_branch(ctx, x, inst->target1->id);
+            buf_byte(ctx->code, OP_ELSE);
+            do_branch(ctx, x, inst->target2->id);
+            ctx->label_count--;
+            buf_byte(ctx->code, OP_END);
+            break;
+        default:
+            break;
+    }
+}
+
+/* Wrap x in one `block` per merge child, outermost first; each child follows its block */
+static void node_within(WasmFnCtx* ctx, int x, const int* merges, int count) {
+    if (count == 0) {
+        emit_node(ctx, x);
+        return;
+    }
+    buf_byte(ctx->code, OP_BLOCK);
+    buf_byte(ctx->code, BLOCK_EMPTY);
+    push_label(ctx, LABEL_BLOCK, merges[0]);
+    node_within(ctx, x, merges + 1, count - 1);
+    ctx->label_count--;
+    buf_byte(ctx->code, OP_END);
+    do_tree(ctx, merges[0]);
+}
+
+static void do_tree(WasmFnCtx* ctx, int x) {
+    /* Dominator-tree children that are merge nodes, latest in reverse postorder first */
+    int* merges = malloc(((size_t)ctx->reachable + 1) * sizeof(int));
+    int count = 0;
+    for (int i = ctx->reachable; i-- > 0;) {
+        int y = ctx->order[i];
+        if (y != x && ctx->idom[y] == x && ctx->forward_preds[y] >= 2) merges[count++] = y;
+    }
+
+    if (ctx->loop_header[x]) {
+        buf_byte(ctx->code, OP_LOOP);
+        buf_byte(ctx->code, BLOCK_EMPTY);
+        push_label(ctx, LABEL_LOOP, x);
+        node_within(ctx, x, merges, count);
+        ctx->label_count--;
+        buf_byte(ctx->code, OP_END);
+    } else {
+        node_within(ctx, x, merges, count);
+    }
+    free(merges);
+}
+
+/* ============================================================
+ * Functions
+ * ============================================================ */
+
+static void fn_free(WasmFnCtx* ctx) {
+    free(ctx->kinds);
+    free(ctx->allocas);
+    free(ctx->escapes);
+    free(ctx->slot_kinds);
+    free(ctx->locals);
+    free(ctx->blocks);
+    free(ctx->rpo);
+    free(ctx->order);
+    free(ctx->idom);
+    free(ctx->forward_preds);
+    free(ctx->loop_header);
+    free(ctx->labels);
+}
+
+/* Append the body of `fn` (locals and code) to `out` */
+static bool emit_function(WasmModuleCtx* m, IrFunction* fn, WasmBuf* out) {
+    WasmFnCtx ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.m = m;
+    scan(&ctx, fn);
+
+    if (fn->entry && !analyze_cfg(&ctx)) {
+        fprintf(stderr, "error: irreducible control flow in '%s'\n", fn->name);
+        fn_free(&ctx);
+        return false;
+    }
+
+    /* Locals after the parameters: one per vreg or non-escaping slot, then the frame */
+    uint8_t* local_types = malloc((size_t)ctx.vreg_count + 2);
+    uint32_t local_count = 0;
+    uint32_t param_count = (uint32_t)(fn->param_count < MAX_WASM_PARAMS ? fn->param_count : MAX_WASM_PARAMS);
+    for (uint32_t id = 0; id < ctx.vreg_count; id++) {
+        ctx.locals[id] = UINT32_MAX;
+        if (id < fn->param_count) {
+            if (id < param_count) ctx.locals[id] = id;
+            continue;
+        }
+        uint8_t vt;
+        if (ctx.allocas[id]) {
+            if (ctx.escapes[id]) ctx.frame_size += slot_size(ctx.slot_kinds[id]);
+            vt = ctx.escapes[id] ? WASM_I32 : valtype(ctx.slot_kinds[id]);
+        } else if (ctx.kinds[id] != IR_VOID) {
+            vt = valtype(ctx.kinds[id]);
+        } else {
+            continue;
+        }
+        ctx.locals[id] = param_count + local_count;
+        local_types[local_count++] = vt;
+    }
+    if (ctx.frame_size) {
+        ctx.frame_local = param_count + local_count;
+        local_types[local_count++] = WASM_I32;
+    }
+
+    WasmBuf body = {0};
+    ctx.code = &body;
+
+    /* Run-length encoded local declarations */
+    uint32_t runs = 0;
+    for (uint32_t i = 0; i < local_count; i++) {
+        if (i == 0 || local_types[i] != local_types[i - 1]) runs++;
+    }
+    buf_u32(&body, runs);
+    for (uint32_t i = 0; i < local_count;) {
+        uint32_t j = i;
+        while (j < local_count && local_types[j] == local_types[i]) j++;
+        buf_u32(&body, j - i);
+        buf_byte(&body, local_types[i]);
+        i = j;
+    }
+    free(local_types);
+
+    /* Prologue: carve escaping slots out of the shadow stack, zeroed */
+    if (ctx.frame_size) {
+        emit_local(&body, OP_GLOBAL_GET, 0);
+        emit_i32(&body, (int32_t)ctx.frame_size);
+        buf_byte(&body, OP_I32_SUB);
+        emit_local(&body, OP_LOCAL_TEE, ctx.frame_local);
+        emit_local(&body, OP_GLOBAL_SET, 0);
+        uint32_t offset = 0;
+        for (uint32_t id = (uint32_t)fn->param_count; id < ctx.vreg_count; id++) {
+            if (!ctx.allocas[id] || !ctx.escapes[id]) continue;
+            emit_local(&body, OP_LOCAL_GET, ctx.frame_local);
+            if (offset) {
+                emit_i32(&body, (int32_t)offset);
+                buf_byte(&body, OP_I32_ADD);
+            }
+            emit_local(&body, OP_LOCAL_SET, ctx.locals[id]);
+            for (uint32_t word = 0; word < slot_size(ctx.slot_kinds[id]); word += 8) {
+                emit_local(&body, OP_LOCAL_GET, ctx.locals[id]);
+                if (word) {
+                    emit_i32(&body, (int32_t)word);
+                    buf_byte(&body, OP_I32_ADD);
+                }
+                buf_byte(&body, OP_I64_CONST);
+                buf_s64(&body, 0);
+                emit_store(&body, IR_I64);
+            }
+            offset += slot_size(ctx.slot_kinds[id]);
+        }
+    }
+
+    if (fn->entry) do_tree(&ctx, fn->entry->id);
+    else emit_return(&ctx, (IrValue){ .kind = VAL_UNDEF });
+
+    /* Every path ends in br or return; tell the validator so */
+    if (fn->ret_type.kind != IR_VOID) buf_byte(&body, OP_UNREACHABLE);
+    buf_byte(&body, OP_END);
+
+    buf_u32(out, (uint32_t)body.len);
+    buf_bytes(out, body.data, body.len);
+    out->oom |= body.oom;
+    free(body.data);
+    fn_free(&ctx);
+    return true;
+}
+
+/* Table entry for `fn`: take the shim's (i64, i64, i64), return i64 */
+static void emit_adapter(WasmModuleCtx* m, IrFunction* fn, WasmBuf* out) {
+    WasmBuf body = {0};
+    buf_u32(&body, 0);
+    size_t n = fn->param_count < MAX_WASM_PARAMS ? fn->param_count : MAX_WASM_PARAMS;
+    for (size_t i = 0; i < n; i++) {
+        if (i < ADAPTER_PARAMS) {
+            emit_local(&body, OP_LOCAL_GET, (uint32_t)i);
+            emit_convert(&body, IR_I64, fn_param_kind(fn, i));
+        } else {
+            emit_zero(&body, fn_param_kind(fn, i));
+        }
+    }
+    buf_byte(&body, OP_CALL);
+    buf_u32(&body, (uint32_t)find_fn(m, fn->name));
+    if (fn->ret_type.kind == IR_VOID) emit_zero(&body, IR_I64);
+    else emit_convert(&body, fn->ret_type.kind, IR_I64);
+    buf_byte(&body, OP_END);
+
+    buf_u32(out, (uint32_t)body.len);
+    buf_bytes(out, body.data, body.len);
+    out->oom |= body.oom;
+    free(body.data);
+}
+
+/* ============================================================
+ * Module Pre-pass
+ * ============================================================ */
+
+/* `call` types an import the runtime doesn't know; NULL only for runtime names */
+static void add_import(WasmModuleCtx* m, const char* name, IrInstr* call) {
+    if (find_fn(m, name) >= 0 || find_import(m, name)) return;
+    if (m->import_count == MAX_IMPORTS) {
+        m->failed = true;
+        return;
+    }
+
+    WasmImport* imp = &m->imports[m->import_count++];
+    const WasmRuntimeSig* sig = find_sig(name);
+    if (sig) {
+        imp->module = "arnm";
+        imp->name = sig->name;
+        imp->ret = sig->ret;
+        imp->param_count = sig->param_count;
+        memcpy(imp->params, sig->params, sizeof(imp->params));
+    } else {
+        /* Neither defined here nor part of the runtime: typed from its first call */
+        imp->module = "env";
+        imp->name = name;
+        imp->ret = call->type.kind == IR_VOID ? IR_VOID : w_norm(call->type.kind);
+        imp->param_count = call->arg_count < MAX_WASM_PARAMS ? call->arg_count : MAX_WASM_PARAMS;
+        for (size_t i = 0; i < imp->param_count; i++) imp->params[i] = w_norm(call->args[i].type.kind);
+    }
+    imp->type = sig_type(m, imp->params, imp->param_count, imp->ret);
+}
+
+static void add_ref(WasmModuleCtx* m, IrValue val) {
+    if (val.kind != VAL_GLOBAL || ref_slot(m, val.storage.global.name)) return;
+    for (size_t i = 0; i < m->func_count; i++) {
+        if (strcmp(m->funcs[i]->name, val.storage.global.name) == 0) {
+            m->refs[m->ref_count++] = m->funcs[i];
+            return;
+        }
+    }
+}
+
+/* Collect imports and functions taken as values; imports are numbered first */
+static void scan_module(WasmModuleCtx* m) {
+    for (IrFunction* fn = m->mod->funcs; fn; fn = fn->next) m->func_count++;
+    m->funcs = calloc(m->func_count + 1, sizeof(IrFunction*));
+    m->refs = calloc(m->func_count + 1, sizeof(IrFunction*));
+    size_t i = 0;
+    for (IrFunction* fn = m->mod->funcs; fn; fn = fn->next) m->funcs[i++] = fn;
+
+    for (IrFunction* fn = m->mod->funcs; fn; fn = fn->next) {
+        for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+            for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+                bool call = inst->op == IR_CALL || inst->op == IR_SPAWN;
+                if (call && inst->op1.kind == VAL_GLOBAL) add_import(m, inst->op1.storage.global.name, inst);
+                else add_ref(m, inst->op1);
+                if (inst->op == IR_BOUNDS_CHECK) add_import(m, "arnm_panic_bounds", NULL);
+                add_ref(m, inst->op2);
+                for (size_t a = 0; a < inst->arg_count; a++) add_ref(m, inst->args[a]);
+            }
+        }
+    }
+}
+
+/* ============================================================
+ * Public API
+ * ============================================================ */
+
+bool wasm_emit(IrModule* mod, FILE* out) {
+    WasmModuleCtx m;
+    memset(&m, 0, sizeof(m));
+    m.mod = mod;
+    scan_module(&m);
+
+    uint8_t adapter_params[ADAPTER_PARAMS] = { WASM_I64, WASM_I64, WASM_I64 };
+    m.adapter_type = intern_type(&m, adapter_params, ADAPTER_PARAMS, WASM_I64);
+    uint32_t* fn_types = malloc((m.func_count + 1) * sizeof(uint32_t));
+    for (size_t i = 0; i < m.func_count; i++) fn_types[i] = fn_type(&m, m.funcs[i]);
+
+    /* Bodies first: they are the only part that can fail */
+    WasmBuf code = {0};
+    bool ok = !m.failed;
+    buf_u32(&code, (uint32_t)(m.func_count + m.ref_count));
+    for (size_t i = 0; i < m.func_count && ok; i++) ok = emit_function(&m, m.funcs[i], &code);
+    for (size_t i = 0; i < m.ref_count && ok; i++) emit_adapter(&m, m.refs[i], &code);
+    if (!ok) {
+        free(code.data);
+        free(fn_types);
+        free(m.funcs);
+        free(m.refs);
+        return false;
+    }
+
+    WasmBuf module = {0};
+    WasmBuf sec = {0};
+    static const uint8_t header[] = { 0x00, 'a', 's', 'm', 0x01, 0x00, 0x00, 0x00 };
+    buf_bytes(&module, header, sizeof(header));
+
+    buf_u32(&sec, (uint32_t)m.type_count);
+    for (size_t i = 0; i < m.type_count; i++) {
+        buf_byte(&sec, 0x60);
+        buf_u32(&sec, (uint32_t)m.types[i].param_count);
+        buf_bytes(&sec, m.types[i].params, m.types[i].param_count);
+        buf_u32(&sec, m.types[i].result ? 1 : 0);
+        if (m.types[i].result) buf_byte(&sec, m.types[i].result);
+    }
+    buf_section(&module, 1, &sec);
+
+    buf_u32(&sec, (uint32_t)m.import_count);
+    for (size_t i = 0; i < m.import_count; i++) {
+        buf_name(&sec, m.imports[i].module);
+        buf_name(&sec, m.imports[i].name);
+        buf_byte(&sec, 0x00);
+        buf_u32(&sec, m.imports[i].type);
+    }
+    buf_section(&module, 2, &sec);
+
+    buf_u32(&sec, (uint32_t)(m.func_count + m.ref_count));
+    for (size_t i = 0; i < m.func_count; i++) buf_u32(&sec, fn_types[i]);
+    for (size_t i = 0; i < m.ref_count; i++) buf_u32(&sec, m.adapter_type);
+    buf_section(&module, 3, &sec);
+
+    /* Table slot 0 stays null so a zero function pointer traps */
+    buf_u32(&sec, 1);
+    buf_byte(&sec, 0x70);
+    buf_byte(&sec, 0x00);
+    buf_u32(&sec, (uint32_t)(m.ref_count + 1));
+    buf_section(&module, 4, &sec);
+
+    buf_u32(&sec, 1);
+    buf_byte(&sec, 0x00);
+    buf_u32(&sec, WASM_MIN_PAGES);
+    buf_section(&module, 5, &sec);
+
+    /* Globals: the shadow stack pointer, then where the shim's heap starts */
+    buf_u32(&sec, 2);
+    buf_byte(&sec, WASM_I32);
+    buf_byte(&sec, 0x01);
+    emit_i32(&sec, WASM_STACK_TOP);
+    buf_byte(&sec, OP_END);
+    buf_byte(&sec, WASM_I32);
+    buf_byte(&sec, 0x00);
+    emit_i32(&sec, WASM_STACK_TOP);
+    buf_byte(&sec, OP_END);
+    buf_section(&module, 6, &sec);
+
+    int64_t main_index = find_fn(&m, "main");
+    buf_u32(&sec, main_index >= 0 ? 5 : 4);
+    buf_name(&sec, "memory");
+    buf_byte(&sec, 0x02);
+    buf_u32(&sec, 0);
+    buf_name(&sec, "__indirect_function_table");
+    buf_byte(&sec, 0x01);
+    buf_u32(&sec, 0);
+    buf_name(&sec, "__stack_pointer");
+    buf_byte(&sec, 0x03);
+    buf_u32(&sec, 0);
+    buf_name(&sec, "__heap_base");
+    buf_byte(&sec, 0x03);
+    buf_u32(&sec, 1);
+    if (main_index >= 0) {
+        buf_name(&sec, "_arnm_main");
+        buf_byte(&sec, 0x00);
+        buf_u32(&sec, (uint32_t)main_index);
+    }
+    buf_section(&module, 7, &sec);
+
+    if (m.ref_count) {
+        buf_u32(&sec, 1);
+        buf_u32(&sec, 0);
+        emit_i32(&sec, 1);
+        buf_byte(&sec, OP_END);
+        buf_u32(&sec, (uint32_t)m.ref_count);
+        uint32_t first_adapter = (uint32_t)(m.import_count + m.func_count);
+        for (size_t i = 0; i < m.ref_count; i++) buf_u32(&sec, first_adapter + (uint32_t)i);
+        buf_section(&module, 9, &sec);
+    }
+
+    buf_section(&module, 10, &code);
+
+    /* Function names, so traps in the playground show ARNm names */
+    WasmBuf names = {0};
+    buf_u32(&names, (uint32_t)(m.import_count + m.func_count));
+    for (size_t i = 0; i < m.import_count; i++) {
+        buf_u32(&names, (uint32_t)i);
+        buf_name(&names, m.imports[i].name);
+    }
+    for (size_t i = 0; i < m.func_count; i++) {
+        buf_u32(&names, (uint32_t)(m.import_count + i));
+        buf_name(&names, m.funcs[i]->name);
+    }
+    buf_name(&sec, "name");
+    buf_byte(&sec, 1);
+    buf_u32(&sec, (uint32_t)names.len);
+    buf_bytes(&sec, names.data, names.len);
+    free(names.data);
+    buf_section(&module, 0, &sec);
+
+    ok = !module.oom;
+    if (ok) fwrite(module.data, 1, module.len, out);
+    free(module.data);
+    free(fn_types);
+    free(m.funcs);
+    free(m.refs);
+    return ok;
+}
@@ -240,6 +240,42 @@ IrInstr* ir_build_field_ptr(IrFunction* fn, IrBlock* block, IrValue ptr, int ind
     return i;
 }
 
+IrInstr* ir_build_array_data(IrFunction* fn, IrBlock* block, IrValue arr) {
+    IrInstr* i = new_instr(IR_ARRAY_DATA);
+    i->type = ir_type_ptr();
+    i->result = ir_val_var(fn->vreg_counter++, i->type);
+    i->op1 = arr;
+    block_append(block, i);
+    return i;
+}
+
+IrInstr* ir_build_array_len(IrFunction* fn, IrBlock* block, IrValue arr) {
+    IrInstr* i = new_instr(IR_ARRAY_LEN);
+    i->type = ir_type_i32();
+    i->result = ir_val_var(fn->vreg_counter++, i->type);
+    i->op1 = arr;
+    block_append(block, i);
+    return i;
+}
+
+IrInstr* ir_build_elem_ptr(IrFunction* fn, IrBlock* block, IrValue data, IrValue idx) {
+    IrInstr* i = new_instr(IR_ELEM_PTR);
+    i->type = ir_type_ptr();
+    i->result = ir_val_var(fn->vreg_counter++, i->type);
+    i->op1 = data;
+    i->op2 = idx;
+    block_append(block, i);
+    return i;
+}
+
+IrInstr* ir_build_bounds_check(IrBlock* block, IrValue idx, IrValue len) {
+    IrInstr* i = new_instr(IR_BOUNDS_CHECK);
+    i->op1 = idx;
+    i->op2 = len;
+    block_append(block, i);
+    return i;
+}
+
 IrInstr* ir_build_call(IrFunction* fn, IrBlock* block, const char* callee_name, IrValue* args, size_t arg_count, IrType ret_type) {
     IrInstr* i = new_instr(IR_CALL);
     
@@ -290,6 +326,43 @@ IrInstr* ir_build_cmp(IrFunction* fn, IrBlock* block, IrOpcode op, IrValue lhs,
     return i;
 } 
 
+/* ============================================================
+ * Editing
+ * ============================================================ */
+
+/* Append a copy of src to block; the caller renames its values */
+IrInstr* ir_instr_copy(IrBlock* block, const IrInstr* src) {
+    IrInstr* i = new_instr(src->op);
+    *i = *src;
+    if (src->arg_count > 0) {
+        i->args = malloc(sizeof(IrValue) * src->arg_count);
+        memcpy(i->args, src->args, sizeof(IrValue) * src->arg_count);
+    }
+    block_append(block, i);
+    return i;
+}
+
+/* Unlink inst from block and free it */
+void ir_instr_remove(IrBlock* block, IrInstr* inst) {
+    if (inst->prev) inst->prev->next = inst->next;
+    else block->head = inst->next;
+    if (inst->next) inst->next->prev = inst->prev;
+    else block->tail = inst->prev;
+    if (inst->args) free(inst->args);
+    free(inst);
+}
+
+/* Unlink an unreachable block from fn's layout and free it with its instructions */
+void ir_block_remove(IrFunction* fn, IrBlock* block) {
+    IrBlock* prev = NULL;
+    for (IrBlock* b = fn->entry; b && b != block; b = b->next) prev = b;
+    if (prev) prev->next = block->next;
+    else fn->entry = block->next;
+    if (fn->blocks_tail == block) fn->blocks_tail = prev;
+    while (block->head) ir_instr_remove(block, block->head);
+    free(block);
+}
+
 /* ... helpers ... */
 
 IrType ir_type_bool(void) {
@@ -325,6 +398,14 @@ IrValue ir_val_const_bool(bool b) {
     return v;
 }
 
+IrValue ir_val_const_f64(double f) {
+    IrValue v;
+    v.kind = VAL_CONST;
+    v.type = ir_type_f64();
+    v.storage.constant.as.f = f;
+    return v;
+}
+
 IrType ir_type_i32(void) {
     IrType t = { IR_I32 };
     return t;
@@ -335,6 +416,11 @@ IrType ir_type_i64(void) {
     return t;
 }
 
+IrType ir_type_f64(void) {
+    IrType t = { IR_F64 };
+    return t;
+}
+
 IrType ir_type_void(void) {
     IrType t = { IR_VOID };
     return t;
@@ -345,6 +431,11 @@ IrType ir_type_ptr(void) {
     return t;
 }
 
+IrType ir_type_vec(void) {
+    IrType t = { IR_VEC };
+    return t;
+}
+
 /* ============================================================
  * Dumping / Debug
  * ============================================================ */
@@ -355,7 +446,9 @@ static void dump_type(IrType t) {
         case IR_BOOL: printf("bool"); break;
         case IR_I32:  printf("i32"); break;
         case IR_I64:  printf("i64"); break;
+        case IR_F64:  printf("f64"); break;
         case IR_PTR:  printf("ptr"); break;
+        case IR_VEC:  printf("vec"); break;
         default:      printf("?"); break;
     }
 }
@@ -402,6 +495,10 @@ void ir_dump_module(IrModule* mod) {
                     case IR_LOAD:   printf("load "); break;
                     case IR_STORE:  printf("store "); break;
                     case IR_FIELD_PTR: printf("field_ptr "); break;
+                    case IR_ARRAY_DATA: printf("array_data "); break;
+                    case IR_ARRAY_LEN: printf("array_len "); break;
+                    case IR_ELEM_PTR: printf("elem_ptr "); break;
+                    case IR_BOUNDS_CHECK: printf("bounds_check "); break;
                     case IR_CALL:   printf("call "); break;
                     case IR_SPAWN:  printf("spawn "); break;
                     case IR_SEND:   printf("send "); break;
@@ -5,6 +5,7 @@
 #include "../include/irgen.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <assert.h>
 #include <string.h>
 #include <ctype.h>
@@ -30,6 +31,12 @@
 #define IRGEN_REQUIRE_FN(ctx) \
     IRGEN_ASSERT((ctx)->cur_fn != NULL, "current function must be set")
 
+typedef struct {
+    char*   name; /* Owns the copy */
+    IrValue val; 
+    IrType  type; /* Content type */
+} GenLocal;
+
 typedef struct {
     SemaContext* sema;
     IrModule*    mod;
@@ -41,11 +48,12 @@ typedef struct {
     IrBlock*     break_bb;    /* Target for break statements */
     IrBlock*     continue_bb; /* Target for continue statements */
     
-    struct {
-        char*   name; /* Owns the copy */
-        IrValue val; 
-        IrType  type; /* Content type */
-    } locals[256];
+    /* Behavior function to restart from, for the receive at its loop head */
+    const char*  recv_restart;
+    
+    int          parallel_count; /* Outlined parallel bodies in this module */
+    
+    GenLocal     locals[256];
     int local_count;
 } GenContext;
 
@@ -63,8 +71,9 @@ static char* my_strdup(const char* s) {
     return copy;
 }
 
+/* Innermost binding first, so a nested let or loop variable shadows */
 static IrValue lookup_local(GenContext* ctx, const char* name, uint32_t len, IrType* out_type) {
-    for (int i = 0; i < ctx->local_count; i++) {
+    for (int i = ctx->local_count - 1; i >= 0; i--) {
         if (strlen(ctx->locals[i].name) == len &&
             strncmp(ctx->locals[i].name, name, len) == 0) {
             if (out_type) *out_type = ctx->locals[i].type;
@@ -90,23 +99,134 @@ static void free_locals(GenContext* ctx) {
     ctx->local_count = 0;
 }
 
+/* Drop the locals declared since `mark`, at the end of their scope */
+static void pop_locals(GenContext* ctx, int mark) {
+    while (ctx->local_count > mark) {
+        free(ctx->locals[--ctx->local_count].name);
+    }
+}
+
+/* ============================================================
+ * Types
+ * ============================================================ */
+
+static Type* expr_sema_type(AstExpr* expr) {
+    switch (expr->kind) {
+        case AST_IDENT_EXPR:      return expr->as.ident.common.sema_type;
+        case AST_INT_LIT_EXPR:    return expr->as.int_lit.common.sema_type;
+        case AST_FLOAT_LIT_EXPR:  return expr->as.float_lit.common.sema_type;
+        case AST_BINARY_EXPR:     return expr->as.binary.common.sema_type;
+        case AST_UNARY_EXPR:      return expr->as.unary.common.sema_type;
+        case AST_CALL_EXPR:       return expr->as.call.common.sema_type;
+        case AST_FIELD_EXPR:      return expr->as.field.common.sema_type;
+        case AST_INDEX_EXPR:      return expr->as.index.common.sema_type;
+        case AST_ARRAY_EXPR:      return expr->as.array.common.sema_type;
+        case AST_GROUP_EXPR:      return expr->as.group.common.sema_type;
+        default:                  return NULL;
+    }
+}
+
+/*
+ * IR type for a value of a sema type. Floats are f64, and SIMD vectors,
+ * arrays and collections are handled by address; everything else keeps
+ * the caller's fallback.
+ */
+static IrType lower_type(Type* type, IrType fallback) {
+    if (!type) return fallback;
+    type = type_resolve(type);
+    switch (type->kind) {
+        case TYPE_F32:
+        case TYPE_F64:   return ir_type_f64();
+        case TYPE_F32X8:
+        case TYPE_I32X8:
+        case TYPE_F64X4:
+        case TYPE_ARRAY:
+        case TYPE_VEC:
+        case TYPE_MAP:
+        case TYPE_DEQUE: return ir_type_ptr();
+        default:         return fallback;
+    }
+}
+
+/* Runtime name prefix of a vector type ("f32x8"), or NULL */
+static const char* vector_name(Type* type) {
+    if (!type) return NULL;
+    switch (type_resolve(type)->kind) {
+        case TYPE_F32X8: return "f32x8";
+        case TYPE_I32X8: return "i32x8";
+        case TYPE_F64X4: return "f64x4";
+        default:         return NULL;
+    }
+}
+
+/* ============================================================
+ * SIMD Vectors
+ * Vector values are the addresses of 32-byte IR_VEC slots. Every
+ * operation writes a fresh slot; locals own a slot of their own and
+ * are copied into on let and assignment.
+ * ============================================================ */
+
+static IrValue vec_slot(GenContext* ctx) {
+    return ir_build_alloca(ctx->cur_fn, ctx->cur_block, ir_type_vec())->result;
+}
+
+static void vec_copy(GenContext* ctx, IrValue dst, IrValue src) {
+    for (int i = 0; i < 4; i++) {
+        IrInstr* from = ir_build_field_ptr(ctx->cur_fn, ctx->cur_block, src, i);
+        IrInstr* word = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i64(), from->result);
+        IrInstr* to = ir_build_field_ptr(ctx->cur_fn, ctx->cur_block, dst, i);
+        ir_build_store(ctx->cur_block, word->result, to->result);
+    }
+}
+
+/* Call arnm_<vec>_<op>; a void kernel gets a fresh dst slot first and yields it */
+static IrValue vec_call(GenContext* ctx, const char* vec, const char* op,
+                        IrValue* args, size_t count, IrType ret) {
+    char name[32];
+    snprintf(name, sizeof(name), "arnm_%s_%s", vec, op);
+    
+    IrValue call_args[5];
+    size_t n = 0;
+    IrValue dst = { .kind = VAL_UNDEF };
+    if (ret.kind == IR_VOID) {
+        dst = vec_slot(ctx);
+        call_args[n++] = dst;
+    }
+    for (size_t i = 0; i < count; i++) call_args[n++] = args[i];
+    
+    IrInstr* call = ir_build_call(ctx->cur_fn, ctx->cur_block, my_strdup(name), call_args, n, ret);
+    return ret.kind == IR_VOID ? dst : call->result;
+}
+
+/* Whether a vector expression already yields a slot nothing else refers to */
+static bool vec_is_fresh(AstExpr* expr) {
+    while (expr->kind == AST_GROUP_EXPR) expr = expr->as.group.inner;
+    return expr->kind == AST_CALL_EXPR || expr->kind == AST_UNARY_EXPR ||
+           (expr->kind == AST_BINARY_EXPR && expr->as.binary.op != BINARY_ASSIGN);
+}
+
 /* ============================================================
  * Expression Generation
  * ============================================================ */
 
 static IrValue gen_expr(GenContext* ctx, AstExpr* expr);
-static IrValue gen_spawn_call(GenContext* ctx, AstCallExpr* call); /* Forward declare */
+static IrValue gen_spawn_call(GenContext* ctx, AstCallExpr* call, bool joinable); /* Forward declare */
 
 static IrValue gen_binary(GenContext* ctx, AstBinaryExpr* bin) {
     if (bin->op == BINARY_ASSIGN) {
         if (bin->left->kind == AST_IDENT_EXPR) {
             /* Assignment: lookup address, eval rhs, store */
-            IrValue addr = lookup_local(ctx, bin->left->as.ident.name, bin->left->as.ident.name_len, NULL); // null type ok for store?
+            IrType type = ir_type_i32();
+            IrValue addr = lookup_local(ctx, bin->left->as.ident.name, bin->left->as.ident.name_len, &type);
             /* Wait, lookup_local returns the address (alloca result). It is PTR. */
             
             if (addr.kind != VAL_UNDEF) {
                  IrValue rhs = gen_expr(ctx, bin->right);
-                 ir_build_store(ctx->cur_block, rhs, addr);
+                 if (type.kind == IR_VEC) {
+                     vec_copy(ctx, addr, rhs);
+                 } else {
+                     ir_build_store(ctx->cur_block, rhs, addr);
+                 }
                  return rhs;
             }
         } else if (bin->left->kind == AST_FIELD_EXPR) {
@@ -152,6 +272,13 @@ static IrValue gen_binary(GenContext* ctx, AstBinaryExpr* bin) {
     IrValue lhs = gen_expr(ctx, bin->left);
     IrValue rhs = gen_expr(ctx, bin->right);
     
+    const char* vec = vector_name(bin->common.sema_type);
+    if (vec && bin->op >= BINARY_ADD && bin->op <= BINARY_DIV) {
+        /* BINARY_ADD..DIV line up with ArnmVecOp */
+        IrValue args[3] = { lhs, rhs, ir_val_const_i32((int32_t)(bin->op - BINARY_ADD)) /* ArnmVecOp */ };
+        return vec_call(ctx, vec, "op", args, 3, ir_type_void());
+    }
+    
     IrInstr* inst = NULL;
     switch (bin->op) {
         case BINARY_ADD: inst = ir_build_add(ctx->cur_fn, ctx->cur_block, lhs, rhs); break;
@@ -173,17 +300,187 @@ static IrValue gen_binary(GenContext* ctx, AstBinaryExpr* bin) {
     return inst ? inst->result : (IrValue){ .kind = VAL_UNDEF };
 }
 
+static IrValue gen_unary(GenContext* ctx, AstUnaryExpr* un) {
+    if (un->op != UNARY_NEG) return (IrValue){ .kind = VAL_UNDEF };
+    
+    IrValue operand = gen_expr(ctx, un->operand);
+    const char* vec = vector_name(un->common.sema_type);
+    if (vec) {
+        IrValue zero = ir_val_const_i32(0);
+        if (strcmp(vec, "i32x8") != 0) zero = ir_val_const_f64(0.0);
+        IrValue args[3] = { vec_call(ctx, vec, "splat", &zero, 1, ir_type_void()), operand,
+                            ir_val_const_i32(1) /* ARNM_VEC_SUB */ };
+        return vec_call(ctx, vec, "op", args, 3, ir_type_void());
+    }
+    
+    if (operand.kind == VAL_CONST) {
+        if (operand.type.kind == IR_F64) return ir_val_const_f64(-operand.storage.constant.as.f);
+        if (operand.type.kind == IR_I32) return ir_val_const_i32(-(int32_t)operand.storage.constant.as.i);
+    }
+    IrValue zero = operand.type.kind == IR_F64 ? ir_val_const_f64(0.0) : ir_val_const_i32(0);
+    zero.type = operand.type;
+    return ir_build_sub(ctx->cur_fn, ctx->cur_block, zero, operand)->result;
+}
+
 static IrValue gen_identifier(GenContext* ctx, AstIdentExpr* ident) {
     IrType type = ir_type_i32(); /* fallback */
     IrValue ptr = lookup_local(ctx, ident->name, ident->name_len, &type);
     
     if (ptr.kind != VAL_UNDEF) {
+        if (type.kind == IR_VEC) return ptr;
         IrInstr* load = ir_build_load(ctx->cur_fn, ctx->cur_block, type, ptr);
         return load->result;
     }
     return (IrValue){ .kind = VAL_UNDEF };
 }
 
+/* ============================================================
+ * Arrays
+ * An array value is the address of a read-only {data, len} header from
+ * the runtime; elements are 8-byte slots. Lengths and element addresses
+ * are separate instructions so the range pass can drop proven checks.
+ * ============================================================ */
+
+/* Element slots keep every bit of 8-byte values; the rest load as they store */
+static IrType elem_type(Type* type) {
+    if (type) {
+        switch (type_resolve(type)->kind) {
+            case TYPE_BOOL:    return ir_type_bool();
+            case TYPE_I64:     return ir_type_i64();
+            case TYPE_PROCESS:
+            case TYPE_ACTOR:
+            case TYPE_STRING:  return ir_type_ptr();
+            default:           break;
+        }
+    }
+    return lower_type(type, ir_type_i32());
+}
+
+/* Element type of an array's sema type (NULL if unresolved) */
+static Type* array_elem(Type* type) {
+    type = type ? type_resolve(type) : NULL;
+    return type && type->kind == TYPE_ARRAY ? type->as.array.element_type : NULL;
+}
+
+/* Length of a fixed-size array is a constant; anything else reads the header */
+static IrValue array_len(GenContext* ctx, IrValue arr, Type* type) {
+    type = type ? type_resolve(type) : NULL;
+    if (type && type->kind == TYPE_ARRAY && type->as.array.length >= 0 &&
+        type->as.array.length <= INT32_MAX) {
+        return ir_val_const_i32((int32_t)type->as.array.length);
+    }
+    return ir_build_array_len(ctx->cur_fn, ctx->cur_block, arr)->result;
+}
+
+static IrValue as_i64(IrValue v) {
+    if (v.kind == VAL_CONST) v.type = ir_type_i64();
+    return v;
+}
+
+static IrValue array_new(GenContext* ctx, IrValue len) {
+    IrValue arg = as_i64(len);
+    return ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_array_new", &arg, 1, ir_type_ptr())->result;
+}
+
+/* Address of object[index], checked unless a constant index fits a fixed size */
+static IrValue gen_elem_addr(GenContext* ctx, AstIndexExpr* index) {
+    Type* type = expr_sema_type(index->object);
+    IrValue arr = gen_expr(ctx, index->object);
+    IrValue idx = gen_expr(ctx, index->index);
+    
+    IrValue len = array_len(ctx, arr, type);
+    bool in_range = idx.kind == VAL_CONST && len.kind == VAL_CONST &&
+                    (int32_t)idx.storage.constant.as.i >= 0 &&
+                    (int32_t)idx.storage.constant.as.i < (int32_t)len.storage.constant.as.i;
+    if (!in_range) {
+        ir_build_bounds_check(ctx->cur_block, idx, len);
+    }
+    IrValue data = ir_build_array_data(ctx->cur_fn, ctx->cur_block, arr)->result;
+    return ir_build_elem_ptr(ctx->cur_fn, ctx->cur_block, data, idx)->result;
+}
+
+/* a[lo..hi]: a new header over the same elements */
+static IrValue gen_slice(GenContext* ctx, AstIndexExpr* index) {
+    Type* type = expr_sema_type(index->object);
+    IrValue args[3];
+    args[0] = gen_expr(ctx, index->object);
+    args[1] = index->index ? as_i64(gen_expr(ctx, index->index)) : as_i64(ir_val_const_i32(0));
+    args[2] = index->end ? gen_expr(ctx, index->end) : array_len(ctx, args[0], type);
+    args[2] = as_i64(args[2]);
+    return ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_array_slice", args, 3, ir_type_ptr())->result;
+}
+
+static IrValue gen_index(GenContext* ctx, AstIndexExpr* index) {
+    if (index->is_slice) return gen_slice(ctx, index);
+    IrValue addr = gen_elem_addr(ctx, index);
+    return ir_build_load(ctx->cur_fn, ctx->cur_block, elem_type(index->common.sema_type), addr)->result;
+}
+
+static bool is_zero_const(IrValue v) {
+    if (v.kind != VAL_CONST) return false;
+    switch (v.type.kind) {
+        case IR_BOOL: return !v.storage.constant.as.b;
+        case IR_F64:  return v.storage.constant.as.i == 0;  /* +0.0 only */
+        case IR_I32:  return (int32_t)v.storage.constant.as.i == 0;
+        default:      return v.storage.constant.as.i == 0;
+    }
+}
+
+/*
+ * [a, b, c] stores each element into a fresh array. [x; n] evaluates x
+ * once and copies it into all n slots, skipping the loop for zero since
+ * new arrays start zeroed.
+ */
+static IrValue gen_array_literal(GenContext* ctx, AstArrayExpr* array) {
+    IrType slot_ty = elem_type(array_elem(array->common.sema_type));
+    
+    if (!array->repeat_count) {
+        IrValue arr = array_new(ctx, ir_val_const_i32((int32_t)array->elem_count));
+        if (array->elem_count == 0) return arr;
+        IrValue data = ir_build_array_data(ctx->cur_fn, ctx->cur_block, arr)->result;
+        for (size_t i = 0; i < array->elem_count; i++) {
+            IrValue val = gen_expr(ctx, array->elems[i]);
+            if (val.kind == VAL_CONST) val.type = slot_ty;
+            IrValue addr = ir_build_elem_ptr(ctx->cur_fn, ctx->cur_block, data,
+                                             ir_val_const_i32((int32_t)i))->result;
+            ir_build_store(ctx->cur_block, val, addr);
+        }
+        return arr;
+    }
+    
+    IrValue fill = gen_expr(ctx, array->elems[0]);
+    if (fill.kind == VAL_CONST) fill.type = slot_ty;
+    IrValue count = gen_expr(ctx, array->repeat_count);
+    IrValue arr = array_new(ctx, count);
+    if (is_zero_const(fill)) return arr;
+    
+    /* for (i = 0; i < n; i++) data[i] = fill; n was checked by arnm_array_new */
+    IrValue data = ir_build_array_data(ctx->cur_fn, ctx->cur_block, arr)->result;
+    IrValue counter = ir_build_alloca(ctx->cur_fn, ctx->cur_block, ir_type_i32())->result;
+    ir_build_store(ctx->cur_block, ir_val_const_i32(0), counter);
+    
+    IrBlock* cond_bb = ir_block_create(ctx->cur_fn, "fill.cond");
+    IrBlock* body_bb = ir_block_create(ctx->cur_fn, "fill.body");
+    IrBlock* done_bb = ir_block_create(ctx->cur_fn, "fill.done");
+    ir_build_jmp(ctx->cur_block, cond_bb);
+    
+    ctx->cur_block = cond_bb;
+    IrValue i = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i32(), counter)->result;
+    IrValue more = ir_build_cmp(ctx->cur_fn, ctx->cur_block, IR_LT, i, count)->result;
+    ir_build_br(ctx->cur_block, more, body_bb, done_bb);
+    
+    ctx->cur_block = body_bb;
+    i = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i32(), counter)->result;
+    IrValue addr = ir_build_elem_ptr(ctx->cur_fn, ctx->cur_block, data, i)->result;
+    ir_build_store(ctx->cur_block, fill, addr);
+    IrValue next = ir_build_add(ctx->cur_fn, ctx->cur_block, i, ir_val_const_i32(1))->result;
+    ir_build_store(ctx->cur_block, next, counter);
+    ir_build_jmp(ctx->cur_block, cond_bb);
+    
+    ctx->cur_block = done_bb;
+    return arr;
+}
+
 static IrValue gen_send(GenContext* ctx, AstSendExpr* send) {
     IrValue target = gen_expr(ctx, send->target);
     IrValue msg = gen_expr(ctx, send->message);
@@ -207,6 +504,117 @@ static IrValue gen_send(GenContext* ctx, AstSendExpr* send) {
 }
 
 
+/* Channel builtins: lowered to runtime calls under their runtime names */
+static const struct {
+    const char* name;
+    const char* symbol;
+    IrType    (*ret)(void);
+} channel_builtins[] = {
+    { "chan",       "arnm_channel_create", ir_type_ptr  },
+    { "chan_send",  "arnm_channel_send",   ir_type_bool },
+    { "chan_close", "arnm_channel_close",  ir_type_void },
+};
+
+/*
+ * Collection builtins. The runtime hands back the address of an element's
+ * 8-byte slot, which is loaded or stored here at the element's type:
+ * n = make a collection, s = store the last argument into the slot,
+ * l = load the slot, b = an int32_t answer read as bool.
+ */
+static const struct {
+    const char* name;
+    const char* symbol;
+    char        access;
+} collection_builtins[] = {
+    { "vec_new",          "arnm_vec_new",          'n' },
+    { "vec_push",         "arnm_vec_push",         's' },
+    { "vec_pop",          "arnm_vec_pop",          'l' },
+    { "vec_get",          "arnm_vec_at",           'l' },
+    { "vec_set",          "arnm_vec_at",           's' },
+    { "map_new",          "arnm_map_new",          'n' },
+    { "map_put",          "arnm_map_slot",         's' },
+    { "map_get",          "arnm_map_at",           'l' },
+    { "map_has",          "arnm_map_has",          'b' },
+    { "map_remove",       "arnm_map_remove",       'b' },
+    { "deque_new",        "arnm_deque_new",        'n' },
+    { "deque_push_back",  "arnm_deque_push_back",  's' },
+    { "deque_push_front", "arnm_deque_push_front", 's' },
+    { "deque_pop_back",   "arnm_deque_pop_back",   'l' },
+    { "deque_pop_front",  "arnm_deque_pop_front",  'l' },
+    { "deque_get",        "arnm_deque_at",         'l' },
+};
+
+static IrValue gen_collection_builtin(GenContext* ctx, AstCallExpr* call, size_t which,
+                                      IrValue* args) {
+    const char* symbol = collection_builtins[which].symbol;
+    char access = collection_builtins[which].access;
+    
+    /* Keys and indexes travel as int64_t */
+    size_t nargs = access == 's' ? call->arg_count - 1 : call->arg_count;
+    for (size_t i = 1; i < nargs; i++) args[i] = as_i64(args[i]);
+    
+    if (access == 'n') {
+        return ir_build_call(ctx->cur_fn, ctx->cur_block, symbol, NULL, 0, ir_type_ptr())->result;
+    }
+    if (access == 'b') {
+        IrValue found = ir_build_call(ctx->cur_fn, ctx->cur_block, symbol, args, nargs,
+                                      ir_type_i32())->result;
+        return ir_build_cmp(ctx->cur_fn, ctx->cur_block, IR_NE, found, ir_val_const_i32(0))->result;
+    }
+    
+    IrValue slot = ir_build_call(ctx->cur_fn, ctx->cur_block, symbol, args, nargs,
+                                 ir_type_ptr())->result;
+    if (access == 'l') {
+        return ir_build_load(ctx->cur_fn, ctx->cur_block, elem_type(call->common.sema_type),
+                             slot)->result;
+    }
+    IrValue val = args[nargs];
+    if (val.kind == VAL_CONST) val.type = elem_type(expr_sema_type(call->args[nargs]));
+    ir_build_store(ctx->cur_block, val, slot);
+    return (IrValue){ .kind = VAL_UNDEF };
+}
+
+/* len() of a collection asks the runtime; its length changes under mutation */
+static IrValue collection_len(GenContext* ctx, IrValue collection, Type* type) {
+    char name[32];
+    snprintf(name, sizeof(name), "arnm_%s_len", type_kind_name(type_resolve(type)->kind));
+    return ir_build_call(ctx->cur_fn, ctx->cur_block, my_strdup(name), &collection, 1,
+                         ir_type_i32())->result;
+}
+
+/* <vec>_<op>(...) builtins: the sema symbol's first parameter or result names the vector */
+static IrValue gen_vector_builtin(GenContext* ctx, AstCallExpr* call, const char* vec,
+                                  const char* op, IrValue* args) {
+    Type* scalar = type_resolve(call->common.sema_type);
+    IrType scalar_ty = lower_type(scalar, ir_type_i32());
+    
+    if (strcmp(op, "splat") == 0) return vec_call(ctx, vec, "splat", args, 1, ir_type_void());
+    if (strcmp(op, "get") == 0)   return vec_call(ctx, vec, "get", args, 2, scalar_ty);
+    if (strcmp(op, "set") == 0)   return vec_call(ctx, vec, "set", args, 3, ir_type_void());
+    if (strcmp(op, "shuffle") == 0) return vec_call(ctx, vec, "shuffle", args, 2, ir_type_void());
+    
+    /* sum / min / max */
+    int reduce = strcmp(op, "sum") == 0 ? 0 : strcmp(op, "min") == 0 ? 1 : 2;
+    IrValue reduce_args[2] = { args[0], ir_val_const_i32(reduce) /* ArnmVecReduce */ };
+    return vec_call(ctx, vec, "reduce", reduce_args, 2, scalar_ty);
+}
+
+static bool is_vector_builtin(AstIdentExpr* id, const char** vec, const char** op) {
+    static const char* const vecs[] = { "f32x8", "i32x8", "f64x4" };
+    static const char* const ops[] = { "splat", "get", "set", "sum", "min", "max", "shuffle" };
+    if (id->name_len < 7 || id->name[5] != '_') return false;
+    for (size_t v = 0; v < 3; v++) {
+        if (strncmp(id->name, vecs[v], 5) != 0) continue;
+        for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); o++) {
+            if (strlen(ops[o]) == id->name_len - 6 && strncmp(id->name + 6, ops[o], id->name_len - 6) == 0) {
+                *vec = vecs[v];
+                *op = ops[o];
+                return true;
+            }
+        }
+    }
+    return false;
+}
 
 static IrValue gen_call(GenContext* ctx, AstCallExpr* call) {
     if (call->callee->kind == AST_IDENT_EXPR) {
@@ -226,14 +634,50 @@ static IrValue gen_call(GenContext* ctx, AstCallExpr* call) {
            We assume the callee name IS the global symbol name.
            Indirect calls (function pointers) are not fully supported yet. */
            
-        /* Determine return type (void for print, i32 otherwise for now) */
-        IrType ret_type = ir_type_i32();
+        if (id->name_len == 3 && strncmp(id->name, "len", 3) == 0 && call->arg_count == 1) {
+            Type* type = expr_sema_type(call->args[0]);
+            IrValue len = type_is_collection(type) ? collection_len(ctx, args[0], type)
+                                                   : array_len(ctx, args[0], type);
+            free(args);
+            return len;
+        }
+        
+        for (size_t i = 0; i < sizeof(collection_builtins) / sizeof(collection_builtins[0]); i++) {
+            if (strlen(collection_builtins[i].name) == id->name_len &&
+                strncmp(id->name, collection_builtins[i].name, id->name_len) == 0) {
+                IrValue result = gen_collection_builtin(ctx, call, i, args);
+                free(args);
+                return result;
+            }
+        }
+        
+        const char* vec;
+        const char* vec_op;
+        if (is_vector_builtin(id, &vec, &vec_op)) {
+            IrValue result = gen_vector_builtin(ctx, call, vec, vec_op, args);
+            free(args);
+            return result;
+        }
+        
+        /* Determine return type (void for print, else from sema with an i32 fallback) */
+        IrType ret_type = lower_type(call->common.sema_type, ir_type_i32());
+        char* callee = NULL;
         if (id->name_len == 5 && strncmp(id->name, "print", 5) == 0) {
             ret_type = ir_type_void();
+            if (call->arg_count == 1 && args[0].type.kind == IR_F64) {
+                callee = my_strdup("arnm_print_f64");
+            }
+        }
+        for (size_t i = 0; i < sizeof(channel_builtins) / sizeof(channel_builtins[0]); i++) {
+            if (strlen(channel_builtins[i].name) == id->name_len &&
+                strncmp(id->name, channel_builtins[i].name, id->name_len) == 0) {
+                callee = my_strdup(channel_builtins[i].symbol);
+                ret_type = channel_builtins[i].ret();
+            }
         }
            
         IrInstr* inst = ir_build_call(ctx->cur_fn, ctx->cur_block, 
-                                      copy_name(id->name, id->name_len), 
+                                      callee ? callee : copy_name(id->name, id->name_len), 
                                       args, call->arg_count, ret_type);
                                       
         if (args) free(args);
@@ -261,8 +705,17 @@ static IrValue gen_expr(GenContext* ctx, AstExpr* expr) {
                     IrType type = ir_type_i32(); 
                     IrValue ptr = lookup_local(ctx, lhs->as.ident.name, lhs->as.ident.name_len, &type);
                     if (ptr.kind != VAL_UNDEF) {
-                        ir_build_store(ctx->cur_block, rhs_val, ptr);
+                        if (type.kind == IR_VEC) {
+                            vec_copy(ctx, ptr, rhs_val);
+                        } else {
+                            ir_build_store(ctx->cur_block, rhs_val, ptr);
+                        }
                     }
+                } else if (lhs->kind == AST_INDEX_EXPR && !lhs->as.index.is_slice) {
+                    IrValue val = rhs_val;
+                    if (val.kind == VAL_CONST) val.type = elem_type(lhs->as.index.common.sema_type);
+                    IrValue addr = gen_elem_addr(ctx, &lhs->as.index);
+                    ir_build_store(ctx->cur_block, val, addr);
                 } else if (lhs->kind == AST_FIELD_EXPR) {
                     /* Handle self.field = val OR struct.field = val */
                     IrValue obj_val = gen_expr(ctx, lhs->as.field.object);
@@ -326,6 +779,8 @@ static IrValue gen_expr(GenContext* ctx, AstExpr* expr) {
             return gen_binary(ctx, &expr->as.binary);
         }
         case AST_INT_LIT_EXPR: return ir_val_const_i32(expr->as.int_lit.value);
+        case AST_FLOAT_LIT_EXPR: return ir_val_const_f64(expr->as.float_lit.value);
+        case AST_UNARY_EXPR: return gen_unary(ctx, &expr->as.unary);
         case AST_BOOL_LIT_EXPR: return ir_val_const_bool(expr->as.bool_lit.value);
         case AST_STRING_LIT_EXPR: {
             /* Create a constant value with string pointer stored in constant.as.i */
@@ -338,6 +793,8 @@ static IrValue gen_expr(GenContext* ctx, AstExpr* expr) {
         }
         case AST_IDENT_EXPR: return gen_identifier(ctx, &expr->as.ident);
         case AST_CALL_EXPR: return gen_call(ctx, &expr->as.call);
+        case AST_INDEX_EXPR: return gen_index(ctx, &expr->as.index);
+        case AST_ARRAY_EXPR: return gen_array_literal(ctx, &expr->as.array);
         case AST_FIELD_EXPR: {
             IrValue obj = gen_expr(ctx, expr->as.field.object);
             Type* obj_type = NULL;
@@ -384,12 +841,7 @@ static IrValue gen_expr(GenContext* ctx, AstExpr* expr) {
                     IrInstr* fptr = ir_build_field_ptr(ctx->cur_fn, ctx->cur_block, base, index);
                     
                     /* Determine result type for load */
-                    IrType load_ty = ir_type_i32(); /* Default */
-                    /* Ideally convert expr->common.sema_type to IrType. 
-                       But current IRGen just uses i32/ptr. 
-                       If field type is pointer (actor, struct)? 
-                       We need type mapping. 
-                       For now, use i32 unless we know better. */
+                    IrType load_ty = lower_type(expr->as.field.common.sema_type, ir_type_i32());
                     
                     IrInstr* load = ir_build_load(ctx->cur_fn, ctx->cur_block, load_ty, fptr->result);
                     return load->result;
@@ -406,7 +858,7 @@ static IrValue gen_expr(GenContext* ctx, AstExpr* expr) {
             }
             
             if (target->kind == AST_CALL_EXPR) {
-                 return gen_spawn_call(ctx, &target->as.call);
+                 return gen_spawn_call(ctx, &target->as.call, expr->as.spawn_expr.joinable);
             }
             return (IrValue){ .kind = VAL_UNDEF };
         }
@@ -426,6 +878,180 @@ static IrValue gen_expr(GenContext* ctx, AstExpr* expr) {
 
 static void gen_block(GenContext* ctx, AstBlock* block);
 
+static bool block_terminated(IrBlock* block) {
+    return block->tail && (block->tail->op == IR_JMP ||
+                           block->tail->op == IR_BR ||
+                           block->tail->op == IR_RET);
+}
+
+/*
+ * parallel for / parallel reduce
+ *
+ * The body is outlined into "<fn>_par<N>"(lo, hi, frame), which runs one
+ * chunk of the range. Every local in scope is captured by address in a
+ * heap frame, so chunks read and write the enclosing variables directly.
+ * A reduce body folds into a private accumulator that the chunk returns;
+ * the runtime combines the partials and the result is folded into the
+ * outer accumulator.
+ */
+static void gen_parallel(GenContext* ctx, AstParallelStmt* par) {
+    IrValue lo = gen_expr(ctx, par->lo);
+    IrValue hi = gen_expr(ctx, par->hi);
+    lo.type = ir_type_i64();
+    hi.type = ir_type_i64();
+    
+    /* Capture everything visible except the names the body rebinds */
+    int captured[256];
+    int capture_count = 0;
+    for (int i = 0; i < ctx->local_count; i++) {
+        const char* name = ctx->locals[i].name;
+        size_t len = strlen(name);
+        if (len == par->var_name_len && strncmp(name, par->var_name, len) == 0) continue;
+        if (par->acc_name && len == par->acc_name_len &&
+            strncmp(name, par->acc_name, len) == 0) continue;
+        captured[capture_count++] = i;
+    }
+    
+    IrValue frame = ir_val_const_i32(0);
+    frame.type = ir_type_ptr();    /* null */
+    if (capture_count > 0) {
+        IrValue alloc_args[2];
+        alloc_args[0] = ir_val_const_i32(capture_count * 8);
+        alloc_args[0].type = ir_type_i64();
+        alloc_args[1] = ir_val_const_i32(0);
+        alloc_args[1].type = ir_type_ptr();
+        frame = ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_alloc",
+                              alloc_args, 2, ir_type_ptr())->result;
+        for (int j = 0; j < capture_count; j++) {
+            IrInstr* slot = ir_build_field_ptr(ctx->cur_fn, ctx->cur_block, frame, j);
+            IrValue addr = ctx->locals[captured[j]].val;
+            addr.type = ir_type_ptr();
+            ir_build_store(ctx->cur_block, addr, slot->result);
+        }
+    }
+    
+    /* Switch to the outlined function */
+    char name[256];
+    snprintf(name, sizeof(name), "%s_par%d", ctx->cur_fn->name, ctx->parallel_count++);
+    
+    IrFunction* parent_fn = ctx->cur_fn;
+    IrBlock* parent_block = ctx->cur_block;
+    IrBlock* parent_break = ctx->break_bb;
+    IrBlock* parent_continue = ctx->continue_bb;
+    const char* parent_restart = ctx->recv_restart;
+    int parent_count = ctx->local_count;
+    size_t saved_size = sizeof(GenLocal) * (size_t)parent_count;
+    GenLocal* parent_locals = malloc(saved_size ? saved_size : 1);
+    memcpy(parent_locals, ctx->locals, saved_size);
+    
+    bool reduce = par->acc_name != NULL;
+    IrType param_types[3] = { ir_type_i64(), ir_type_i64(), ir_type_ptr() };
+    IrFunction* body_fn = ir_function_create(ctx->mod, my_strdup(name),
+                                             reduce ? ir_type_i64() : ir_type_void(),
+                                             param_types, 3);
+    ctx->cur_fn = body_fn;
+    ctx->cur_block = ir_block_create(body_fn, "entry");
+    ctx->break_bb = NULL;
+    ctx->continue_bb = NULL;
+    ctx->recv_restart = NULL;
+    ctx->local_count = 0;
+    
+    IrInstr* index = ir_build_alloca(ctx->cur_fn, ctx->cur_block, ir_type_i64());
+    ir_build_store(ctx->cur_block, ir_val_var(0, ir_type_i64()), index->result);
+    add_local(ctx, par->var_name, par->var_name_len, index->result, ir_type_i64());
+    
+    IrInstr* acc = NULL;
+    if (reduce) {
+        IrValue identity = ir_val_const_i32(par->reduce_op == BINARY_MUL ? 1 : 0);
+        identity.type = ir_type_i64();
+        acc = ir_build_alloca(ctx->cur_fn, ctx->cur_block, ir_type_i64());
+        ir_build_store(ctx->cur_block, identity, acc->result);
+        add_local(ctx, par->acc_name, par->acc_name_len, acc->result, ir_type_i64());
+    }
+    
+    IrValue child_frame = ir_val_var(2, ir_type_ptr());
+    for (int j = 0; j < capture_count; j++) {
+        IrInstr* slot = ir_build_field_ptr(ctx->cur_fn, ctx->cur_block, child_frame, j);
+        IrInstr* addr = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_ptr(), slot->result);
+        GenLocal* outer = &parent_locals[captured[j]];
+        IrValue cap_addr = addr->result;
+        cap_addr.type = outer->val.type;
+        add_local(ctx, outer->name, (uint32_t)strlen(outer->name), cap_addr, outer->type);
+    }
+    
+    /* while (i < hi) { body; i = i + 1 } */
+    IrBlock* cond_bb = ir_block_create(ctx->cur_fn, "par.cond");
+    IrBlock* body_bb = ir_block_create(ctx->cur_fn, "par.body");
+    IrBlock* exit_bb = ir_block_create(ctx->cur_fn, "par.exit");
+    ir_build_jmp(ctx->cur_block, cond_bb);
+    
+    ctx->cur_block = cond_bb;
+    IrValue cur = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i64(), index->result)->result;
+    IrValue cmp = ir_build_cmp(ctx->cur_fn, ctx->cur_block, IR_LT, cur,
+                               ir_val_var(1, ir_type_i64()))->result;
+    ir_build_br(ctx->cur_block, cmp, body_bb, exit_bb);
+    
+    ctx->cur_block = body_bb;
+    gen_block(ctx, par->body);
+    if (!block_terminated(ctx->cur_block)) {
+        IrValue now = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i64(), index->result)->result;
+        IrValue one = ir_val_const_i32(1);
+        one.type = ir_type_i64();
+        IrValue next = ir_build_add(ctx->cur_fn, ctx->cur_block, now, one)->result;
+        ir_build_store(ctx->cur_block, next, index->result);
+        ir_build_jmp(ctx->cur_block, cond_bb);
+    }
+    
+    ctx->cur_block = exit_bb;
+    if (reduce) {
+        IrValue partial = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i64(), acc->result)->result;
+        ir_build_ret(ctx->cur_block, partial);
+    } else {
+        ir_build_ret_void(ctx->cur_block);
+    }
+    
+    /* Back to the enclosing function */
+    free_locals(ctx);
+    memcpy(ctx->locals, parent_locals, saved_size);
+    free(parent_locals);
+    ctx->local_count = parent_count;
+    ctx->cur_fn = parent_fn;
+    ctx->cur_block = parent_block;
+    ctx->break_bb = parent_break;
+    ctx->continue_bb = parent_continue;
+    ctx->recv_restart = parent_restart;
+    
+    IrValue args[5];
+    args[0] = lo;
+    args[1] = hi;
+    args[2].kind = VAL_GLOBAL;
+    args[2].storage.global.name = body_fn->name;
+    args[2].type = ir_type_ptr();
+    args[3] = frame;
+    if (reduce) {
+        args[4] = ir_val_const_i32(par->reduce_op == BINARY_MUL ? 1 : 0);  /* ArnmReduceOp */
+        args[4].type = ir_type_i32();
+        IrValue total = ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_parallel_reduce_op",
+                                      args, 5, ir_type_i64())->result;
+        
+        IrType outer_type;
+        IrValue outer = lookup_local(ctx, par->acc_name, par->acc_name_len, &outer_type);
+        if (outer.kind != VAL_UNDEF) {
+            IrValue old = ir_build_load(ctx->cur_fn, ctx->cur_block, outer_type, outer)->result;
+            IrInstr* folded = par->reduce_op == BINARY_MUL
+                ? ir_build_mul(ctx->cur_fn, ctx->cur_block, old, total)
+                : ir_build_add(ctx->cur_fn, ctx->cur_block, old, total);
+            ir_build_store(ctx->cur_block, folded->result, outer);
+        }
+    } else {
+        ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_parallel_for", args, 4, ir_type_void());
+    }
+    
+    if (capture_count > 0) {
+        ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_release", &frame, 1, ir_type_void());
+    }
+}
+
 static void gen_stmt(GenContext* ctx, AstStmt* stmt) {
     /* Contract: gen_stmt requires valid context and statement */
     IRGEN_REQUIRE_NOT_NULL(ctx, "context");
@@ -437,6 +1063,17 @@ static void gen_stmt(GenContext* ctx, AstStmt* stmt) {
         case AST_LET_STMT: {
             AstLetStmt* let = &stmt->as.let_stmt;
             IrValue init_val;
+            if (let->init && vector_name(expr_sema_type(let->init))) {
+                /* A fresh result becomes the local's slot; anything else is copied */
+                IrValue vec = gen_expr(ctx, let->init);
+                if (!vec_is_fresh(let->init)) {
+                    IrValue slot = vec_slot(ctx);
+                    vec_copy(ctx, slot, vec);
+                    vec = slot;
+                }
+                add_local(ctx, let->name, let->name_len, vec, ir_type_vec());
+                break;
+            }
             if (let->init) {
                 init_val = gen_expr(ctx, let->init);
             } else {
@@ -464,6 +1101,10 @@ static void gen_stmt(GenContext* ctx, AstStmt* stmt) {
             gen_expr(ctx, stmt->as.expr_stmt.expr);
             break;
         }
+        case AST_BLOCK:
+            /* A plain else { ... } */
+            gen_block(ctx, &stmt->as.block);
+            break;
         case AST_LOOP_STMT: {
             IrBlock* body_bb = ir_block_create(ctx->cur_fn, "loop.body");
             IrBlock* end_bb  = ir_block_create(ctx->cur_fn, "loop.end");
@@ -493,18 +1134,69 @@ static void gen_stmt(GenContext* ctx, AstStmt* stmt) {
             break;
         }
         case AST_FOR_STMT: {
-            fprintf(stderr, "Code generation for 'for' loops not yet implemented\n");
+            /*
+             * for x in a: a is evaluated once and its header never changes,
+             * so the length is read up front and elements need no check.
+             */
+            AstForStmt* f = &stmt->as.for_stmt;
+            Type* iter_type = expr_sema_type(f->iterable);
+            IrType slot_ty = elem_type(array_elem(iter_type));
+            IrValue arr = gen_expr(ctx, f->iterable);
+            IrValue len = array_len(ctx, arr, iter_type);
+            IrValue data = ir_build_array_data(ctx->cur_fn, ctx->cur_block, arr)->result;
+            IrValue counter = ir_build_alloca(ctx->cur_fn, ctx->cur_block, ir_type_i32())->result;
+            ir_build_store(ctx->cur_block, ir_val_const_i32(0), counter);
+            
+            IrBlock* cond_bb = ir_block_create(ctx->cur_fn, "for.cond");
+            IrBlock* body_bb = ir_block_create(ctx->cur_fn, "for.body");
+            IrBlock* step_bb = ir_block_create(ctx->cur_fn, "for.step");
+            IrBlock* exit_bb = ir_block_create(ctx->cur_fn, "for.exit");
+            ir_build_jmp(ctx->cur_block, cond_bb);
+            
+            ctx->cur_block = cond_bb;
+            IrValue i = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i32(), counter)->result;
+            IrValue more = ir_build_cmp(ctx->cur_fn, ctx->cur_block, IR_LT, i, len)->result;
+            ir_build_br(ctx->cur_block, more, body_bb, exit_bb);
+            
+            IrBlock* prev_break = ctx->break_bb;
+            IrBlock* prev_continue = ctx->continue_bb;
+            ctx->break_bb = exit_bb;
+            ctx->continue_bb = step_bb;
+            
+            ctx->cur_block = body_bb;
+            int mark = ctx->local_count;
+            i = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i32(), counter)->result;
+            IrValue addr = ir_build_elem_ptr(ctx->cur_fn, ctx->cur_block, data, i)->result;
+            IrValue elem = ir_build_load(ctx->cur_fn, ctx->cur_block, slot_ty, addr)->result;
+            IrInstr* var = ir_build_alloca(ctx->cur_fn, ctx->cur_block, slot_ty);
+            ir_build_store(ctx->cur_block, elem, var->result);
+            add_local(ctx, f->var_name, f->var_name_len, var->result, slot_ty);
+            gen_block(ctx, f->body);
+            pop_locals(ctx, mark);
+            if (!block_terminated(ctx->cur_block)) {
+                ir_build_jmp(ctx->cur_block, step_bb);
+            }
+            
+            ctx->cur_block = step_bb;
+            i = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i32(), counter)->result;
+            IrValue next = ir_build_add(ctx->cur_fn, ctx->cur_block, i, ir_val_const_i32(1))->result;
+            ir_build_store(ctx->cur_block, next, counter);
+            ir_build_jmp(ctx->cur_block, cond_bb);
+            
+            ctx->break_bb = prev_break;
+            ctx->continue_bb = prev_continue;
+            ctx->cur_block = exit_bb;
             break;
         }
         case AST_SPAWN_STMT: {
             AstSpawnStmt* spawn = &stmt->as.spawn_stmt;
             if (spawn->expr->kind == AST_CALL_EXPR) {
-                gen_spawn_call(ctx, &spawn->expr->as.call);
+                gen_spawn_call(ctx, &spawn->expr->as.call, false);
             } else if (spawn->expr->kind == AST_GROUP_EXPR) {
                 AstExpr* target = spawn->expr;
                 while (target->kind == AST_GROUP_EXPR) target = target->as.group.inner;
                 if (target->kind == AST_CALL_EXPR) {
-                    gen_spawn_call(ctx, &target->as.call);
+                    gen_spawn_call(ctx, &target->as.call, false);
                 }
             }
             break;
@@ -601,12 +1293,26 @@ static void gen_stmt(GenContext* ctx, AstStmt* stmt) {
         case AST_RECEIVE_STMT: {
             AstReceiveStmt* recv = &stmt->as.receive_stmt;
             
-            /* Call runtime: %msg = arnm_receive(null) */
-            /* Call runtime: %msg = arnm_receive(null) */
-            IrValue args[1];
-            args[0] = ir_val_const_i32(0); args[0].type = ir_type_ptr(); /* null */
+            /*
+             * Call runtime: %msg = arnm_receive(null), or at a behavior
+             * loop head %msg = arnm_receive_idle(@Actor_behavior) so an idle
+             * actor can drop its stack and restart there. Receives nested
+             * inside arms hold live locals and never qualify.
+             */
+            const char* restart = ctx->recv_restart;
+            ctx->recv_restart = NULL;
             
-            IrInstr* call = ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_receive", args, 1, ir_type_ptr());
+            IrValue args[1];
+            IrInstr* call;
+            if (restart) {
+                args[0].kind = VAL_GLOBAL;
+                args[0].storage.global.name = (char*)restart;
+                args[0].type = ir_type_ptr();
+                call = ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_receive_idle", args, 1, ir_type_ptr());
+            } else {
+                args[0] = ir_val_const_i32(0); args[0].type = ir_type_ptr(); /* null */
+                call = ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_receive", args, 1, ir_type_ptr());
+            }
             IrValue msg_val = call->result;
             
             /* Tag is at offset 0 in ArnmMessage */
@@ -614,6 +1320,10 @@ static void gen_stmt(GenContext* ctx, AstStmt* stmt) {
             IrInstr* load_tag = ir_build_load(ctx->cur_fn, ctx->cur_block, ir_type_i64(), field->result);
             IrValue tag_val = load_tag->result;
             
+            /* Patterns only look at the tag; release the message right away */
+            IrValue free_args[1] = { msg_val };
+            ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_message_free", free_args, 1, ir_type_void());
+            
             if (recv->arm_count == 0) {
                 /* No arms - nothing to match */
                 break;
@@ -697,6 +1407,95 @@ static void gen_stmt(GenContext* ctx, AstStmt* stmt) {
             
             break;
         }
+        case AST_SELECT_STMT: {
+            AstSelectStmt* sel = &stmt->as.select_stmt;
+            if (sel->arm_count == 0) break;
+            
+            /*
+             * %arm = arnm_select_recv4(c0, c1, c2, c3, has_mailbox) parks until
+             * one arm can run: channel arms are 0..3 in source order (unused
+             * slots null), the mailbox arm is 4, -1 means every channel was
+             * closed. %val = arnm_select_value() is the value or message tag.
+             */
+            IrValue args[SELECT_MAX_CHANNELS + 1];
+            int64_t arm_index[SELECT_MAX_CHANNELS + 1];
+            size_t channels = 0;
+            bool has_mailbox = false;
+            
+            for (size_t i = 0; i < sel->arm_count; i++) {
+                if (sel->arms[i].channel) {
+                    args[channels] = gen_expr(ctx, sel->arms[i].channel);
+                    arm_index[i] = (int64_t)channels++;
+                } else {
+                    has_mailbox = true;
+                    arm_index[i] = SELECT_MAX_CHANNELS;
+                }
+            }
+            for (size_t c = channels; c < SELECT_MAX_CHANNELS; c++) {
+                args[c] = ir_val_const_i32(0); args[c].type = ir_type_ptr(); /* null */
+            }
+            args[SELECT_MAX_CHANNELS] = ir_val_const_i32(has_mailbox ? 1 : 0);
+            args[SELECT_MAX_CHANNELS].type = ir_type_i64();
+            
+            IrInstr* call = ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_select_recv4",
+                                          args, SELECT_MAX_CHANNELS + 1, ir_type_i64());
+            IrValue arm_val = call->result;
+            IrInstr* value = ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_select_value",
+                                           NULL, 0, ir_type_i64());
+            IrValue sel_val = value->result;
+            
+            IrBlock* merge_bb = ir_block_create(ctx->cur_fn, "select.merge");
+            IrBlock** arm_blocks = malloc(sizeof(IrBlock*) * sel->arm_count);
+            for (size_t i = 0; i < sel->arm_count; i++) {
+                char label[32];
+                snprintf(label, sizeof(label), "select.arm%zu", i);
+                arm_blocks[i] = ir_block_create(ctx->cur_fn, my_strdup(label));
+            }
+            
+            /* Dispatch on the arm index; -1 (all closed) falls through to merge */
+            for (size_t i = 0; i < sel->arm_count; i++) {
+                IrValue expected = ir_val_const_i32((int32_t)arm_index[i]);
+                IrInstr* cmp = ir_build_cmp(ctx->cur_fn, ctx->cur_block, IR_EQ, arm_val, expected);
+                IrBlock* next_check = (i + 1 < sel->arm_count) ?
+                                      ir_block_create(ctx->cur_fn, "select.check") : merge_bb;
+                ir_build_br(ctx->cur_block, cmp->result, arm_blocks[i], next_check);
+                ctx->cur_block = next_check;
+            }
+            
+            for (size_t i = 0; i < sel->arm_count; i++) {
+                SelectArm* arm = &sel->arms[i];
+                ctx->cur_block = arm_blocks[i];
+                
+                IrInstr* alloca = ir_build_alloca(ctx->cur_fn, ctx->cur_block, ir_type_i64());
+                ir_build_store(ctx->cur_block, sel_val, alloca->result);
+                add_local(ctx, arm->binding, arm->binding_len, alloca->result, ir_type_i64());
+                
+                if (arm->body) {
+                    gen_block(ctx, arm->body);
+                }
+                
+                if (!ctx->cur_block->tail || 
+                    (ctx->cur_block->tail->op != IR_JMP && 
+                     ctx->cur_block->tail->op != IR_BR && 
+                     ctx->cur_block->tail->op != IR_RET)) {
+                    ir_build_jmp(ctx->cur_block, merge_bb);
+                }
+            }
+            
+            free(arm_blocks);
+            ctx->cur_block = merge_bb;
+            break;
+        }
+        case AST_PARALLEL_STMT:
+            gen_parallel(ctx, &stmt->as.parallel_stmt);
+            break;
+        case AST_AWAIT_STMT: {
+            /* arnm_join_proc parks until exit and releases the handle */
+            IrValue proc = gen_expr(ctx, stmt->as.await_stmt.process);
+            proc.type = ir_type_ptr();
+            ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_join_proc", &proc, 1, ir_type_i32());
+            break;
+        }
         case AST_BREAK_STMT: {
             /* Jump to break target (loop exit) */
             if (ctx->break_bb) {
@@ -716,9 +1515,11 @@ static void gen_stmt(GenContext* ctx, AstStmt* stmt) {
 }
 
 static void gen_block(GenContext* ctx, AstBlock* block) {
+    int mark = ctx->local_count;
     for (size_t i = 0; i < block->stmt_count; i++) {
         gen_stmt(ctx, block->stmts[i]);
     }
+    pop_locals(ctx, mark);
 }
 
 /* ============================================================
@@ -726,8 +1527,6 @@ static void gen_block(GenContext* ctx, AstBlock* block) {
  * ============================================================ */
 
 static void gen_func(GenContext* ctx, AstFnDecl* func, const char* override_name, const char* chain_call) {
-    IrType ret_type = func->return_type ? ir_type_i32() : ir_type_void();
-    
     char* fn_name;
     if (override_name) {
         fn_name = my_strdup(override_name);
@@ -735,17 +1534,28 @@ static void gen_func(GenContext* ctx, AstFnDecl* func, const char* override_name
         fn_name = copy_name(func->name, func->name_len);
     }
     
+    /* Parameter and return types as sema resolved them (i32 where it did not) */
+    Symbol* sym = symbol_lookup(&ctx->sema->symbols, fn_name, strlen(fn_name));
+    Type* fn_type = sym && sym->type ? type_resolve(sym->type) : NULL;
+    if (fn_type && (fn_type->kind != TYPE_FN || fn_type->as.fn.param_count != func->param_count)) {
+        fn_type = NULL;
+    }
+    
+    IrType ret_type = ir_type_void();
+    if (func->return_type) {
+        ret_type = lower_type(fn_type ? fn_type->as.fn.return_type : NULL, ir_type_i32());
+    }
+    
     /* Build param types array */
     IrType* param_types = NULL;
     if (func->param_count > 0) {
         param_types = malloc(sizeof(IrType) * func->param_count);
         for (size_t i = 0; i < func->param_count; i++) {
-             param_types[i] = ir_type_i32(); /* Default to i32 for now */
+             param_types[i] = lower_type(fn_type ? fn_type->as.fn.param_types[i] : NULL, ir_type_i32());
         }
     }
     
     IrFunction* ir_fn = ir_function_create(ctx->mod, fn_name, ret_type, param_types, func->param_count);
-    if (param_types) free(param_types);
     
     ctx->cur_fn = ir_fn;
     ctx->cur_block = ir_block_create(ir_fn, "entry");
@@ -754,11 +1564,19 @@ static void gen_func(GenContext* ctx, AstFnDecl* func, const char* override_name
     /* Process parameters: alloca and store arg values */
     for (size_t i = 0; i < func->param_count; i++) {
         FnParam* p = &func->params[i];
-        IrType ty = ir_type_i32(); /* Default */
+        IrType ty = param_types[i];
         
         /* 1. Create argument value */
         IrValue arg_val = ir_val_var(i, ty);
         
+        /* Vectors arrive by address; the callee takes its own copy */
+        if (fn_type && vector_name(fn_type->as.fn.param_types[i])) {
+            IrValue slot = vec_slot(ctx);
+            vec_copy(ctx, slot, arg_val);
+            add_local(ctx, p->name, p->name_len, slot, ir_type_vec());
+            continue;
+        }
+        
         /* 2. Alloca for the local variable */
         IrInstr* alloca = ir_build_alloca(ctx->cur_fn, ctx->cur_block, ty);
         
@@ -769,6 +1587,8 @@ static void gen_func(GenContext* ctx, AstFnDecl* func, const char* override_name
         add_local(ctx, p->name, p->name_len, alloca->result, ty);
     }
     
+    if (param_types) free(param_types);
+    
     if (func->body) {
         gen_block(ctx, func->body);
     }
@@ -787,7 +1607,7 @@ static void gen_func(GenContext* ctx, AstFnDecl* func, const char* override_name
 }
 
 
-static IrValue gen_spawn_call(GenContext* ctx, AstCallExpr* call) {
+static IrValue gen_spawn_call(GenContext* ctx, AstCallExpr* call, bool joinable) {
     char* target_name = NULL;
     size_t state_size = 0;
     
@@ -856,8 +1676,9 @@ static IrValue gen_spawn_call(GenContext* ctx, AstCallExpr* call) {
     args[2] = ir_val_const_i32((int)state_size); /* i32 is fine? Runtime uses size_t (i64) */
     args[2].type = ir_type_i64(); 
     
-    /* Call arnm_spawn(func, arg, size) */
-    IrInstr* inst = ir_build_call(ctx->cur_fn, ctx->cur_block, "arnm_spawn", args, 3, ir_type_ptr());
+    /* Call arnm_spawn(func, arg, size); an awaited handle must outlive the process */
+    const char* spawn_fn = joinable ? "arnm_spawn_joinable" : "arnm_spawn";
+    IrInstr* inst = ir_build_call(ctx->cur_fn, ctx->cur_block, spawn_fn, args, 3, ir_type_ptr());
     return inst->result;
 }
 
@@ -904,6 +1725,7 @@ static void gen_actor(GenContext* ctx, AstActorDecl* actor) {
         AstStmt stmt;
         stmt.kind = AST_RECEIVE_STMT;
         stmt.as.receive_stmt = *actor->receive_block;
+        ctx->recv_restart = ir_fn->name;
         gen_stmt(ctx, &stmt);
         
         /* Jump back to loop start */
@@ -927,7 +1749,7 @@ static void gen_actor(GenContext* ctx, AstActorDecl* actor) {
         
         const char* chain = NULL;
         if (IS_INIT(method) && actor->receive_block) {
-            chain = behavior_name;
+            chain = my_strdup(behavior_name);   /* The call outlives this frame */
         }
         
         gen_func(ctx, method, buffer, chain);
@@ -943,6 +1765,8 @@ bool ir_generate(SemaContext* ctx, AstProgram* program, IrModule* out_mod) {
     gen_ctx.cur_actor_type = NULL;
     gen_ctx.break_bb = NULL;
     gen_ctx.continue_bb = NULL;
+    gen_ctx.recv_restart = NULL;
+    gen_ctx.parallel_count = 0;
     gen_ctx.cur_block = NULL;
     gen_ctx.cur_actor_type = NULL;
     gen_ctx.local_count = 0;
@@ -26,6 +26,7 @@ typedef struct {
 
 static const KeywordEntry keywords[] = {
     {"actor",    TOK_ACTOR},
+    {"await",    TOK_AWAIT},
     {"break",    TOK_BREAK},
     {"const",    TOK_CONST},
     {"continue", TOK_CONTINUE},
@@ -41,8 +42,10 @@ static const KeywordEntry keywords[] = {
     {"match",    TOK_MATCH},
     {"mut",      TOK_MUT},
     {"nil",      TOK_NIL},
+    {"parallel", TOK_PARALLEL},
     {"receive",  TOK_RECEIVE},
     {"return",   TOK_RETURN},
+    {"select",   TOK_SELECT},
     {"self",     TOK_SELF},
     {"shared",   TOK_SHARED},
     {"spawn",    TOK_SPAWN},
@@ -102,6 +105,7 @@ const char* token_kind_name(TokenKind kind) {
         [TOK_CHAR_LIT]     = "CHAR_LIT",
         [TOK_FN]           = "fn",
         [TOK_ACTOR]        = "actor",
+        [TOK_AWAIT]        = "await",
         [TOK_LET]          = "let",
         [TOK_MUT]          = "mut",
         [TOK_CONST]        = "const",
@@ -116,6 +120,8 @@ const char* token_kind_name(TokenKind kind) {
         [TOK_RETURN]       = "return",
         [TOK_SPAWN]        = "spawn",
         [TOK_RECEIVE]      = "receive",
+        [TOK_SELECT]       = "select",
+        [TOK_PARALLEL]     = "parallel",
         [TOK_SELF]         = "self",
         [TOK_UNIQUE]       = "unique",
         [TOK_SHARED]       = "shared",
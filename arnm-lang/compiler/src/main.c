@@ -7,15 +7,23 @@
  *   --dump-tokens   Print token stream
  *   --dump-ast      Print AST structure
  *   --check         Run semantic analysis only
+ *   --backend=<b>   Build a native binary with the x86, llvm or c backend
+ *   -O<n>           Optimization level for the native build
+ *   -o <file>       Output binary
  *   --help          Show help
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "../include/lexer.h"
 #include "../include/parser.h"
 #include "../include/sema.h"
 #include "../include/irgen.h"
+#include "../include/opt.h"
 #include "../include/codegen.h"
 #include "../include/codegen_x86.h"
+#include "../include/codegen_c.h"
+#include "../include/codegen_wasm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -174,9 +182,23 @@ static void print_stmt(AstStmt* stmt, int depth) {
             printf("Spawn:\n");
             print_expr(stmt->as.spawn_stmt.expr, depth + 1);
             break;
+        case AST_AWAIT_STMT:
+            printf("Await:\n");
+            print_expr(stmt->as.await_stmt.process, depth + 1);
+            break;
         case AST_RECEIVE_STMT:
             printf("Receive: %zu arms\n", stmt->as.receive_stmt.arm_count);
             break;
+        case AST_SELECT_STMT:
+            printf("Select: %zu arms\n", stmt->as.select_stmt.arm_count);
+            break;
+        case AST_PARALLEL_STMT:
+            printf("Parallel %s: %.*s\n", stmt->as.parallel_stmt.acc_name ? "reduce" : "for",
+                   (int)stmt->as.parallel_stmt.var_name_len, stmt->as.parallel_stmt.var_name);
+            print_expr(stmt->as.parallel_stmt.lo, depth + 1);
+            print_expr(stmt->as.parallel_stmt.hi, depth + 1);
+            print_block(stmt->as.parallel_stmt.body, depth + 1);
+            break;
         case AST_EXPR_STMT:
             printf("ExprStmt:\n");
             print_expr(stmt->as.expr_stmt.expr, depth + 1);
@@ -249,6 +271,190 @@ static void print_tokens(const char* source, size_t len) {
     } while (tok.kind != TOK_EOF && tok.kind != TOK_ERROR);
 }
 
+/* ============================================================
+ * Native Build
+ * ============================================================ */
+
+typedef enum {
+    BACKEND_NONE,
+    BACKEND_X86,
+    BACKEND_LLVM,
+    BACKEND_C
+} Backend;
+
+static bool tool_exists(const char* tool) {
+    char cmd[256];
+    snprintf(cmd, sizeof(cmd), "command -v %s >/dev/null 2>&1", tool);
+    return system(cmd) == 0;
+}
+
+static bool run_command(const char* cmd) {
+    if (system(cmd) == 0) return true;
+    fprintf(stderr, "error: command failed: %s\n", cmd);
+    return false;
+}
+
+static bool file_exists(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    fclose(f);
+    return true;
+}
+
+/*
+ * LLVM 14 parses `ptr` only with -opaque-pointers; the flag was dropped
+ * once opaque pointers became the only mode. Probe instead of parsing
+ * version strings.
+ */
+static const char* opaque_flag(const char* probe) {
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "%s >/dev/null 2>&1", probe);
+    return system(cmd) == 0 ? " -opaque-pointers" : "";
+}
+
+/* Remove the first "name..." entry of a comma-separated pass list */
+static void drop_pass(char* passes, const char* name) {
+    char* at = strstr(passes, name);
+    if (!at) return;
+    char* end = strchr(at, ',');
+    if (end) memmove(at, end + 1, strlen(end + 1) + 1);
+    else if (at > passes) at[-1] = '\0';
+    else at[0] = '\0';
+}
+
+/*
+ * LLVM 14's loop access analysis asks an opaque pointer for its pointee
+ * type when it builds runtime alias checks and crashes, so any loop over
+ * two arrays that may overlap takes down opt. Ask opt for its -O<n>
+ * pipeline and drop the two passes that build those checks; the IR-level
+ * pass in opt.c has already removed the bounds checks they would matter for.
+ */
+static bool opaque_safe_pipeline(int opt_level, char* out, size_t cap) {
+    char cmd[256];
+    snprintf(cmd, sizeof(cmd),
+             "opt -opaque-pointers -O%d -print-pipeline-passes -disable-output /dev/null 2>/dev/null",
+             opt_level);
+    FILE* pipe = popen(cmd, "r");
+    if (!pipe) return false;
+    size_t n = fread(out, 1, cap - 1, pipe);
+    bool ok = pclose(pipe) == 0 && n > 0 && n < cap - 1;
+    out[n] = '\0';
+    while (n > 0 && (out[n - 1] == '\n' || out[n - 1] == '\r')) out[--n] = '\0';
+    if (!ok || strchr(out, '\'')) return false;
+    
+    drop_pass(out, "loop-vectorize");
+    drop_pass(out, "loop-load-elim");
+    return out[0] != '\0';
+}
+
+/*
+ * .ll -> .o through clang when present, otherwise opt + llc. A clang that
+ * needs -opaque-pointers gives way to opt, whose pipeline can be trimmed.
+ */
+static bool llvm_compile(const char* ll_path, const char* obj_path, int opt_level) {
+    char cmd[12288];
+    bool have_opt = tool_exists("opt") && tool_exists("llc");
+    const char* flag = tool_exists("clang")
+        ? opaque_flag("clang -Xclang -opaque-pointers -fsyntax-only -x c /dev/null") : NULL;
+    if (flag && !(flag[0] && have_opt)) {
+        snprintf(cmd, sizeof(cmd), "clang%s -O%d -fPIC -c -o '%s' '%s'",
+                 flag[0] ? " -Xclang -opaque-pointers" : "", opt_level, obj_path, ll_path);
+        return run_command(cmd);
+    }
+    if (!have_opt) {
+        fprintf(stderr, "error: the llvm backend needs clang, or opt and llc, on PATH\n");
+        return false;
+    }
+
+    flag = opaque_flag("opt -opaque-pointers -version");
+    char passes[4096];
+    if (flag[0] && opaque_safe_pipeline(opt_level, passes, sizeof(passes))) {
+        snprintf(cmd, sizeof(cmd), "opt%s -passes='%s' -o '%s.bc' '%s' && llc%s -O%d "
+                 "-relocation-model=pic -filetype=obj -o '%s' '%s.bc'",
+                 flag, passes, obj_path, ll_path, flag, opt_level, obj_path, obj_path);
+    } else {
+        snprintf(cmd, sizeof(cmd), "opt%s -O%d -o '%s.bc' '%s' && llc%s -O%d -relocation-model=pic "
+                 "-filetype=obj -o '%s' '%s.bc'",
+                 flag, opt_level, obj_path, ll_path, flag, opt_level, obj_path, obj_path);
+    }
+    bool ok = run_command(cmd);
+
+    snprintf(cmd, sizeof(cmd), "%s.bc", obj_path);
+    remove(cmd);
+    return ok;
+}
+
+/* Lower the module to an object, then link it with crt0 and libarnm */
+static bool build_native(IrModule* mod, Backend backend, int opt_level,
+                         const char* output, const char* argv0) {
+    /* The compiler lives in build/, next to crt0.o; the runtime in runtime/build */
+    char bin_dir[1024] = ".";
+    const char* slash = strrchr(argv0, '/');
+    if (slash) snprintf(bin_dir, sizeof(bin_dir), "%.*s", (int)(slash - argv0), argv0);
+
+    char crt0[1100], rt_dir[1100], rt_lib[1200], rt_inc[1200];
+    snprintf(crt0, sizeof(crt0), "%s/crt0.o", bin_dir);
+    const char* env_rt = getenv("ARNM_RUNTIME");
+    if (env_rt) snprintf(rt_dir, sizeof(rt_dir), "%s", env_rt);
+    else snprintf(rt_dir, sizeof(rt_dir), "%s/../runtime/build", bin_dir);
+    snprintf(rt_lib, sizeof(rt_lib), "%s/libarnm.a", rt_dir);
+    snprintf(rt_inc, sizeof(rt_inc), "%s/../include", rt_dir);
+
+    if (!file_exists(crt0) || !file_exists(rt_lib)) {
+        fprintf(stderr, "error: runtime not built (need %s and %s; run 'make native')\n", crt0, rt_lib);
+        return false;
+    }
+
+    char src_path[1100], obj_path[1100];
+    snprintf(src_path, sizeof(src_path), "%s%s", output,
+             backend == BACKEND_LLVM ? ".ll" : backend == BACKEND_C ? ".c" : ".s");
+    snprintf(obj_path, sizeof(obj_path), "%s.o", output);
+
+    FILE* src = fopen(src_path, "w");
+    if (!src) {
+        fprintf(stderr, "error: could not write '%s'\n", src_path);
+        return false;
+    }
+    if (backend == BACKEND_LLVM) codegen_emit(mod, src);
+    else if (backend == BACKEND_C) c_emit(mod, src);
+    else x86_emit(mod, src);
+    fclose(src);
+
+    char cmd[8192];
+    bool ok;
+    if (backend == BACKEND_LLVM) {
+        ok = llvm_compile(src_path, obj_path, opt_level);
+    } else if (backend == BACKEND_C) {
+        /* ARNM_CFLAGS passes extra flags through, e.g. -fprofile-generate / -fprofile-use */
+        const char* extra = getenv("ARNM_CFLAGS");
+        snprintf(cmd, sizeof(cmd), "cc -std=gnu11 -O%d%s -fwrapv -fno-strict-aliasing "
+                 "-Werror=implicit-function-declaration %s -I'%s' -c -o '%s' '%s'",
+                 opt_level, opt_level >= 2 ? " -march=native" : "", extra ? extra : "",
+                 rt_inc, obj_path, src_path);
+        ok = run_command(cmd);
+    } else {
+        snprintf(cmd, sizeof(cmd), "cc -c -o '%s' '%s'", obj_path, src_path);
+        ok = run_command(cmd);
+    }
+
+    /*
+     * The x86 backend's absolute addressing is not position independent;
+     * C flags such as -fprofile-generate also need their runtime linked.
+     */
+    if (ok) {
+        const char* extra = backend == BACKEND_C ? getenv("ARNM_CFLAGS") : NULL;
+        snprintf(cmd, sizeof(cmd), "cc%s %s -o '%s' '%s' '%s' -L'%s' -larnm -lpthread",
+                 backend == BACKEND_X86 ? " -no-pie" : "", extra ? extra : "",
+                 output, obj_path, crt0, rt_dir);
+        ok = run_command(cmd);
+    }
+
+    remove(src_path);
+    remove(obj_path);
+    if (ok) fprintf(stderr, "Built: %s\n", output);
+    return ok;
+}
+
 /* ============================================================
  * Main
  * ============================================================ */
@@ -262,6 +468,11 @@ static void print_usage(const char* program) {
     printf("  --emit-ir       Emit SSA Intermediate Representation\n");
     printf("  --emit-llvm     Emit LLVM IR (.ll)\n");
     printf("  --emit-asm      Emit x86_64 Assembly (.s)\n");
+    printf("  --emit-c        Emit portable C11 (.c)\n");
+    printf("  --emit-wasm     Write a WebAssembly module (<name>.wasm, or -o) for wasm/arnm_runtime.js\n");
+    printf("  --backend=<b>   Build a native binary with backend x86, llvm or c\n");
+    printf("  -O<n>           Optimization level 0-3 for the native build\n");
+    printf("  -o <file>       Output binary (default: source name without .arnm)\n");
     printf("  --help          Show this help\n");
 }
 
@@ -275,6 +486,9 @@ int main(int argc, char** argv) {
     bool dump_tokens = false;
     bool dump_ast = false;
     bool check_only = false;
+    Backend backend = BACKEND_NONE;
+    int opt_level = 0;
+    const char* output = NULL;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--help") == 0) {
@@ -292,6 +506,31 @@ int main(int argc, char** argv) {
              /* Handled later */
         } else if (strcmp(argv[i], "--emit-asm") == 0) {
              /* Handled later */
+        } else if (strcmp(argv[i], "--emit-c") == 0) {
+             /* Handled later */
+        } else if (strcmp(argv[i], "--emit-wasm") == 0) {
+             /* Handled later */
+        } else if (strncmp(argv[i], "--backend=", 10) == 0) {
+            const char* name = argv[i] + 10;
+            if (strcmp(name, "llvm") == 0) {
+                backend = BACKEND_LLVM;
+            } else if (strcmp(name, "x86") == 0) {
+                backend = BACKEND_X86;
+            } else if (strcmp(name, "c") == 0) {
+                backend = BACKEND_C;
+            } else {
+                fprintf(stderr, "error: unknown backend '%s' (expected x86, llvm or c)\n", name);
+                return 1;
+            }
+        } else if (argv[i][0] == '-' && argv[i][1] == 'O' && argv[i][2] >= '0' &&
+                   argv[i][2] <= '3' && argv[i][3] == '\0') {
+            opt_level = argv[i][2] - '0';
+        } else if (strcmp(argv[i], "-o") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "error: -o needs a file name\n");
+                return 1;
+            }
+            output = argv[++i];
         } else if (argv[i][0] != '-') {
             source_file = argv[i];
         } else {
@@ -385,10 +624,14 @@ int main(int argc, char** argv) {
     bool emit_ir = false;
     bool emit_llvm = false;
     bool emit_asm = false;
+    bool emit_c = false;
+    bool emit_wasm = false;
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--emit-ir") == 0) emit_ir = true;
         if (strcmp(argv[i], "--emit-llvm") == 0) emit_llvm = true;
         if (strcmp(argv[i], "--emit-asm") == 0) emit_asm = true;
+        if (strcmp(argv[i], "--emit-c") == 0) emit_c = true;
+        if (strcmp(argv[i], "--emit-wasm") == 0) emit_wasm = true;
     }
 
     IrModule ir_mod;
@@ -399,6 +642,7 @@ int main(int argc, char** argv) {
         free(source);
         return 1;
     }
+    ir_optimize(&ir_mod, opt_level);
 
     if (emit_ir) {
         fprintf(stderr, "\n--- ARNm IR ---\n");
@@ -416,6 +660,45 @@ int main(int argc, char** argv) {
         fprintf(stderr, "--- x86_64 Assembly ---\n");
         x86_emit(&ir_mod, stdout);
     }
+
+    if (emit_c) {
+        if (emit_ir || emit_llvm || emit_asm) fprintf(stderr, "\n");
+        fprintf(stderr, "--- C ---\n");
+        c_emit(&ir_mod, stdout);
+    }
+
+    int status = 0;
+    char default_out[1024];
+    if (!output) {
+        const char* base = strrchr(source_file, '/');
+        base = base ? base + 1 : source_file;
+        size_t len = strlen(base);
+        if (len > 5 && strcmp(base + len - 5, ".arnm") == 0) len -= 5;
+        snprintf(default_out, sizeof(default_out), "%.*s%s", (int)len, base, emit_wasm ? ".wasm" : "");
+    }
+
+    if (emit_wasm) {
+        /* A binary module, so always to a file; -o names it */
+        const char* path = output ? output : default_out;
+        FILE* f = fopen(path, "wb");
+        if (!f) {
+            fprintf(stderr, "error: could not write '%s'\n", path);
+            status = 1;
+        } else {
+            bool ok = wasm_emit(&ir_mod, f);
+            fclose(f);
+            if (ok) {
+                fprintf(stderr, "Built: %s\n", path);
+            } else {
+                remove(path);
+                status = 1;
+            }
+        }
+    } else if (backend != BACKEND_NONE || output) {
+        if (!output) output = default_out;
+        if (backend == BACKEND_NONE) backend = BACKEND_X86;
+        if (!build_native(&ir_mod, backend, opt_level, output, argv[0])) status = 1;
+    }
     
     ir_module_destroy(&ir_mod);
     
@@ -424,6 +707,6 @@ int main(int argc, char** argv) {
     ast_arena_destroy(&arena);
     free(source);
     
-    return 0;
+    return status;
 }
 
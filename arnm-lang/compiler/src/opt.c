@@ -0,0 +1,1252 @@
+/*
+ * ARNm Compiler - IR Optimization
+ *
+ * Bounds-check elimination by range analysis of loop counters. irgen
+ * lowers `while i < n { ... a[i] ... }` to a header block that loads i,
+ * compares it with n and branches into the body. When i lives in an
+ * alloca nothing else can reach, and every store to it is a non-negative
+ * constant or one more than a value read inside the loop, then a read of
+ * i that is only reached from the header's true edge, with no store in
+ * between, sees 0 <= i < n.
+ *
+ * A check of such a read against len(a) goes away outright when n is
+ * len(a) itself. When n is some other value fixed for the whole loop,
+ * the loop is versioned instead: the preheader tests n <= len(a) once
+ * and enters a copy of the loop without the checks, or the original,
+ * checked loop when the test fails, so out-of-range accesses still panic
+ * at the same iteration.
+ *
+ * From -O2, loops whose body is a straight line of blocks are reshaped
+ * after that: unrolled in full when the trip count is a small constant,
+ * else given a copy of the body four times over that runs while four
+ * more iterations fit, ahead of the original loop. At -O3, bodies that
+ * only map f64 elements at i to f64 elements at i get an f64x4 loop
+ * there instead, guarded by a runtime test that no written array
+ * overlaps another at an offset.
+ */
+
+#include "../include/opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Loops bigger than this are not worth duplicating */
+#define VERSION_MAX_INSTRS 512
+
+/* Full unrolling: at most this many iterations and instructions in all */
+#define UNROLL_FULL_MAX_TRIPS  16
+#define UNROLL_FULL_MAX_INSTRS 128
+
+/* Partial unrolling: bodies up to this size run UNROLL_FACTOR iterations per test */
+#define UNROLL_MAX_INSTRS      48
+#define UNROLL_FACTOR          4
+
+/* Vectorized loops: f64x4 lanes, and the arrays and stores one body may have */
+#define VECTOR_LANES           4
+#define VECTOR_MAX_ARRAYS      8
+#define VECTOR_MAX_STORES      16
+
+/* Blocks in a straight-line loop body */
+#define BODY_MAX_BLOCKS        8
+
+typedef struct {
+    IrFunction* fn;
+    int         block_count;
+    IrBlock**   blocks;         /* By block id */
+    int*        succs;          /* Two per block, -1 when absent */
+    int*        pred_start;     /* Preds of b: preds[pred_start[b] .. pred_start[b + 1]) */
+    int*        preds;
+    uint32_t    vreg_count;
+    IrInstr**   defs;           /* Defining instruction per vreg */
+    int*        def_block;      /* Its block id; -1 for parameters */
+    bool*       slots;          /* Allocas that are only loaded from and stored to */
+} FnInfo;
+
+typedef struct {
+    FnInfo*     info;
+    int         header;
+    int         body;           /* The header's true successor */
+    uint32_t    counter;        /* Alloca holding the loop counter */
+    IrValue     bound;          /* The header tests counter < bound */
+    bool*       in_loop;        /* By block id; includes the header */
+    bool*       stores_counter; /* By block id */
+} Loop;
+
+/* ============================================================
+ * Control Flow and Definitions
+ * ============================================================ */
+
+static bool is_terminator(IrOpcode op) {
+    return op == IR_RET || op == IR_BR || op == IR_JMP;
+}
+
+static IrInstr* block_terminator(IrBlock* blk) {
+    for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+        if (is_terminator(inst->op)) return inst;
+    }
+    return NULL;
+}
+
+/* Successor ids; a block without a terminator falls through in layout */
+static int successors(IrBlock* blk, int out[2]) {
+    IrInstr* term = block_terminator(blk);
+    int n = 0;
+    if (!term) {
+        if (blk->next) out[n++] = blk->next->id;
+    } else if (term->op == IR_JMP) {
+        if (term->target1) out[n++] = term->target1->id;
+    } else if (term->op == IR_BR) {
+        if (term->target1) out[n++] = term->target1->id;
+        if (term->target2) out[n++] = term->target2->id;
+    }
+    return n;
+}
+
+/* Operand k of inst: op1, op2, then the call arguments */
+static size_t operand_count(const IrInstr* inst) {
+    return 2 + inst->arg_count;
+}
+
+static IrValue* operand(IrInstr* inst, size_t k) {
+    if (k == 0) return &inst->op1;
+    if (k == 1) return &inst->op2;
+    return &inst->args[k - 2];
+}
+
+static bool is_var(IrValue v, uint32_t id) {
+    return v.kind == VAL_VAR && v.storage.id == id;
+}
+
+static bool is_store_to(const IrInstr* inst, uint32_t slot) {
+    return inst->op == IR_STORE && is_var(inst->op2, slot);
+}
+
+static void info_build(FnInfo* info, IrFunction* fn) {
+    int n = (int)fn->block_counter;
+    memset(info, 0, sizeof(*info));
+    info->fn = fn;
+    info->block_count = n;
+    info->blocks = calloc((size_t)n + 1, sizeof(IrBlock*));
+    info->succs = malloc(((size_t)n * 2 + 1) * sizeof(int));
+    info->pred_start = calloc((size_t)n + 2, sizeof(int));
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) info->blocks[blk->id] = blk;
+
+    /* Successors, then predecessors by counting sort */
+    for (int b = 0; b < n; b++) {
+        int succ[2] = { -1, -1 };
+        if (info->blocks[b]) successors(info->blocks[b], succ);
+        info->succs[b * 2] = succ[0];
+        info->succs[b * 2 + 1] = succ[1];
+        for (int k = 0; k < 2; k++) {
+            if (succ[k] >= 0) info->pred_start[succ[k] + 1]++;
+        }
+    }
+    for (int b = 0; b < n; b++) info->pred_start[b + 1] += info->pred_start[b];
+    info->preds = malloc(((size_t)info->pred_start[n] + 1) * sizeof(int));
+    int* fill = calloc((size_t)n + 1, sizeof(int));
+    for (int b = 0; b < n; b++) {
+        for (int k = 0; k < 2; k++) {
+            int s = info->succs[b * 2 + k];
+            if (s >= 0) info->preds[info->pred_start[s] + fill[s]++] = b;
+        }
+    }
+    free(fill);
+
+    info->vreg_count = fn->vreg_counter;
+    info->defs = calloc((size_t)info->vreg_count + 1, sizeof(IrInstr*));
+    info->def_block = malloc(((size_t)info->vreg_count + 1) * sizeof(int));
+    info->slots = calloc((size_t)info->vreg_count + 1, sizeof(bool));
+    for (uint32_t v = 0; v < info->vreg_count; v++) info->def_block[v] = -1;
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if (inst->result.kind != VAL_VAR) continue;
+            uint32_t id = inst->result.storage.id;
+            info->defs[id] = inst;
+            info->def_block[id] = blk->id;
+            info->slots[id] = inst->op == IR_ALLOCA;
+        }
+    }
+
+    /* An alloca whose address goes anywhere but a load or store may change behind our back */
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            for (size_t k = 0; k < operand_count(inst); k++) {
+                IrValue* v = operand(inst, k);
+                if (v->kind != VAL_VAR || v->storage.id >= info->vreg_count) continue;
+                bool addr_use = (inst->op == IR_LOAD && k == 0) ||
+                                (inst->op == IR_STORE && k == 1);
+                if (!addr_use) info->slots[v->storage.id] = false;
+            }
+        }
+    }
+}
+
+static void info_free(FnInfo* info) {
+    free(info->blocks);
+    free(info->succs);
+    free(info->pred_start);
+    free(info->preds);
+    free(info->defs);
+    free(info->def_block);
+    free(info->slots);
+}
+
+static IrInstr* def_of(FnInfo* info, IrValue v) {
+    if (v.kind != VAL_VAR || v.storage.id >= info->vreg_count) return NULL;
+    return info->defs[v.storage.id];
+}
+
+static int def_block_of(FnInfo* info, IrValue v) {
+    if (v.kind != VAL_VAR || v.storage.id >= info->vreg_count) return -1;
+    return info->def_block[v.storage.id];
+}
+
+/* ============================================================
+ * Loop Recognition
+ * ============================================================ */
+
+static void loop_free(Loop* loop) {
+    free(loop->in_loop);
+    free(loop->stores_counter);
+}
+
+/*
+ * The loop is every block on a path from the header's true successor
+ * back to the header. Returns false unless the header ends in
+ * `br (lt (load counter) bound)` and the body really does loop back.
+ */
+static bool loop_find(FnInfo* info, int header, Loop* loop) {
+    IrBlock* hb = info->blocks[header];
+    IrInstr* term = block_terminator(hb);
+    if (!term || term->op != IR_BR || !term->target1 || !term->target2 ||
+        term->target1 == term->target2 || term->target1 == hb) {
+        return false;
+    }
+    IrInstr* cmp = def_of(info, term->op1);
+    if (!cmp || cmp->op != IR_LT || def_block_of(info, term->op1) != header) return false;
+    IrInstr* load = def_of(info, cmp->op1);
+    if (!load || load->op != IR_LOAD || load->type.kind != IR_I32 ||
+        def_block_of(info, cmp->op1) != header || load->op1.kind != VAL_VAR ||
+        !info->slots[load->op1.storage.id]) {
+        return false;
+    }
+
+    int n = info->block_count;
+    memset(loop, 0, sizeof(*loop));
+    loop->info = info;
+    loop->header = header;
+    loop->body = term->target1->id;
+    loop->counter = load->op1.storage.id;
+    loop->bound = cmp->op2;
+
+    /* Forward from the body without re-entering the header ... */
+    bool* reach = calloc((size_t)n + 1, sizeof(bool));
+    int* work = malloc(((size_t)n + 1) * sizeof(int));
+    int top = 0;
+    reach[loop->body] = true;
+    work[top++] = loop->body;
+    while (top > 0) {
+        int b = work[--top];
+        for (int k = 0; k < 2; k++) {
+            int s = info->succs[b * 2 + k];
+            if (s >= 0 && s != header && !reach[s]) {
+                reach[s] = true;
+                work[top++] = s;
+            }
+        }
+    }
+
+    /* ... intersected with backward from the header */
+    loop->in_loop = calloc((size_t)n + 1, sizeof(bool));
+    loop->in_loop[header] = true;
+    work[top++] = header;
+    while (top > 0) {
+        int b = work[--top];
+        for (int p = info->pred_start[b]; p < info->pred_start[b + 1]; p++) {
+            int pred = info->preds[p];
+            if (reach[pred] && !loop->in_loop[pred]) {
+                loop->in_loop[pred] = true;
+                work[top++] = pred;
+            }
+        }
+    }
+    free(reach);
+    free(work);
+    if (!loop->in_loop[loop->body]) {
+        loop_free(loop);
+        return false;
+    }
+
+    loop->stores_counter = calloc((size_t)n + 1, sizeof(bool));
+    for (int b = 0; b < n; b++) {
+        if (!info->blocks[b]) continue;
+        for (IrInstr* inst = info->blocks[b]->head; inst; inst = inst->next) {
+            if (is_store_to(inst, loop->counter)) loop->stores_counter[b] = true;
+        }
+    }
+    if (loop->stores_counter[header]) {
+        loop_free(loop);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * True if load (a read of the counter) only sees values the header let
+ * through: every path to it enters the loop along the header's true
+ * edge and stores nothing to the counter on the way.
+ */
+static bool reads_in_range(Loop* loop, IrInstr* load) {
+    FnInfo* info = loop->info;
+    int start = def_block_of(info, load->result);
+    if (start < 0 || start == loop->header || !loop->in_loop[start]) return false;
+    for (IrInstr* inst = info->blocks[start]->head; inst && inst != load; inst = inst->next) {
+        if (is_store_to(inst, loop->counter)) return false;
+    }
+
+    int n = info->block_count;
+    bool* seen = calloc((size_t)n + 1, sizeof(bool));
+    int* work = malloc(((size_t)n + 1) * sizeof(int));
+    int top = 0;
+    bool ok = true;
+    seen[start] = true;
+    work[top++] = start;
+    while (ok && top > 0) {
+        int b = work[--top];
+        if (b == info->fn->entry->id) ok = false;
+        for (int p = info->pred_start[b]; ok && p < info->pred_start[b + 1]; p++) {
+            int pred = info->preds[p];
+            if (pred == loop->header) {
+                if (b != loop->body) ok = false;
+            } else if (!loop->in_loop[pred] || loop->stores_counter[pred]) {
+                ok = false;
+            } else if (!seen[pred]) {
+                seen[pred] = true;
+                work[top++] = pred;
+            }
+        }
+    }
+    free(seen);
+    free(work);
+    return ok;
+}
+
+static bool is_const_one(IrValue v) {
+    return v.kind == VAL_CONST && (int32_t)v.storage.constant.as.i == 1;
+}
+
+/*
+ * A read of the counter that the test of this loop, or of another loop
+ * over the same counter (such as a versioned copy), keeps below a bound.
+ */
+static bool read_is_bounded(Loop* loop, IrInstr* load) {
+    FnInfo* info = loop->info;
+    int b = def_block_of(info, load->result);
+    if (b < 0) return false;
+    if (loop->in_loop[b]) return reads_in_range(loop, load);
+    for (int h = 0; h < info->block_count; h++) {
+        Loop other;
+        if (h == loop->header || !info->blocks[h] || !loop_find(info, h, &other)) continue;
+        bool ok = other.counter == loop->counter && other.in_loop[b] && reads_in_range(&other, load);
+        loop_free(&other);
+        if (ok) return true;
+    }
+    return false;
+}
+
+/*
+ * The counter starts at a constant >= 0 and only ever steps by one from
+ * a read some loop test bounds, so it is never negative and never wraps.
+ */
+static bool counter_is_induction(Loop* loop) {
+    FnInfo* info = loop->info;
+    for (int b = 0; b < info->block_count; b++) {
+        if (!loop->stores_counter[b]) continue;
+        for (IrInstr* inst = info->blocks[b]->head; inst; inst = inst->next) {
+            if (!is_store_to(inst, loop->counter)) continue;
+            IrValue v = inst->op1;
+            if (v.kind == VAL_CONST) {
+                if ((int32_t)v.storage.constant.as.i < 0) return false;
+                continue;
+            }
+            IrInstr* add = def_of(info, v);
+            if (!add || add->op != IR_ADD) return false;
+            IrValue prev = is_const_one(add->op2) ? add->op1 :
+                           is_const_one(add->op1) ? add->op2 : v;
+            IrInstr* load = def_of(info, prev);
+            if (!load || load->op != IR_LOAD || !is_var(load->op1, loop->counter) ||
+                !read_is_bounded(loop, load)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* ============================================================
+ * Loop-Invariant Values
+ * ============================================================ */
+
+static bool slot_stored_in_loop(Loop* loop, uint32_t slot) {
+    FnInfo* info = loop->info;
+    for (int b = 0; b < info->block_count; b++) {
+        if (!loop->in_loop[b]) continue;
+        for (IrInstr* inst = info->blocks[b]->head; inst; inst = inst->next) {
+            if (is_store_to(inst, slot)) return true;
+        }
+    }
+    return false;
+}
+
+/* A load inside the loop from a slot declared outside it and never stored in it */
+static bool is_invariant_load(Loop* loop, IrInstr* load) {
+    FnInfo* info = loop->info;
+    if (load->op != IR_LOAD || load->op1.kind != VAL_VAR) return false;
+    uint32_t slot = load->op1.storage.id;
+    if (slot >= info->vreg_count || !info->slots[slot]) return false;
+    int slot_block = info->def_block[slot];
+    if (slot_block < 0 || loop->in_loop[slot_block]) return false;
+    return !slot_stored_in_loop(loop, slot);
+}
+
+/* v has one value for a whole run of the loop: defined before it, or a load or length of such */
+static bool is_invariant(Loop* loop, IrValue v) {
+    if (v.kind == VAL_CONST) return true;
+    if (v.kind != VAL_VAR) return false;
+    int b = def_block_of(loop->info, v);
+    if (b < 0 || !loop->in_loop[b]) return true;
+    IrInstr* def = def_of(loop->info, v);
+    if (def->op == IR_LOAD) return is_invariant_load(loop, def);
+    if (def->op == IR_ARRAY_LEN) return is_invariant(loop, def->op1);
+    return false;
+}
+
+/* a and b are equal wherever both are available inside one iteration */
+static bool same_value(Loop* loop, IrValue a, IrValue b) {
+    if (a.kind == VAL_CONST && b.kind == VAL_CONST) {
+        return (int32_t)a.storage.constant.as.i == (int32_t)b.storage.constant.as.i;
+    }
+    if (a.kind != VAL_VAR || b.kind != VAL_VAR) return false;
+    if (a.storage.id == b.storage.id) return true;
+    IrInstr* da = def_of(loop->info, a);
+    IrInstr* db = def_of(loop->info, b);
+    if (!da || !db || da->op != db->op) return false;
+    switch (da->op) {
+        case IR_ARRAY_LEN:
+            return same_value(loop, da->op1, db->op1);
+        case IR_LOAD:
+            return da->op1.kind == VAL_VAR && is_var(db->op1, da->op1.storage.id) &&
+                   loop->in_loop[def_block_of(loop->info, a)] &&
+                   loop->in_loop[def_block_of(loop->info, b)] &&
+                   is_invariant_load(loop, da);
+        default:
+            return false;
+    }
+}
+
+/* Recompute an invariant value at the end of block `at`, outside the loop */
+static IrValue materialize(Loop* loop, IrBlock* at, IrValue v) {
+    FnInfo* info = loop->info;
+    int b = def_block_of(info, v);
+    if (v.kind != VAL_VAR || b < 0 || !loop->in_loop[b]) return v;
+    IrInstr* def = def_of(info, v);
+    if (def->op == IR_LOAD) return ir_build_load(info->fn, at, def->type, def->op1)->result;
+    return ir_build_array_len(info->fn, at, materialize(loop, at, def->op1))->result;
+}
+
+/* ============================================================
+ * Loop Versioning
+ * ============================================================ */
+
+static bool in_list(IrInstr** list, size_t count, const IrInstr* inst) {
+    for (size_t i = 0; i < count; i++) {
+        if (list[i] == inst) return true;
+    }
+    return false;
+}
+
+static void rename_value(IrValue* v, const uint32_t* renamed, uint32_t limit) {
+    if (v->kind == VAL_VAR && v->storage.id < limit && renamed[v->storage.id]) {
+        v->storage.id = renamed[v->storage.id];
+    }
+}
+
+/* The loop's one predecessor outside it, or -1 */
+static int loop_preheader(Loop* loop) {
+    FnInfo* info = loop->info;
+    int pre = -1;
+    for (int p = info->pred_start[loop->header]; p < info->pred_start[loop->header + 1]; p++) {
+        int pred = info->preds[p];
+        if (loop->in_loop[pred]) continue;
+        if (pre >= 0 && pre != pred) return -1;
+        pre = pred;
+    }
+    return pre;
+}
+
+/*
+ * Single entry through the header from pre, and nothing computed in the
+ * loop used after it. Adds up the loop's instructions in *size.
+ */
+static bool loop_is_closed(Loop* loop, int pre, size_t* size) {
+    FnInfo* info = loop->info;
+    *size = 0;
+    for (int b = 0; b < info->block_count; b++) {
+        if (!info->blocks[b]) continue;
+        if (loop->in_loop[b]) {
+            for (int p = info->pred_start[b]; p < info->pred_start[b + 1]; p++) {
+                int pred = info->preds[p];
+                if (!loop->in_loop[pred] && !(b == loop->header && pred == pre)) return false;
+            }
+            for (IrInstr* inst = info->blocks[b]->head; inst; inst = inst->next) (*size)++;
+            continue;
+        }
+        for (IrInstr* inst = info->blocks[b]->head; inst; inst = inst->next) {
+            for (size_t k = 0; k < operand_count(inst); k++) {
+                int def = def_block_of(info, *operand(inst, k));
+                if (def >= 0 && loop->in_loop[def]) return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* Point the edges of from's terminator that lead to old at to instead */
+static void retarget(IrBlock* from, IrBlock* old, IrBlock* to) {
+    IrInstr* term = block_terminator(from);
+    if (term->target1 == old) term->target1 = to;
+    if (term->target2 == old) term->target2 = to;
+}
+
+/*
+ * Give the loop a checked and an unchecked copy. The preheader, the
+ * loop's only way in, tests bound <= len once for every len in checks
+ * and enters the copy without them when all hold. Returns the copy's
+ * header id, or -1 if the loop can't be versioned.
+ */
+static int version_loop(Loop* loop, IrInstr** checks, size_t check_count) {
+    FnInfo* info = loop->info;
+    IrFunction* fn = info->fn;
+
+    int pre = loop_preheader(loop);
+    if (pre < 0) return -1;
+    IrInstr* jmp = block_terminator(info->blocks[pre]);
+    if (!jmp || jmp->op != IR_JMP) return -1;
+
+    /* Small enough to copy */
+    size_t size;
+    if (!loop_is_closed(loop, pre, &size) || size > VERSION_MAX_INSTRS) return -1;
+
+    /* New blocks and registers for the copy, appended after the function */
+    IrBlock** copy = calloc((size_t)info->block_count + 1, sizeof(IrBlock*));
+    uint32_t limit = info->vreg_count;
+    uint32_t* renamed = calloc((size_t)limit + 1, sizeof(uint32_t));
+    IrBlock* last = fn->blocks_tail;
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        if (loop->in_loop[blk->id]) copy[blk->id] = ir_block_create(fn, blk->label);
+        for (IrInstr* inst = blk->head; loop->in_loop[blk->id] && inst; inst = inst->next) {
+            if (inst->result.kind == VAL_VAR) renamed[inst->result.storage.id] = fn->vreg_counter++;
+            if (is_terminator(inst->op)) break;
+        }
+        if (blk == last) break;
+    }
+
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        IrBlock* dst = loop->in_loop[blk->id] ? copy[blk->id] : NULL;
+        bool terminated = false;
+        for (IrInstr* inst = blk->head; dst && inst; inst = inst->next) {
+            if (in_list(checks, check_count, inst)) continue;
+            IrInstr* c = ir_instr_copy(dst, inst);
+            rename_value(&c->result, renamed, limit);
+            for (size_t k = 0; k < operand_count(c); k++) rename_value(operand(c, k), renamed, limit);
+            if (c->target1 && loop->in_loop[c->target1->id]) c->target1 = copy[c->target1->id];
+            if (c->target2 && loop->in_loop[c->target2->id]) c->target2 = copy[c->target2->id];
+            if (is_terminator(inst->op)) {
+                terminated = true;
+                break;
+            }
+        }
+        if (dst && !terminated && blk->next) {
+            IrBlock* next = blk->next;
+            ir_build_jmp(dst, loop->in_loop[next->id] ? copy[next->id] : next);
+        }
+        if (blk == last) break;
+    }
+
+    /* The preheader's jump becomes the one-time test */
+    IrBlock* pb = info->blocks[pre];
+    while (pb->tail != jmp) ir_instr_remove(pb, pb->tail);
+    ir_instr_remove(pb, jmp);
+    IrValue bound = materialize(loop, pb, loop->bound);
+    IrValue cond = ir_val_const_bool(true);
+    for (size_t i = 0; i < check_count; i++) {
+        bool repeated = false;
+        for (size_t j = 0; j < i && !repeated; j++) {
+            repeated = same_value(loop, checks[i]->op2, checks[j]->op2);
+        }
+        if (repeated) continue;
+        IrValue len = materialize(loop, pb, checks[i]->op2);
+        IrValue fits = ir_build_cmp(fn, pb, IR_LE, bound, len)->result;
+        cond = cond.kind == VAL_CONST ? fits : ir_build_and(fn, pb, cond, fits)->result;
+    }
+    int fast = copy[loop->header]->id;
+    ir_build_br(pb, cond, copy[loop->header], info->blocks[loop->header]);
+
+    free(copy);
+    free(renamed);
+    return fast;
+}
+
+/* ============================================================
+ * Bounds-Check Elimination
+ * ============================================================ */
+
+/*
+ * Drop the checks the header's test already covers and collect those
+ * that a one-time test could cover. Returns the id of a new unchecked
+ * copy of the loop, or -1 if the loop was left in one piece.
+ */
+static int eliminate_checks(Loop* loop) {
+    FnInfo* info = loop->info;
+    if (!counter_is_induction(loop)) return -1;
+
+    bool bound_invariant = is_invariant(loop, loop->bound);
+    size_t count = 0, cap = 8;
+    IrInstr** deferred = malloc(cap * sizeof(IrInstr*));
+    for (int b = 0; b < info->block_count; b++) {
+        if (!loop->in_loop[b] || b == loop->header) continue;
+        IrBlock* blk = info->blocks[b];
+        IrInstr* next;
+        for (IrInstr* inst = blk->head; inst; inst = next) {
+            next = inst->next;
+            if (inst->op != IR_BOUNDS_CHECK) continue;
+            IrInstr* index = def_of(info, inst->op1);
+            if (!index || index->op != IR_LOAD || !is_var(index->op1, loop->counter) ||
+                !reads_in_range(loop, index)) {
+                continue;
+            }
+            if (same_value(loop, loop->bound, inst->op2)) {
+                ir_instr_remove(blk, inst);
+            } else if (bound_invariant && is_invariant(loop, inst->op2)) {
+                if (count == cap) deferred = realloc(deferred, (cap *= 2) * sizeof(IrInstr*));
+                deferred[count++] = inst;
+            }
+        }
+    }
+
+    int fast = count > 0 ? version_loop(loop, deferred, count) : -1;
+    free(deferred);
+    return fast;
+}
+
+/* The removed checks were often the only users of an array_len and the load feeding it */
+static void remove_dead_lengths(IrFunction* fn) {
+    uint32_t count = fn->vreg_counter;
+    uint32_t* uses = calloc((size_t)count + 1, sizeof(uint32_t));
+    bool* allocas = calloc((size_t)count + 1, sizeof(bool));
+    for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+        for (IrInstr* inst = blk->head; inst; inst = inst->next) {
+            if (inst->op == IR_ALLOCA && inst->result.kind == VAL_VAR) {
+                allocas[inst->result.storage.id] = true;
+            }
+            for (size_t k = 0; k < operand_count(inst); k++) {
+                IrValue* v = operand(inst, k);
+                if (v->kind == VAL_VAR && v->storage.id < count) uses[v->storage.id]++;
+            }
+        }
+    }
+
+    /* Lengths first, so the loads they read become dead too */
+    for (int pass = 0; pass < 2; pass++) {
+        for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+            IrInstr* next;
+            for (IrInstr* inst = blk->head; inst; inst = next) {
+                next = inst->next;
+                bool dead = inst->result.kind == VAL_VAR && uses[inst->result.storage.id] == 0 &&
+                            (pass == 0 ? inst->op == IR_ARRAY_LEN
+                                       : inst->op == IR_LOAD && inst->op1.kind == VAL_VAR &&
+                                         allocas[inst->op1.storage.id]);
+                if (!dead) continue;
+                if (inst->op1.kind == VAL_VAR && inst->op1.storage.id < count) {
+                    uses[inst->op1.storage.id]--;
+                }
+                ir_instr_remove(blk, inst);
+            }
+        }
+    }
+    free(uses);
+    free(allocas);
+}
+
+/* ============================================================
+ * Straight-Line Loops
+ * ============================================================ */
+
+/* Running it more or fewer times, or not at all, is unobservable */
+static bool is_pure(IrOpcode op) {
+    switch (op) {
+        case IR_LOAD: case IR_ARRAY_LEN: case IR_ARRAY_DATA: case IR_ELEM_PTR: case IR_FIELD_PTR:
+        case IR_ADD: case IR_SUB: case IR_MUL:
+        case IR_EQ: case IR_NE: case IR_LT: case IR_LE: case IR_GT: case IR_GE:
+        case IR_AND: case IR_OR: case IR_MOV:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * A loop whose body has no branches: a chain of blocks from the header's
+ * true edge back to the header. Its instructions can be copied one
+ * after another into a single block.
+ */
+typedef struct {
+    Loop*   loop;
+    int     blocks[BODY_MAX_BLOCKS];
+    int     count;
+    size_t  size;           /* Instructions, not counting jumps */
+    int     pre;            /* The loop's preheader */
+    int     exit;           /* The header's false successor */
+} Body;
+
+/*
+ * The header only computes its test, the body is a chain that adds to
+ * the counter once and uses nothing the header computed, and the loop
+ * has a preheader ending in a jump or branch.
+ */
+static bool body_find(Loop* loop, Body* body) {
+    FnInfo* info = loop->info;
+    IrBlock* hb = info->blocks[loop->header];
+    IrInstr* term = block_terminator(hb);
+    for (IrInstr* inst = hb->head; inst != term; inst = inst->next) {
+        if (!is_pure(inst->op)) return false;
+    }
+
+    memset(body, 0, sizeof(*body));
+    body->loop = loop;
+    body->exit = term->target2->id;
+    body->pre = loop_preheader(loop);
+    size_t size;
+    if (body->pre < 0 || !block_terminator(info->blocks[body->pre]) ||
+        !loop_is_closed(loop, body->pre, &size)) {
+        return false;
+    }
+
+    IrInstr* step = NULL;
+    for (int b = loop->body; b != loop->header; ) {
+        int succ[2];
+        if (body->count == BODY_MAX_BLOCKS || successors(info->blocks[b], succ) != 1 ||
+            info->pred_start[b + 1] - info->pred_start[b] != 1) {
+            return false;
+        }
+        body->blocks[body->count++] = b;
+        for (IrInstr* inst = info->blocks[b]->head; inst; inst = inst->next) {
+            if (is_terminator(inst->op)) break;
+            body->size++;
+            if (is_store_to(inst, loop->counter)) {
+                if (step) return false;
+                step = inst;
+            }
+            for (size_t k = 0; k < operand_count(inst); k++) {
+                if (def_block_of(info, *operand(inst, k)) == loop->header) return false;
+            }
+        }
+        b = succ[0];
+    }
+
+    /* Each iteration adds one to the counter */
+    IrInstr* add = step ? def_of(info, step->op1) : NULL;
+    return add && add->op == IR_ADD;
+}
+
+/* Append one iteration of the body to dst, with registers of its own */
+static void copy_body(Body* body, IrBlock* dst, uint32_t* renamed) {
+    FnInfo* info = body->loop->info;
+    uint32_t limit = info->vreg_count;
+    memset(renamed, 0, ((size_t)limit + 1) * sizeof(uint32_t));
+    for (int i = 0; i < body->count; i++) {
+        for (IrInstr* inst = info->blocks[body->blocks[i]]->head; inst; inst = inst->next) {
+            if (is_terminator(inst->op)) break;
+            IrInstr* c = ir_instr_copy(dst, inst);
+            for (size_t k = 0; k < operand_count(c); k++) rename_value(operand(c, k), renamed, limit);
+            if (c->result.kind == VAL_VAR && c->result.storage.id < limit) {
+                renamed[c->result.storage.id] = info->fn->vreg_counter++;
+                c->result.storage.id = renamed[c->result.storage.id];
+            }
+        }
+    }
+}
+
+/*
+ * Test at the end of `at` that the next `count` iterations all pass the
+ * header: i < bound and i < bound - (count - 1). The second wraps only
+ * for a bound so negative that the first fails, as the counter is never
+ * negative.
+ */
+static IrValue wide_test(Loop* loop, IrBlock* at, IrValue bound, int count) {
+    IrFunction* fn = loop->info->fn;
+    IrValue i = ir_build_load(fn, at, ir_type_i32(), ir_val_var(loop->counter, ir_type_ptr()))->result;
+    IrValue last = ir_build_sub(fn, at, bound, ir_val_const_i32(count - 1))->result;
+    return ir_build_and(fn, at, ir_build_cmp(fn, at, IR_LT, i, bound)->result,
+                        ir_build_cmp(fn, at, IR_LT, i, last)->result)->result;
+}
+
+/* ============================================================
+ * Loop Unrolling
+ * ============================================================ */
+
+/*
+ * A loop from a constant to a constant becomes its iterations in a row.
+ * The header and body are deleted. Returns false if the loop is too big.
+ */
+static bool unroll_fully(Body* body) {
+    Loop* loop = body->loop;
+    FnInfo* info = loop->info;
+    IrFunction* fn = info->fn;
+    if (loop->bound.kind != VAL_CONST) return false;
+
+    IrBlock* pb = info->blocks[body->pre];
+    IrInstr* init = NULL;
+    for (IrInstr* inst = pb->tail; inst && !init; inst = inst->prev) {
+        if (is_store_to(inst, loop->counter)) init = inst;
+    }
+    if (!init || init->op1.kind != VAL_CONST) return false;
+    int64_t trips = (int64_t)(int32_t)loop->bound.storage.constant.as.i -
+                    (int32_t)init->op1.storage.constant.as.i;
+    if (trips < 0) trips = 0;
+    if (trips > UNROLL_FULL_MAX_TRIPS || (size_t)trips * body->size > UNROLL_FULL_MAX_INSTRS) {
+        return false;
+    }
+
+    IrBlock* unrolled = ir_block_create(fn, "unroll.body");
+    uint32_t* renamed = malloc(((size_t)info->vreg_count + 1) * sizeof(uint32_t));
+    for (int64_t t = 0; t < trips; t++) copy_body(body, unrolled, renamed);
+    free(renamed);
+    ir_build_jmp(unrolled, info->blocks[body->exit]);
+    retarget(pb, info->blocks[loop->header], unrolled);
+
+    ir_block_remove(fn, info->blocks[loop->header]);
+    for (int i = 0; i < body->count; i++) ir_block_remove(fn, info->blocks[body->blocks[i]]);
+    return true;
+}
+
+/*
+ * Run UNROLL_FACTOR iterations per test while that many are left, then
+ * let the original loop finish. Returns the new loop's header id, or -1.
+ */
+static int unroll_partially(Body* body) {
+    Loop* loop = body->loop;
+    FnInfo* info = loop->info;
+    IrFunction* fn = info->fn;
+    if (body->size > UNROLL_MAX_INSTRS || !is_invariant(loop, loop->bound)) return -1;
+
+    IrBlock* hb = info->blocks[loop->header];
+    IrBlock* cond = ir_block_create(fn, "unroll.cond");
+    IrBlock* unrolled = ir_block_create(fn, "unroll.body");
+    IrValue bound = materialize(loop, cond, loop->bound);
+    ir_build_br(cond, wide_test(loop, cond, bound, UNROLL_FACTOR), unrolled, hb);
+
+    uint32_t* renamed = malloc(((size_t)info->vreg_count + 1) * sizeof(uint32_t));
+    for (int t = 0; t < UNROLL_FACTOR; t++) copy_body(body, unrolled, renamed);
+    free(renamed);
+    ir_build_jmp(unrolled, cond);
+    retarget(info->blocks[body->pre], hb, cond);
+    return cond->id;
+}
+
+/* ============================================================
+ * Vectorization
+ * ============================================================ */
+
+/* What a body register holds, lane by lane, in a loop being vectorized */
+typedef enum {
+    LANE_NONE,
+    LANE_INDEX,     /* The counter: lane k is i + k */
+    LANE_ARRAY,     /* An array header fixed for the whole loop */
+    LANE_DATA,      /* Its data pointer */
+    LANE_ADDR,      /* &a[i + k] */
+    LANE_ELEM,      /* a[i + k], an f64 */
+    LANE_SCALAR,    /* One f64 in every lane */
+    LANE_OP,        /* f64 arithmetic, lane by lane */
+} LaneKind;
+
+typedef struct {
+    uint32_t    key;        /* Loads of one slot read the same array */
+    IrValue     header;     /* As read in or before the loop */
+    bool        written;
+    IrValue     data;       /* Data pointer, computed before the vector loop */
+    IrValue     addr;       /* &a[i] in the vector body */
+} LaneArray;
+
+typedef struct {
+    Body*       body;
+    LaneKind*   kinds;      /* By vreg, for registers defined in the body */
+    int*        array_of;   /* By vreg: the array a LANE_ARRAY..LANE_ELEM refers to */
+    int*        epoch;      /* By vreg: element stores before a LANE_ELEM was loaded */
+    uint32_t*   uses;       /* By vreg, inside the body */
+    LaneArray   arrays[VECTOR_MAX_ARRAYS];
+    int         array_count;
+    IrInstr*    stores[VECTOR_MAX_STORES];
+    int         store_count;
+    IrBlock*    pre;        /* Where splats and temporaries go */
+} Vectorizer;
+
+static bool is_lanes(LaneKind kind) {
+    return kind == LANE_ELEM || kind == LANE_SCALAR || kind == LANE_OP;
+}
+
+static int add_array(Vectorizer* vz, IrValue header) {
+    FnInfo* info = vz->body->loop->info;
+    IrInstr* def = def_of(info, header);
+    uint32_t key = def && def->op == IR_LOAD && def->op1.kind == VAL_VAR ? def->op1.storage.id
+                                                                         : header.storage.id;
+    for (int k = 0; k < vz->array_count; k++) {
+        if (vz->arrays[k].key == key) return k;
+    }
+    if (vz->array_count == VECTOR_MAX_ARRAYS) return -1;
+    LaneArray* arr = &vz->arrays[vz->array_count];
+    memset(arr, 0, sizeof(*arr));
+    arr->key = key;
+    arr->header = header;
+    return vz->array_count++;
+}
+
+/*
+ * Kind of an operand. Body registers have been classified already;
+ * values from before the loop are f64 scalars, data pointers or arrays.
+ */
+static LaneKind lane_of(Vectorizer* vz, IrValue v, int* array) {
+    FnInfo* info = vz->body->loop->info;
+    if (v.kind == VAL_CONST) return v.type.kind == IR_F64 ? LANE_SCALAR : LANE_NONE;
+    if (v.kind != VAL_VAR || v.storage.id >= info->vreg_count) return LANE_NONE;
+    int b = def_block_of(info, v);
+    if (b >= 0 && vz->body->loop->in_loop[b]) {
+        if (array) *array = vz->array_of[v.storage.id];
+        return vz->kinds[v.storage.id];
+    }
+    if (v.type.kind == IR_F64) return LANE_SCALAR;
+    if (v.type.kind != IR_PTR) return LANE_NONE;
+    IrInstr* def = def_of(info, v);
+    bool data = def && def->op == IR_ARRAY_DATA;
+    int k = add_array(vz, data ? def->op1 : v);
+    if (array) *array = k;
+    return k < 0 ? LANE_NONE : data ? LANE_DATA : LANE_ARRAY;
+}
+
+/* Every element tree v reads was loaded after the last element store, as the vector loop reads it */
+static bool reads_current(Vectorizer* vz, IrValue v) {
+    LaneKind kind = lane_of(vz, v, NULL);
+    if (kind == LANE_ELEM) return vz->epoch[v.storage.id] == vz->store_count;
+    if (kind != LANE_OP) return true;
+    IrInstr* def = def_of(vz->body->loop->info, v);
+    return vz->uses[v.storage.id] == 1 && reads_current(vz, def->op1) && reads_current(vz, def->op2);
+}
+
+/*
+ * Give every instruction of the body a lane kind. The body may only
+ * compute f64 element-wise results from a[i], and scalars fixed for the
+ * loop, and store them to b[i]. Then the counter steps by one.
+ */
+static bool lanes_classify(Vectorizer* vz) {
+    Loop* loop = vz->body->loop;
+    FnInfo* info = loop->info;
+    IrBlock* blk = info->blocks[vz->body->blocks[0]];
+    IrInstr* term = block_terminator(blk);
+    IrInstr* step = term ? term->prev : NULL;
+    if (!step || !is_store_to(step, loop->counter)) return false;
+    IrInstr* add = def_of(info, step->op1);
+
+    for (IrInstr* inst = blk->head; inst != step; inst = inst->next) {
+        for (size_t k = 0; k < operand_count(inst); k++) {
+            IrValue* v = operand(inst, k);
+            if (v->kind == VAL_VAR && v->storage.id < info->vreg_count) vz->uses[v->storage.id]++;
+        }
+    }
+    if (add->result.kind != VAL_VAR || vz->uses[add->result.storage.id] != 0) return false;
+
+    for (IrInstr* inst = blk->head; inst != step; inst = inst->next) {
+        if (inst == add) continue;
+        LaneKind kind = LANE_NONE;
+        int arr = -1;
+        switch (inst->op) {
+            case IR_LOAD:
+                /* Slots before addresses: lane_of would take a slot for an array */
+                if (is_var(inst->op1, loop->counter)) {
+                    kind = LANE_INDEX;
+                } else if (is_invariant_load(loop, inst)) {
+                    if (inst->type.kind == IR_F64) kind = LANE_SCALAR;
+                    if (inst->type.kind == IR_PTR && (arr = add_array(vz, inst->result)) >= 0) {
+                        kind = LANE_ARRAY;
+                    }
+                } else if (lane_of(vz, inst->op1, &arr) == LANE_ADDR) {
+                    if (inst->type.kind == IR_F64) kind = LANE_ELEM;
+                }
+                break;
+            case IR_ARRAY_DATA:
+                if (lane_of(vz, inst->op1, &arr) == LANE_ARRAY) kind = LANE_DATA;
+                break;
+            case IR_ELEM_PTR:
+                if (lane_of(vz, inst->op1, &arr) == LANE_DATA &&
+                    lane_of(vz, inst->op2, NULL) == LANE_INDEX) {
+                    kind = LANE_ADDR;
+                }
+                break;
+            case IR_ADD: case IR_SUB: case IR_MUL: case IR_DIV:
+                if (inst->type.kind == IR_F64 && is_lanes(lane_of(vz, inst->op1, NULL)) &&
+                    is_lanes(lane_of(vz, inst->op2, NULL))) {
+                    kind = LANE_OP;
+                }
+                break;
+            case IR_STORE:
+                if (lane_of(vz, inst->op2, &arr) != LANE_ADDR ||
+                    !is_lanes(lane_of(vz, inst->op1, NULL)) || !reads_current(vz, inst->op1) ||
+                    vz->store_count == VECTOR_MAX_STORES) {
+                    return false;
+                }
+                vz->arrays[arr].written = true;
+                vz->stores[vz->store_count++] = inst;
+                continue;
+            default:
+                break;
+        }
+        if (kind == LANE_NONE || inst->result.kind != VAL_VAR) return false;
+        vz->kinds[inst->result.storage.id] = kind;
+        vz->array_of[inst->result.storage.id] = arr;
+        vz->epoch[inst->result.storage.id] = vz->store_count;
+    }
+    return vz->store_count > 0;
+}
+
+static IrValue vec_call(Vectorizer* vz, IrBlock* at, const char* name, IrValue* args, size_t count) {
+    return ir_build_call(vz->body->loop->info->fn, at, name, args, count, ir_type_void())->result;
+}
+
+/* A fresh 32-byte slot, allocated once before the vector loop */
+static IrValue vec_slot(Vectorizer* vz) {
+    return ir_build_alloca(vz->body->loop->info->fn, vz->pre, ir_type_vec())->result;
+}
+
+/*
+ * Address of the four lanes of v in the vector body at `at`, computed
+ * into dst when v is arithmetic and dst is given.
+ */
+static IrValue emit_lanes(Vectorizer* vz, IrBlock* at, IrValue v, IrValue dst) {
+    Loop* loop = vz->body->loop;
+    int arr = -1;
+    switch (lane_of(vz, v, &arr)) {
+        case LANE_ELEM:
+            return vz->arrays[arr].addr;
+        case LANE_SCALAR: {
+            IrValue args[2] = { vec_slot(vz), materialize(loop, vz->pre, v) };
+            vec_call(vz, vz->pre, "arnm_f64x4_splat", args, 2);
+            return args[0];
+        }
+        default: {
+            IrInstr* def = def_of(loop->info, v);
+            IrValue args[4] = {
+                dst.kind == VAL_VAR ? dst : vec_slot(vz),
+                emit_lanes(vz, at, def->op1, (IrValue){ .kind = VAL_UNDEF }),
+                emit_lanes(vz, at, def->op2, (IrValue){ .kind = VAL_UNDEF }),
+                ir_val_const_i32((int32_t)(def->op - IR_ADD)) /* ArnmVecOp */,
+            };
+            vec_call(vz, at, "arnm_f64x4_op", args, 4);
+            return args[0];
+        }
+    }
+}
+
+/*
+ * Put a loop running VECTOR_LANES iterations at a time on f64x4
+ * kernels in front of the original, which does what is left. It is
+ * skipped when a written array overlaps another one at an offset.
+ * Returns the vector loop's header id, or -1.
+ */
+static int vectorize(Body* body) {
+    Loop* loop = body->loop;
+    FnInfo* info = loop->info;
+    IrFunction* fn = info->fn;
+    if (body->count != 1 || !is_invariant(loop, loop->bound)) return -1;
+
+    Vectorizer vz;
+    memset(&vz, 0, sizeof(vz));
+    vz.body = body;
+    vz.kinds = calloc((size_t)info->vreg_count + 1, sizeof(LaneKind));
+    vz.array_of = calloc((size_t)info->vreg_count + 1, sizeof(int));
+    vz.epoch = calloc((size_t)info->vreg_count + 1, sizeof(int));
+    vz.uses = calloc((size_t)info->vreg_count + 1, sizeof(uint32_t));
+    bool ok = lanes_classify(&vz);
+    free(vz.uses);
+    free(vz.epoch);
+    if (!ok) {
+        free(vz.kinds);
+        free(vz.array_of);
+        return -1;
+    }
+
+    IrBlock* hb = info->blocks[loop->header];
+    vz.pre = ir_block_create(fn, "vector.pre");
+    IrBlock* cond = ir_block_create(fn, "vector.cond");
+    IrBlock* vbody = ir_block_create(fn, "vector.body");
+    IrValue bound = materialize(loop, vz.pre, loop->bound);
+    for (int k = 0; k < vz.array_count; k++) {
+        LaneArray* arr = &vz.arrays[k];
+        arr->header = materialize(loop, vz.pre, arr->header);
+        arr->data = ir_build_array_data(fn, vz.pre, arr->header)->result;
+    }
+
+    /* Body: element addresses, each store's lanes, then the counter */
+    IrValue counter = ir_val_var(loop->counter, ir_type_ptr());
+    IrValue i = ir_build_load(fn, vbody, ir_type_i32(), counter)->result;
+    for (int k = 0; k < vz.array_count; k++) {
+        vz.arrays[k].addr = ir_build_elem_ptr(fn, vbody, vz.arrays[k].data, i)->result;
+    }
+    IrValue zero = { .kind = VAL_UNDEF };
+    for (int s = 0; s < vz.store_count; s++) {
+        IrInstr* store = vz.stores[s];
+        int arr = -1;
+        lane_of(&vz, store->op2, &arr);
+        IrValue dst = vz.arrays[arr].addr;
+        if (lane_of(&vz, store->op1, NULL) == LANE_OP) {
+            emit_lanes(&vz, vbody, store->op1, dst);
+            continue;
+        }
+        /* A plain copy: x - 0.0 is x, -0.0 included */
+        if (zero.kind == VAL_UNDEF) zero = emit_lanes(&vz, vbody, ir_val_const_f64(0.0), zero);
+        IrValue args[4] = { dst, emit_lanes(&vz, vbody, store->op1, (IrValue){ .kind = VAL_UNDEF }), zero,
+                            ir_val_const_i32(1) /* ARNM_VEC_SUB */ };
+        vec_call(&vz, vbody, "arnm_f64x4_op", args, 4);
+    }
+    ir_build_store(vbody, ir_build_add(fn, vbody, i, ir_val_const_i32(VECTOR_LANES))->result, counter);
+    ir_build_jmp(vbody, cond);
+
+    /* Arrays written in the loop must not overlap any other at an offset */
+    IrValue go = ir_val_const_bool(true);
+    for (int a = 0; a < vz.array_count; a++) {
+        for (int b = a + 1; b < vz.array_count; b++) {
+            if (!vz.arrays[a].written && !vz.arrays[b].written) continue;
+            IrValue args[2] = { vz.arrays[a].header, vz.arrays[b].header };
+            IrValue overlap = ir_build_call(fn, vz.pre, "arnm_array_aliased", args, 2,
+                                            ir_type_i32())->result;
+            IrValue apart = ir_build_cmp(fn, vz.pre, IR_EQ, overlap, ir_val_const_i32(0))->result;
+            go = go.kind == VAL_CONST ? apart : ir_build_and(fn, vz.pre, go, apart)->result;
+        }
+    }
+    if (go.kind == VAL_CONST) ir_build_jmp(vz.pre, cond);
+    else ir_build_br(vz.pre, go, cond, hb);
+
+    ir_build_br(cond, wide_test(loop, cond, bound, VECTOR_LANES), vbody, hb);
+    retarget(info->blocks[body->pre], hb, vz.pre);
+    free(vz.kinds);
+    free(vz.array_of);
+    return cond->id;
+}
+
+/* ============================================================
+ * Driver
+ * ============================================================ */
+
+#define LOOP_KEPT    (-1)
+#define LOOP_CHANGED (-2)
+
+/* Rewrites the loop at header if it can; returns a new header to leave alone, or one of the above */
+typedef int (*LoopPass)(FnInfo* info, int header, void* ctx);
+
+static int check_pass(FnInfo* info, int header, void* ctx) {
+    (void)ctx;
+    Loop loop;
+    if (!loop_find(info, header, &loop)) return LOOP_KEPT;
+    int fast = eliminate_checks(&loop);
+    loop_free(&loop);
+    return fast;
+}
+
+/*
+ * Counters are judged once, before any loop is reshaped: a reshaped
+ * copy steps its counter several times per block, which the induction
+ * test cannot see through, though the copies keep every step bounded.
+ */
+typedef struct {
+    int       opt_level;
+    bool*     inductions;     /* By slot */
+    uint32_t  slot_count;
+} Shaping;
+
+static void shaping_init(Shaping* shaping, IrFunction* fn, int opt_level) {
+    FnInfo info;
+    info_build(&info, fn);
+    shaping->opt_level = opt_level;
+    shaping->slot_count = info.vreg_count;
+    shaping->inductions = calloc((size_t)info.vreg_count + 1, sizeof(bool));
+    for (int h = 0; h < info.block_count; h++) {
+        Loop loop;
+        if (!info.blocks[h] || !loop_find(&info, h, &loop)) continue;
+        shaping->inductions[loop.counter] = counter_is_induction(&loop);
+        loop_free(&loop);
+    }
+    info_free(&info);
+}
+
+/* Vectorize at -O3, else unroll fully, else partially */
+static int shape_pass(FnInfo* info, int header, void* ctx) {
+    Shaping* shaping = ctx;
+    Loop loop;
+    if (!loop_find(info, header, &loop)) return LOOP_KEPT;
+    int result = LOOP_KEPT;
+    Body body;
+    if (loop.counter < shaping->slot_count && shaping->inductions[loop.counter] &&
+        body_find(&loop, &body)) {
+        if (shaping->opt_level >= 3) result = vectorize(&body);
+        if (result == LOOP_KEPT && unroll_fully(&body)) result = LOOP_CHANGED;
+        if (result == LOOP_KEPT) result = unroll_partially(&body);
+    }
+    loop_free(&loop);
+    return result;
+}
+
+static void done_grow(bool** done, size_t* cap, IrFunction* fn) {
+    if (*cap >= fn->block_counter) return;
+    *done = realloc(*done, fn->block_counter * sizeof(bool));
+    memset(*done + *cap, 0, (fn->block_counter - *cap) * sizeof(bool));
+    *cap = fn->block_counter;
+}
+
+/* Passes add and remove blocks, so start over on the new graph after each change */
+static void run_loop_pass(IrFunction* fn, LoopPass pass, void* ctx) {
+    size_t done_cap = 0;
+    bool* done = NULL;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        FnInfo info;
+        info_build(&info, fn);
+        done_grow(&done, &done_cap, fn);
+        for (IrBlock* blk = fn->entry; blk; blk = blk->next) {
+            if (done[blk->id]) continue;
+            done[blk->id] = true;
+            int result = pass(&info, blk->id, ctx);
+            if (result == LOOP_KEPT) continue;
+            done_grow(&done, &done_cap, fn);
+            if (result >= 0) done[result] = true;
+            changed = true;
+            break;
+        }
+        info_free(&info);
+    }
+    free(done);
+}
+
+static void optimize_function(IrFunction* fn, int opt_level) {
+    if (!fn->entry) return;
+    run_loop_pass(fn, check_pass, NULL);
+    remove_dead_lengths(fn);
+    if (opt_level < 2) return;
+    Shaping shaping;
+    shaping_init(&shaping, fn, opt_level);
+    run_loop_pass(fn, shape_pass, &shaping);
+    free(shaping.inductions);
+}
+
+void ir_optimize(IrModule* mod, int opt_level) {
+    for (IrFunction* fn = mod->funcs; fn; fn = fn->next) {
+        optimize_function(fn, opt_level);
+    }
+}
@@ -29,6 +29,9 @@ void* ast_arena_alloc(AstArena* arena, size_t size) {
     
     void* ptr = arena->buffer + arena->used;
     arena->used += size;
+    
+    /* Nodes are partially initialized; sema relies on zeroed cache fields */
+    memset(ptr, 0, size);
     return ptr;
 }
 
@@ -111,7 +114,10 @@ static void synchronize(Parser* parser) {
             case TOK_FOR:
             case TOK_RETURN:
             case TOK_SPAWN:
+            case TOK_AWAIT:
             case TOK_RECEIVE:
+            case TOK_SELECT:
+            case TOK_PARALLEL:
                 return;
             default:
                 break;
@@ -347,15 +353,71 @@ static AstExpr* parse_call(Parser* parser, AstExpr* callee) {
 }
 
 static AstExpr* parse_index(Parser* parser, AstExpr* object) {
-    AstExpr* index = parse_expression(parser);
-    consume(parser, TOK_RBRACKET, "expected ']' after index");
+    Span start = parser->previous.span;
+    
+    /* a[i], or a slice a[lo..hi] where either bound may be omitted.
+     * '..' is not an infix operator, so a bound stops right before it. */
+    AstExpr* index = NULL;
+    AstExpr* end = NULL;
+    bool is_slice = false;
+    if (!check(parser, TOK_DOT_DOT)) {
+        index = parse_expression(parser);
+    }
+    if (match(parser, TOK_DOT_DOT)) {
+        is_slice = true;
+        if (!check(parser, TOK_RBRACKET)) {
+            end = parse_expression(parser);
+        }
+    }
+    consume(parser, TOK_RBRACKET, is_slice ? "expected ']' after slice" : "expected ']' after index");
     
     AstExpr* expr = AST_NEW(parser->arena, AstExpr);
     if (!expr) return NULL;
     
     expr->kind = AST_INDEX_EXPR;
+    expr->as.index.common.span = start;
     expr->as.index.object = object;
     expr->as.index.index = index;
+    expr->as.index.end = end;
+    expr->as.index.is_slice = is_slice;
+    return expr;
+}
+
+static AstExpr* parse_array(Parser* parser) {
+    Span start = parser->previous.span;
+    AstExpr* elems[256];
+    size_t elem_count = 0;
+    AstExpr* repeat_count = NULL;
+    
+    if (!check(parser, TOK_RBRACKET)) {
+        elems[elem_count++] = parse_expression(parser);
+        if (match(parser, TOK_SEMI)) {
+            /* [value; count] */
+            repeat_count = parse_expression(parser);
+        } else {
+            while (match(parser, TOK_COMMA)) {
+                if (check(parser, TOK_RBRACKET)) break;  /* trailing comma */
+                if (elem_count >= 256) {
+                    error(parser, "too many elements in array literal");
+                    break;
+                }
+                elems[elem_count++] = parse_expression(parser);
+            }
+        }
+    }
+    consume(parser, TOK_RBRACKET, "expected ']' after array elements");
+    
+    AstExpr* expr = AST_NEW(parser->arena, AstExpr);
+    if (!expr) return NULL;
+    
+    expr->kind = AST_ARRAY_EXPR;
+    expr->as.array.common.span = start;
+    expr->as.array.elem_count = elem_count;
+    expr->as.array.repeat_count = repeat_count;
+    if (elem_count > 0) {
+        expr->as.array.elems = AST_NEW_ARRAY(parser->arena, AstExpr*, elem_count);
+        memcpy(expr->as.array.elems, elems, sizeof(AstExpr*) * elem_count);
+    }
     return expr;
 }
 
@@ -382,6 +444,7 @@ static AstExpr* parse_spawn_expr(Parser* parser) {
     expr->kind = AST_SPAWN_EXPR;
     expr->as.spawn_expr.common.span = start;
     expr->as.spawn_expr.expr = inner;
+    expr->as.spawn_expr.joinable = false;
     return expr;
 }
 
@@ -392,6 +455,7 @@ static AstExpr* parse_prefix(Parser* parser) {
         case TOK_STRING_LIT:  return parse_string(parser);
         case TOK_IDENT:       return parse_identifier(parser);
         case TOK_LPAREN:      return parse_grouping(parser);
+        case TOK_LBRACKET:    return parse_array(parser);
         case TOK_MINUS:
         case TOK_BANG:
         case TOK_TILDE:       return parse_unary(parser);
@@ -710,6 +774,21 @@ static AstStmt* parse_spawn_stmt(Parser* parser) {
     return stmt;
 }
 
+static AstStmt* parse_await_stmt(Parser* parser) {
+    Span start = parser->previous.span;
+    
+    AstExpr* process = parse_expression(parser);
+    consume(parser, TOK_SEMI, "expected ';' after await");
+    
+    AstStmt* stmt = AST_NEW(parser->arena, AstStmt);
+    if (!stmt) return NULL;
+    
+    stmt->kind = AST_AWAIT_STMT;
+    stmt->as.await_stmt.common.span = start;
+    stmt->as.await_stmt.process = process;
+    return stmt;
+}
+
 static AstStmt* parse_receive_stmt(Parser* parser) {
     Span start = parser->previous.span;
     consume(parser, TOK_LBRACE, "expected '{' after receive");
@@ -751,6 +830,114 @@ static AstStmt* parse_receive_stmt(Parser* parser) {
     return stmt;
 }
 
+/*
+ * select { v := ch => { ... }  receive tag => { ... } }
+ * Up to SELECT_MAX_CHANNELS channel arms and at most one mailbox arm.
+ */
+static AstStmt* parse_select_stmt(Parser* parser) {
+    Span start = parser->previous.span;
+    consume(parser, TOK_LBRACE, "expected '{' after select");
+    
+    SelectArm arms[SELECT_MAX_CHANNELS + 1];
+    size_t arm_count = 0;
+    size_t channel_arms = 0;
+    bool has_mailbox = false;
+    
+    while (!check(parser, TOK_RBRACE) && !check(parser, TOK_EOF)) {
+        SelectArm arm = {0};
+        bool mailbox = match(parser, TOK_RECEIVE);
+        
+        consume(parser, TOK_IDENT, mailbox ? "expected name after receive"
+                                           : "expected 'name := channel' or 'receive name'");
+        arm.binding = parser->previous.lexeme;
+        arm.binding_len = parser->previous.length;
+        
+        if (mailbox) {
+            if (has_mailbox) error(parser, "select has more than one receive arm");
+            has_mailbox = true;
+        } else {
+            if (channel_arms++ == SELECT_MAX_CHANNELS) error(parser, "too many select channel arms");
+            consume(parser, TOK_COLON_EQ, "expected ':=' after name");
+            arm.channel = parse_expression(parser);
+        }
+        
+        consume(parser, TOK_FAT_ARROW, "expected '=>' in select arm");
+        arm.body = parse_block(parser);
+        
+        if (parser->panic_mode) break;
+        if (arm_count < SELECT_MAX_CHANNELS + 1) arms[arm_count++] = arm;
+    }
+    
+    consume(parser, TOK_RBRACE, "expected '}' after select arms");
+    
+    AstStmt* stmt = AST_NEW(parser->arena, AstStmt);
+    if (!stmt) return NULL;
+    
+    stmt->kind = AST_SELECT_STMT;
+    stmt->as.select_stmt.common.span = start;
+    stmt->as.select_stmt.arm_count = arm_count;
+    if (arm_count > 0) {
+        stmt->as.select_stmt.arms = AST_NEW_ARRAY(parser->arena, SelectArm, arm_count);
+        memcpy(stmt->as.select_stmt.arms, arms, sizeof(SelectArm) * arm_count);
+    }
+    return stmt;
+}
+
+/* Contextual keyword check (like 'in' after a for variable) */
+static bool match_word(Parser* parser, const char* word) {
+    size_t len = strlen(word);
+    if (!check(parser, TOK_IDENT) || parser->current.length != len ||
+        strncmp(parser->current.lexeme, word, len) != 0) {
+        return false;
+    }
+    advance(parser);
+    return true;
+}
+
+/*
+ * parallel for i in lo..hi { ... }
+ * parallel reduce(+) acc for i in lo..hi { ... }
+ */
+static AstStmt* parse_parallel_stmt(Parser* parser) {
+    Span start = parser->previous.span;
+    
+    AstStmt* stmt = AST_NEW(parser->arena, AstStmt);
+    if (!stmt) return NULL;
+    stmt->kind = AST_PARALLEL_STMT;
+    AstParallelStmt* par = &stmt->as.parallel_stmt;
+    memset(par, 0, sizeof(*par));
+    par->common.span = start;
+    
+    if (match_word(parser, "reduce")) {
+        consume(parser, TOK_LPAREN, "expected '(' after reduce");
+        if (match(parser, TOK_PLUS)) {
+            par->reduce_op = BINARY_ADD;
+        } else if (match(parser, TOK_STAR)) {
+            par->reduce_op = BINARY_MUL;
+        } else {
+            error(parser, "expected '+' or '*' as reduce operator");
+        }
+        consume(parser, TOK_RPAREN, "expected ')' after reduce operator");
+        consume(parser, TOK_IDENT, "expected accumulator name");
+        par->acc_name = parser->previous.lexeme;
+        par->acc_name_len = parser->previous.length;
+    }
+    
+    consume(parser, TOK_FOR, "expected 'for' after parallel");
+    consume(parser, TOK_IDENT, "expected iterator variable after 'for'");
+    par->var_name = parser->previous.lexeme;
+    par->var_name_len = parser->previous.length;
+    
+    if (!match_word(parser, "in")) {
+        error(parser, "expected 'in' after iterator variable");
+    }
+    par->lo = parse_expression(parser);
+    consume(parser, TOK_DOT_DOT, "expected '..' in parallel range");
+    par->hi = parse_expression(parser);
+    par->body = parse_block(parser);
+    return stmt;
+}
+
 AstStmt* parse_statement(Parser* parser) {
     if (match(parser, TOK_LET))     return parse_let_stmt(parser);
     if (match(parser, TOK_CONST))   return parse_const_stmt(parser);
@@ -760,7 +947,10 @@ AstStmt* parse_statement(Parser* parser) {
     if (match(parser, TOK_FOR))     return parse_for_stmt(parser);
     if (match(parser, TOK_LOOP))    return parse_loop_stmt(parser);
     if (match(parser, TOK_SPAWN))   return parse_spawn_stmt(parser);
+    if (match(parser, TOK_AWAIT))   return parse_await_stmt(parser);
     if (match(parser, TOK_RECEIVE)) return parse_receive_stmt(parser);
+    if (match(parser, TOK_SELECT))  return parse_select_stmt(parser);
+    if (match(parser, TOK_PARALLEL)) return parse_parallel_stmt(parser);
     
     if (match(parser, TOK_BREAK)) {
         consume(parser, TOK_SEMI, "expected ';' after break");
@@ -806,7 +996,34 @@ AstType* parse_type(Parser* parser) {
     type->as.ident.common.span = parser->previous.span;
     type->as.ident.name = parser->previous.lexeme;
     type->as.ident.name_len = parser->previous.length;
-    
+
+    /* Handle type arguments: Name<T, ...> */
+    if (match(parser, TOK_LT)) {
+        AstType* args[8];
+        size_t arg_count = 0;
+        do {
+            if (arg_count >= 8) {
+                error(parser, "too many type arguments");
+                break;
+            }
+            args[arg_count++] = parse_type(parser);
+        } while (match(parser, TOK_COMMA));
+        consume(parser, TOK_GT, "expected '>' after type arguments");
+
+        AstType* generic = AST_NEW(parser->arena, AstType);
+        if (!generic) return NULL;
+        generic->kind = AST_TYPE_GENERIC;
+        generic->as.generic.common.span = type->as.ident.common.span;
+        generic->as.generic.name = type->as.ident.name;
+        generic->as.generic.name_len = type->as.ident.name_len;
+        generic->as.generic.args = AST_NEW_ARRAY(parser->arena, AstType*, arg_count);
+        if (generic->as.generic.args) {
+            memcpy(generic->as.generic.args, args, sizeof(AstType*) * arg_count);
+        }
+        generic->as.generic.arg_count = arg_count;
+        type = generic;
+    }
+
     /* Handle optional type: Type? */
     if (match(parser, TOK_QUESTION)) {
         AstType* optional = AST_NEW(parser->arena, AstType);
@@ -817,15 +1034,20 @@ AstType* parse_type(Parser* parser) {
         }
     }
     
-    /* Handle array type: [Type] */
-    if (match(parser, TOK_LBRACKET)) {
+    /* Handle array types: Type[N] (fixed size) and Type[] (slice) */
+    while (match(parser, TOK_LBRACKET)) {
+        AstExpr* size = NULL;
+        if (match(parser, TOK_INT_LIT)) {
+            size = parse_number(parser);
+        }
         consume(parser, TOK_RBRACKET, "expected ']'");
         AstType* array = AST_NEW(parser->arena, AstType);
-        if (array) {
-            array->kind = AST_TYPE_ARRAY;
-            array->as.array.element_type = type;
-            return array;
-        }
+        if (!array) return NULL;
+        array->kind = AST_TYPE_ARRAY;
+        array->as.array.common.span = type->as.ident.common.span;
+        array->as.array.element_type = type;
+        array->as.array.size = size;
+        type = array;
     }
     
     return type;
@@ -20,6 +20,102 @@ static char* my_strdup(const char* s) {
  * Context Management
  * ============================================================ */
 
+/*
+ * SIMD vector builtins, seven per vector type (V) with lane scalar S:
+ *   <t>_splat(S) -> V        <t>_get(V, i32) -> S    <t>_set(V, i32, S) -> V
+ *   <t>_sum/_min/_max(V) -> S                        <t>_shuffle(V, i32x8) -> V
+ * f32x8 lanes are read and written as f64.
+ */
+static const char* const vector_builtin_names[3][7] = {
+    { "f32x8_splat", "f32x8_get", "f32x8_set", "f32x8_sum", "f32x8_min", "f32x8_max", "f32x8_shuffle" },
+    { "i32x8_splat", "i32x8_get", "i32x8_set", "i32x8_sum", "i32x8_min", "i32x8_max", "i32x8_shuffle" },
+    { "f64x4_splat", "f64x4_get", "f64x4_set", "f64x4_sum", "f64x4_min", "f64x4_max", "f64x4_shuffle" },
+};
+
+static void define_vector_builtins(SemaContext* ctx) {
+    TypeArena* arena = &ctx->type_arena;
+    Type* vecs[3] = { type_f32x8(arena), type_i32x8(arena), type_f64x4(arena) };
+    Type* scalars[3] = { type_f64(arena), type_i32(arena), type_f64(arena) };
+    
+    for (int v = 0; v < 3; v++) {
+        Type* vec = vecs[v];
+        Type* scalar = scalars[v];
+        for (int k = 0; k < 7; k++) {
+            Type** params = type_arena_alloc(arena, 3 * sizeof(Type*));
+            size_t count;
+            Type* ret;
+            switch (k) {
+                case 0:  params[0] = scalar; count = 1; ret = vec; break;
+                case 1:  params[0] = vec; params[1] = type_i32(arena); count = 2; ret = scalar; break;
+                case 2:  params[0] = vec; params[1] = type_i32(arena); params[2] = scalar;
+                         count = 3; ret = vec; break;
+                case 6:  params[0] = vec; params[1] = vecs[1]; count = 2; ret = vec; break;
+                default: params[0] = vec; count = 1; ret = scalar; break;
+            }
+            const char* name = vector_builtin_names[v][k];
+            symbol_define(&ctx->symbols, name, strlen(name), SYMBOL_FN,
+                          type_fn(arena, params, count, ret), (Span){0});
+        }
+    }
+}
+
+/*
+ * Collection builtins. Parameter codes: c = the collection, k = its key,
+ * e = its element, i = an i32 index. Return codes add b = bool, u = unit.
+ * Each call site gets fresh key and element types, so one name serves
+ * every vec<T>, map<K, V> and deque<T>.
+ */
+typedef struct {
+    const char* name;
+    TypeKind    kind;
+    const char* params;
+    char        ret;
+} CollectionBuiltin;
+
+static const CollectionBuiltin collection_builtins[] = {
+    { "vec_new",          TYPE_VEC,   "",    'c' },
+    { "vec_push",         TYPE_VEC,   "ce",  'u' },
+    { "vec_pop",          TYPE_VEC,   "c",   'e' },
+    { "vec_get",          TYPE_VEC,   "ci",  'e' },
+    { "vec_set",          TYPE_VEC,   "cie", 'u' },
+    { "map_new",          TYPE_MAP,   "",    'c' },
+    { "map_put",          TYPE_MAP,   "cke", 'u' },
+    { "map_get",          TYPE_MAP,   "ck",  'e' },
+    { "map_has",          TYPE_MAP,   "ck",  'b' },
+    { "map_remove",       TYPE_MAP,   "ck",  'b' },
+    { "deque_new",        TYPE_DEQUE, "",    'c' },
+    { "deque_push_back",  TYPE_DEQUE, "ce",  'u' },
+    { "deque_push_front", TYPE_DEQUE, "ce",  'u' },
+    { "deque_pop_back",   TYPE_DEQUE, "c",   'e' },
+    { "deque_pop_front",  TYPE_DEQUE, "c",   'e' },
+    { "deque_get",        TYPE_DEQUE, "ci",  'e' },
+};
+
+#define COLLECTION_BUILTIN_COUNT (sizeof(collection_builtins) / sizeof(collection_builtins[0]))
+
+static const CollectionBuiltin* find_collection_builtin(const char* name, uint32_t name_len) {
+    for (size_t i = 0; i < COLLECTION_BUILTIN_COUNT; i++) {
+        const char* candidate = collection_builtins[i].name;
+        if (strlen(candidate) == name_len && memcmp(candidate, name, name_len) == 0) {
+            return &collection_builtins[i];
+        }
+    }
+    return NULL;
+}
+
+/* Placeholder signatures of the right arity; infer_call types each use */
+static void define_collection_builtins(SemaContext* ctx) {
+    TypeArena* arena = &ctx->type_arena;
+    for (size_t i = 0; i < COLLECTION_BUILTIN_COUNT; i++) {
+        const CollectionBuiltin* builtin = &collection_builtins[i];
+        size_t count = strlen(builtin->params);
+        Type** params = count ? type_arena_alloc(arena, count * sizeof(Type*)) : NULL;
+        for (size_t k = 0; k < count; k++) params[k] = type_var(arena);
+        symbol_define(&ctx->symbols, builtin->name, strlen(builtin->name), SYMBOL_FN,
+                      type_fn(arena, params, count, type_var(arena)), (Span){0});
+    }
+}
+
 void sema_init(SemaContext* ctx) {
     type_arena_init(&ctx->type_arena, 1024 * 1024);  /* 1MB */
     symtab_init(&ctx->symbols, &ctx->type_arena);
@@ -27,7 +123,12 @@ void sema_init(SemaContext* ctx) {
     ctx->had_error = false;
     ctx->current_fn_return = NULL;
     ctx->in_loop = false;
+    ctx->in_parallel = false;
+    ctx->loop_depth = 0;
     ctx->in_actor = false;
+    ctx->collections = NULL;
+    ctx->collection_count = 0;
+    ctx->collection_cap = 0;
     
     /* Register built-in functions */
     /* print(any) -> void - uses type variable to accept any type */
@@ -41,9 +142,36 @@ void sema_init(SemaContext* ctx) {
     println_params[0] = type_var(&ctx->type_arena);  /* Accept any type */
     Type* println_type = type_fn(&ctx->type_arena, println_params, 1, type_unit(&ctx->type_arena));
     symbol_define(&ctx->symbols, "println", 7, SYMBOL_FN, println_type, (Span){0});
+    
+    /* chan(capacity) -> channel handle, chan_send(ch, v) -> bool, chan_close(ch) */
+    Type** chan_params = type_arena_alloc(&ctx->type_arena, sizeof(Type*));
+    chan_params[0] = type_var(&ctx->type_arena);
+    Type* chan_type = type_fn(&ctx->type_arena, chan_params, 1, type_i64(&ctx->type_arena));
+    symbol_define(&ctx->symbols, "chan", 4, SYMBOL_FN, chan_type, (Span){0});
+    
+    Type** send_params = type_arena_alloc(&ctx->type_arena, 2 * sizeof(Type*));
+    send_params[0] = type_var(&ctx->type_arena);
+    send_params[1] = type_var(&ctx->type_arena);
+    Type* send_type = type_fn(&ctx->type_arena, send_params, 2, type_bool(&ctx->type_arena));
+    symbol_define(&ctx->symbols, "chan_send", 9, SYMBOL_FN, send_type, (Span){0});
+    
+    Type** close_params = type_arena_alloc(&ctx->type_arena, sizeof(Type*));
+    close_params[0] = type_var(&ctx->type_arena);
+    Type* close_type = type_fn(&ctx->type_arena, close_params, 1, type_unit(&ctx->type_arena));
+    symbol_define(&ctx->symbols, "chan_close", 10, SYMBOL_FN, close_type, (Span){0});
+    
+    /* len(array) -> i32 */
+    Type** len_params = type_arena_alloc(&ctx->type_arena, sizeof(Type*));
+    len_params[0] = type_var(&ctx->type_arena);
+    Type* len_type = type_fn(&ctx->type_arena, len_params, 1, type_i32(&ctx->type_arena));
+    symbol_define(&ctx->symbols, "len", 3, SYMBOL_FN, len_type, (Span){0});
+    
+    define_vector_builtins(ctx);
+    define_collection_builtins(ctx);
 }
 
 void sema_destroy(SemaContext* ctx) {
+    free(ctx->collections);
     symtab_destroy(&ctx->symbols);
     type_arena_destroy(&ctx->type_arena);
 }
@@ -102,6 +230,7 @@ static Span get_expr_span(AstExpr* expr) {
         case AST_BINARY_EXPR:     return expr->as.binary.common.span;
         case AST_CALL_EXPR:       return expr->as.call.common.span;
         case AST_INDEX_EXPR:      return expr->as.index.common.span;
+        case AST_ARRAY_EXPR:      return expr->as.array.common.span;
         case AST_FIELD_EXPR:      return expr->as.field.common.span;
         case AST_SEND_EXPR:       return expr->as.send.common.span;
         case AST_SPAWN_EXPR:      return expr->as.spawn_expr.common.span;
@@ -146,6 +275,10 @@ static bool check_assignment_target(SemaContext* ctx, AstExpr* target) {
         }
         
         case AST_INDEX_EXPR: {
+            if (target->as.index.is_slice) {
+                sema_error(ctx, target->as.index.common.span, "cannot assign to a slice");
+                return false;
+            }
             /* Array indexing - check array mutability */
             return check_assignment_target(ctx, target->as.index.object);
         }
@@ -157,6 +290,20 @@ static bool check_assignment_target(SemaContext* ctx, AstExpr* target) {
     }
 }
 
+/* Element type of an array-typed value. An unresolved type variable
+ * becomes a slice of a fresh element type; NULL if it is not an array. */
+static Type* array_element_type(SemaContext* ctx, Type* type) {
+    type = type_resolve(type);
+    if (type->kind == TYPE_ARRAY) return type->as.array.element_type;
+    if (type->kind == TYPE_ERROR) return type;
+    if (type->kind == TYPE_VAR) {
+        Type* elem = type_var(&ctx->type_arena);
+        type_unify(type, type_array(&ctx->type_arena, elem));
+        return elem;
+    }
+    return NULL;
+}
+
 static Type* infer_binary(SemaContext* ctx, AstBinaryExpr* bin) {
     Type* left = sema_infer_expr(ctx, bin->left);
     Type* right = sema_infer_expr(ctx, bin->right);
@@ -170,6 +317,11 @@ static Type* infer_binary(SemaContext* ctx, AstBinaryExpr* bin) {
             /* Numeric operations */
             if (!type_unify(left, right)) {
                 sema_error(ctx, bin->common.span, "type mismatch in binary operation");
+            } else if (bin->op == BINARY_MOD) {
+                Type* t = type_resolve(left);
+                if (type_is_vector(t) || t->kind == TYPE_F32 || t->kind == TYPE_F64) {
+                    sema_error(ctx, bin->common.span, "'%' requires integer operands");
+                }
             }
             return left;
             
@@ -182,6 +334,8 @@ static Type* infer_binary(SemaContext* ctx, AstBinaryExpr* bin) {
             /* Comparison returns bool */
             if (!type_unify(left, right)) {
                 sema_error(ctx, bin->common.span, "type mismatch in comparison");
+            } else if (type_is_vector(left)) {
+                sema_error(ctx, bin->common.span, "cannot compare SIMD vectors");
             }
             return type_bool(&ctx->type_arena);
             
@@ -211,6 +365,11 @@ static Type* infer_binary(SemaContext* ctx, AstBinaryExpr* bin) {
                 sema_error(ctx, bin->common.span, 
                           "send target must be a process");
             }
+            if (type_is_vector(right)) {
+                sema_error(ctx, bin->common.span, "cannot send a SIMD vector");
+            } else if (type_is_collection(right)) {
+                sema_error(ctx, bin->common.span, "cannot send a collection; it belongs to one process");
+            }
             return type_unit(&ctx->type_arena);
             
         default:
@@ -236,6 +395,68 @@ static Type* infer_unary(SemaContext* ctx, AstUnaryExpr* un) {
     }
 }
 
+static void track_collection(SemaContext* ctx, Type* type, Span span) {
+    if (ctx->collection_count == ctx->collection_cap) {
+        ctx->collection_cap = ctx->collection_cap ? ctx->collection_cap * 2 : 16;
+        ctx->collections = realloc(ctx->collections,
+                                   ctx->collection_cap * sizeof(SemaCollection));
+    }
+    ctx->collections[ctx->collection_count++] = (SemaCollection){ type, span };
+}
+
+static Type* infer_collection_call(SemaContext* ctx, AstCallExpr* call,
+                                   const CollectionBuiltin* builtin) {
+    TypeArena* arena = &ctx->type_arena;
+    Type* key = builtin->kind == TYPE_MAP ? type_var(arena) : NULL;
+    Type* elem = type_var(arena);
+    Type* collection = type_collection(arena, builtin->kind, key, elem);
+    if (!builtin->params[0]) {
+        track_collection(ctx, collection, call->common.span);
+    }
+    
+    for (size_t i = 0; i < call->arg_count; i++) {
+        Type* arg = sema_infer_expr(ctx, call->args[i]);
+        Type* expected;
+        switch (builtin->params[i]) {
+            case 'c': expected = collection; break;
+            case 'k': expected = key; break;
+            case 'e': expected = elem; break;
+            default:  expected = type_i32(arena); break;
+        }
+        if (!type_unify(arg, expected)) {
+            sema_error(ctx, get_expr_span(call->args[i]),
+                      builtin->params[i] == 'c' ? "wrong collection kind for this builtin"
+                                                : "argument type mismatch");
+        }
+    }
+    
+    switch (builtin->ret) {
+        case 'c': return collection;
+        case 'e': return elem;
+        case 'b': return type_bool(arena);
+        default:  return type_unit(arena);
+    }
+}
+
+/* Element slots are 8 bytes and map keys hash as integers */
+static void check_collections(SemaContext* ctx) {
+    for (size_t i = 0; i < ctx->collection_count; i++) {
+        Type* type = type_resolve(ctx->collections[i].type);
+        Span span = ctx->collections[i].span;
+        if (type_is_vector(type->as.collection.element_type)) {
+            sema_error(ctx, span, "collections cannot hold SIMD vectors");
+        }
+        if (type->kind == TYPE_MAP) {
+            Type* key = type_resolve(type->as.collection.key_type);
+            if (key->kind != TYPE_I32 && key->kind != TYPE_I64 &&
+                key->kind != TYPE_BOOL && key->kind != TYPE_VAR &&
+                key->kind != TYPE_ERROR) {
+                sema_error(ctx, span, "map keys must be i32, i64 or bool");
+            }
+        }
+    }
+}
+
 static Type* infer_call(SemaContext* ctx, AstCallExpr* call) {
     Type* callee_type = sema_infer_expr(ctx, call->callee);
     callee_type = type_resolve(callee_type);
@@ -308,6 +529,18 @@ static Type* infer_call(SemaContext* ctx, AstCallExpr* call) {
     bool is_print_builtin = false;
     if (call->callee->kind == AST_IDENT_EXPR) {
         AstIdentExpr* ident = &call->callee->as.ident;
+        if (ident->name_len == 3 && memcmp(ident->name, "len", 3) == 0) {
+            /* len() takes an array, slice or collection of any element type */
+            Type* arg = sema_infer_expr(ctx, call->args[0]);
+            if (!type_is_collection(arg) && !array_element_type(ctx, arg)) {
+                sema_error(ctx, call->common.span, "len() requires an array or collection");
+            }
+            return callee_type->as.fn.return_type;
+        }
+        const CollectionBuiltin* builtin = find_collection_builtin(ident->name, ident->name_len);
+        if (builtin) {
+            return infer_collection_call(ctx, call, builtin);
+        }
         if ((ident->name_len == 5 && memcmp(ident->name, "print", 5) == 0) ||
             (ident->name_len == 7 && memcmp(ident->name, "println", 7) == 0)) {
             is_print_builtin = true;
@@ -321,6 +554,12 @@ static Type* infer_call(SemaContext* ctx, AstCallExpr* call) {
             if (!type_unify(arg_type, callee_type->as.fn.param_types[i])) {
                 sema_error(ctx, call->common.span, "argument type mismatch");
             }
+        } else if (type_is_vector(arg_type)) {
+            sema_error(ctx, call->common.span, "cannot print a SIMD vector; print its lanes");
+        } else if (type_resolve(arg_type)->kind == TYPE_ARRAY) {
+            sema_error(ctx, call->common.span, "cannot print an array; print its elements");
+        } else if (type_is_collection(arg_type)) {
+            sema_error(ctx, call->common.span, "cannot print a collection; print its elements");
         }
     }
     
@@ -331,7 +570,11 @@ static Type* infer_send(SemaContext* ctx, AstSendExpr* send) {
     Type* target = sema_infer_expr(ctx, send->target);
     Type* message = sema_infer_expr(ctx, send->message);
     (void)target;
-    (void)message;
+    if (type_is_vector(message)) {
+        sema_error(ctx, send->common.span, "cannot send a SIMD vector");
+    } else if (type_is_collection(message)) {
+        sema_error(ctx, send->common.span, "cannot send a collection; it belongs to one process");
+    }
     /* Send returns unit */
     return type_unit(&ctx->type_arena);
 }
@@ -347,6 +590,16 @@ static Type* infer_spawn(SemaContext* ctx, AstSpawnExpr* spawn) {
                   "spawn requires function or actor method");
     }
     
+    /* Collections are unsynchronized, so they never cross into a new process */
+    if (spawn->expr->kind == AST_CALL_EXPR) {
+        AstCallExpr* call = &spawn->expr->as.call;
+        for (size_t i = 0; i < call->arg_count; i++) {
+            if (type_is_collection(sema_infer_expr(ctx, call->args[i]))) {
+                sema_error(ctx, spawn->common.span, "cannot pass a collection to a spawned process");
+            }
+        }
+    }
+    
     /* spawn returns Process handle */
     return type_process(&ctx->type_arena, inner);
 }
@@ -363,6 +616,8 @@ Type* sema_infer_expr(SemaContext* ctx, AstExpr* expr) {
         case AST_UNARY_EXPR:      cached = expr->as.unary.common.sema_type; break;
         case AST_CALL_EXPR:       cached = expr->as.call.common.sema_type; break;
         case AST_FIELD_EXPR:      cached = expr->as.field.common.sema_type; break;
+        case AST_INDEX_EXPR:      cached = expr->as.index.common.sema_type; break;
+        case AST_ARRAY_EXPR:      cached = expr->as.array.common.sema_type; break;
         case AST_SPAWN_EXPR:      cached = expr->as.spawn_expr.common.sema_type; break;
         default: break;
     }
@@ -495,15 +750,51 @@ Type* sema_infer_expr(SemaContext* ctx, AstExpr* expr) {
             break;
             
         case AST_INDEX_EXPR: {
-            Type* obj = sema_infer_expr(ctx, expr->as.index.object);
-            Type* idx = sema_infer_expr(ctx, expr->as.index.index);
-            (void)idx;
-            obj = type_resolve(obj);
-            if (obj->kind == TYPE_ARRAY) {
-                result = obj->as.array.element_type;
+            AstIndexExpr* index = &expr->as.index;
+            Type* elem = array_element_type(ctx, sema_infer_expr(ctx, index->object));
+            Type* i32 = type_i32(&ctx->type_arena);
+            if (index->index && !type_unify(sema_infer_expr(ctx, index->index), i32)) {
+                sema_error(ctx, index->common.span, "array index must be an i32");
+            }
+            if (index->end && !type_unify(sema_infer_expr(ctx, index->end), i32)) {
+                sema_error(ctx, index->common.span, "array index must be an i32");
+            }
+            if (!elem) {
+                sema_error(ctx, index->common.span, "indexing a non-array");
+                result = type_error(&ctx->type_arena);
+            } else if (index->is_slice) {
+                result = type_array(&ctx->type_arena, elem);
             } else {
-                result = type_var(&ctx->type_arena);
+                result = elem;
+            }
+            break;
+        }
+        
+        case AST_ARRAY_EXPR: {
+            AstArrayExpr* array = &expr->as.array;
+            Type* elem = type_var(&ctx->type_arena);
+            for (size_t i = 0; i < array->elem_count; i++) {
+                if (!type_unify(sema_infer_expr(ctx, array->elems[i]), elem)) {
+                    sema_error(ctx, get_expr_span(array->elems[i]),
+                              "array elements must have the same type");
+                }
             }
+            if (type_is_vector(elem)) {
+                sema_error(ctx, array->common.span, "arrays cannot hold SIMD vectors");
+            }
+            
+            /* Literals have a static length; [x; n] only when n is one */
+            int64_t length = (int64_t)array->elem_count;
+            if (array->repeat_count) {
+                Type* count = sema_infer_expr(ctx, array->repeat_count);
+                if (!type_unify(count, type_i32(&ctx->type_arena))) {
+                    sema_error(ctx, array->common.span, "array length must be an i32");
+                }
+                AstExpr* n = array->repeat_count;
+                while (n->kind == AST_GROUP_EXPR) n = n->as.group.inner;
+                length = n->kind == AST_INT_LIT_EXPR ? n->as.int_lit.value : -1;
+            }
+            result = type_array_sized(&ctx->type_arena, elem, length);
             break;
         }
             
@@ -524,6 +815,8 @@ Type* sema_infer_expr(SemaContext* ctx, AstExpr* expr) {
             case AST_UNARY_EXPR:      expr->as.unary.common.sema_type = result; break;
             case AST_CALL_EXPR:       expr->as.call.common.sema_type = result; break;
             case AST_FIELD_EXPR:      expr->as.field.common.sema_type = result; break;
+            case AST_INDEX_EXPR:      expr->as.index.common.sema_type = result; break;
+            case AST_ARRAY_EXPR:      expr->as.array.common.sema_type = result; break;
             case AST_SPAWN_EXPR:      expr->as.spawn_expr.common.sema_type = result; break;
             case AST_SEND_EXPR:       expr->as.send.common.sema_type = result; break;
             case AST_GROUP_EXPR:      expr->as.group.common.sema_type = result; break;
@@ -560,6 +853,10 @@ void sema_check_stmt(SemaContext* ctx, AstStmt* stmt) {
                 sema_error(ctx, let->common.span, "duplicate variable definition");
             } else {
                 sym->is_mutable = let->is_mut;
+                sym->loop_depth = ctx->loop_depth;
+                AstExpr* init = let->init;
+                while (init && init->kind == AST_GROUP_EXPR) init = init->as.group.inner;
+                if (init && init->kind == AST_SPAWN_EXPR) sym->spawn_init = init;
             }
             break;
         }
@@ -569,6 +866,10 @@ void sema_check_stmt(SemaContext* ctx, AstStmt* stmt) {
             break;
             
         case AST_RETURN_STMT: {
+            if (ctx->in_parallel) {
+                sema_error(ctx, stmt->as.return_stmt.common.span,
+                          "return inside parallel loop");
+            }
             Type* ret_type = stmt->as.return_stmt.value 
                 ? sema_infer_expr(ctx, stmt->as.return_stmt.value)
                 : type_unit(&ctx->type_arena);
@@ -602,7 +903,9 @@ void sema_check_stmt(SemaContext* ctx, AstStmt* stmt) {
             }
             bool was_in_loop = ctx->in_loop;
             ctx->in_loop = true;
+            ctx->loop_depth++;
             check_block(ctx, while_stmt->body);
+            ctx->loop_depth--;
             ctx->in_loop = was_in_loop;
             break;
         }
@@ -612,13 +915,11 @@ void sema_check_stmt(SemaContext* ctx, AstStmt* stmt) {
             /* Infer iterable type */
             Type* iter_type = sema_infer_expr(ctx, for_stmt->iterable);
             
-            /* Create constraint: iter_type must be array or range of 'elem_type' */
-            Type* elem_type = type_var(&ctx->type_arena);
-            Type* array_type = type_array(&ctx->type_arena, elem_type);
-            
-            /* Attempt unify with array (TODO: Trait-based Iterable) */
-            if (!type_unify(iter_type, array_type)) {
-                /* If failed, maybe it's something else? for now just warn/error or allow loose typing via var */
+            /* Only arrays and slices are iterable for now */
+            Type* elem_type = array_element_type(ctx, iter_type);
+            if (!elem_type) {
+                sema_error(ctx, for_stmt->common.span, "'for' requires an array to iterate over");
+                elem_type = type_error(&ctx->type_arena);
             }
             
             /* Scope for loop variable */
@@ -628,7 +929,9 @@ void sema_check_stmt(SemaContext* ctx, AstStmt* stmt) {
             
             bool was_in_loop = ctx->in_loop;
             ctx->in_loop = true;
+            ctx->loop_depth++;
             check_block(ctx, for_stmt->body);
+            ctx->loop_depth--;
             ctx->in_loop = was_in_loop;
             scope_pop(&ctx->symbols);
             break;
@@ -637,7 +940,9 @@ void sema_check_stmt(SemaContext* ctx, AstStmt* stmt) {
         case AST_LOOP_STMT: {
             bool was_in_loop = ctx->in_loop;
             ctx->in_loop = true;
+            ctx->loop_depth++;
             check_block(ctx, stmt->as.loop_stmt.body);
+            ctx->loop_depth--;
             ctx->in_loop = was_in_loop;
             break;
         }
@@ -646,7 +951,38 @@ void sema_check_stmt(SemaContext* ctx, AstStmt* stmt) {
             sema_infer_expr(ctx, stmt->as.spawn_stmt.expr);
             break;
             
+        case AST_AWAIT_STMT: {
+            /*
+             * The handle must outlive the process, so it is spawned
+             * joinable and released by the await: that needs the one
+             * spawn it came from, awaited at most once.
+             */
+            AstAwaitStmt* aw = &stmt->as.await_stmt;
+            sema_infer_expr(ctx, aw->process);
+            Symbol* sym = NULL;
+            if (aw->process->kind == AST_IDENT_EXPR) {
+                sym = symbol_lookup(&ctx->symbols, aw->process->as.ident.name,
+                                    aw->process->as.ident.name_len);
+            }
+            if (ctx->in_parallel) {
+                sema_error(ctx, aw->common.span, "await inside parallel loop");
+            } else if (!sym || !sym->spawn_init || sym->is_mutable) {
+                sema_error(ctx, aw->common.span,
+                          "await needs an immutable binding initialized by spawn");
+            } else if (sym->awaited || sym->loop_depth != ctx->loop_depth) {
+                sema_error(ctx, aw->common.span, "process may be awaited more than once");
+            } else {
+                sym->awaited = true;
+                sym->spawn_init->as.spawn_expr.joinable = true;
+            }
+            break;
+        }
+            
         case AST_RECEIVE_STMT:
+            if (ctx->in_parallel) {
+                sema_error(ctx, stmt->as.receive_stmt.common.span,
+                          "receive inside parallel loop");
+            }
             /* Check receive arms */
             for (size_t i = 0; i < stmt->as.receive_stmt.arm_count; i++) {
                 ReceiveArm* arm = &stmt->as.receive_stmt.arms[i];
@@ -668,6 +1004,71 @@ void sema_check_stmt(SemaContext* ctx, AstStmt* stmt) {
             }
             break;
             
+        case AST_SELECT_STMT:
+            if (ctx->in_parallel) {
+                sema_error(ctx, stmt->as.select_stmt.common.span,
+                          "select inside parallel loop");
+            }
+            for (size_t i = 0; i < stmt->as.select_stmt.arm_count; i++) {
+                SelectArm* arm = &stmt->as.select_stmt.arms[i];
+                if (arm->channel) {
+                    sema_infer_expr(ctx, arm->channel);
+                }
+                if (arm->body) {
+                    /* The binding is the channel value or the message tag */
+                    scope_push(&ctx->symbols);
+                    symbol_define(&ctx->symbols, arm->binding, arm->binding_len,
+                                  SYMBOL_VAR, type_var(&ctx->type_arena), (Span){0});
+                    for (size_t j = 0; j < arm->body->stmt_count; j++) {
+                        sema_check_stmt(ctx, arm->body->stmts[j]);
+                    }
+                    scope_pop(&ctx->symbols);
+                }
+            }
+            break;
+            
+        case AST_PARALLEL_STMT: {
+            AstParallelStmt* par = &stmt->as.parallel_stmt;
+            Type* int_type = type_i32(&ctx->type_arena);
+            if (!type_unify(sema_infer_expr(ctx, par->lo), int_type) ||
+                !type_unify(sema_infer_expr(ctx, par->hi), int_type)) {
+                sema_error(ctx, par->common.span, "parallel range bounds must be integers");
+            }
+            
+            Type* acc_type = NULL;
+            if (par->acc_name) {
+                Symbol* acc = symbol_lookup(&ctx->symbols, par->acc_name, par->acc_name_len);
+                if (!acc) {
+                    sema_error(ctx, par->common.span, "undefined reduce accumulator");
+                } else if (!acc->is_mutable) {
+                    sema_error(ctx, par->common.span, "reduce accumulator must be mutable");
+                } else if (!type_unify(acc->type, int_type)) {
+                    sema_error(ctx, par->common.span, "reduce accumulator must be an integer");
+                }
+                acc_type = int_type;
+            }
+            
+            /* Each chunk gets its own index and a private accumulator */
+            scope_push(&ctx->symbols);
+            symbol_define(&ctx->symbols, par->var_name, par->var_name_len,
+                          SYMBOL_VAR, int_type, par->common.span);
+            if (acc_type) {
+                Symbol* local = symbol_define(&ctx->symbols, par->acc_name, par->acc_name_len,
+                                              SYMBOL_VAR, acc_type, par->common.span);
+                if (local) local->is_mutable = true;
+            }
+            
+            bool was_in_loop = ctx->in_loop;
+            bool was_in_parallel = ctx->in_parallel;
+            ctx->in_loop = false;
+            ctx->in_parallel = true;
+            check_block(ctx, par->body);
+            ctx->in_loop = was_in_loop;
+            ctx->in_parallel = was_in_parallel;
+            scope_pop(&ctx->symbols);
+            break;
+        }
+            
         case AST_BREAK_STMT:
         case AST_CONTINUE_STMT:
             if (!ctx->in_loop) {
@@ -726,6 +1127,11 @@ static void check_function(SemaContext* ctx, AstFnDecl* fn, const char* override
     ctx->current_fn_return = saved_return;
     scope_pop(&ctx->symbols);
     
+    /* Vectors are passed by address; there is no return slot to hand one back in */
+    if (type_is_vector(ret_type)) {
+        sema_error(ctx, fn->common.span, "functions cannot return SIMD vectors");
+    }
+    
     /* Build function type */
     Type* fn_type = type_fn(&ctx->type_arena, param_types, fn->param_count, ret_type);
     
@@ -733,8 +1139,77 @@ static void check_function(SemaContext* ctx, AstFnDecl* fn, const char* override
     if (override_name) {
         char* permanent_name = my_strdup(override_name);
         symbol_define(&ctx->symbols, permanent_name, strlen(permanent_name), SYMBOL_FN, fn_type, fn->common.span);
-    } else {
-        symbol_define(&ctx->symbols, fn->name, fn->name_len, SYMBOL_FN, fn_type, fn->common.span);
+    } else if (!symbol_define(&ctx->symbols, fn->name, fn->name_len, SYMBOL_FN, fn_type, fn->common.span)) {
+        /* Forward-declared in the first pass: bind it to the checked signature */
+        Symbol* fwd = symbol_lookup_current(&ctx->symbols, fn->name, fn->name_len);
+        if (fwd && fwd->kind == SYMBOL_FN && !fwd->is_defined) {
+            fwd->is_defined = true;
+            if (!type_unify(fwd->type, fn_type)) {
+                sema_error(ctx, fn->common.span, "function type does not match its uses");
+            }
+        }
+    }
+}
+
+static bool type_name_is(const char* name, uint32_t name_len, const char* expected) {
+    return strlen(expected) == name_len && memcmp(name, expected, name_len) == 0;
+}
+
+/* Type of an annotation. Names sema does not know (actors, structs)
+ * become type variables and are settled by the field's uses. */
+static Type* resolve_type_ann(SemaContext* ctx, AstType* ann) {
+    TypeArena* arena = &ctx->type_arena;
+    switch (ann->kind) {
+        case AST_TYPE_IDENT: {
+            const char* name = ann->as.ident.name;
+            uint32_t len = ann->as.ident.name_len;
+            if (type_name_is(name, len, "i32"))    return type_i32(arena);
+            if (type_name_is(name, len, "i64"))    return type_i64(arena);
+            if (type_name_is(name, len, "f32"))    return type_f32(arena);
+            if (type_name_is(name, len, "f64"))    return type_f64(arena);
+            if (type_name_is(name, len, "bool"))   return type_bool(arena);
+            if (type_name_is(name, len, "char"))   return type_char(arena);
+            if (type_name_is(name, len, "string")) return type_string(arena);
+            if (type_name_is(name, len, "f32x8"))  return type_f32x8(arena);
+            if (type_name_is(name, len, "i32x8"))  return type_i32x8(arena);
+            if (type_name_is(name, len, "f64x4"))  return type_f64x4(arena);
+            return type_var(arena);
+        }
+        
+        case AST_TYPE_ARRAY:
+            return type_array(arena, resolve_type_ann(ctx, ann->as.array.element_type));
+            
+        case AST_TYPE_OPTIONAL:
+            return type_optional(arena, resolve_type_ann(ctx, ann->as.optional.inner));
+            
+        case AST_TYPE_GENERIC: {
+            AstTypeGeneric* generic = &ann->as.generic;
+            TypeKind kind;
+            size_t arity = 1;
+            if (type_name_is(generic->name, generic->name_len, "vec")) {
+                kind = TYPE_VEC;
+            } else if (type_name_is(generic->name, generic->name_len, "deque")) {
+                kind = TYPE_DEQUE;
+            } else if (type_name_is(generic->name, generic->name_len, "map")) {
+                kind = TYPE_MAP;
+                arity = 2;
+            } else {
+                sema_error(ctx, generic->common.span, "unknown generic type");
+                return type_error(arena);
+            }
+            if (generic->arg_count != arity) {
+                sema_error(ctx, generic->common.span, "wrong number of type arguments");
+                return type_error(arena);
+            }
+            Type* key = arity == 2 ? resolve_type_ann(ctx, generic->args[0]) : NULL;
+            Type* collection = type_collection(arena, kind, key,
+                                               resolve_type_ann(ctx, generic->args[arity - 1]));
+            track_collection(ctx, collection, generic->common.span);
+            return collection;
+        }
+        
+        default:
+            return type_var(arena);
     }
 }
 
@@ -764,27 +1239,10 @@ static void check_actor(SemaContext* ctx, AstActorDecl* actor) {
         for (size_t i = 0; i < actor->field_count; i++) {
             AstLetStmt* field = actor->fields[i];
             Type* field_type = type_var(&ctx->type_arena);
-            if (field->type_ann) {
-                /* TODO: parse type annotation to Type*? 
-                   We don't have sema_resolve_type yet? 
-                   Wait, types.c has type constructors but parser returns AstType. 
-                   We need to lower AstType to Type*.
-                   We don't have that helper visible here? 
-                   Let's assume generic type_var for now if annotation resolver missing.
-                   Actually we really need `sema_resolve_type` for explicit fields.
-                   For now, let's just use `type_i32` if we can't resolve, 
-                   or leave as var and rely on init?
-                   But fields usually require explicit types in structs.
-                */
-                 /* Hack: if init exists, infer from it. If not, default to i32? */
-                 if (field->init) {
-                     field_type = sema_infer_expr(ctx, field->init);
-                 } else {
-                     /* Fallback to i32 for demo if no annotation resolver */
-                     field_type = type_i32(&ctx->type_arena); 
-                 }
-            } else if (field->init) {
+            if (field->init) {
                 field_type = sema_infer_expr(ctx, field->init);
+            } else if (field->type_ann) {
+                field_type = resolve_type_ann(ctx, field->type_ann);
             }
             
             actor_type->as.actor.fields[i].name = field->name;
@@ -831,6 +1289,13 @@ static void check_actor(SemaContext* ctx, AstActorDecl* actor) {
     
     ctx->in_actor = was_in_actor;
     ctx->cur_actor = was_cur_actor;
+    
+    /* Actor state slots are 8 bytes wide */
+    for (size_t i = 0; i < actor_type->as.actor.field_count; i++) {
+        if (type_is_vector(actor_type->as.actor.fields[i].type)) {
+            sema_error(ctx, actor->fields[i]->common.span, "actor fields cannot be SIMD vectors");
+        }
+    }
 }
 
 static void check_struct_decl(SemaContext* ctx, AstStructDecl* decl) {
@@ -942,5 +1407,6 @@ bool sema_analyze(SemaContext* ctx, AstProgram* program) {
         sema_check_decl(ctx, program->decls[i]);
     }
     
+    check_collections(ctx);
     return !ctx->had_error;
 }
@@ -90,6 +90,9 @@ Symbol* symbol_define(SymbolTable* table, const char* name, uint32_t name_len,
     sym->def_span = span;
     sym->is_mutable = false;
     sym->is_defined = true;
+    sym->spawn_init = NULL;
+    sym->loop_depth = 0;
+    sym->awaited = false;
     
     /* Insert into hash table */
     uint32_t bucket = hash_name(name, name_len) % SCOPE_BUCKET_COUNT;
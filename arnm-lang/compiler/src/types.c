@@ -43,8 +43,8 @@ void type_arena_destroy(TypeArena* arena) {
  * ============================================================ */
 
 /* Static storage for primitive types - these are never freed */
-static Type primitive_storage[16];
-static Type* primitive_cache[16] = {0};
+static Type primitive_storage[TYPE_ERROR + 1];
+static Type* primitive_cache[TYPE_ERROR + 1] = {0};
 
 static Type* get_or_create_primitive(TypeArena* arena, TypeKind kind) {
     (void)arena;  /* Primitives don't use arena - they're eternal singletons */
@@ -69,6 +69,9 @@ Type* type_f32(TypeArena* arena) { return get_or_create_primitive(arena, TYPE_F3
 Type* type_f64(TypeArena* arena) { return get_or_create_primitive(arena, TYPE_F64); }
 Type* type_string(TypeArena* arena) { return get_or_create_primitive(arena, TYPE_STRING); }
 Type* type_char(TypeArena* arena) { return get_or_create_primitive(arena, TYPE_CHAR); }
+Type* type_f32x8(TypeArena* arena) { return get_or_create_primitive(arena, TYPE_F32X8); }
+Type* type_i32x8(TypeArena* arena) { return get_or_create_primitive(arena, TYPE_I32X8); }
+Type* type_f64x4(TypeArena* arena) { return get_or_create_primitive(arena, TYPE_F64X4); }
 Type* type_error(TypeArena* arena) { return get_or_create_primitive(arena, TYPE_ERROR); }
 
 /* ============================================================
@@ -109,12 +112,28 @@ Type* type_fn(TypeArena* arena, Type** params, size_t param_count, Type* ret) {
 }
 
 Type* type_array(TypeArena* arena, Type* elem) {
+    return type_array_sized(arena, elem, -1);
+}
+
+Type* type_array_sized(TypeArena* arena, Type* elem, int64_t length) {
     Type* type = type_arena_alloc(arena, sizeof(Type));
     if (!type) return NULL;
     
     type->kind = TYPE_ARRAY;
     type->perm = PERM_UNKNOWN;
     type->as.array.element_type = elem;
+    type->as.array.length = length;
+    return type;
+}
+
+Type* type_collection(TypeArena* arena, TypeKind kind, Type* key, Type* elem) {
+    Type* type = type_arena_alloc(arena, sizeof(Type));
+    if (!type) return NULL;
+    
+    type->kind = kind;
+    type->perm = PERM_UNIQUE;   /* Owned by one process */
+    type->as.collection.key_type = key;
+    type->as.collection.element_type = elem;
     return type;
 }
 
@@ -214,11 +233,21 @@ bool type_equals(Type* a, Type* b) {
             return true;
             
         case TYPE_ARRAY:
+            if (a->as.array.length != b->as.array.length) return false;
             return type_equals(a->as.array.element_type, b->as.array.element_type);
             
         case TYPE_OPTIONAL:
             return type_equals(a->as.optional.inner_type, b->as.optional.inner_type);
             
+        case TYPE_VEC:
+        case TYPE_MAP:
+        case TYPE_DEQUE:
+            if (a->kind == TYPE_MAP &&
+                !type_equals(a->as.collection.key_type, b->as.collection.key_type)) {
+                return false;
+            }
+            return type_equals(a->as.collection.element_type, b->as.collection.element_type);
+            
         case TYPE_ACTOR:
             if (a->as.actor.name_len != b->as.actor.name_len) return false;
             return memcmp(a->as.actor.name, b->as.actor.name, a->as.actor.name_len) == 0;
@@ -257,6 +286,12 @@ static bool occurs_in(TypeVar* var, Type* type) {
         case TYPE_OPTIONAL:
             return occurs_in(var, type->as.optional.inner_type);
             
+        case TYPE_VEC:
+        case TYPE_MAP:
+        case TYPE_DEQUE:
+            if (type->kind == TYPE_MAP && occurs_in(var, type->as.collection.key_type)) return true;
+            return occurs_in(var, type->as.collection.element_type);
+            
         default:
             return false;
     }
@@ -304,11 +339,27 @@ bool type_unify(Type* a, Type* b) {
             return type_unify(a->as.fn.return_type, b->as.fn.return_type);
             
         case TYPE_ARRAY:
+            /* A fixed-size array meeting a different length (or a slice)
+             * decays to a slice on both sides: the static length is only
+             * trusted once inference is over, so widening here is safe */
+            if (a->as.array.length != b->as.array.length) {
+                a->as.array.length = -1;
+                b->as.array.length = -1;
+            }
             return type_unify(a->as.array.element_type, b->as.array.element_type);
             
         case TYPE_OPTIONAL:
             return type_unify(a->as.optional.inner_type, b->as.optional.inner_type);
             
+        case TYPE_VEC:
+        case TYPE_MAP:
+        case TYPE_DEQUE:
+            if (a->kind == TYPE_MAP &&
+                !type_unify(a->as.collection.key_type, b->as.collection.key_type)) {
+                return false;
+            }
+            return type_unify(a->as.collection.element_type, b->as.collection.element_type);
+            
         case TYPE_ACTOR:
             return type_equals(a, b);
             
@@ -340,11 +391,29 @@ bool type_has_free_vars(Type* type) {
         case TYPE_OPTIONAL:
             return type_has_free_vars(type->as.optional.inner_type);
             
+        case TYPE_VEC:
+        case TYPE_MAP:
+        case TYPE_DEQUE:
+            if (type->kind == TYPE_MAP && type_has_free_vars(type->as.collection.key_type)) return true;
+            return type_has_free_vars(type->as.collection.element_type);
+            
         default:
             return false;
     }
 }
 
+bool type_is_vector(Type* type) {
+    type = type_resolve(type);
+    return type && (type->kind == TYPE_F32X8 || type->kind == TYPE_I32X8 ||
+                    type->kind == TYPE_F64X4);
+}
+
+bool type_is_collection(Type* type) {
+    type = type_resolve(type);
+    return type && (type->kind == TYPE_VEC || type->kind == TYPE_MAP ||
+                    type->kind == TYPE_DEQUE);
+}
+
 /* ============================================================
  * Type Printing
  * ============================================================ */
@@ -367,6 +436,12 @@ const char* type_kind_name(TypeKind kind) {
         case TYPE_ARRAY:    return "array";
         case TYPE_OPTIONAL: return "optional";
         case TYPE_PROCESS:  return "Process";
+        case TYPE_F32X8:    return "f32x8";
+        case TYPE_I32X8:    return "i32x8";
+        case TYPE_F64X4:    return "f64x4";
+        case TYPE_VEC:      return "vec";
+        case TYPE_MAP:      return "map";
+        case TYPE_DEQUE:    return "deque";
         case TYPE_ERROR:    return "<error>";
         default:            return "?";
     }
@@ -402,9 +477,13 @@ int type_print(Type* type, char* buf, size_t buf_size) {
         }
         
         case TYPE_ARRAY: {
-            int len = snprintf(buf, buf_size, "[");
-            len += type_print(type->as.array.element_type, buf + len, buf_size - len);
-            len += snprintf(buf + len, buf_size - len, "]");
+            int len = type_print(type->as.array.element_type, buf, buf_size);
+            if (type->as.array.length >= 0) {
+                len += snprintf(buf + len, buf_size - len, "[%lld]",
+                                (long long)type->as.array.length);
+            } else {
+                len += snprintf(buf + len, buf_size - len, "[]");
+            }
             return len;
         }
         
@@ -414,6 +493,19 @@ int type_print(Type* type, char* buf, size_t buf_size) {
             return len;
         }
         
+        case TYPE_VEC:
+        case TYPE_MAP:
+        case TYPE_DEQUE: {
+            int len = snprintf(buf, buf_size, "%s<", type_kind_name(type->kind));
+            if (type->kind == TYPE_MAP) {
+                len += type_print(type->as.collection.key_type, buf + len, buf_size - len);
+                len += snprintf(buf + len, buf_size - len, ", ");
+            }
+            len += type_print(type->as.collection.element_type, buf + len, buf_size - len);
+            len += snprintf(buf + len, buf_size - len, ">");
+            return len;
+        }
+        
         case TYPE_ACTOR:
             return snprintf(buf, buf_size, "%.*s", 
                 (int)type->as.actor.name_len, type->as.actor.name);
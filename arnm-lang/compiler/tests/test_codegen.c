@@ -4,7 +4,10 @@
 
 #define _POSIX_C_SOURCE 200809L
 #include "../include/irgen.h"
+#include "../include/opt.h"
 #include "../include/codegen.h"
+#include "../include/codegen_c.h"
+#include "../include/codegen_wasm.h"
 #include "../include/parser.h"
 #include "../include/sema.h"
 #include <stdio.h>
@@ -49,7 +52,7 @@ static void test_codegen_stdout(void) {
                My IR gen emits ADD for literal addition currently, doesn't constant fold yet. 
                Wait, 30 + 12 -> 42? No, `gen_binary` emits `ir_build_add`.
             */
-            if (strstr(buf, "define i32 @main()")) {
+            if (strstr(buf, "define i32 @_arnm_main()")) {
                 if (strstr(buf, "add i32 30, 12") || strstr(buf, "add i32")) {
                     printf(" OK\n");
                 } else {
@@ -72,8 +75,366 @@ static void test_codegen_stdout(void) {
     ast_arena_destroy(&arena);
 }
 
+/* Emit LLVM for `src` after -O<opt_level> IR passes; returns a malloc'd string or NULL */
+static char* emit_llvm(const char* src, int opt_level) {
+    AstArena arena;
+    ast_arena_init(&arena, 1024 * 1024);
+
+    Lexer lexer;
+    lexer_init(&lexer, src, strlen(src));
+    Parser parser;
+    parser_init(&parser, &lexer, &arena);
+    AstProgram* prog = parser_parse_program(&parser);
+
+    char* buf = NULL;
+    SemaContext sema;
+    sema_init(&sema);
+    IrModule mod;
+    if (parser_success(&parser) && sema_analyze(&sema, prog) && ir_generate(&sema, prog, &mod)) {
+        ir_optimize(&mod, opt_level);
+        size_t size;
+        FILE* mem = open_memstream(&buf, &size);
+        codegen_emit(&mod, mem);
+        fclose(mem);
+        ir_module_destroy(&mod);
+    }
+    sema_destroy(&sema);
+    ast_arena_destroy(&arena);
+    return buf;
+}
+
+static void test_codegen_actor(void) {
+    printf("  codegen_actor...");
+
+    char* buf = emit_llvm(
+        "actor Counter {\n"
+        "    let count: i32;\n"
+        "    fn init() { self.count = 0; }\n"
+        "    receive { val => { self.count = self.count + val; } }\n"
+        "}\n"
+        "fn main() { let c = spawn Counter.init(); c ! 10; }\n", 0);
+    if (!buf) {
+        printf(" FAIL (frontend)\n");
+        return;
+    }
+
+    const char* expect[] = {
+        "declare i32 @arnm_send(ptr, i64, ptr, i64)",           /* Every runtime call declared */
+        "call ptr @arnm_spawn(ptr @Counter_init, ptr null, i64 8)",
+        "!invariant.load",                                      /* Actor state pointer */
+        "getelementptr inbounds i8, ptr",                       /* Field address */
+        "define void @_arnm_main()",
+    };
+    for (size_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        if (!strstr(buf, expect[i])) {
+            printf(" FAIL (missing '%s')\n", expect[i]);
+            printf("Output:\n%s\n", buf);
+            free(buf);
+            return;
+        }
+    }
+    /* Values are named, so LLVM's sequential numbering never applies */
+    if (strstr(buf, " %0") || strstr(buf, "ptr 0,")) {
+        printf(" FAIL (unnamed value or untyped null)\n");
+    } else {
+        printf(" OK\n");
+    }
+    free(buf);
+}
+
+static void test_codegen_simd(void) {
+    printf("  codegen_simd...");
+
+    char* buf = emit_llvm(
+        "fn scale(v: f64x4, k: f64) -> f64 { return f64x4_sum(v * f64x4_splat(k)); }\n"
+        "fn main() {\n"
+        "    let x = 0.5;\n"
+        "    if x * 2.0 > 0.75 { print(scale(f64x4_splat(x), -x)); }\n"
+        "}\n", 0);
+    if (!buf) {
+        printf(" FAIL (frontend)\n");
+        return;
+    }
+
+    const char* expect[] = {
+        "define double @scale(ptr",                             /* Vectors by address */
+        "alloca [4 x i64], align 32",
+        "fmul <4 x double>",                                    /* Operators inline */
+        "call double @arnm_f64x4_reduce(ptr",
+        "fmul double",
+        "fcmp ogt double",
+        "0x3FE0000000000000",                                   /* 0.5, exactly */
+        "call void @arnm_print_f64(double",
+    };
+    for (size_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        if (!strstr(buf, expect[i])) {
+            printf(" FAIL (missing '%s')\n", expect[i]);
+            printf("Output:\n%s\n", buf);
+            free(buf);
+            return;
+        }
+    }
+    printf(" OK\n");
+    free(buf);
+}
+
+static void test_codegen_arrays(void) {
+    printf("  codegen_arrays...");
+
+    char* buf = emit_llvm(
+        "fn sum(a: i32[]) -> i32 {\n"
+        "    let mut s = 0;\n"
+        "    let mut i = 0;\n"
+        "    while i < len(a) { s = s + a[i]; i = i + 1; }\n"
+        "    return s;\n"
+        "}\n"
+        "fn fill(mut a: i32[], n: i32) { let mut i = 0; while i < n { a[i] = 1; i = i + 1; } }\n"
+        "fn main() { let mut b = [0; 8]; fill(b, 4); print(sum(b[2..])); }\n", 0);
+    if (!buf) {
+        printf(" FAIL (frontend)\n");
+        return;
+    }
+
+    const char* expect[] = {
+        "call ptr @arnm_array_new(i64 8)",
+        "call ptr @arnm_array_slice(ptr",
+        "!invariant.load",                                      /* Length and data */
+        "icmp sle i32",                                         /* fill's version test */
+    };
+    for (size_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        if (!strstr(buf, expect[i])) {
+            printf(" FAIL (missing '%s')\n", expect[i]);
+            printf("Output:\n%s\n", buf);
+            free(buf);
+            return;
+        }
+    }
+    /* sum and main need no checks; only fill's fallback loop keeps one */
+    int checks = 0;
+    for (const char* p = buf; (p = strstr(p, "call void @arnm_panic_bounds")); p++) checks++;
+    if (checks != 1) {
+        printf(" FAIL (%d bounds checks, expected 1)\n", checks);
+    } else {
+        printf(" OK\n");
+    }
+    free(buf);
+}
+
+static void test_codegen_collections(void) {
+    printf("  codegen_collections...");
+
+    char* buf = emit_llvm(
+        "fn main() {\n"
+        "    let m = map_new();\n"
+        "    map_put(m, 3, 2.5);\n"
+        "    if map_has(m, 3) { print(map_get(m, 3)); }\n"
+        "    let v = vec_new();\n"
+        "    vec_push(v, 4);\n"
+        "    print(len(v));\n"
+        "}\n", 0);
+    if (!buf) {
+        printf(" FAIL (frontend)\n");
+        return;
+    }
+
+    /* Runtime calls hand back slots; the element type picks the access */
+    const char* expect[] = {
+        "declare nonnull ptr @arnm_map_slot(ptr, i64)",
+        "call ptr @arnm_map_new()",
+        "store double 0x4004000000000000, ptr",
+        "icmp ne i32",
+        "load double, ptr",
+        "store i32 4, ptr",
+        "call i32 @arnm_vec_len(ptr",
+    };
+    for (size_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        if (!strstr(buf, expect[i])) {
+            printf(" FAIL (missing '%s')\n", expect[i]);
+            printf("Output:\n%s\n", buf);
+            free(buf);
+            return;
+        }
+    }
+    printf(" OK\n");
+    free(buf);
+}
+
+static void test_codegen_loops(void) {
+    printf("  codegen_loops...");
+
+    const char* src =
+        "fn saxpy(mut y: f64[], x: f64[], k: f64) {\n"
+        "    let mut i = 0;\n"
+        "    while i < len(y) { y[i] = y[i] + k * x[i]; i = i + 1; }\n"
+        "}\n"
+        "fn main() {\n"
+        "    let mut s = 0;\n"
+        "    for v in [1, 2, 3] { s = s + v; }\n"
+        "    let mut y = [0.5; 8];\n"
+        "    saxpy(y, [1.5; 8], 2.0);\n"
+        "    print(s);\n"
+        "}\n";
+    char* o2 = emit_llvm(src, 2);
+    char* o3 = emit_llvm(src, 3);
+    if (!o2 || !o3) {
+        printf(" FAIL (frontend)\n");
+        free(o2);
+        free(o3);
+        return;
+    }
+
+    /* -O2 unrolls: the for loop is gone, saxpy steps four at a time */
+    const char* fail = NULL;
+    const char* out = o2;
+    if (!strstr(o2, "unroll.body") || strstr(o2, "for.cond")) fail = "-O2 unrolling";
+    else if (strstr(o2, "<4 x double>")) fail = "-O2 vectorized";
+
+    /* -O3 runs saxpy on vectors once the arrays are known not to overlap */
+    if (!fail) {
+        out = o3;
+        if (!strstr(o3, "fmul <4 x double>") || !strstr(o3, "fadd <4 x double>")) fail = "-O3 vector body";
+        else if (!strstr(o3, "call i32 @arnm_array_aliased(ptr")) fail = "-O3 alias test";
+    }
+
+    if (fail) {
+        printf(" FAIL (%s)\n", fail);
+        printf("Output:\n%s\n", out);
+    } else {
+        printf(" OK\n");
+    }
+    free(o2);
+    free(o3);
+}
+
+static void test_codegen_c(void) {
+    printf("  codegen_c...");
+
+    const char* src =
+        "fn main() {\n"
+        "    let mut i = 0;\n"
+        "    while i < 10 { i = i + 1; }\n"
+        "    let w = spawn worker(i);\n"
+        "}\n"
+        "fn worker(n: i32) { print(n); }\n";
+
+    AstArena arena;
+    ast_arena_init(&arena, 1024 * 1024);
+    Lexer lexer;
+    lexer_init(&lexer, src, strlen(src));
+    Parser parser;
+    parser_init(&parser, &lexer, &arena);
+    AstProgram* prog = parser_parse_program(&parser);
+    SemaContext sema;
+    sema_init(&sema);
+    IrModule mod;
+    if (!parser_success(&parser) || !sema_analyze(&sema, prog) || !ir_generate(&sema, prog, &mod)) {
+        printf(" FAIL (frontend)\n");
+        sema_destroy(&sema);
+        ast_arena_destroy(&arena);
+        return;
+    }
+
+    char* buf;
+    size_t size;
+    FILE* mem = open_memstream(&buf, &size);
+    c_emit(&mod, mem);
+    fclose(mem);
+
+    const char* expect[] = {
+        "#include \"arnm.h\"",
+        "void _arnm_main(void) {",
+        "static void fn_worker(int32_t v0) {",
+        "int32_t s",                                        /* `i` is a typed local, not a slot */
+        "goto L",
+        "arnm_spawn((void (*)(void*))((void*)fn_worker), (void*)(intptr_t)(v",
+        "arnm_print_int(",
+    };
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+        if (!strstr(buf, expect[i])) {
+            printf(" FAIL (missing '%s')\n", expect[i]);
+            printf("Output:\n%s\n", buf);
+            ok = false;
+            break;
+        }
+    }
+    if (ok) printf(" OK\n");
+
+    free(buf);
+    ir_module_destroy(&mod);
+    sema_destroy(&sema);
+    ast_arena_destroy(&arena);
+}
+
+static bool contains(const char* buf, size_t size, const char* needle) {
+    size_t n = strlen(needle);
+    for (size_t i = 0; i + n <= size; i++) {
+        if (memcmp(buf + i, needle, n) == 0) return true;
+    }
+    return false;
+}
+
+static void test_codegen_wasm(void) {
+    printf("  codegen_wasm...");
+
+    const char* src =
+        "fn main() {\n"
+        "    let mut i = 0;\n"
+        "    while i < 10 { if i == 5 { break; } i = i + 1; }\n"
+        "    let w = spawn worker(i);\n"
+        "}\n"
+        "fn worker(n: i32) { print(n); }\n";
+
+    AstArena arena;
+    ast_arena_init(&arena, 1024 * 1024);
+    Lexer lexer;
+    lexer_init(&lexer, src, strlen(src));
+    Parser parser;
+    parser_init(&parser, &lexer, &arena);
+    AstProgram* prog = parser_parse_program(&parser);
+    SemaContext sema;
+    sema_init(&sema);
+    IrModule mod;
+    if (!parser_success(&parser) || !sema_analyze(&sema, prog) || !ir_generate(&sema, prog, &mod)) {
+        printf(" FAIL (frontend)\n");
+        sema_destroy(&sema);
+        ast_arena_destroy(&arena);
+        return;
+    }
+
+    char* buf;
+    size_t size;
+    FILE* mem = open_memstream(&buf, &size);
+    bool emitted = wasm_emit(&mod, mem);
+    fclose(mem);
+
+    /* Runtime imports, the entry point and the table the shim calls through */
+    const char* expect[] = { "arnm_spawn", "arnm_print_int", "_arnm_main", "__indirect_function_table" };
+    bool ok = emitted && size > 8 && memcmp(buf, "\0asm\1\0\0\0", 8) == 0;
+    if (!ok) printf(" FAIL (bad module header)\n");
+    for (size_t i = 0; ok && i < sizeof(expect) / sizeof(expect[0]); i++) {
+        if (!contains(buf, size, expect[i])) {
+            printf(" FAIL (missing '%s')\n", expect[i]);
+            ok = false;
+        }
+    }
+    if (ok) printf(" OK\n");
+
+    free(buf);
+    ir_module_destroy(&mod);
+    sema_destroy(&sema);
+    ast_arena_destroy(&arena);
+}
+
 int main(void) {
     printf("Running Codegen tests:\n");
     test_codegen_stdout();
+    test_codegen_actor();
+    test_codegen_simd();
+    test_codegen_arrays();
+    test_codegen_collections();
+    test_codegen_loops();
+    test_codegen_c();
+    test_codegen_wasm();
     return 0;
 }
@@ -210,6 +210,60 @@ TEST(receive_block) {
     ast_arena_destroy(&arena);
 }
 
+TEST(select_block) {
+    const char* src = "fn main() { select { v := a => { } w := b => { } receive t => { } } }";
+    AstArena arena;
+    Parser parser;
+    AstProgram* prog = parse_source(src, &arena, &parser);
+    
+    ASSERT(parser_success(&parser));
+    AstBlock* body = prog->decls[0]->as.fn_decl.body;
+    ASSERT_EQ(body->stmt_count, 1);
+    ASSERT_EQ(body->stmts[0]->kind, AST_SELECT_STMT);
+    AstSelectStmt* sel = &body->stmts[0]->as.select_stmt;
+    ASSERT_EQ(sel->arm_count, 3);
+    ASSERT(sel->arms[0].channel != NULL);
+    ASSERT(sel->arms[2].channel == NULL);
+    ASSERT_EQ(sel->arms[2].binding_len, 1);
+    
+    ast_arena_destroy(&arena);
+}
+
+TEST(parallel_loops) {
+    const char* src = "fn main() { parallel for i in 0..n { } parallel reduce(*) p for i in 1..10 { } }";
+    AstArena arena;
+    Parser parser;
+    AstProgram* prog = parse_source(src, &arena, &parser);
+    
+    ASSERT(parser_success(&parser));
+    AstBlock* body = prog->decls[0]->as.fn_decl.body;
+    ASSERT_EQ(body->stmt_count, 2);
+    ASSERT_EQ(body->stmts[0]->kind, AST_PARALLEL_STMT);
+    ASSERT(body->stmts[0]->as.parallel_stmt.acc_name == NULL);
+    ASSERT_EQ(body->stmts[0]->as.parallel_stmt.hi->kind, AST_IDENT_EXPR);
+    AstParallelStmt* red = &body->stmts[1]->as.parallel_stmt;
+    ASSERT(red->acc_name != NULL);
+    ASSERT_EQ(red->acc_name_len, 1);
+    ASSERT_EQ(red->reduce_op, BINARY_MUL);
+    
+    ast_arena_destroy(&arena);
+}
+
+TEST(await_statement) {
+    const char* src = "fn main() { let p = spawn w(); await p; }";
+    AstArena arena;
+    Parser parser;
+    AstProgram* prog = parse_source(src, &arena, &parser);
+    
+    ASSERT(parser_success(&parser));
+    AstBlock* body = prog->decls[0]->as.fn_decl.body;
+    ASSERT_EQ(body->stmt_count, 2);
+    ASSERT_EQ(body->stmts[1]->kind, AST_AWAIT_STMT);
+    ASSERT_EQ(body->stmts[1]->as.await_stmt.process->kind, AST_IDENT_EXPR);
+    
+    ast_arena_destroy(&arena);
+}
+
 TEST(binary_expressions) {
     const char* src = "fn main() { let x = 1 + 2 * 3; }";
     AstArena arena;
@@ -262,6 +316,9 @@ int main(void) {
     RUN_TEST(spawn_statement);
     RUN_TEST(message_send);
     RUN_TEST(receive_block);
+    RUN_TEST(select_block);
+    RUN_TEST(parallel_loops);
+    RUN_TEST(await_statement);
     RUN_TEST(binary_expressions);
     RUN_TEST(call_expression);
     
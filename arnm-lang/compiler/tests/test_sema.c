@@ -163,6 +163,184 @@ TEST(break_inside_loop) {
     ast_arena_destroy(&arena);
 }
 
+TEST(select_arms) {
+    SemaContext ctx;
+    AstArena arena;
+    AstProgram* prog = parse_and_analyze(
+        "fn main() { let c = chan(4); chan_send(c, 1); "
+        "select { v := c => { print(v); } receive t => { print(t); } } }", &ctx, &arena);
+    ASSERT(prog != NULL);
+    ASSERT(!ctx.had_error);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+}
+
+TEST(parallel_reduce) {
+    SemaContext ctx;
+    AstArena arena;
+    AstProgram* prog = parse_and_analyze(
+        "fn main() { let mut s = 0; parallel reduce(+) s for i in 0..100 { s = s + i; } print(s); }",
+        &ctx, &arena);
+    ASSERT(prog != NULL);
+    ASSERT(!ctx.had_error);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+    
+    /* The accumulator must be mutable, and chunks cannot break out */
+    parse_and_analyze("fn main() { let s = 0; parallel reduce(+) s for i in 0..9 { } }", &ctx, &arena);
+    ASSERT(ctx.had_error);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+    
+    parse_and_analyze("fn main() { loop { parallel for i in 0..9 { break; } } }", &ctx, &arena);
+    ASSERT(ctx.had_error);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+}
+
+TEST(await_spawned) {
+    SemaContext ctx;
+    AstArena arena;
+    AstProgram* prog = parse_and_analyze(
+        "fn w() { } fn main() { let p = spawn w(); await p; }", &ctx, &arena);
+    ASSERT(prog != NULL);
+    ASSERT(!ctx.had_error);
+    /* The awaited spawn is marked so its handle outlives the process */
+    AstExpr* init = prog->decls[1]->as.fn_decl.body->stmts[0]->as.let_stmt.init;
+    ASSERT(init->as.spawn_expr.joinable);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+    
+    /* Awaited twice, or in a loop the binding is outside of */
+    parse_and_analyze("fn w() { } fn main() { let p = spawn w(); await p; await p; }", &ctx, &arena);
+    ASSERT(ctx.had_error);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+    
+    parse_and_analyze("fn w() { } fn main() { let p = spawn w(); loop { await p; } }", &ctx, &arena);
+    ASSERT(ctx.had_error);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+    
+    /* Not from a spawn */
+    parse_and_analyze("fn main() { let p = 1; await p; }", &ctx, &arena);
+    ASSERT(ctx.had_error);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+}
+
+TEST(simd_vectors) {
+    SemaContext ctx;
+    AstArena arena;
+    AstProgram* prog = parse_and_analyze(
+        "fn main() { let v = f32x8_splat(1.5) * f32x8_splat(2.0); let s = f32x8_sum(v); "
+        "let n = i32x8_get(i32x8_splat(3), 1); }", &ctx, &arena);
+    ASSERT(prog != NULL);
+    ASSERT(!ctx.had_error);
+    /* Reductions give the lane scalar: f64 for f32x8, i32 for i32x8 */
+    AstStmt** stmts = prog->decls[0]->as.fn_decl.body->stmts;
+    ASSERT(type_resolve(stmts[1]->as.let_stmt.init->as.call.common.sema_type)->kind == TYPE_F64);
+    ASSERT(type_resolve(stmts[2]->as.let_stmt.init->as.call.common.sema_type)->kind == TYPE_I32);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+    
+    /* No remainder, comparison or return of vectors, and lanes must match */
+    const char* bad[] = {
+        "fn main() { let v = i32x8_splat(1) % i32x8_splat(2); }",
+        "fn main() { let b = f64x4_splat(1.0) == f64x4_splat(1.0); }",
+        "fn f() -> f64x4 { return f64x4_splat(1.0); } fn main() { }",
+        "fn main() { let v = f32x8_splat(1.0) + i32x8_splat(1); }",
+        "fn main() { let x = 2.5 % 1.0; }",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        parse_and_analyze(bad[i], &ctx, &arena);
+        ASSERT(ctx.had_error);
+        sema_destroy(&ctx);
+        ast_arena_destroy(&arena);
+    }
+}
+
+TEST(arrays) {
+    SemaContext ctx;
+    AstArena arena;
+    AstProgram* prog = parse_and_analyze(
+        "fn sum(a: i32[]) -> i32 { let mut s = 0; for x in a { s = s + x; } return s; } "
+        "fn main() { let mut a = [1, 2, 3]; a[0] = len(a); let t = sum(a[1..]); }", &ctx, &arena);
+    ASSERT(prog != NULL);
+    ASSERT(!ctx.had_error);
+    /* A literal knows its length; a slice of it does not */
+    AstStmt** stmts = prog->decls[1]->as.fn_decl.body->stmts;
+    Type* lit = type_resolve(stmts[0]->as.let_stmt.init->as.array.common.sema_type);
+    ASSERT(lit->kind == TYPE_ARRAY && lit->as.array.length == 3);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+    
+    const char* bad[] = {
+        "fn main() { let a = [1, 2]; a[0] = 5; }",
+        "fn main() { let mut a = [1, 2]; a[0..1] = a; }",
+        "fn main() { let a = [1, 2.0]; }",
+        "fn main() { let a = [1, 2]; let x = a[1.0]; }",
+        "fn main() { let x = 5; let y = x[0]; }",
+        "fn main() { let n = len(5); }",
+        "fn main() { print([1, 2]); }",
+        "fn main() { for x in 5 { } }",
+        "fn main() { let a = [f64x4_splat(1.0); 2]; }",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        parse_and_analyze(bad[i], &ctx, &arena);
+        ASSERT(ctx.had_error);
+        sema_destroy(&ctx);
+        ast_arena_destroy(&arena);
+    }
+}
+
+TEST(collections) {
+    SemaContext ctx;
+    AstArena arena;
+    AstProgram* prog = parse_and_analyze(
+        "actor Index { let seen: map<i64, bool>; fn init() { self.seen = map_new(); } } "
+        "fn main() { let v = vec_new(); vec_push(v, 1.5); let m = map_new(); "
+        "map_put(m, 7, vec_pop(v)); let d = deque_new(); deque_push_back(d, map_has(m, 7)); "
+        "let n = len(v) + len(m) + len(d); }", &ctx, &arena);
+    ASSERT(prog != NULL);
+    ASSERT(!ctx.had_error);
+    /* Each builtin use gets its own element type */
+    AstStmt** stmts = prog->decls[1]->as.fn_decl.body->stmts;
+    Type* m = type_resolve(stmts[2]->as.let_stmt.init->as.call.common.sema_type);
+    ASSERT(m->kind == TYPE_MAP);
+    ASSERT(type_resolve(m->as.collection.key_type)->kind == TYPE_I32);
+    ASSERT(type_resolve(m->as.collection.element_type)->kind == TYPE_F64);
+    Type* d = type_resolve(stmts[4]->as.let_stmt.init->as.call.common.sema_type);
+    ASSERT(d->kind == TYPE_DEQUE && type_resolve(d->as.collection.element_type)->kind == TYPE_BOOL);
+    /* A field's annotation types it */
+    Symbol* index = symbol_lookup(&ctx.symbols, "Index", 5);
+    ASSERT(index && index->type->kind == TYPE_ACTOR);
+    Type* seen = type_resolve(index->type->as.actor.fields[0].type);
+    ASSERT(seen->kind == TYPE_MAP);
+    ASSERT(type_resolve(seen->as.collection.key_type)->kind == TYPE_I64);
+    ASSERT(type_resolve(seen->as.collection.element_type)->kind == TYPE_BOOL);
+    sema_destroy(&ctx);
+    ast_arena_destroy(&arena);
+    
+    const char* bad[] = {
+        "fn main() { let v = vec_new(); vec_push(v, 1); vec_push(v, true); }",
+        "fn main() { let m = map_new(); map_put(m, 1.5, 2); }",
+        "fn main() { let v = vec_new(); map_put(v, 1, 2); }",
+        "fn main() { let v = vec_new(); vec_push(v, f64x4_splat(1.0)); }",
+        "fn main() { let d = deque_new(); let x = deque_get(d, 1.0); }",
+        "fn main() { print(vec_new()); }",
+        "fn main() { let p = spawn main(); p ! vec_new(); }",
+        "actor A { let t: map<i32>; }",
+        "actor A { let t: list<i32>; }",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        parse_and_analyze(bad[i], &ctx, &arena);
+        ASSERT(ctx.had_error);
+        sema_destroy(&ctx);
+        ast_arena_destroy(&arena);
+    }
+}
+
 /* ============================================================
  * Main
  * ============================================================ */
@@ -181,6 +359,12 @@ int main(void) {
     RUN_TEST(actor_definition);
     RUN_TEST(break_outside_loop);
     RUN_TEST(break_inside_loop);
+    RUN_TEST(select_arms);
+    RUN_TEST(parallel_reduce);
+    RUN_TEST(await_spawned);
+    RUN_TEST(simd_vectors);
+    RUN_TEST(arrays);
+    RUN_TEST(collections);
     
     printf("\n%d/%d tests passed\n", tests_passed, tests_run);
     return tests_passed == tests_run ? 0 : 1;
@@ -60,6 +60,11 @@ async function runArnmCode(source) {
         }
     }
 
+    // Compile to a real wasm module when both the compiler export and the shim are present
+    if (arnmModule._arnm_compile_wasm && window.ArnmRuntime) {
+        return runCompiledModule(source);
+    }
+
     try {
         // Call the compile function
         const result = arnmModule.ccall(
@@ -87,6 +92,41 @@ async function runArnmCode(source) {
     }
 }
 
+// Compile ARNm straight to WebAssembly and run it with the runtime shim
+async function runCompiledModule(source) {
+    const result = arnmModule.ccall('arnm_compile_wasm', 'number', ['string'], [source]);
+    if (result !== 0) {
+        const outputPtr = arnmModule.ccall('arnm_get_output', 'number', [], []);
+        return {
+            success: false,
+            output: arnmModule.UTF8ToString(outputPtr) || '[Compilation failed]',
+            exitCode: result
+        };
+    }
+
+    // Copy the module out of the compiler's heap before it can move
+    const ptr = arnmModule.ccall('arnm_get_module', 'number', [], []);
+    const size = arnmModule.ccall('arnm_get_module_size', 'number', [], []);
+    const bytes = arnmModule.HEAPU8.slice(ptr, ptr + size);
+
+    const lines = [];
+    try {
+        const exitCode = await window.ArnmRuntime.run(bytes, { print: (line) => lines.push(line) });
+        return {
+            success: true,
+            output: lines.length ? lines.join('\n') : '[No output]',
+            exitCode
+        };
+    } catch (error) {
+        lines.push(`[Runtime Error] ${error.message}`);
+        return {
+            success: false,
+            output: lines.join('\n'),
+            exitCode: -1
+        };
+    }
+}
+
 // Get reason for WASM unavailability
 function getLoadError() {
     return arnmLoadError;
@@ -0,0 +1,608 @@
+/*
+ * ARNm WebAssembly Runtime Shim
+ *
+ * Supplies the "arnm" imports of modules built with `arnmc --emit-wasm`
+ * and runs them: in the playground through window.ArnmRuntime, headless
+ * under node with
+ *
+ *     node wasm/arnm_runtime.js program.wasm
+ *
+ * Processes run one at a time on the JS thread. A process that blocks
+ * (receive, join, select) runs other ready processes nested inside the
+ * call until it can continue; an actor blocking at the top of its
+ * behavior loop (arnm_receive_idle) instead drops its wasm stack by
+ * throwing, and is restarted there when a message arrives, like the
+ * native runtime's restart entry. Channels are unbounded, and parallel
+ * loops run as a single chunk.
+ *
+ * Memory layout (set by the compiler): the shadow stack sits below
+ * __heap_base, and this shim allocates process headers, actor state,
+ * messages and frames above it. Pointer-sized slots are 8 bytes.
+ */
+
+(function (root, factory) {
+    if (typeof module === 'object' && module.exports) {
+        module.exports = factory();
+    } else {
+        root.ArnmRuntime = factory();
+    }
+}(typeof self !== 'undefined' ? self : this, function () {
+    'use strict';
+
+    const PAGE = 65536;
+
+    /* Thrown through wasm frames to park an idle actor */
+    const IDLE = { arnmIdle: true };
+
+    /*
+     * SIMD vectors: 32 bytes at the address compiled code passes, with the
+     * semantics of runtime/src/simd.c. f32 arithmetic rounds each result,
+     * and reductions fold in the runtime's tree order, so results match
+     * the native build bit for bit.
+     */
+    const VECTORS = {
+        f32x8: {
+            lanes: 8, width: 4, round: Math.fround,
+            load: (v, p) => v.getFloat32(p, true), store: (v, p, x) => v.setFloat32(p, x, true),
+        },
+        i32x8: {
+            lanes: 8, width: 4, round: (x) => x | 0,
+            load: (v, p) => v.getInt32(p, true), store: (v, p, x) => v.setInt32(p, x, true),
+        },
+        f64x4: {
+            lanes: 4, width: 8, round: (x) => x,
+            load: (v, p) => v.getFloat64(p, true), store: (v, p, x) => v.setFloat64(p, x, true),
+        },
+    };
+
+    /* ArnmVecOp on one lane */
+    function laneOp(vec, a, b, op) {
+        if (vec === VECTORS.i32x8) {
+            switch (op) {
+                case 1: return (a - b) | 0;
+                case 2: return Math.imul(a, b);
+                case 3: return b === 0 ? 0 : (a / b) | 0;     /* INT32_MIN / -1 wraps back */
+                default: return (a + b) | 0;
+            }
+        }
+        switch (op) {
+            case 1: return vec.round(a - b);
+            case 2: return vec.round(a * b);
+            case 3: return vec.round(a / b);
+            default: return vec.round(a + b);
+        }
+    }
+
+    /* ArnmVecReduce on a pair */
+    function laneFold(vec, a, b, op) {
+        switch (op) {
+            case 1: return a < b ? a : b;
+            case 2: return a > b ? a : b;
+            default: return vec.round(a + b);
+        }
+    }
+
+    /* printf("%.<p>g") */
+    function formatG(x, p) {
+        const strip = (s) => (s.includes('.') ? s.replace(/0+$/, '').replace(/\.$/, '') : s);
+        const [mant, exp] = x.toExponential(p - 1).split('e');
+        const e = Number(exp);
+        if (e < -4 || e >= p) {
+            return `${strip(mant)}e${e < 0 ? '-' : '+'}${String(Math.abs(e)).padStart(2, '0')}`;
+        }
+        return strip(x.toFixed(p - 1 - e));
+    }
+
+    /* Mirrors output_format_f64: the shortest of %.15g-%.17g that reads back exactly */
+    function formatF64(x) {
+        if (Number.isNaN(x)) return 'nan';
+        if (!Number.isFinite(x)) return x < 0 ? '-inf' : 'inf';
+        if (x === 0) return Object.is(x, -0) ? '-0' : '0';
+        for (let p = 15; p < 17; p++) {
+            const s = formatG(x, p);
+            if (Number(s) === x) return s;
+        }
+        return formatG(x, 17);
+    }
+
+    class Deadlock extends Error {
+        constructor() {
+            super('deadlock: every process is waiting');
+        }
+    }
+
+    function createRuntime(print) {
+        let exports = null;
+        let memory = null;
+        let table = null;
+
+        /* --- Heap: bump allocation with per-size free lists --- */
+        let heapTop = 0;
+        const freeLists = new Map();
+
+        function view() {
+            return new DataView(memory.buffer);
+        }
+
+        function alloc(size) {
+            size = Math.max(8, (size + 7) & ~7);
+            const list = freeLists.get(size);
+            let ptr;
+            if (list && list.length) {
+                ptr = list.pop();
+            } else {
+                ptr = heapTop + 8;
+                heapTop = ptr + size;
+                if (heapTop > memory.buffer.byteLength) {
+                    memory.grow(Math.ceil((heapTop - memory.buffer.byteLength) / PAGE));
+                }
+                view().setUint32(ptr - 8, size, true);
+            }
+            new Uint8Array(memory.buffer, ptr, size).fill(0);
+            return ptr;
+        }
+
+        function free(ptr) {
+            if (!ptr) return;
+            const size = view().getUint32(ptr - 8, true);
+            if (!freeLists.has(size)) freeLists.set(size, []);
+            freeLists.get(size).push(ptr);
+        }
+
+        /* Call a table entry through its (i64, i64, i64) -> i64 adapter */
+        function callRef(index, a = 0n, b = 0n, c = 0n) {
+            const fn = table.get(index);
+            if (!fn) throw new Error(`call through null function pointer ${index}`);
+            return fn(BigInt(a), BigInt(b), BigInt(c));
+        }
+
+        /* --- Processes --- */
+        const procs = new Map();            /* Header address -> process */
+        const ready = [];
+        let readyHead = 0;
+        let current = null;
+
+        function createProcess(invoke, stateSize) {
+            const header = alloc(16);
+            const proc = {
+                header,
+                invoke,                     /* Runs the entry; replaced by the restart point */
+                mailbox: [],
+                state: 'ready',
+                dead: false,
+            };
+            if (stateSize > 0) view().setBigUint64(header, BigInt(alloc(stateSize)), true);
+            procs.set(header, proc);
+            ready.push(proc);
+            return proc;
+        }
+
+        function wake(proc) {
+            if (proc.state === 'idle') {
+                proc.state = 'ready';
+                ready.push(proc);
+            }
+        }
+
+        function step(proc) {
+            const saved = current;
+            const sp = exports.__stack_pointer.value;
+            current = proc;
+            proc.state = 'running';
+            try {
+                proc.invoke();
+                proc.state = 'dead';
+                proc.dead = true;
+            } catch (e) {
+                if (e !== IDLE) throw e;
+            } finally {
+                /* An idle throw skips the epilogues that pop the shadow stack */
+                exports.__stack_pointer.value = sp;
+                current = saved;
+            }
+        }
+
+        function nextReady() {
+            if (readyHead === ready.length) return null;
+            const proc = ready[readyHead++];
+            if (readyHead > 1024 && readyHead * 2 > ready.length) {
+                ready.splice(0, readyHead);
+                readyHead = 0;
+            }
+            return proc;
+        }
+
+        /* Block the current process: run others until `done()` holds */
+        function waitUntil(done) {
+            const self = current;
+            while (!done()) {
+                const proc = nextReady();
+                if (!proc) throw new Deadlock();
+                step(proc);
+            }
+            current = self;
+        }
+
+        function spawn(fn, arg, size) {
+            const proc = createProcess(() => callRef(fn, arg), Number(size));
+            return proc.header;
+        }
+
+        function receive() {
+            const self = current;
+            waitUntil(() => self.mailbox.length > 0);
+            const msg = alloc(8);
+            view().setBigUint64(msg, self.mailbox.shift(), true);
+            return msg;
+        }
+
+        /* --- Channels --- */
+        const channels = new Map();
+        let nextChannel = 1;
+        let selectValue = 0n;
+
+        /* Mirrors arnm_select_recv4: arm 0-3 for a channel, 4 for the mailbox, -1 if all closed */
+        function selectRecv(chans, withMailbox) {
+            const self = current;
+            let result = -1n;
+            const poll = () => {
+                let live = withMailbox;
+                for (let i = 0; i < chans.length; i++) {
+                    const ch = channels.get(chans[i]);
+                    if (!ch) continue;
+                    if (ch.queue.length) {
+                        selectValue = BigInt(ch.queue.shift());
+                        result = BigInt(i);
+                        return true;
+                    }
+                    if (!ch.closed) live = true;
+                }
+                if (withMailbox && self.mailbox.length) {
+                    selectValue = self.mailbox.shift();
+                    result = 4n;
+                    return true;
+                }
+                result = -1n;
+                return !live;
+            };
+            waitUntil(poll);
+            return result;
+        }
+
+        /* --- Collections: each handle is an 8-byte block keyed to its JS state --- */
+        const collections = new Map();
+
+        function newCollection(state) {
+            const handle = alloc(8);
+            collections.set(handle, state);
+            return handle;
+        }
+
+        /* Vector and deque storage: 8-byte slots in wasm memory, doubling from 4 */
+        function grow(c) {
+            const cap = c.cap ? c.cap * 2 : 4;
+            const data = alloc(cap * 8);
+            const bytes = new Uint8Array(memory.buffer);
+            for (let i = 0; i < c.len; i++) {
+                const from = c.data + ((c.head + i) % c.cap) * 8;
+                bytes.copyWithin(data + i * 8, from, from + 8);
+            }
+            free(c.data);
+            c.data = data;
+            c.cap = cap;
+            c.head = 0;
+        }
+
+        function ringSlot(c, index) {
+            return c.data + ((c.head + index) % c.cap) * 8;
+        }
+
+        function checkIndex(c, index) {
+            if (index < 0n || index >= BigInt(c.len)) {
+                throw new Error(`index ${index} out of bounds for length ${c.len}`);
+            }
+            return Number(index);
+        }
+
+        function popSlot(c, what, index) {
+            if (!c.len) throw new Error(`Pop from an empty ${what}`);
+            const slot = ringSlot(c, index);
+            c.len--;
+            return slot;
+        }
+
+        /* A popped value stays readable until the next push reuses its slot */
+        function pushSlot(c, index) {
+            if (c.len === c.cap) grow(c);
+            c.len++;
+            const slot = ringSlot(c, index);
+            view().setBigUint64(slot, 0n, true);
+            return slot;
+        }
+
+        function readVec(vec, ptr) {
+            const v = view();
+            const lanes = [];
+            for (let i = 0; i < vec.lanes; i++) lanes.push(vec.load(v, ptr + i * vec.width));
+            return lanes;
+        }
+
+        function writeVec(vec, ptr, lanes) {
+            const v = view();
+            for (let i = 0; i < vec.lanes; i++) vec.store(v, ptr + i * vec.width, lanes[i]);
+        }
+
+        /* arnm_<vec>_splat/get/set/op/reduce/shuffle */
+        function vectorImports(name, vec) {
+            const mask = vec.lanes - 1;
+            return {
+                [`arnm_${name}_splat`](dst, x) {
+                    writeVec(vec, dst, new Array(vec.lanes).fill(x));
+                },
+                [`arnm_${name}_get`](ptr, i) {
+                    return readVec(vec, ptr)[i & mask];
+                },
+                [`arnm_${name}_set`](dst, ptr, i, x) {
+                    const lanes = readVec(vec, ptr);
+                    lanes[i & mask] = x;
+                    writeVec(vec, dst, lanes);
+                },
+                [`arnm_${name}_op`](dst, a, b, op) {
+                    const x = readVec(vec, a), y = readVec(vec, b);
+                    writeVec(vec, dst, x.map((lane, i) => laneOp(vec, lane, y[i], Number(op))));
+                },
+                [`arnm_${name}_reduce`](ptr, op) {
+                    const t = readVec(vec, ptr);
+                    for (let w = vec.lanes >> 1; w >= 1; w >>= 1) {
+                        for (let i = 0; i < w; i++) t[i] = laneFold(vec, t[i], t[i + w], Number(op));
+                    }
+                    return t[0];
+                },
+                [`arnm_${name}_shuffle`](dst, ptr, idx) {
+                    const lanes = readVec(vec, ptr), order = readVec(VECTORS.i32x8, idx);
+                    writeVec(vec, dst, lanes.map((_, i) => lanes[order[i] & mask]));
+                },
+            };
+        }
+
+        const imports = {
+            arnm_spawn: spawn,
+            arnm_spawn_joinable: spawn,
+            arnm_join_proc(handle) {
+                const proc = procs.get(handle);
+                if (!proc) return -1;
+                waitUntil(() => proc.dead);
+                return 0;
+            },
+            arnm_send(target, tag) {
+                const proc = procs.get(target);
+                if (!proc || proc.dead) return -1;
+                proc.mailbox.push(BigInt.asUintN(64, tag));
+                wake(proc);
+                return 0;
+            },
+            arnm_receive: receive,
+            arnm_receive_idle(restart) {
+                const self = current;
+                if (self.mailbox.length) return receive();
+                self.invoke = () => callRef(restart);
+                self.state = 'idle';
+                throw IDLE;
+            },
+            arnm_message_free: free,
+            arnm_self() {
+                return current ? current.header : 0;
+            },
+            arnm_panic_nomatch() {
+                throw new Error('receive: no arm matches the message');
+            },
+            arnm_panic_bounds(index, len) {
+                throw new Error(`index ${index} out of bounds for length ${len}`);
+            },
+            /* Arrays: a { data, len } header; a new array's elements follow it */
+            arnm_array_new(len) {
+                if (len < 0n || len > 0x7fffffffn) throw new Error(`array length ${len} out of range`);
+                const arr = alloc(16 + Number(len) * 8);
+                const v = view();
+                v.setBigUint64(arr, BigInt(arr + 16), true);
+                v.setBigInt64(arr + 8, len, true);
+                return arr;
+            },
+            arnm_array_slice(arr, lo, hi) {
+                const len = view().getBigInt64(arr + 8, true);
+                if (lo < 0n || lo > hi || hi > len) {
+                    throw new Error(`slice [${lo}..${hi}] out of range for length ${len}`);
+                }
+                const data = view().getBigUint64(arr, true) + lo * 8n;
+                const slice = alloc(16);
+                const v = view();
+                v.setBigUint64(slice, data, true);
+                v.setBigInt64(slice + 8, hi - lo, true);
+                return slice;
+            },
+            arnm_array_aliased(a, b) {
+                const v = view();
+                const da = v.getBigUint64(a, true), db = v.getBigUint64(b, true);
+                if (da === db) return 0;
+                const ea = da + v.getBigInt64(a + 8, true) * 8n;
+                const eb = db + v.getBigInt64(b + 8, true) * 8n;
+                return da < eb && db < ea ? 1 : 0;
+            },
+            arnm_vec_new() {
+                return newCollection({ data: 0, len: 0, cap: 0, head: 0 });
+            },
+            arnm_vec_len(vec) {
+                return collections.get(vec).len;
+            },
+            arnm_vec_push(vec) {
+                const c = collections.get(vec);
+                return pushSlot(c, c.len);
+            },
+            arnm_vec_pop(vec) {
+                const c = collections.get(vec);
+                return popSlot(c, 'vec', c.len - 1);
+            },
+            arnm_vec_at(vec, index) {
+                const c = collections.get(vec);
+                return ringSlot(c, checkIndex(c, index));
+            },
+            /* Map entries own individually allocated slots, so addresses stay put */
+            arnm_map_new() {
+                return newCollection(new Map());
+            },
+            arnm_map_len(map) {
+                return collections.get(map).size;
+            },
+            arnm_map_slot(map, key) {
+                const m = collections.get(map);
+                let slot = m.get(key);
+                if (slot === undefined) {
+                    slot = alloc(8);
+                    m.set(key, slot);
+                }
+                return slot;
+            },
+            arnm_map_at(map, key) {
+                const slot = collections.get(map).get(key);
+                if (slot === undefined) throw new Error(`Key ${key} not in map`);
+                return slot;
+            },
+            arnm_map_has(map, key) {
+                return collections.get(map).has(key) ? 1 : 0;
+            },
+            arnm_map_remove(map, key) {
+                const m = collections.get(map);
+                const slot = m.get(key);
+                if (slot === undefined) return 0;
+                m.delete(key);
+                free(slot);
+                return 1;
+            },
+            arnm_deque_new() {
+                return newCollection({ data: 0, len: 0, cap: 0, head: 0 });
+            },
+            arnm_deque_len(deque) {
+                return collections.get(deque).len;
+            },
+            arnm_deque_push_back(deque) {
+                const c = collections.get(deque);
+                return pushSlot(c, c.len);
+            },
+            arnm_deque_push_front(deque) {
+                const c = collections.get(deque);
+                if (c.len === c.cap) grow(c);
+                c.head = (c.head + c.cap - 1) % c.cap;
+                c.len++;
+                const slot = ringSlot(c, 0);
+                view().setBigUint64(slot, 0n, true);
+                return slot;
+            },
+            arnm_deque_pop_back(deque) {
+                const c = collections.get(deque);
+                return popSlot(c, 'deque', c.len - 1);
+            },
+            arnm_deque_pop_front(deque) {
+                const c = collections.get(deque);
+                const slot = popSlot(c, 'deque', 0);
+                c.head = (c.head + 1) % c.cap;
+                return slot;
+            },
+            arnm_deque_at(deque, index) {
+                const c = collections.get(deque);
+                return ringSlot(c, checkIndex(c, index));
+            },
+            arnm_print_int(value) {
+                print(String(value));
+            },
+            arnm_print_f64(value) {
+                print(formatF64(value));
+            },
+            arnm_channel_create() {
+                const id = nextChannel++;
+                channels.set(id, { queue: [], closed: false });
+                return id;
+            },
+            arnm_channel_send(id, value) {
+                const ch = channels.get(id);
+                if (!ch || ch.closed) return 0;
+                ch.queue.push(value);
+                return 1;
+            },
+            arnm_channel_close(id) {
+                const ch = channels.get(id);
+                if (ch) ch.closed = true;
+            },
+            arnm_select_recv4(c0, c1, c2, c3, withMailbox) {
+                return selectRecv([c0, c1, c2, c3], withMailbox !== 0n);
+            },
+            arnm_select_value() {
+                return selectValue;
+            },
+            arnm_parallel_for(lo, hi, body, frame) {
+                if (lo < hi) callRef(body, lo, hi, frame);
+            },
+            arnm_parallel_reduce_op(lo, hi, body, frame, op) {
+                if (lo >= hi) return op === 1n ? 1n : 0n;     /* ARNM_REDUCE_MUL : ADD */
+                return callRef(body, lo, hi, frame);
+            },
+            arnm_alloc(size) {
+                return alloc(Number(size));
+            },
+            arnm_release: free,
+        };
+        for (const [name, vec] of Object.entries(VECTORS)) {
+            Object.assign(imports, vectorImports(name, vec));
+        }
+
+        return {
+            imports,
+            attach(instance) {
+                exports = instance.exports;
+                memory = exports.memory;
+                table = exports.__indirect_function_table;
+                heapTop = exports.__heap_base.value;
+            },
+            run() {
+                createProcess(() => exports._arnm_main(), 0);
+                for (let proc = nextReady(); proc; proc = nextReady()) step(proc);
+            },
+        };
+    }
+
+    /*
+     * Instantiate and run a compiled program to completion.
+     * `options.print(line)` receives each line of output (default: console.log).
+     * Resolves to 0; traps and deadlocks reject.
+     */
+    async function run(bytes, options = {}) {
+        const print = options.print || ((line) => console.log(line));
+        const rt = createRuntime(print);
+        const env = new Proxy({}, {
+            get: (_, name) => () => {
+                throw new Error(`unresolved external '${String(name)}'`);
+            },
+        });
+        const { instance } = await WebAssembly.instantiate(bytes, { arnm: rt.imports, env });
+        rt.attach(instance);
+        rt.run();
+        return 0;
+    }
+
+    return { run, Deadlock };
+}));
+
+/* Headless entry point: node arnm_runtime.js program.wasm */
+if (typeof require !== 'undefined' && typeof module !== 'undefined' && require.main === module) {
+    const path = process.argv[2];
+    if (!path) {
+        console.error('usage: node arnm_runtime.js <program.wasm>');
+        process.exit(2);
+    }
+    const bytes = require('fs').readFileSync(path);
+    module.exports.run(bytes).then(
+        (code) => process.exit(code),
+        (err) => {
+            console.error(`error: ${err.message}`);
+            process.exit(1);
+        });
+}
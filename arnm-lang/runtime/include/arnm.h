@@ -22,6 +22,10 @@
 #define ARNM_DEFAULT_STACK_SIZE     (64 * 1024)     /* 64KB per process */
 #define ARNM_MAX_WORKERS            64
 #define ARNM_MAILBOX_CAPACITY       1024
+#define ARNM_STARVATION_LIMIT       32              /* Picks a ready class may be passed over */
+#define ARNM_DEFAULT_BATCH          64              /* Messages handled per scheduling quantum */
+#define ARNM_DEFAULT_HIBERNATE_MS   5000            /* Idle time before a parked stack is released */
+#define ARNM_LOG_MAX_ARGS           6               /* Integer arguments per log record */
 
 /* ============================================================
  * Forward Declarations
@@ -31,6 +35,8 @@ typedef struct ArnmProcess ArnmProcess;
 typedef struct ArnmMessage ArnmMessage;
 typedef struct ArnmMailbox ArnmMailbox;
 typedef struct ArnmContext ArnmContext;
+typedef struct ArnmSnapshot ArnmSnapshot;
+typedef struct ArnmTrace ArnmTrace;
 
 /* ============================================================
  * Process State
@@ -43,6 +49,54 @@ typedef enum {
     PROC_DEAD,          /* Terminated */
 } ProcessState;
 
+/* ============================================================
+ * Priority Classes
+ * ============================================================ */
+
+typedef enum {
+    ARNM_PRIO_HIGH,     /* Latency-critical (EDF by deadline hint) */
+    ARNM_PRIO_NORMAL,   /* Default */
+    ARNM_PRIO_LOW,      /* Batch / background */
+    ARNM_PRIO_COUNT
+} ArnmPriority;
+
+typedef enum {
+    ARNM_PLACE_LOCAL,           /* Spawner's worker (default) */
+    ARNM_PLACE_ROUND_ROBIN,     /* Next worker in turn */
+    ARNM_PLACE_LEAST_LOADED,    /* Worker with the shortest run queues */
+    ARNM_PLACE_WORKER,          /* Explicit worker id */
+} ArnmPlacement;
+
+typedef struct {
+    ArnmPriority    priority;       /* Scheduling class */
+    uint64_t        deadline_ns;    /* Relative deadline hint, HIGH only (0 = none) */
+    ArnmPlacement   placement;      /* Initial worker choice */
+    uint32_t        worker;         /* Target for ARNM_PLACE_WORKER */
+    bool            joinable;       /* Handle outlives exit until arnm_join_proc */
+} ArnmSpawnOptions;
+
+/* ============================================================
+ * Runtime Configuration
+ * ============================================================ */
+
+typedef struct {
+    int     num_workers;    /* Worker threads (0 = one per online CPU) */
+    bool    pin_workers;    /* Pin workers to CPUs, spread over NUMA nodes */
+    int     max_batch;      /* Receives per quantum before a forced yield */
+    int     hibernate_ms;   /* Parked this long -> release stack (0 = never) */
+    const char* trace_path; /* Capture a message trace here (NULL = off) */
+    bool    line_atomic;    /* Output buffers flush whole lines only */
+    int     log_level;      /* Least severe ArnmLogLevel recorded */
+    const char* log_path;   /* Log destination (NULL = stderr) */
+} ArnmConfig;
+
+/*
+ * Fill config with defaults. Honours ARNM_WORKERS, ARNM_PIN_WORKERS,
+ * ARNM_BATCH, ARNM_HIBERNATE_MS, ARNM_TRACE, ARNM_LINE_ATOMIC,
+ * ARNM_LOG_LEVEL (debug/info/warn/error/off) and ARNM_LOG.
+ */
+void arnm_config_default(ArnmConfig* config);
+
 /* ============================================================
  * Runtime Lifecycle
  * ============================================================ */
@@ -50,6 +104,9 @@ typedef enum {
 /* Initialize runtime with specified number of worker threads */
 int arnm_init(int num_workers);
 
+/* Initialize runtime from an explicit configuration */
+int arnm_init_ex(const ArnmConfig* config);
+
 /* Shutdown runtime and cleanup */
 void arnm_shutdown(void);
 
@@ -63,18 +120,63 @@ void arnm_run(void);
 /* Spawn a new process with given entry function */
 ArnmProcess* arnm_spawn(void (*entry)(void*), void* arg, size_t state_size);
 
+/* Spawn with explicit scheduling options (NULL = defaults) */
+ArnmProcess* arnm_spawn_ex(void (*entry)(void*), void* arg, size_t state_size,
+                           const ArnmSpawnOptions* options);
+
+/* Fill spawn options with defaults */
+void arnm_spawn_options_default(ArnmSpawnOptions* options);
+
+/* Set the current process's deadline, relative to now (0 = clear) */
+void arnm_set_deadline(uint64_t deadline_ns);
+
 /* Get current process */
 ArnmProcess* arnm_self(void);
 
 /* Get process ID */
 uint64_t arnm_pid(ArnmProcess* proc);
 
+/* Get a process's actor state (NULL if spawned with state_size 0) */
+void* arnm_actor_state(ArnmProcess* proc);
+
 /* Yield to scheduler */
 void arnm_yield(void);
 
 /* Exit current process */
 void arnm_exit(void);
 
+/* ============================================================
+ * Monitors and Join
+ * ============================================================
+ * Watchers sit on the exiting process and are handed off in one pass
+ * at exit: no polling, and exit costs O(watchers). Both take pids, so
+ * they are safe on processes that have already gone.
+ */
+
+/* Tag of the message a monitor receives; data is the exited uint64_t pid */
+#define ARNM_TAG_DOWN   0xFFFFFFFFFFFF0001ull
+
+/*
+ * Send the calling process an ARNM_TAG_DOWN message when pid exits, or
+ * at once if it is not running. Returns 0, or -1 outside a process.
+ */
+int arnm_monitor(uint64_t pid);
+
+/* Cancel monitors on pid; a DOWN already under way may still arrive */
+void arnm_demonitor(uint64_t pid);
+
+/* Park until pid exits (at once if it is not running). -1 outside a process */
+int arnm_join(uint64_t pid);
+
+/*
+ * Spawn with a handle that stays readable after the process exits,
+ * like a joinable thread. Release it with exactly one arnm_join_proc.
+ */
+ArnmProcess* arnm_spawn_joinable(void (*entry)(void*), void* arg, size_t state_size);
+
+/* Join a joinable process and release its handle (-1 outside a process) */
+int arnm_join_proc(ArnmProcess* proc);
+
 /* ============================================================
  * Message Passing
  * ============================================================ */
@@ -85,6 +187,14 @@ int arnm_send(ArnmProcess* target, uint64_t tag, void* data, size_t size);
 /* Receive message (blocks until available) */
 ArnmMessage* arnm_receive(void);
 
+/*
+ * Receive at a point where the process holds no live stack state (the
+ * top of an actor's behavior loop). If the process hibernates while
+ * waiting, its stack may be freed and it resumes by calling restart
+ * on a fresh stack instead of returning here.
+ */
+ArnmMessage* arnm_receive_idle(void (*restart)(void*));
+
 /* Try to receive message (non-blocking, returns NULL if empty) */
 ArnmMessage* arnm_try_receive(void);
 
@@ -99,6 +209,417 @@ size_t arnm_message_size(ArnmMessage* msg);
 /* Panic on unmatched message (for receive blocks) */
 void arnm_panic_nomatch(void);
 
+/* ============================================================
+ * Output
+ * ============================================================
+ * Buffered per worker and written to stdout without stdio, so it is
+ * not ordered with printf output. Each process's output appears in
+ * the order it printed it. Buffers are flushed when full, when a
+ * worker goes idle, by arnm_flush and arnm_shutdown, and at exit.
+ */
+
+/* Print a decimal integer and a newline (the print built-in) */
+void arnm_print_int(int32_t val);
+void arnm_print_i64(int64_t val);
+
+/* Print the shortest decimal form of val that reads back exactly, and a newline */
+void arnm_print_f64(double val);
+
+/* Print len bytes of s and a newline */
+void arnm_print_str(const char* s, size_t len);
+
+/* Write len raw bytes of s */
+void arnm_write(const char* s, size_t len);
+
+/* Write out every output buffer */
+void arnm_flush(void);
+
+/* ============================================================
+ * Logging
+ * ============================================================
+ * Records hold a format id and up to ARNM_LOG_MAX_ARGS integer
+ * arguments, substituted for "{}" in the format when a background
+ * thread writes them out. Logging never blocks: under overload
+ * records are dropped and counted. Calls below ARNM_LOG_MIN_LEVEL
+ * (define it before including arnm.h) compile to nothing; the rest
+ * are filtered against the runtime level.
+ */
+
+typedef enum {
+    ARNM_LOG_DEBUG,
+    ARNM_LOG_INFO,
+    ARNM_LOG_WARN,
+    ARNM_LOG_ERROR,
+    ARNM_LOG_OFF,
+} ArnmLogLevel;
+
+#ifndef ARNM_LOG_MIN_LEVEL
+#define ARNM_LOG_MIN_LEVEL ARNM_LOG_DEBUG
+#endif
+
+/* Id for a format string; the string must outlive the logger */
+uint32_t arnm_log_format(const char* fmt);
+
+/* Record a log entry (drops it if the level is filtered or the ring is full) */
+void arnm_log_write(ArnmLogLevel level, uint32_t format, const int64_t* args, size_t nargs);
+
+/* True if records at level are currently kept */
+bool arnm_log_enabled(ArnmLogLevel level);
+
+/* Change the runtime level */
+void arnm_log_set_level(ArnmLogLevel level);
+
+/* Send the log to path (NULL = stderr), starting the writer; -1 on error */
+int arnm_log_open(const char* path);
+
+/* Write out everything recorded so far and stop the writer */
+void arnm_log_close(void);
+
+/* Records dropped so far because a ring was full */
+uint64_t arnm_log_dropped(void);
+
+/* Log with a format literal and integer arguments, e.g. ARNM_LOG(ARNM_LOG_INFO, "got {}", n) */
+#define ARNM_LOG(level, fmt, ...) do { \
+    if ((level) >= ARNM_LOG_MIN_LEVEL && arnm_log_enabled(level)) { \
+        static _Atomic uint32_t arnm_log_fmt_id_; \
+        if (!arnm_log_fmt_id_) arnm_log_fmt_id_ = arnm_log_format(fmt); \
+        const int64_t arnm_log_args_[] = { 0, __VA_ARGS__ }; \
+        arnm_log_write((level), arnm_log_fmt_id_, arnm_log_args_ + 1, \
+                       sizeof(arnm_log_args_) / sizeof(int64_t) - 1); \
+    } \
+} while (0)
+
+/* ============================================================
+ * Distribution
+ * ============================================================
+ * Processes on other nodes are addressed through remote handles and
+ * sent to with arnm_send like local ones. Delivery is in order per
+ * node pair; messages to a node that is unreachable fail with -1 and
+ * messages to a pid that no longer exists are dropped on arrival.
+ */
+
+/*
+ * Join a cluster as node_id (1..1023), accepting peers on port
+ * (0 = connect-only). While the node is up the scheduler keeps
+ * running even if every local process is parked.
+ */
+int arnm_node_start(uint32_t node_id, uint16_t port);
+
+/* Connect to a peer node; returns its node id, or -1 */
+int arnm_node_connect(const char* host, uint16_t port);
+
+/*
+ * Link to a peer node on the same host through the named POSIX
+ * shared-memory segment name (e.g. "/arnm-1-2"). Both nodes call
+ * this with the same name; the first creates the segment and the
+ * second attaches. Messages to peer_node then bypass TCP.
+ */
+int arnm_node_link_shm(const char* name, uint32_t peer_node);
+
+/*
+ * Flush queued messages and close all peer connections. Remote
+ * handles become invalid; no process may be sending remotely.
+ */
+void arnm_node_stop(void);
+
+/* This node's id (0 = distribution not started) */
+uint32_t arnm_node_id(void);
+
+/* Handle for process pid on another node (NULL if not started) */
+ArnmProcess* arnm_remote(uint32_t node_id, uint64_t pid);
+
+/* Node a process lives on (this node's id for local processes) */
+uint32_t arnm_pid_node(ArnmProcess* proc);
+
+/* ============================================================
+ * Snapshots
+ * ============================================================
+ * Actor state and pending messages can be appended to a snapshot
+ * file and restored into fresh processes, e.g. after a restart.
+ * Repeated snapshots to the same path only write actors whose state
+ * or mailbox changed. While the scheduler runs, only parked actors
+ * are captured; the rest are picked up by a later snapshot.
+ */
+
+/* Append changed actors to path; returns actors written, or -1 */
+int arnm_snapshot(const char* path);
+
+/* Map a snapshot file for restoring (NULL on error) */
+ArnmSnapshot* arnm_snapshot_open(const char* path);
+
+/* Release a snapshot opened with arnm_snapshot_open */
+void arnm_snapshot_close(ArnmSnapshot* snap);
+
+/* Number of distinct actors in the snapshot */
+size_t arnm_snapshot_count(ArnmSnapshot* snap);
+
+/* Pid (as of capture) of the index-th actor */
+uint64_t arnm_snapshot_pid(ArnmSnapshot* snap, size_t index);
+
+/*
+ * Spawn a process running entry with the newest saved state and
+ * pending messages of pid. The process gets a new pid.
+ */
+ArnmProcess* arnm_snapshot_restore(ArnmSnapshot* snap, uint64_t pid,
+                                   void (*entry)(void*), void* arg);
+
+/* ============================================================
+ * Tracing and Replay
+ * ============================================================
+ * A capture records every actor's spawns, sends (with payloads) and
+ * receives. Replaying a trace re-runs that traffic on a fresh runtime
+ * with any configuration and reports throughput and send-to-receive
+ * latency, so recorded production traffic can serve as a benchmark.
+ * Sends to and from other nodes are not captured; messages delivered
+ * from other nodes appear as sent from outside any process.
+ */
+
+typedef struct {
+    ArnmConfig          config;         /* Runtime to replay on */
+    ArnmSpawnOptions    spawn;          /* Priority and placement of replayed actors */
+    void              (*on_message)(uint64_t pid, ArnmMessage* msg, void* ctx);
+                                        /* Called per receive with the recorded pid (NULL = none) */
+    void*               ctx;
+} ArnmReplayOptions;
+
+typedef struct {
+    uint64_t    actors;             /* Actors replayed */
+    uint64_t    messages;           /* Messages received */
+    uint64_t    dropped;            /* Sends whose target never appeared or had exited */
+    uint64_t    elapsed_ns;         /* Wall time of the replay */
+    double      throughput;         /* Messages received per second */
+    uint64_t    latency_p50_ns;     /* Send-to-receive latency */
+    uint64_t    latency_p99_ns;
+    uint64_t    latency_max_ns;
+} ArnmReplayReport;
+
+/* Start capturing to path (truncated); -1 if already capturing */
+int arnm_trace_start(const char* path);
+
+/* Stop capturing and flush (also done by arnm_shutdown); call with the scheduler stopped */
+void arnm_trace_stop(void);
+
+/* Load a captured trace (NULL on error) */
+ArnmTrace* arnm_trace_open(const char* path);
+
+/* Release a trace opened with arnm_trace_open */
+void arnm_trace_close(ArnmTrace* trace);
+
+/* Actors and received messages in the trace */
+size_t arnm_trace_actor_count(ArnmTrace* trace);
+uint64_t arnm_trace_message_count(ArnmTrace* trace);
+
+/* Fill replay options with defaults (default runtime config and spawn options) */
+void arnm_replay_options_default(ArnmReplayOptions* options);
+
+/*
+ * Replay a trace on a runtime initialized from options (NULL =
+ * defaults), run it to completion and shut it down. The runtime must
+ * not be initialized when this is called. Returns 0 or -1.
+ */
+int arnm_trace_replay(ArnmTrace* trace, const ArnmReplayOptions* options,
+                      ArnmReplayReport* report);
+
+/* ============================================================
+ * Data Parallelism (Fork-Join)
+ * ============================================================
+ * A parallel loop splits [begin, end) into a few chunks per worker.
+ * Workers pick chunks up between processes (or when idle) and run
+ * them as plain calls on their own stacks; no process is created.
+ * The caller runs chunks too and then parks until the last one is
+ * done, without going through its mailbox. Bodies run outside any
+ * process, so they must not receive or yield.
+ */
+
+typedef void    (*ArnmForBody)(int64_t lo, int64_t hi, void* ctx);
+typedef int64_t (*ArnmReduceBody)(int64_t lo, int64_t hi, void* ctx);
+typedef int64_t (*ArnmCombine)(int64_t a, int64_t b);
+
+/* Operators for the compiled reduce */
+typedef enum {
+    ARNM_REDUCE_ADD,
+    ARNM_REDUCE_MUL,
+} ArnmReduceOp;
+
+/* Run body over chunks of [begin, end) on all workers; returns once all are done */
+void arnm_parallel_for(int64_t begin, int64_t end, ArnmForBody body, void* ctx);
+
+/*
+ * Run body over chunks of [begin, end) and fold the per-chunk results
+ * with combine, in chunk order, starting from identity.
+ */
+int64_t arnm_parallel_reduce(int64_t begin, int64_t end, int64_t identity,
+                             ArnmReduceBody body, ArnmCombine combine, void* ctx);
+
+/* Compiled parallel reduce with an ArnmReduceOp */
+int64_t arnm_parallel_reduce_op(int64_t begin, int64_t end, ArnmReduceBody body,
+                                void* ctx, int64_t op);
+
+/* ============================================================
+ * SIMD Vectors
+ * ============================================================
+ * 256-bit vectors behind the f32x8, i32x8 and f64x4 types. Compiled
+ * code passes them by address and results go to a caller-provided
+ * dst, which may be one of the operands. Lane indices are taken
+ * modulo the lane count, and integer lanes wrap. Kernels use AVX2
+ * when the CPU and OS support it and SSE2 otherwise, chosen once at
+ * load time; ARNM_SIMD=sse2 forces the fallback. Reductions fold in
+ * the same tree order at every level, so results do not depend on it.
+ */
+
+typedef struct { float   lane[8]; } ArnmF32x8;
+typedef struct { int32_t lane[8]; } ArnmI32x8;
+typedef struct { double  lane[4]; } ArnmF64x4;
+
+/* Element-wise operators */
+typedef enum {
+    ARNM_VEC_ADD,
+    ARNM_VEC_SUB,
+    ARNM_VEC_MUL,
+    ARNM_VEC_DIV,       /* i32x8: a zero divisor gives 0 */
+} ArnmVecOp;
+
+/* Horizontal reductions */
+typedef enum {
+    ARNM_VEC_SUM,
+    ARNM_VEC_MIN,
+    ARNM_VEC_MAX,
+} ArnmVecReduce;
+
+typedef enum {
+    ARNM_SIMD_SCALAR,   /* Not x86-64: plain loops */
+    ARNM_SIMD_SSE2,
+    ARNM_SIMD_AVX2,
+} ArnmSimdLevel;
+
+/* Nonzero while the AVX2 kernels are selected; the x86 backend's inline code tests it */
+extern uint8_t arnm_simd_avx2;
+
+/* Level in use */
+ArnmSimdLevel arnm_simd_level(void);
+
+/* Use level, or the best the CPU supports below it; returns the level in use */
+ArnmSimdLevel arnm_simd_select(ArnmSimdLevel level);
+
+void   arnm_f32x8_splat(ArnmF32x8* dst, double x);
+double arnm_f32x8_get(const ArnmF32x8* v, int32_t i);
+void   arnm_f32x8_set(ArnmF32x8* dst, const ArnmF32x8* v, int32_t i, double x);
+void   arnm_f32x8_op(ArnmF32x8* dst, const ArnmF32x8* a, const ArnmF32x8* b, int64_t op);
+double arnm_f32x8_reduce(const ArnmF32x8* v, int64_t op);
+void   arnm_f32x8_shuffle(ArnmF32x8* dst, const ArnmF32x8* v, const ArnmI32x8* idx);
+
+void    arnm_i32x8_splat(ArnmI32x8* dst, int32_t x);
+int32_t arnm_i32x8_get(const ArnmI32x8* v, int32_t i);
+void    arnm_i32x8_set(ArnmI32x8* dst, const ArnmI32x8* v, int32_t i, int32_t x);
+void    arnm_i32x8_op(ArnmI32x8* dst, const ArnmI32x8* a, const ArnmI32x8* b, int64_t op);
+int32_t arnm_i32x8_reduce(const ArnmI32x8* v, int64_t op);
+void    arnm_i32x8_shuffle(ArnmI32x8* dst, const ArnmI32x8* v, const ArnmI32x8* idx);
+
+/* f64x4 shuffles read lanes 0-3 of idx */
+void   arnm_f64x4_splat(ArnmF64x4* dst, double x);
+double arnm_f64x4_get(const ArnmF64x4* v, int32_t i);
+void   arnm_f64x4_set(ArnmF64x4* dst, const ArnmF64x4* v, int32_t i, double x);
+void   arnm_f64x4_op(ArnmF64x4* dst, const ArnmF64x4* a, const ArnmF64x4* b, int64_t op);
+double arnm_f64x4_reduce(const ArnmF64x4* v, int64_t op);
+void   arnm_f64x4_shuffle(ArnmF64x4* dst, const ArnmF64x4* v, const ArnmI32x8* idx);
+
+/* ============================================================
+ * Arrays
+ * ============================================================
+ * Array and slice values are the address of a header that is never
+ * written after it is created. Elements are 8-byte slots, zeroed when
+ * the array is made. A slice shares its parent's elements. Compiled
+ * code does not release arrays yet, so their storage lives until
+ * exit. The panics print to stderr and abort.
+ */
+
+typedef struct {
+    void*   data;       /* First element */
+    int64_t len;        /* Element count, 0..ARNM_ARRAY_MAX_LEN */
+} ArnmArray;
+
+/* Lengths are i32 in the language */
+#define ARNM_ARRAY_MAX_LEN INT32_MAX
+
+/* New zero-filled array; panics unless 0 <= len <= ARNM_ARRAY_MAX_LEN */
+ArnmArray* arnm_array_new(int64_t len);
+
+/* Elements lo..hi-1 of arr; panics unless 0 <= lo <= hi <= arr->len */
+ArnmArray* arnm_array_slice(const ArnmArray* arr, int64_t lo, int64_t hi);
+
+/*
+ * Nonzero when a and b share storage at different offsets, so that some
+ * a[i] is b[j] with i != j. Vectorized loops test this before running.
+ */
+int32_t arnm_array_aliased(const ArnmArray* a, const ArnmArray* b);
+
+/* Panic for a failed bounds check (index outside 0..len-1) */
+void arnm_panic_bounds(int64_t index, int64_t len);
+
+/* ============================================================
+ * Collections
+ * ============================================================
+ * vec, map and deque values are the address of a header owned by the
+ * process that made it; nothing here locks or uses atomics. Elements
+ * are 8-byte slots as in arrays. Calls hand compiled code the address
+ * of a slot, which it loads or stores at its own type: the address is
+ * good until the next call that adds to the same collection. Storage
+ * comes from the node-local heap of the calling thread, and grows by
+ * doubling. Lengths stay within ARNM_ARRAY_MAX_LEN. The panics print
+ * to stderr and abort, like the array ones.
+ */
+
+/* Growable vector: elements 0..len-1 in data */
+typedef struct {
+    int64_t* data;
+    int64_t  len;
+    int64_t  cap;
+} ArnmVec;
+
+/*
+ * Swiss-table hash map from integer keys. Slots are probed a group of
+ * ARNM_MAP_GROUP control bytes at a time, each a 7-bit hash tag, empty
+ * or deleted; on x86-64 one SSE2 compare tests a whole group.
+ */
+typedef struct {
+    uint8_t* ctrl;          /* cap control bytes, then cap entries */
+    int64_t  len;
+    int64_t  cap;           /* 0 or a power of two >= ARNM_MAP_GROUP */
+    int64_t  growth_left;   /* Inserts into empty slots before a rehash */
+} ArnmMap;
+
+#define ARNM_MAP_GROUP 16
+
+/* Ring-buffer deque: element i is data[(head + i) & (cap - 1)] */
+typedef struct {
+    int64_t* data;
+    int64_t  len;
+    int64_t  cap;           /* 0 or a power of two */
+    int64_t  head;
+} ArnmDeque;
+
+ArnmVec* arnm_vec_new(void);
+int32_t  arnm_vec_len(const ArnmVec* vec);
+int64_t* arnm_vec_push(ArnmVec* vec);                   /* New last slot */
+int64_t* arnm_vec_pop(ArnmVec* vec);                    /* Removed last slot; panics if empty */
+int64_t* arnm_vec_at(ArnmVec* vec, int64_t index);      /* Panics unless 0 <= index < len */
+
+ArnmMap* arnm_map_new(void);
+int32_t  arnm_map_len(const ArnmMap* map);
+int64_t* arnm_map_slot(ArnmMap* map, int64_t key);      /* Value slot, added zeroed if new */
+int64_t* arnm_map_find(const ArnmMap* map, int64_t key);/* Value slot or NULL */
+int64_t* arnm_map_at(const ArnmMap* map, int64_t key);  /* Value slot; panics if absent */
+int32_t  arnm_map_has(const ArnmMap* map, int64_t key);
+int32_t  arnm_map_remove(ArnmMap* map, int64_t key);    /* Nonzero if it was there */
+
+ArnmDeque* arnm_deque_new(void);
+int32_t    arnm_deque_len(const ArnmDeque* deque);
+int64_t*   arnm_deque_push_back(ArnmDeque* deque);
+int64_t*   arnm_deque_push_front(ArnmDeque* deque);
+int64_t*   arnm_deque_pop_back(ArnmDeque* deque);       /* Panics if empty */
+int64_t*   arnm_deque_pop_front(ArnmDeque* deque);      /* Panics if empty */
+int64_t*   arnm_deque_at(ArnmDeque* deque, int64_t index);
+
 /* ============================================================
  * Memory Management (ARC)
  * ============================================================ */
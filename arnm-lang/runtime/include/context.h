@@ -27,6 +27,12 @@ typedef struct ArnmContext {
     uint64_t rip;       /* Return address / entry point */
 } ArnmContext;
 
+/* Saved stack pointer of a switched-out context */
+#define ARNM_CONTEXT_SP(ctx)    ((ctx)->rsp)
+
+/* Bytes below the stack pointer the ABI lets leaf code use */
+#define ARNM_RED_ZONE           128
+
 #elif defined(__aarch64__) || defined(_M_ARM64)
 
 typedef struct ArnmContext {
@@ -45,6 +51,12 @@ typedef struct ArnmContext {
     uint64_t x30;       /* Link register (return address) */
 } ArnmContext;
 
+/* Saved stack pointer of a switched-out context */
+#define ARNM_CONTEXT_SP(ctx)    ((ctx)->sp)
+
+/* AAPCS64 has no red zone */
+#define ARNM_RED_ZONE           0
+
 #else
 #error "Unsupported architecture for context switching"
 #endif
@@ -0,0 +1,79 @@
+/*
+ * ARNm Runtime - Distribution
+ *
+ * Nodes talk over one TCP connection per node pair. Each side sends
+ * an 8-byte hello (magic, version, node id), then a stream of frames:
+ *
+ *     u64 target pid | u64 tag | u32 payload size | payload
+ *
+ * All integers are little-endian. Frames queued by senders are
+ * written in batches with writev by a per-peer writer thread; a
+ * per-peer reader thread delivers incoming frames by pid through
+ * the process registry.
+ */
+
+#ifndef ARNM_DIST_H
+#define ARNM_DIST_H
+
+#include "arnm.h"
+#include "process.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/* ============================================================
+ * Wire Format
+ * ============================================================ */
+
+#define DIST_MAGIC          0x4D4E5241u     /* "ARNM" */
+#define DIST_VERSION        1
+#define DIST_HELLO_SIZE     8
+#define DIST_HEADER_SIZE    20
+#define DIST_MAX_NODES      1024            /* Node ids are 1..DIST_MAX_NODES-1 */
+#define DIST_MAX_PAYLOAD    (64u * 1024 * 1024)
+#define DIST_IOV_BATCH      64              /* Frames per writev */
+#define DIST_READ_BUFFER    (64 * 1024)
+
+/* ============================================================
+ * Peer Connection
+ * ============================================================ */
+
+typedef struct DistFrame {
+    struct DistFrame*   next;
+    uint32_t            size;           /* Header + payload bytes */
+    uint8_t             bytes[];        /* Encoded frame */
+} DistFrame;
+
+typedef struct DistPeer {
+    int                 fd;             /* Connected socket */
+    uint32_t            node_id;        /* Remote node */
+    pthread_t           reader;         /* Delivers incoming frames */
+    pthread_t           writer;         /* Flushes queued frames */
+
+    /* Outbound queue, guarded by lock */
+    pthread_mutex_t     lock;
+    pthread_cond_t      cond;
+    DistFrame*          head;
+    DistFrame*          tail;
+    bool                closing;        /* Writer drains, then exits */
+
+    /* Statistics */
+    atomic_uint_fast64_t frames_out;
+    atomic_uint_fast64_t frames_in;
+    atomic_uint_fast64_t writevs;       /* writev calls (frames_out / writevs = batch) */
+    atomic_uint_fast64_t dropped;       /* Frames for pids that no longer exist */
+} DistPeer;
+
+/* ============================================================
+ * Internal API
+ * ============================================================ */
+
+/* Queue a message for a remote handle (-1 if its node is unreachable) */
+int dist_send(ArnmProcess* target, uint64_t tag, const void* data, size_t size);
+
+/* Peer connection for a node id (NULL if not connected) */
+DistPeer* dist_peer(uint32_t node_id);
+
+#endif /* ARNM_DIST_H */
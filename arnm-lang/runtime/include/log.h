@@ -0,0 +1,55 @@
+/*
+ * ARNm Runtime - Structured Logging
+ *
+ * A log call stores a fixed-size binary record (time, pid, level,
+ * format id, integer arguments) into a ring owned by the calling
+ * worker; it never formats or makes a syscall. Each worker's ring
+ * has exactly one producer (the worker) and one consumer (the
+ * flusher thread), so both sides are plain load/store with
+ * acquire/release. Threads outside the scheduler share one more
+ * ring behind a spin lock.
+ *
+ * When a ring is full the record is dropped and counted; the flusher
+ * reports drop counts in the log. The flusher drains every ring in
+ * turn, formats what it took into one staging buffer per ring and
+ * writes all of them with a single writev. It starts with the first
+ * record and is stopped (after a final drain) by arnm_shutdown.
+ */
+
+#ifndef ARNM_LOG_H
+#define ARNM_LOG_H
+
+#include "arnm.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define LOG_RING_SIZE       1024                    /* Records per ring (power of 2) */
+#define LOG_RINGS           (ARNM_MAX_WORKERS + 1)  /* Last one: non-worker threads */
+#define LOG_MAX_FORMATS     4096
+#define LOG_STAGING_SIZE    (16 * 1024)             /* Formatted bytes per ring per pass */
+#define LOG_IDLE_US         1000                    /* Flusher sleep when all rings are empty */
+
+typedef struct {
+    uint64_t    time;           /* ns since the logger started */
+    uint64_t    pid;            /* Logging process (0 = outside any) */
+    uint32_t    format;         /* Id from arnm_log_format */
+    uint8_t     level;          /* ArnmLogLevel */
+    uint8_t     nargs;
+    uint16_t    reserved;
+    int64_t     args[ARNM_LOG_MAX_ARGS];
+} LogRecord;
+
+typedef struct {
+    _Alignas(64) _Atomic uint64_t tail;     /* Next slot to fill (producer) */
+    _Alignas(64) _Atomic uint64_t head;     /* Next slot to drain (flusher) */
+    atomic_uint_fast64_t dropped;           /* Records lost to a full ring */
+    atomic_flag         lock;               /* Shared ring only */
+    LogRecord           records[LOG_RING_SIZE];
+} LogRing;
+
+/* Apply runtime configuration (destination and level) */
+void log_configure(const ArnmConfig* config);
+
+#endif /* ARNM_LOG_H */
@@ -18,6 +18,7 @@ typedef struct ArnmMessage {
     uint64_t            tag;            /* Message type/tag */
     void*               data;           /* Payload pointer */
     size_t              size;           /* Payload size */
+    uint64_t            sent_at;        /* Enqueue time while tracing (ns, 0 = not stamped) */
     struct ArnmMessage* next;           /* Queue link */
 } ArnmMessage;
 
@@ -78,6 +79,14 @@ bool mailbox_empty(ArnmMailbox* mbox);
 /* Get pending message count */
 size_t mailbox_count(ArnmMailbox* mbox);
 
+/*
+ * Visit pending messages oldest first without dequeuing them. Only
+ * the consumer side may call this (the owner, or whoever claimed it).
+ * Messages enqueued during the walk may or may not be visited.
+ * Returns the number visited.
+ */
+size_t mailbox_visit(ArnmMailbox* mbox, void (*fn)(const ArnmMessage* msg, void* ctx), void* ctx);
+
 /* ============================================================
  * Message API
  * ============================================================ */
@@ -85,6 +94,9 @@ size_t mailbox_count(ArnmMailbox* mbox);
 /* Create a new message */
 ArnmMessage* message_create(uint64_t tag, void* data, size_t size);
 
+/* Create a new message on a NUMA node (-1 = caller's node) */
+ArnmMessage* message_create_on(uint64_t tag, void* data, size_t size, int node);
+
 /* Free a message */
 void message_free(ArnmMessage* msg);
 
@@ -57,6 +57,23 @@ void* pool_alloc(MemoryPool* pool);
 /* Return to pool */
 void pool_free(MemoryPool* pool, void* ptr);
 
+/* ============================================================
+ * Node-Local Heap
+ * ============================================================
+ * Size-classed free lists per NUMA node, carved from pages bound
+ * to that node. Blocks remember their home node and go back to it
+ * on free, whichever thread frees them. Thread-safe.
+ */
+
+/* Allocate from a node's heap (node < 0 = caller's node) */
+void* node_alloc(size_t size, int node);
+
+/* Return a block to its home node */
+void node_free(void* ptr);
+
+/* Node a block was allocated on */
+int node_of(void* ptr);
+
 /* ============================================================
  * Stack Allocation
  * ============================================================ */
@@ -64,6 +81,9 @@ void pool_free(MemoryPool* pool, void* ptr);
 /* Allocate a process stack with guard pages */
 void* stack_alloc(size_t size);
 
+/* Allocate a process stack preferring a NUMA node (node < 0 = any) */
+void* stack_alloc_on(size_t size, int node);
+
 /* Free a process stack */
 void stack_free(void* stack, size_t size);
 
@@ -0,0 +1,44 @@
+/*
+ * ARNm Runtime - Buffered Output
+ *
+ * print and friends append to a buffer owned by the calling worker
+ * (threads outside the scheduler share one extra buffer) and never
+ * touch stdio. A buffer is written to stdout when it fills, when its
+ * worker goes idle or stops, and on arnm_flush / arnm_shutdown / exit.
+ *
+ * Per-process order: a process remembers which buffer holds its
+ * newest output and how far into that buffer's stream it reaches.
+ * If it prints on another worker before that buffer was written out,
+ * it writes it out first, so a migrating process never sees its
+ * lines reordered. Lines of different processes may interleave.
+ *
+ * In line-atomic mode a full buffer is written only up to its last
+ * newline; the partial line stays behind, so raw arnm_write pieces
+ * of one line from a process that stays on its worker are never
+ * split by another worker's output.
+ */
+
+#ifndef ARNM_OUTPUT_H
+#define ARNM_OUTPUT_H
+
+#include "arnm.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define OUTPUT_BUFFER_SIZE  8192
+#define OUTPUT_BUFFERS      (ARNM_MAX_WORKERS + 1)  /* Last one: non-worker threads */
+
+/* Apply runtime configuration (line-atomic mode) */
+void output_configure(const ArnmConfig* config);
+
+/* Write out a worker's buffer (idle and exit paths) */
+void output_flush_worker(uint32_t worker_id);
+
+/* Format v in decimal into out (at least 20 bytes); returns the length */
+size_t output_format_i64(char* out, int64_t v);
+
+/* Format v in the shortest %g form that reads back exactly (at least 32 bytes) */
+size_t output_format_f64(char* out, double v);
+
+#endif /* ARNM_OUTPUT_H */
@@ -0,0 +1,46 @@
+/*
+ * ARNm Runtime - Fork-Join Data Parallelism
+ *
+ * A job describes one parallel loop. It lives on the caller's stack
+ * and is listed while chunks may still be claimed. Chunks are
+ * claimed with one fetch_add on the job's next index, so helpers
+ * never contend on a lock per chunk. Helpers register under the job
+ * list lock before touching a job and the caller returns only after
+ * every chunk is done and every helper has left; the last one out
+ * notifies the parked caller.
+ */
+
+#ifndef ARNM_PARALLEL_H
+#define ARNM_PARALLEL_H
+
+#include "arnm.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define PARALLEL_CHUNKS_PER_WORKER  4   /* Slack for uneven chunks */
+#define PARALLEL_MAX_CHUNKS         (ARNM_MAX_WORKERS * PARALLEL_CHUNKS_PER_WORKER)
+
+typedef struct ParallelJob {
+    ArnmForBody         body;           /* parallel for */
+    ArnmReduceBody      reduce;         /* parallel reduce */
+    void*               ctx;
+    int64_t             begin;
+    int64_t             end;
+    int64_t             chunk;          /* Iterations per chunk */
+    uint32_t            chunks;
+    int64_t*            partials;       /* reduce: one result per chunk */
+    atomic_uint         next;           /* Next chunk to claim */
+    atomic_uint         done;           /* Chunks finished */
+    uint32_t            helpers;        /* Workers inside (under the list lock) */
+    ArnmProcess*        waiter;         /* Caller, while parked on the join */
+    struct ParallelJob* next_job;
+} ParallelJob;
+
+/* Jobs with chunks left to claim (checked by workers every loop) */
+extern _Atomic uint32_t g_parallel_jobs;
+
+/* Run chunks of a listed job on the calling worker's stack */
+void parallel_help(void);
+
+#endif /* ARNM_PARALLEL_H */
@@ -17,6 +17,12 @@ typedef struct ArnmMailbox ArnmMailbox;
  * Process Structure
  * ============================================================ */
 
+typedef enum {
+    PROC_AWAKE,             /* Full stack resident */
+    PROC_TRIMMED,           /* Unused stack pages returned to the OS */
+    PROC_STACK_FREED,       /* No stack; restarts at restart_entry */
+} ProcHibernation;
+
 typedef enum {
     PROC_STATE_READY,       /* Ready to run */
     PROC_STATE_RUNNING,     /* Currently executing */
@@ -24,9 +30,22 @@ typedef enum {
     PROC_STATE_DEAD,        /* Terminated */
 } ProcState;
 
+/*
+ * Someone waiting for a process to exit. Joiners list a node on their
+ * own stack; monitors get a heap node. Lists and the listed flag are
+ * guarded by the target pid's registry shard.
+ */
+typedef struct ArnmWatcher {
+    struct ArnmWatcher*  next;
+    struct ArnmProcess*  joiner;    /* Join: process to wake (NULL = monitor) */
+    uint64_t             pid;       /* Monitor: process to send DOWN to */
+    bool                 listed;    /* Still on the target's list */
+} ArnmWatcher;
+
 typedef struct ArnmProcess {
     void*               actor_state;    /* Pointer to actor state (must be first) */
     uint64_t            pid;            /* Unique process ID */
+    size_t              state_size;     /* Bytes at actor_state */
     ProcState           state;          /* Current state */
     ArnmContext         context;        /* CPU context */
     
@@ -39,7 +58,43 @@ typedef struct ArnmProcess {
     
     /* Scheduling */
     struct ArnmProcess* next;           /* Run queue link */
+    atomic_bool         parked;         /* Switched out and waiting for a wake-up */
+    atomic_bool         notified;       /* A channel it waits on changed (see sched_notify) */
+    atomic_bool         mailbox_wait;   /* Mailbox sends wake us (off in a channel-only select) */
+    uint32_t            reductions;     /* Receives left in this quantum */
     uint32_t            worker_id;      /* Assigned worker */
+    _Atomic uint32_t    affinity;       /* Dominant sender worker (hi 16) + vote (lo 16) */
+    uint64_t            migrate_run;    /* run_count at last migration */
+    int32_t             node;           /* Home NUMA node (-1 = none) */
+    uint8_t             priority;       /* ArnmPriority class */
+    uint64_t            deadline;       /* Absolute deadline, monotonic ns (0 = none) */
+    
+    /* Hibernation */
+    void              (*restart_entry)(void*); /* Behavior loop head, while parked there */
+    uint64_t            park_time;      /* When the process last parked (ns) */
+    struct ArnmProcess* idle_next;      /* Worker idle list links */
+    struct ArnmProcess* idle_prev;
+    _Atomic int32_t     idle_worker;    /* Idle list holding us (-1 = none) */
+    uint8_t             hibernation;    /* ProcHibernation */
+    
+    /* Exit */
+    ArnmWatcher*        watchers;       /* Monitors and joiners (under the registry shard) */
+    _Atomic uint32_t    shell_refs;     /* 2 while a joinable handle is unjoined */
+    
+    /* Distribution */
+    struct ArnmProcess* table_next;     /* Pid registry chain */
+    uint32_t            dist_node;      /* Owning cluster node of a remote handle (0 = local) */
+    
+    /* Snapshots */
+    uint64_t            snap_hash;      /* Hash of state + mailbox when last written */
+    uint32_t            snap_gen;       /* Snapshot file that hash refers to (0 = none) */
+    
+    /* Tracing */
+    uint64_t            trace_seq;      /* Events recorded for this process */
+    
+    /* Output */
+    int32_t             out_buffer;     /* Output buffer holding our newest print (-1 = none) */
+    uint64_t            out_mark;       /* That buffer's stream offset just past it */
     
     /* Statistics */
     uint64_t            spawn_time;     /* When process was created */
@@ -53,6 +108,10 @@ typedef struct ArnmProcess {
 /* Create a new process (does not start it) */
 ArnmProcess* proc_create(void (*entry)(void*), void* arg, size_t stack_size, size_t state_size);
 
+/* Create a new process with shell, state and stack on a NUMA node (-1 = caller's) */
+ArnmProcess* proc_create_on(void (*entry)(void*), void* arg, size_t stack_size,
+                            size_t state_size, int node);
+
 /* Destroy a process and free resources */
 void proc_destroy(ArnmProcess* proc);
 
@@ -62,9 +121,69 @@ void proc_ready(ArnmProcess* proc);
 /* Mark process as waiting (blocked on receive) */
 void proc_wait(ArnmProcess* proc);
 
-/* Mark process as dead */
+/* Mark process as dead and notify its monitors and joiners */
 void proc_exit(ArnmProcess* proc);
 
+/* Drop one reference to an exited process's shell; the last frees it */
+void proc_release_shell(ArnmProcess* proc);
+
+/* ============================================================
+ * Exit Watchers
+ * ============================================================
+ * Watchers are kept per target and handed off in one pass when it
+ * exits, so exit costs O(watchers) and nobody polls.
+ */
+
+/* List a joiner on a live local process (false if it is not running) */
+bool proc_watch(uint64_t pid, ArnmWatcher* watcher);
+
+/* Unlist a joiner (false if the exit already unlisted it) */
+bool proc_unwatch(uint64_t pid, ArnmWatcher* watcher);
+
+/* Send watcher_pid a DOWN when pid exits (0 = listed, 1 = not running, -1 = OOM) */
+int proc_monitor(uint64_t pid, uint64_t watcher_pid);
+
+/* Drop the monitors watcher_pid holds on pid */
+void proc_demonitor(uint64_t pid, uint64_t watcher_pid);
+
+/* ============================================================
+ * Hibernation
+ * ============================================================ */
+
+/*
+ * Release stack memory of a parked process. With a restart entry the
+ * stack is freed outright; otherwise pages below the saved stack
+ * pointer are dropped with madvise. Caller must own the process.
+ */
+void proc_hibernate(ArnmProcess* proc);
+
+/* Give a hibernated process a runnable stack again (false on OOM) */
+bool proc_thaw(ArnmProcess* proc);
+
+/* ============================================================
+ * Process Registry
+ * ============================================================
+ * Pid -> process lookup for deliveries that arrive by pid rather
+ * than by handle (remote nodes). Processes are registered on
+ * creation and removed before they are freed.
+ */
+
+/* Register a local process under its pid */
+void proc_table_insert(ArnmProcess* proc);
+
+/* Unregister a process (no-op if absent) */
+void proc_table_remove(ArnmProcess* proc);
+
+/* Send to a live local process by pid (false if no such process) */
+bool proc_send_pid(uint64_t pid, uint64_t tag, void* data, size_t size);
+
+/*
+ * Call fn on every registered process. Each registry shard is locked
+ * while its processes are visited, so none of them can be destroyed
+ * under fn; fn must not spawn or send by pid.
+ */
+void proc_table_foreach(void (*fn)(ArnmProcess* proc, void* ctx), void* ctx);
+
 /* ============================================================
  * Process ID Generation
  * ============================================================ */
@@ -10,8 +10,7 @@
 #endif
 
 #include "process.h"
-#include <pthread.h>
-#include <stdatomic.h>
+#include "arnm.h"
 #include <pthread.h>
 #include <stdatomic.h>
 
@@ -27,15 +26,14 @@ typedef struct {
 } RunQueue;
 
 /* ============================================================
- * Wait Queue (for parked processes)
+ * Idle List (parked processes, oldest first, for hibernation)
  * ============================================================ */
 
 typedef struct {
     ArnmProcess*        head;
     ArnmProcess*        tail;
-    atomic_size_t       count;
     pthread_spinlock_t  lock;
-} WaitQueue;
+} IdleList;
 
 /* ============================================================
  * Worker Thread
@@ -45,10 +43,19 @@ typedef struct ArnmWorker {
     pthread_t           thread;         /* OS thread */
     uint32_t            id;             /* Worker ID */
     ArnmProcess*        current;        /* Running process */
-    RunQueue            local_queue;    /* Local run queue */
+    RunQueue            local_queues[ARNM_PRIO_COUNT]; /* Local run queue per class */
+    uint32_t            skipped[ARNM_PRIO_COUNT];      /* Picks a ready class was passed over */
     ArnmContext         scheduler_ctx;  /* Scheduler context */
     atomic_bool         running;        /* Worker active */
+    int32_t             node;           /* NUMA node (-1 = unpinned) */
+    int32_t             cpu;            /* Pinned CPU (-1 = unpinned) */
     uint64_t            steal_count;    /* Work stolen */
+    uint64_t            remote_steal_count; /* Work stolen across nodes */
+    uint64_t            send_seq;       /* Sends issued here (drives edge sampling) */
+    uint64_t            edge_samples;   /* Sampled sender->receiver edges */
+    atomic_uint_fast64_t migrations;    /* Processes pulled here by affinity */
+    IdleList            idle;           /* Processes that parked on this worker */
+    uint64_t            hibernations;   /* Stacks released */
     uint64_t            run_count;      /* Processes run */
 } ArnmWorker;
 
@@ -59,19 +66,24 @@ typedef struct ArnmWorker {
 typedef struct {
     ArnmWorker*         workers;        /* Worker array */
     uint32_t            num_workers;    /* Number of workers */
-    RunQueue            global_queue;   /* Global run queue */
-    WaitQueue           wait_queue;     /* Parked processes waiting for messages */
+    uint32_t            num_nodes;      /* NUMA nodes spanned by workers */
+    bool                pin_workers;    /* Workers pinned to CPUs */
+    uint32_t            max_batch;      /* Receives per quantum */
+    atomic_uint         rr_next;        /* Round-robin placement cursor */
+    uint64_t            hibernate_ns;   /* Idle time before hibernation (0 = off) */
+    RunQueue            global_queues[ARNM_PRIO_COUNT]; /* Global run queue per class */
     atomic_bool         shutdown;       /* Shutdown flag */
     atomic_size_t       active_procs;   /* Active process count */
     atomic_size_t       waiting_procs;  /* Waiting (parked) process count */
+    atomic_size_t       holds;          /* External message sources keeping workers up */
 } Scheduler;
 
 /* ============================================================
  * Scheduler API
  * ============================================================ */
 
-/* Initialize scheduler with N workers */
-int sched_init(uint32_t num_workers);
+/* Initialize scheduler from runtime configuration */
+int sched_init(const ArnmConfig* config);
 
 /* Shutdown scheduler */
 void sched_shutdown(void);
@@ -85,6 +97,12 @@ void sched_enqueue(ArnmProcess* proc);
 /* Enqueue to specific worker's local queue */
 void sched_enqueue_local(ArnmProcess* proc, uint32_t worker_id);
 
+/* Choose a worker for a new process (-1 = spawner's worker / global queue) */
+int sched_place(ArnmPlacement placement, uint32_t explicit_worker);
+
+/* Record a sampled message edge from the current worker to receiver */
+void sched_note_send(ArnmProcess* receiver);
+
 /* Get next process to run (may steal from other workers) */
 ArnmProcess* sched_next(ArnmWorker* worker);
 
@@ -97,13 +115,48 @@ ArnmWorker* sched_current_worker(void);
 /* Get global scheduler */
 Scheduler* sched_global(void);
 
-/* Park a process in wait queue (called when waiting for message) */
+/*
+ * Park a process that switched out in WAITING state. Called by the
+ * worker once the process's context is saved, so a concurrent waker
+ * can never resume a half-switched process.
+ */
 void sched_park(ArnmProcess* proc);
 
-/* Wake a parked process (called when message sent) */
+/* Wake a parked process (no-op if it is not parked) */
 void sched_wake(ArnmProcess* proc);
 
+/*
+ * Wake a process waiting on something other than its mailbox. The
+ * notified flag stays set, so a process that is still on its way to
+ * parking is put straight back (the sched_park recheck sees it).
+ */
+void sched_notify(ArnmProcess* proc);
+
+/*
+ * Take ownership of a parked process without waking it, the way a
+ * waker would (false if it is not parked). The caller may then touch
+ * its stack, state and mailbox until sched_unclaim re-parks it.
+ */
+bool sched_claim(ArnmProcess* proc);
+
+/* Re-park a claimed process, waking it if messages arrived meanwhile */
+void sched_unclaim(ArnmProcess* proc);
+
+/* True while any worker thread is running */
+bool sched_is_running(void);
+
+/*
+ * Keep workers running while an external source (a network peer, a
+ * shared-memory ring) may still deliver messages, even if every local
+ * process is parked or none exist yet.
+ */
+void sched_hold(void);
+void sched_release(void);
+
 /* Check for deadlock condition */
 bool sched_check_deadlock(void);
 
+/* Monotonic clock in nanoseconds */
+uint64_t sched_clock_ns(void);
+
 #endif /* ARNM_SCHEDULER_H */
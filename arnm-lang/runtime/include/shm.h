@@ -0,0 +1,88 @@
+/*
+ * ARNm Runtime - Shared-Memory Transport
+ *
+ * Two runtimes on one host can link through a named POSIX shared
+ * memory segment instead of TCP. The segment holds one ring per
+ * direction. Each ring has many producers (every worker of the
+ * sending runtime) and one consumer (a delivery thread in the
+ * receiving runtime):
+ *
+ *   - Records are whole 64-byte slots: an 8-byte sequence word, the
+ *     record header, then the payload, possibly running over into
+ *     following slots and wrapping at the end of the ring.
+ *   - Producers reserve slots with a CAS on tail, write the payload
+ *     straight into the ring, then publish by storing pos + 1 in the
+ *     first slot's sequence word.
+ *   - The consumer spins briefly, then parks on a futex word in the
+ *     ring. Producers only issue a wake-up syscall when that word
+ *     says the consumer is parked.
+ */
+
+#ifndef ARNM_SHM_H
+#define ARNM_SHM_H
+
+#include "arnm.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+/* ============================================================
+ * Segment Layout
+ * ============================================================ */
+
+#define SHM_MAGIC           0x4D485341u     /* "ASHM" */
+#define SHM_VERSION         1
+#define SHM_SLOT_SIZE       64
+#define SHM_RING_SLOTS      16384           /* 1MB per direction */
+#define SHM_RECORD_HEADER   32              /* seq, tag, pid, size, slots */
+#define SHM_MAX_PAYLOAD     ((SHM_RING_SLOTS / 2) * SHM_SLOT_SIZE - SHM_RECORD_HEADER)
+#define SHM_SPIN            256             /* Empty polls before parking */
+#define SHM_PARK_MS         50              /* Park timeout (stop checks) */
+
+typedef struct {
+    _Alignas(64) _Atomic uint64_t tail;     /* Next slot to reserve */
+    _Alignas(64) _Atomic uint64_t head;     /* Next slot to consume */
+    _Atomic uint32_t    parked;             /* Futex word: 1 = consumer asleep */
+    _Alignas(64) uint8_t slots[SHM_RING_SLOTS * SHM_SLOT_SIZE];
+} ShmRing;
+
+typedef struct {
+    uint32_t            magic;
+    uint32_t            version;
+    uint32_t            nodes[2];           /* [0] = creator, [1] = attacher */
+    _Atomic uint32_t    ready;              /* Creator finished initializing */
+    _Atomic uint32_t    attached;           /* Attacher mapped the segment */
+    ShmRing             rings[2];           /* rings[i] is consumed by nodes[i] */
+} ShmSegment;
+
+/* ============================================================
+ * Link
+ * ============================================================ */
+
+typedef struct ShmLink {
+    ShmSegment*         seg;
+    int                 side;               /* 0 = creator, 1 = attacher */
+    uint32_t            peer_node;
+    char                name[64];
+    pthread_t           consumer;
+    atomic_bool         stopping;
+
+    /* Statistics */
+    atomic_uint_fast64_t sent;
+    atomic_uint_fast64_t received;
+    atomic_uint_fast64_t wakeups;           /* Futex wakes issued by our producers */
+    atomic_uint_fast64_t dropped;
+} ShmLink;
+
+/* Shared-memory link to node (NULL if none) */
+ShmLink* shm_link(uint32_t node_id);
+
+/* Write a message into the peer's inbound ring (-1 if too large) */
+int shm_send(ShmLink* link, uint64_t pid, uint64_t tag, const void* data, size_t size);
+
+/* Tear down every link (called from arnm_node_stop) */
+void shm_stop_all(void);
+
+#endif /* ARNM_SHM_H */
@@ -0,0 +1,67 @@
+/*
+ * ARNm Runtime - Actor Snapshots
+ *
+ * A snapshot file is append-only and written through a shared
+ * mapping. It starts with a fixed header; after that come epochs.
+ * Each epoch is a run of actor records followed by one commit
+ * record:
+ *
+ *     SnapRecord | state bytes | { SnapMessage | payload }*
+ *
+ * Each part is padded to 8 bytes. The header's committed length is
+ * advanced only after an epoch's records are synced, so a crash
+ * mid-write leaves the previous epochs intact. The newest committed
+ * record for a pid supersedes older ones. An epoch only contains the
+ * actors whose state or pending mailbox changed since the previous
+ * epoch written by this runtime.
+ */
+
+#ifndef ARNM_SNAPSHOT_H
+#define ARNM_SNAPSHOT_H
+
+#include "arnm.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* ============================================================
+ * File Format
+ * ============================================================ */
+
+#define SNAP_MAGIC          0x31504E534D4E5241ull   /* "ARNMSNP1" */
+#define SNAP_VERSION        1
+#define SNAP_HEADER_SIZE    64
+#define SNAP_GROW           (1024 * 1024)           /* File growth step */
+
+typedef enum {
+    SNAP_ACTOR = 1,         /* Actor state + pending messages */
+    SNAP_COMMIT = 2,        /* End of an epoch */
+} SnapKind;
+
+typedef struct {
+    uint64_t    magic;
+    uint32_t    version;
+    uint32_t    reserved;
+    uint64_t    committed;      /* Bytes of the file that are valid */
+    uint64_t    epochs;         /* Committed epochs */
+} SnapHeader;
+
+typedef struct {
+    uint32_t    kind;           /* SnapKind */
+    uint32_t    messages;       /* Pending messages (actor count for commits) */
+    uint64_t    pid;
+    uint64_t    epoch;
+    uint64_t    state_size;
+    uint64_t    length;         /* Whole record, padding included */
+} SnapRecord;
+
+typedef struct {
+    uint64_t    tag;
+    uint64_t    size;
+} SnapMessage;
+
+static inline size_t snap_pad(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+#endif /* ARNM_SNAPSHOT_H */
@@ -10,9 +10,29 @@
 #include <stdbool.h>
 #include <stdatomic.h>
 #include <pthread.h>
+#include "arnm.h"
 
-/* Forward declarations */
-typedef struct ArnmProcess ArnmProcess;
+/* ============================================================
+ * Waiters
+ * ============================================================
+ * A process blocked on a primitive is listed with a node on its own
+ * stack and parks; whoever changes the primitive notifies it with
+ * sched_notify, which also catches a process still on its way to
+ * parking. Nothing here spins through arnm_yield.
+ */
+
+typedef struct ArnmWaiter {
+    ArnmProcess*        proc;
+    struct ArnmWaiter*  next;
+    struct ArnmWaiter*  prev;
+    atomic_bool         listed;         /* Still queued (a waker unlists what it wakes) */
+} ArnmWaiter;
+
+/* FIFO of waiters, guarded by the owning primitive's lock */
+typedef struct {
+    ArnmWaiter*         head;
+    ArnmWaiter*         tail;
+} ArnmWaitQueue;
 
 /* ============================================================
  * Mutex (Process-Level Mutual Exclusion)
@@ -58,6 +78,7 @@ typedef struct ArnmChannel {
     atomic_size_t       count;          /* Current count */
     pthread_spinlock_t  lock;           /* Internal protection */
     atomic_bool         closed;         /* Channel closed flag */
+    ArnmWaiter*         waiters;        /* Blocked processes (under lock) */
 } ArnmChannel;
 
 /* Create a new channel with specified capacity */
@@ -87,6 +108,136 @@ bool arnm_channel_is_closed(ArnmChannel* chan);
 /* Get current message count */
 size_t arnm_channel_count(ArnmChannel* chan);
 
+/* ============================================================
+ * Select (Wait on Several Channels and the Mailbox)
+ * ============================================================
+ * The caller registers as a waiter on every channel in the set and
+ * parks until one case can complete; exactly one case is performed.
+ * Channel sends, receives and closes notify registered waiters, and
+ * a mailbox send wakes its owner as usual. Cases are polled from a
+ * rotating start so a busy case cannot starve the others. Blocking
+ * channel send/receive are one-case selects.
+ */
+
+#define ARNM_SELECT_MAX     16
+
+typedef enum {
+    ARNM_SELECT_RECV,                   /* Receive from chan into data */
+    ARNM_SELECT_SEND,                   /* Send data to chan */
+    ARNM_SELECT_MAILBOX,                /* Receive a message into msg */
+} ArnmSelectKind;
+
+typedef struct {
+    ArnmSelectKind      kind;
+    ArnmChannel*        chan;           /* RECV / SEND (NULL: never ready) */
+    void*               data;           /* SEND: value to send; RECV: value received */
+    ArnmMessage*        msg;            /* MAILBOX: received message (caller frees) */
+    bool                ok;             /* RECV: false if chan was closed and drained */
+} ArnmSelectCase;
+
+/*
+ * Block until one case completes and return its index. A receive on a
+ * closed, drained channel completes with ok == false; a send on a
+ * closed channel never completes. Returns -1 if no case ever can.
+ */
+int arnm_select(ArnmSelectCase* cases, size_t count);
+
+/* Complete a case that is ready now, or return -1 */
+int arnm_select_try(ArnmSelectCase* cases, size_t count);
+
+/*
+ * Compiled select: receive from up to four channels (NULL = unused)
+ * and, if with_mailbox, the mailbox. Returns the arm index (4 = the
+ * mailbox, -1 = every channel closed); the value received, or the
+ * message tag, is then read with arnm_select_value.
+ */
+int64_t arnm_select_recv4(ArnmChannel* c0, ArnmChannel* c1, ArnmChannel* c2,
+                          ArnmChannel* c3, int64_t with_mailbox);
+
+/* Value delivered by the calling thread's last arnm_select_recv4 */
+int64_t arnm_select_value(void);
+
+/* ============================================================
+ * Reader-Writer Lock
+ * ============================================================
+ * Readers count themselves in a per-worker slot, so read-mostly
+ * locking touches no shared cache line. A slot may go negative when
+ * a reader unlocks on another worker than it locked on; only the sum
+ * matters. Writers are preferred: once a writer has raised the
+ * writer flag, new readers wait, and the writer waits for the
+ * reader sum to drain to zero.
+ */
+
+#define ARNM_RWLOCK_SLOTS   (ARNM_MAX_WORKERS + 1)  /* Last one: non-worker threads */
+
+typedef struct {
+    _Alignas(64) atomic_long readers;
+} ArnmReaderSlot;
+
+typedef struct ArnmRwLock {
+    ArnmReaderSlot      slots[ARNM_RWLOCK_SLOTS];
+    _Alignas(64) atomic_bool writer;    /* A writer holds or is draining */
+    pthread_spinlock_t  lock;           /* Guards the wait queues */
+    ArnmWaitQueue       read_waiters;
+    ArnmWaitQueue       write_waiters;  /* Writers waiting for the flag */
+    ArnmWaitQueue       drain_waiters;  /* The writer waiting for readers */
+} ArnmRwLock;
+
+/* Create a reader-writer lock */
+ArnmRwLock* arnm_rwlock_create(void);
+
+/* Destroy a reader-writer lock */
+void arnm_rwlock_destroy(ArnmRwLock* rw);
+
+/* Acquire shared (parks while a writer holds or waits) */
+void arnm_rwlock_read_lock(ArnmRwLock* rw);
+
+/* Try to acquire shared (non-blocking) */
+bool arnm_rwlock_try_read_lock(ArnmRwLock* rw);
+
+/* Release shared */
+void arnm_rwlock_read_unlock(ArnmRwLock* rw);
+
+/* Acquire exclusive (parks until other writers and all readers leave) */
+void arnm_rwlock_write_lock(ArnmRwLock* rw);
+
+/* Try to acquire exclusive (non-blocking) */
+bool arnm_rwlock_try_write_lock(ArnmRwLock* rw);
+
+/* Release exclusive */
+void arnm_rwlock_write_unlock(ArnmRwLock* rw);
+
+/* ============================================================
+ * Semaphore (Counting)
+ * ============================================================
+ * Bounds concurrency: acquire takes a permit or parks until one is
+ * released. Waiters are woken one per released permit, in order.
+ */
+
+typedef struct ArnmSemaphore {
+    atomic_long         permits;        /* Available permits */
+    pthread_spinlock_t  lock;           /* Guards the wait queue */
+    ArnmWaitQueue       waiters;
+} ArnmSemaphore;
+
+/* Create a semaphore with the given number of permits */
+ArnmSemaphore* arnm_semaphore_create(long permits);
+
+/* Destroy a semaphore */
+void arnm_semaphore_destroy(ArnmSemaphore* sem);
+
+/* Take a permit (parks while none is available) */
+void arnm_semaphore_acquire(ArnmSemaphore* sem);
+
+/* Take a permit if one is available (non-blocking) */
+bool arnm_semaphore_try_acquire(ArnmSemaphore* sem);
+
+/* Return a permit */
+void arnm_semaphore_release(ArnmSemaphore* sem);
+
+/* Currently available permits */
+long arnm_semaphore_available(ArnmSemaphore* sem);
+
 /* ============================================================
  * Barrier (Process Synchronization Point)
  * ============================================================
@@ -0,0 +1,73 @@
+/*
+ * ARNm Runtime - CPU/NUMA Topology
+ */
+
+#ifndef ARNM_TOPOLOGY_H
+#define ARNM_TOPOLOGY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/* ============================================================
+ * Limits
+ * ============================================================ */
+
+#define TOPO_MAX_CPUS       1024
+#define TOPO_MAX_NODES      64
+
+/* ============================================================
+ * Topology
+ * ============================================================
+ * Discovered once from /sys/devices/system/node. Machines (or
+ * containers) without sysfs NUMA info are treated as one node
+ * holding every online CPU.
+ */
+
+typedef struct {
+    uint32_t    num_nodes;                      /* Nodes with at least one CPU */
+    uint32_t    num_cpus;                       /* Online CPUs */
+    int16_t     cpu_node[TOPO_MAX_CPUS];        /* CPU -> node (-1 = offline) */
+    uint32_t    node_cpu_count[TOPO_MAX_NODES]; /* CPUs per node */
+    int         node_id[TOPO_MAX_NODES];        /* Dense index -> sysfs node id */
+} ArnmTopology;
+
+/* Discover topology (idempotent) */
+void topo_init(void);
+
+/* Get discovered topology */
+const ArnmTopology* topo_get(void);
+
+/* Number of NUMA nodes (always >= 1) */
+uint32_t topo_num_nodes(void);
+
+/* Dense node index of a CPU (0 if unknown) */
+uint32_t topo_node_of_cpu(int cpu);
+
+/* Dense node index of the CPU the caller runs on */
+uint32_t topo_current_node(void);
+
+/*
+ * Pick a CPU for a worker. Workers are spread round-robin over
+ * nodes so that a partial worker count still uses every socket.
+ * Returns the CPU and stores its dense node index in *node.
+ */
+int topo_cpu_for_worker(uint32_t worker_id, uint32_t* node);
+
+/* Pin calling thread to one CPU (returns false on failure) */
+bool topo_pin_thread(int cpu);
+
+/* ============================================================
+ * Node-Local Pages
+ * ============================================================ */
+
+/* mmap pages preferring the given node (node < 0 = no policy) */
+void* topo_alloc_pages(size_t size, int node);
+
+/* Release pages from topo_alloc_pages */
+void topo_free_pages(void* ptr, size_t size);
+
+/* Apply preferred-node policy to an existing mapping */
+void topo_bind_pages(void* ptr, size_t size, int node);
+
+#endif /* ARNM_TOPOLOGY_H */
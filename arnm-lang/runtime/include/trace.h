@@ -0,0 +1,96 @@
+/*
+ * ARNm Runtime - Message Tracing
+ *
+ * Capture mode records what every actor did, in the order it did it:
+ * whom it spawned, what it sent to whom, and what it received. Code
+ * running outside any process (main, the network and shared-memory
+ * delivery threads) is recorded as pid 0. The log is a header
+ * followed by fixed-size records:
+ *
+ *     TraceRecord | payload (SEND only)
+ *
+ * each padded to 8 bytes. Every thread appends to its own buffer and
+ * only takes the file lock to write a full buffer out, so records of
+ * different actors interleave arbitrarily in the file. Records of
+ * one actor carry an increasing seq; the reader sorts by it.
+ *
+ * Replay turns each recorded actor back into a process that repeats
+ * its spawns, sends and receives, so the recorded traffic shape runs
+ * against any runtime configuration.
+ */
+
+#ifndef ARNM_TRACE_H
+#define ARNM_TRACE_H
+
+#include "arnm.h"
+#include "mailbox.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* ============================================================
+ * File Format
+ * ============================================================ */
+
+#define TRACE_MAGIC         0x314352544D4E5241ull   /* "ARNMTRC1" */
+#define TRACE_VERSION       1
+#define TRACE_HEADER_SIZE   32
+#define TRACE_BUFFER_SIZE   (64 * 1024)             /* Per-thread buffer */
+#define TRACE_REPLAY_WAIT_NS 1000000000ull          /* Wait for a send target to be spawned */
+
+typedef enum {
+    TRACE_SPAWN = 1,        /* peer = child pid */
+    TRACE_SEND = 2,         /* peer = target pid, payload follows */
+    TRACE_RECV = 3,         /* peer = send-to-receive latency (ns, 0 = unknown) */
+} TraceKind;
+
+typedef struct {
+    uint64_t    magic;
+    uint32_t    version;
+    uint32_t    reserved;
+    uint64_t    start_ns;       /* Monotonic clock at capture start */
+    uint64_t    reserved2;
+} TraceHeader;
+
+typedef struct {
+    uint32_t    kind;           /* TraceKind */
+    uint32_t    size;           /* Message size */
+    uint64_t    pid;            /* Actor the event belongs to (0 = outside) */
+    uint64_t    seq;            /* Order among pid's events */
+    uint64_t    peer;
+    uint64_t    tag;
+    uint64_t    time;           /* ns since capture start */
+} TraceRecord;
+
+static inline size_t trace_pad(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+/* ============================================================
+ * Capture Hooks
+ * ============================================================
+ * Each hook is a single relaxed load while nothing is traced.
+ */
+
+extern atomic_bool g_trace_capture;     /* Capture running */
+extern atomic_bool g_trace_stamp;       /* Stamp messages with their enqueue time */
+
+static inline bool trace_capturing(void) {
+    return atomic_load_explicit(&g_trace_capture, memory_order_relaxed);
+}
+
+static inline bool trace_stamping(void) {
+    return atomic_load_explicit(&g_trace_stamp, memory_order_relaxed);
+}
+
+/* Current actor spawned child */
+void trace_spawn(uint64_t child);
+
+/* Current actor sent a message to local process target */
+void trace_send(uint64_t target, uint64_t tag, const void* data, size_t size);
+
+/* Current actor received msg */
+void trace_recv(const ArnmMessage* msg);
+
+#endif /* ARNM_TRACE_H */
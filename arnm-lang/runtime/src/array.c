@@ -0,0 +1,58 @@
+/*
+ * ARNm Runtime - Arrays
+ *
+ * An array value is the address of an ArnmArray header that is filled
+ * in here and never written again, which is what lets compiled code
+ * load a length once for a whole loop. A new array's elements follow
+ * its header in the same allocation; a slice is a fresh header
+ * pointing into its parent's elements.
+ */
+
+#include "../include/arnm.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static ArnmArray* array_header(size_t elems) {
+    ArnmArray* arr = arnm_alloc(sizeof(ArnmArray) + elems * sizeof(int64_t), NULL);
+    if (!arr) {
+        fprintf(stderr, "[ARNM PANIC] Out of memory allocating an array\n");
+        abort();
+    }
+    return arr;
+}
+
+ArnmArray* arnm_array_new(int64_t len) {
+    if (len < 0 || len > ARNM_ARRAY_MAX_LEN) {
+        fprintf(stderr, "[ARNM PANIC] Array length %lld out of range\n", (long long)len);
+        abort();
+    }
+    ArnmArray* arr = array_header((size_t)len);
+    arr->data = arr + 1;
+    arr->len = len;
+    return arr;
+}
+
+ArnmArray* arnm_array_slice(const ArnmArray* arr, int64_t lo, int64_t hi) {
+    if (lo < 0 || lo > hi || hi > arr->len) {
+        fprintf(stderr, "[ARNM PANIC] Slice [%lld..%lld] out of range for length %lld\n",
+                (long long)lo, (long long)hi, (long long)arr->len);
+        abort();
+    }
+    ArnmArray* slice = array_header(0);
+    slice->data = (int64_t*)arr->data + lo;
+    slice->len = hi - lo;
+    return slice;
+}
+
+int32_t arnm_array_aliased(const ArnmArray* a, const ArnmArray* b) {
+    uintptr_t pa = (uintptr_t)a->data, pb = (uintptr_t)b->data;
+    if (pa == pb) return 0;
+    return pa < pb + (uintptr_t)b->len * sizeof(int64_t) &&
+           pb < pa + (uintptr_t)a->len * sizeof(int64_t);
+}
+
+void arnm_panic_bounds(int64_t index, int64_t len) {
+    fprintf(stderr, "[ARNM PANIC] Index %lld out of bounds for length %lld\n",
+            (long long)index, (long long)len);
+    abort();
+}
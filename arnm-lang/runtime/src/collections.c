@@ -0,0 +1,352 @@
+/*
+ * ARNm Runtime - Collections
+ *
+ * Headers are ARC objects whose destructor returns the storage to the
+ * node-local heap. Each collection belongs to one process, so nothing
+ * here synchronizes; the node heap itself is the only shared state.
+ *
+ * The map is a Swiss table: entries live in one array, and a parallel
+ * array of control bytes holds, per slot, the low 7 bits of the key's
+ * hash when the slot is full. Lookups hash once, then scan groups of
+ * ARNM_MAP_GROUP control bytes along a triangular probe sequence: a
+ * group is compared against the tag all at once, only keys whose tag
+ * matches are compared, and a group with an empty byte ends the search.
+ * Removal leaves a tombstone unless the group still has an empty byte,
+ * in which case no probe has ever gone past it.
+ */
+
+#include "../include/arnm.h"
+#include "../include/memory.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#define MAP_SSE2 1
+#else
+#define MAP_SSE2 0
+#endif
+
+#define MIN_CAPACITY    4
+
+/* Control bytes: a full slot holds its 7-bit tag */
+#define CTRL_EMPTY      0x80
+#define CTRL_DELETED    0xFE
+
+static void panic_empty(const char* what) {
+    fprintf(stderr, "[ARNM PANIC] Pop from an empty %s\n", what);
+    abort();
+}
+
+static void* storage_alloc(size_t bytes) {
+    void* p = node_alloc(bytes, -1);
+    if (!p) {
+        fprintf(stderr, "[ARNM PANIC] Out of memory growing a collection\n");
+        abort();
+    }
+    return p;
+}
+
+static void* header_alloc(size_t size, ArnmDestructor dtor) {
+    void* header = arnm_alloc(size, dtor);
+    if (!header) {
+        fprintf(stderr, "[ARNM PANIC] Out of memory allocating a collection\n");
+        abort();
+    }
+    return header;
+}
+
+/* Capacity for one more element than len: doubled, or panics past the length limit */
+static int64_t grown(int64_t len, int64_t cap) {
+    if (len >= ARNM_ARRAY_MAX_LEN) {
+        fprintf(stderr, "[ARNM PANIC] Collection length %lld out of range\n", (long long)len + 1);
+        abort();
+    }
+    return cap ? cap * 2 : MIN_CAPACITY;
+}
+
+/* ============================================================
+ * Vector
+ * ============================================================ */
+
+static void vec_destroy(void* obj) {
+    node_free(((ArnmVec*)obj)->data);
+}
+
+ArnmVec* arnm_vec_new(void) {
+    return header_alloc(sizeof(ArnmVec), vec_destroy);
+}
+
+int32_t arnm_vec_len(const ArnmVec* vec) {
+    return (int32_t)vec->len;
+}
+
+int64_t* arnm_vec_push(ArnmVec* vec) {
+    if (vec->len == vec->cap) {
+        int64_t cap = grown(vec->len, vec->cap);
+        int64_t* data = storage_alloc((size_t)cap * sizeof(int64_t));
+        if (vec->len) memcpy(data, vec->data, (size_t)vec->len * sizeof(int64_t));
+        node_free(vec->data);
+        vec->data = data;
+        vec->cap = cap;
+    }
+    int64_t* slot = &vec->data[vec->len++];
+    *slot = 0;
+    return slot;
+}
+
+int64_t* arnm_vec_pop(ArnmVec* vec) {
+    if (vec->len == 0) panic_empty("vec");
+    return &vec->data[--vec->len];
+}
+
+int64_t* arnm_vec_at(ArnmVec* vec, int64_t index) {
+    if (index < 0 || index >= vec->len) arnm_panic_bounds(index, vec->len);
+    return &vec->data[index];
+}
+
+/* ============================================================
+ * Map
+ * ============================================================ */
+
+typedef struct {
+    int64_t key;
+    int64_t value;
+} MapEntry;
+
+static MapEntry* map_entries(const ArnmMap* map) {
+    return (MapEntry*)(map->ctrl + map->cap);
+}
+
+/* 64-bit finalizer: every key bit reaches both the tag and the group index */
+static uint64_t map_hash(int64_t key) {
+    uint64_t h = (uint64_t)key;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/* Bit i set where byte i of the group at ctrl equals b */
+static uint32_t group_match(const uint8_t* ctrl, uint8_t b) {
+#if MAP_SSE2
+    __m128i group = _mm_load_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)b)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < ARNM_MAP_GROUP; i++) {
+        if (ctrl[i] == b) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+/* Bit i set where slot i of the group is empty or deleted: the only bytes with the top bit */
+static uint32_t group_match_free(const uint8_t* ctrl) {
+#if MAP_SSE2
+    return (uint32_t)_mm_movemask_epi8(_mm_load_si128((const __m128i*)ctrl));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < ARNM_MAP_GROUP; i++) {
+        if (ctrl[i] & 0x80) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+/* Index of the entry for key, or -1 */
+static int64_t map_lookup(const ArnmMap* map, int64_t key) {
+    if (map->cap == 0) return -1;
+    uint64_t hash = map_hash(key);
+    uint8_t tag = (uint8_t)(hash & 0x7F);
+    uint64_t groups_mask = (uint64_t)map->cap / ARNM_MAP_GROUP - 1;
+    uint64_t group = (hash >> 7) & groups_mask;
+    const MapEntry* entries = map_entries(map);
+
+    for (uint64_t step = 1;; step++) {
+        const uint8_t* ctrl = map->ctrl + group * ARNM_MAP_GROUP;
+        for (uint32_t hits = group_match(ctrl, tag); hits; hits &= hits - 1) {
+            int64_t i = (int64_t)(group * ARNM_MAP_GROUP) + __builtin_ctz(hits);
+            if (entries[i].key == key) return i;
+        }
+        if (group_match(ctrl, CTRL_EMPTY)) return -1;
+        group = (group + step) & groups_mask;
+    }
+}
+
+/* First empty or deleted slot on key's probe sequence; the table has one */
+static int64_t map_free_slot(const ArnmMap* map, uint64_t hash) {
+    uint64_t groups_mask = (uint64_t)map->cap / ARNM_MAP_GROUP - 1;
+    uint64_t group = (hash >> 7) & groups_mask;
+    for (uint64_t step = 1;; step++) {
+        uint32_t free = group_match_free(map->ctrl + group * ARNM_MAP_GROUP);
+        if (free) return (int64_t)(group * ARNM_MAP_GROUP) + __builtin_ctz(free);
+        group = (group + step) & groups_mask;
+    }
+}
+
+/* Load factor 7/8 */
+static int64_t map_growth(int64_t cap) {
+    return cap - cap / 8;
+}
+
+/* Move every entry into a fresh table of cap slots, dropping tombstones */
+static void map_rehash(ArnmMap* map, int64_t cap) {
+    ArnmMap old = *map;
+    map->ctrl = storage_alloc((size_t)cap * (1 + sizeof(MapEntry)));
+    memset(map->ctrl, CTRL_EMPTY, (size_t)cap);
+    map->cap = cap;
+    map->growth_left = map_growth(cap) - map->len;
+
+    MapEntry* entries = map_entries(map);
+    const MapEntry* old_entries = map_entries(&old);
+    for (int64_t i = 0; i < old.cap; i++) {
+        if (old.ctrl[i] & 0x80) continue;
+        uint64_t hash = map_hash(old_entries[i].key);
+        int64_t slot = map_free_slot(map, hash);
+        map->ctrl[slot] = (uint8_t)(hash & 0x7F);
+        entries[slot] = old_entries[i];
+    }
+    node_free(old.ctrl);
+}
+
+static void map_destroy(void* obj) {
+    node_free(((ArnmMap*)obj)->ctrl);
+}
+
+ArnmMap* arnm_map_new(void) {
+    return header_alloc(sizeof(ArnmMap), map_destroy);
+}
+
+int32_t arnm_map_len(const ArnmMap* map) {
+    return (int32_t)map->len;
+}
+
+int64_t* arnm_map_slot(ArnmMap* map, int64_t key) {
+    int64_t i = map_lookup(map, key);
+    if (i >= 0) return &map_entries(map)[i].value;
+
+    uint64_t hash = map_hash(key);
+    if (map->growth_left == 0) {
+        /* Mostly tombstones: clean up in place; otherwise double */
+        int64_t cap = map->cap == 0 ? ARNM_MAP_GROUP :
+                      map->len * 2 < map_growth(map->cap) ? map->cap :
+                      grown(map->len, map->cap);
+        map_rehash(map, cap);
+    }
+    i = map_free_slot(map, hash);
+    if (map->ctrl[i] == CTRL_EMPTY) map->growth_left--;
+    map->ctrl[i] = (uint8_t)(hash & 0x7F);
+    map->len++;
+
+    MapEntry* entry = &map_entries(map)[i];
+    entry->key = key;
+    entry->value = 0;
+    return &entry->value;
+}
+
+int64_t* arnm_map_find(const ArnmMap* map, int64_t key) {
+    int64_t i = map_lookup(map, key);
+    return i < 0 ? NULL : &map_entries(map)[i].value;
+}
+
+int64_t* arnm_map_at(const ArnmMap* map, int64_t key) {
+    int64_t* slot = arnm_map_find(map, key);
+    if (!slot) {
+        fprintf(stderr, "[ARNM PANIC] Key %lld not in map\n", (long long)key);
+        abort();
+    }
+    return slot;
+}
+
+int32_t arnm_map_has(const ArnmMap* map, int64_t key) {
+    return map_lookup(map, key) >= 0;
+}
+
+int32_t arnm_map_remove(ArnmMap* map, int64_t key) {
+    int64_t i = map_lookup(map, key);
+    if (i < 0) return 0;
+    const uint8_t* group = map->ctrl + (i & ~(int64_t)(ARNM_MAP_GROUP - 1));
+    if (group_match(group, CTRL_EMPTY)) {
+        map->ctrl[i] = CTRL_EMPTY;
+        map->growth_left++;
+    } else {
+        map->ctrl[i] = CTRL_DELETED;
+    }
+    map->len--;
+    return 1;
+}
+
+/* ============================================================
+ * Deque
+ * ============================================================ */
+
+static void deque_destroy(void* obj) {
+    node_free(((ArnmDeque*)obj)->data);
+}
+
+/* Make room for one more element, unwrapping the ring to start at 0 */
+static void deque_reserve(ArnmDeque* deque) {
+    if (deque->len < deque->cap) return;
+    int64_t cap = grown(deque->len, deque->cap);
+    int64_t* data = storage_alloc((size_t)cap * sizeof(int64_t));
+    int64_t first = deque->cap - deque->head;
+    if (first > deque->len) first = deque->len;
+    if (deque->len) {
+        memcpy(data, deque->data + deque->head, (size_t)first * sizeof(int64_t));
+        memcpy(data + first, deque->data, (size_t)(deque->len - first) * sizeof(int64_t));
+    }
+    node_free(deque->data);
+    deque->data = data;
+    deque->cap = cap;
+    deque->head = 0;
+}
+
+static int64_t* deque_slot(const ArnmDeque* deque, int64_t i) {
+    return &deque->data[(deque->head + i) & (deque->cap - 1)];
+}
+
+ArnmDeque* arnm_deque_new(void) {
+    return header_alloc(sizeof(ArnmDeque), deque_destroy);
+}
+
+int32_t arnm_deque_len(const ArnmDeque* deque) {
+    return (int32_t)deque->len;
+}
+
+int64_t* arnm_deque_push_back(ArnmDeque* deque) {
+    deque_reserve(deque);
+    int64_t* slot = deque_slot(deque, deque->len++);
+    *slot = 0;
+    return slot;
+}
+
+int64_t* arnm_deque_push_front(ArnmDeque* deque) {
+    deque_reserve(deque);
+    deque->head = (deque->head - 1) & (deque->cap - 1);
+    deque->len++;
+    int64_t* slot = deque_slot(deque, 0);
+    *slot = 0;
+    return slot;
+}
+
+int64_t* arnm_deque_pop_back(ArnmDeque* deque) {
+    if (deque->len == 0) panic_empty("deque");
+    return deque_slot(deque, --deque->len);
+}
+
+int64_t* arnm_deque_pop_front(ArnmDeque* deque) {
+    if (deque->len == 0) panic_empty("deque");
+    int64_t* slot = deque_slot(deque, 0);
+    deque->head = (deque->head + 1) & (deque->cap - 1);
+    deque->len--;
+    return slot;
+}
+
+int64_t* arnm_deque_at(ArnmDeque* deque, int64_t index) {
+    if (index < 0 || index >= deque->len) arnm_panic_bounds(index, deque->len);
+    return deque_slot(deque, index);
+}
@@ -0,0 +1,527 @@
+/*
+ * ARNm Runtime - Distribution Implementation
+ */
+
+#include "../include/dist.h"
+#include "../include/scheduler.h"
+#include "../include/shm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#define DIST_HANDLE_BUCKETS 1024
+
+/* ============================================================
+ * Node State
+ * ============================================================ */
+
+typedef struct {
+    uint32_t            node_id;        /* 0 = not started */
+    int                 listen_fd;
+    pthread_t           acceptor;
+    bool                accepting;
+
+    pthread_mutex_t     lock;           /* Guards peers and handles */
+    DistPeer*           peers[DIST_MAX_NODES];
+    ArnmProcess*        handles[DIST_HANDLE_BUCKETS];
+} DistNode;
+
+static DistNode g_dist = {
+    .listen_fd = -1,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/* ============================================================
+ * Encoding
+ * ============================================================ */
+
+static inline void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t* p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static inline uint64_t get_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+/* ============================================================
+ * Socket Helpers
+ * ============================================================ */
+
+static bool write_all(int fd, const void* buf, size_t len) {
+    const uint8_t* p = buf;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool read_all(int fd, void* buf, size_t len) {
+    uint8_t* p = buf;
+    while (len > 0) {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* writev until every byte of iov[0..count) is out, advancing past short writes */
+static bool writev_all(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+
+        size_t done = (size_t)n;
+        while (count > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (uint8_t*)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return true;
+}
+
+/* Exchange hellos; returns the peer's node id or 0 on mismatch */
+static uint32_t handshake(int fd) {
+    uint8_t hello[DIST_HELLO_SIZE];
+    put_u32(hello, DIST_MAGIC);
+    put_u16(hello + 4, DIST_VERSION);
+    put_u16(hello + 6, (uint16_t)g_dist.node_id);
+    if (!write_all(fd, hello, sizeof(hello))) return 0;
+
+    if (!read_all(fd, hello, sizeof(hello))) return 0;
+    if (get_u32(hello) != DIST_MAGIC || get_u16(hello + 4) != DIST_VERSION) return 0;
+
+    uint32_t node = get_u16(hello + 6);
+    return node > 0 && node < DIST_MAX_NODES && node != g_dist.node_id ? node : 0;
+}
+
+/* ============================================================
+ * Peer Threads
+ * ============================================================ */
+
+static void* peer_writer(void* arg) {
+    DistPeer* peer = (DistPeer*)arg;
+    struct iovec iov[DIST_IOV_BATCH];
+    DistFrame* batch[DIST_IOV_BATCH];
+    bool ok = true;
+
+    for (;;) {
+        pthread_mutex_lock(&peer->lock);
+        while (!peer->head && !peer->closing) {
+            pthread_cond_wait(&peer->cond, &peer->lock);
+        }
+        DistFrame* list = peer->head;
+        peer->head = peer->tail = NULL;
+        bool closing = peer->closing;
+        pthread_mutex_unlock(&peer->lock);
+
+        /* Everything queued since the last wake-up goes out together */
+        while (list) {
+            int count = 0;
+            while (list && count < DIST_IOV_BATCH) {
+                batch[count] = list;
+                iov[count].iov_base = list->bytes;
+                iov[count].iov_len = list->size;
+                list = list->next;
+                count++;
+            }
+
+            if (ok) {
+                ok = writev_all(peer->fd, iov, count);
+                atomic_fetch_add(&peer->writevs, 1);
+                atomic_fetch_add(&peer->frames_out, (uint64_t)count);
+            }
+            for (int i = 0; i < count; i++) {
+                free(batch[i]);
+            }
+        }
+
+        if (!ok) {
+            /* Connection lost: refuse further sends, drop what was queued */
+            pthread_mutex_lock(&peer->lock);
+            peer->closing = true;
+            pthread_mutex_unlock(&peer->lock);
+        }
+        if (closing || !ok) break;
+    }
+
+    /* Frames queued while we were breaking out are dropped */
+    pthread_mutex_lock(&peer->lock);
+    DistFrame* rest = peer->head;
+    peer->head = peer->tail = NULL;
+    pthread_mutex_unlock(&peer->lock);
+    while (rest) {
+        DistFrame* next = rest->next;
+        free(rest);
+        rest = next;
+    }
+
+    return NULL;
+}
+
+static void* peer_reader(void* arg) {
+    DistPeer* peer = (DistPeer*)arg;
+    size_t cap = DIST_READ_BUFFER;
+    uint8_t* buf = malloc(cap);
+    size_t have = 0;
+
+    while (buf) {
+        ssize_t n = recv(peer->fd, buf + have, cap - have, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        have += (size_t)n;
+
+        /* Deliver every complete frame in the buffer */
+        size_t pos = 0;
+        while (have - pos >= DIST_HEADER_SIZE) {
+            const uint8_t* hdr = buf + pos;
+            uint32_t size = get_u32(hdr + 16);
+            if (size > DIST_MAX_PAYLOAD) {
+                fprintf(stderr, "[ARNM WARNING] Oversized frame from node %u, closing\n",
+                        peer->node_id);
+                goto done;
+            }
+            if (have - pos < DIST_HEADER_SIZE + (size_t)size) break;
+
+            uint64_t pid = get_u64(hdr);
+            uint64_t tag = get_u64(hdr + 8);
+            void* payload = size ? (void*)(hdr + DIST_HEADER_SIZE) : NULL;
+
+            atomic_fetch_add(&peer->frames_in, 1);
+            if (!proc_send_pid(pid, tag, payload, size)) {
+                atomic_fetch_add(&peer->dropped, 1);
+            }
+            pos += DIST_HEADER_SIZE + size;
+        }
+
+        /* Keep the partial frame, growing the buffer if it can't fit */
+        memmove(buf, buf + pos, have - pos);
+        have -= pos;
+        if (have >= DIST_HEADER_SIZE) {
+            size_t need = DIST_HEADER_SIZE + get_u32(buf + 16);
+            if (need > cap) {
+                uint8_t* grown = realloc(buf, need);
+                if (!grown) break;
+                buf = grown;
+                cap = need;
+            }
+        }
+    }
+
+done:
+    free(buf);
+
+    /* Peer went away: stop accepting sends to it */
+    pthread_mutex_lock(&peer->lock);
+    peer->closing = true;
+    pthread_cond_signal(&peer->cond);
+    pthread_mutex_unlock(&peer->lock);
+    return NULL;
+}
+
+/* Register a connected, handshaken socket as the peer for node */
+static int peer_add(int fd, uint32_t node) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    DistPeer* peer = calloc(1, sizeof(DistPeer));
+    if (!peer) return -1;
+    peer->fd = fd;
+    peer->node_id = node;
+    pthread_mutex_init(&peer->lock, NULL);
+    pthread_cond_init(&peer->cond, NULL);
+
+    /* One connection per node pair: a second one is refused */
+    pthread_mutex_lock(&g_dist.lock);
+    if (g_dist.peers[node]) {
+        pthread_mutex_unlock(&g_dist.lock);
+        pthread_mutex_destroy(&peer->lock);
+        pthread_cond_destroy(&peer->cond);
+        free(peer);
+        return -1;
+    }
+    g_dist.peers[node] = peer;
+    pthread_mutex_unlock(&g_dist.lock);
+
+    pthread_create(&peer->writer, NULL, peer_writer, peer);
+    pthread_create(&peer->reader, NULL, peer_reader, peer);
+    return 0;
+}
+
+static void peer_close(DistPeer* peer) {
+    /* Writer flushes what is queued before exiting */
+    pthread_mutex_lock(&peer->lock);
+    peer->closing = true;
+    pthread_cond_signal(&peer->cond);
+    pthread_mutex_unlock(&peer->lock);
+    pthread_join(peer->writer, NULL);
+
+    shutdown(peer->fd, SHUT_RDWR);
+    pthread_join(peer->reader, NULL);
+    close(peer->fd);
+
+    pthread_mutex_destroy(&peer->lock);
+    pthread_cond_destroy(&peer->cond);
+    free(peer);
+}
+
+static void* acceptor_main(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        int fd = accept(g_dist.listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;      /* Listener shut down */
+        }
+
+        uint32_t node = handshake(fd);
+        if (node == 0 || peer_add(fd, node) != 0) {
+            close(fd);
+        }
+    }
+    return NULL;
+}
+
+/* ============================================================
+ * Sending
+ * ============================================================ */
+
+DistPeer* dist_peer(uint32_t node_id) {
+    if (node_id == 0 || node_id >= DIST_MAX_NODES) return NULL;
+
+    pthread_mutex_lock(&g_dist.lock);
+    DistPeer* peer = g_dist.peers[node_id];
+    pthread_mutex_unlock(&g_dist.lock);
+    return peer;
+}
+
+int dist_send(ArnmProcess* target, uint64_t tag, const void* data, size_t size) {
+    if (size > DIST_MAX_PAYLOAD) return -1;
+
+    /* Same-host peers linked through shared memory skip the socket */
+    ShmLink* link = shm_link(target->dist_node);
+    if (link && size <= SHM_MAX_PAYLOAD) {
+        return shm_send(link, target->pid, tag, data, size);
+    }
+
+    DistPeer* peer = dist_peer(target->dist_node);
+    if (!peer) return -1;
+
+    DistFrame* frame = malloc(sizeof(DistFrame) + DIST_HEADER_SIZE + size);
+    if (!frame) return -1;
+    frame->next = NULL;
+    frame->size = (uint32_t)(DIST_HEADER_SIZE + size);
+    put_u64(frame->bytes, target->pid);
+    put_u64(frame->bytes + 8, tag);
+    put_u32(frame->bytes + 16, (uint32_t)size);
+    if (size) {
+        memcpy(frame->bytes + DIST_HEADER_SIZE, data, size);
+    }
+
+    /* Only the first frame into an empty queue needs to wake the writer */
+    pthread_mutex_lock(&peer->lock);
+    if (peer->closing) {
+        pthread_mutex_unlock(&peer->lock);
+        free(frame);
+        return -1;
+    }
+    bool was_empty = peer->head == NULL;
+    if (peer->tail) {
+        peer->tail->next = frame;
+    } else {
+        peer->head = frame;
+    }
+    peer->tail = frame;
+    if (was_empty) {
+        pthread_cond_signal(&peer->cond);
+    }
+    pthread_mutex_unlock(&peer->lock);
+
+    return 0;
+}
+
+/* ============================================================
+ * Public API
+ * ============================================================ */
+
+int arnm_node_start(uint32_t node_id, uint16_t port) {
+    if (node_id == 0 || node_id >= DIST_MAX_NODES || g_dist.node_id != 0) return -1;
+
+    if (port) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port);
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+            close(fd);
+            return -1;
+        }
+
+        g_dist.listen_fd = fd;
+    }
+
+    g_dist.node_id = node_id;
+    sched_hold();
+
+    if (g_dist.listen_fd >= 0) {
+        g_dist.accepting = pthread_create(&g_dist.acceptor, NULL, acceptor_main, NULL) == 0;
+    }
+    return 0;
+}
+
+int arnm_node_connect(const char* host, uint16_t port) {
+    if (g_dist.node_id == 0) return -1;
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* res;
+    if (getaddrinfo(host, service, &hints, &res) != 0) return -1;
+
+    int fd = -1;
+    for (struct addrinfo* ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) return -1;
+
+    uint32_t node = handshake(fd);
+    if (node == 0 || peer_add(fd, node) != 0) {
+        close(fd);
+        return -1;
+    }
+    return (int)node;
+}
+
+void arnm_node_stop(void) {
+    if (g_dist.node_id == 0) return;
+
+    if (g_dist.listen_fd >= 0) {
+        shutdown(g_dist.listen_fd, SHUT_RDWR);
+        if (g_dist.accepting) {
+            pthread_join(g_dist.acceptor, NULL);
+        }
+        close(g_dist.listen_fd);
+        g_dist.listen_fd = -1;
+        g_dist.accepting = false;
+    }
+
+    pthread_mutex_lock(&g_dist.lock);
+    DistPeer* peers[DIST_MAX_NODES];
+    memcpy(peers, g_dist.peers, sizeof(peers));
+    memset(g_dist.peers, 0, sizeof(g_dist.peers));
+
+    /* Remote handles are only valid while the node is up */
+    for (int b = 0; b < DIST_HANDLE_BUCKETS; b++) {
+        ArnmProcess* h = g_dist.handles[b];
+        while (h) {
+            ArnmProcess* next = h->table_next;
+            free(h);
+            h = next;
+        }
+        g_dist.handles[b] = NULL;
+    }
+    pthread_mutex_unlock(&g_dist.lock);
+
+    for (int i = 0; i < DIST_MAX_NODES; i++) {
+        if (peers[i]) {
+            peer_close(peers[i]);
+        }
+    }
+    shm_stop_all();
+
+    g_dist.node_id = 0;
+    sched_release();
+}
+
+uint32_t arnm_node_id(void) {
+    return g_dist.node_id;
+}
+
+ArnmProcess* arnm_remote(uint32_t node_id, uint64_t pid) {
+    if (node_id == 0 || node_id >= DIST_MAX_NODES || g_dist.node_id == 0) return NULL;
+
+    size_t b = (pid * 31 + node_id) % DIST_HANDLE_BUCKETS;
+
+    pthread_mutex_lock(&g_dist.lock);
+    ArnmProcess* h = g_dist.handles[b];
+    while (h && (h->pid != pid || h->dist_node != node_id)) {
+        h = h->table_next;
+    }
+    if (!h) {
+        /* A handle is a bare process shell: no stack, no mailbox */
+        h = calloc(1, sizeof(ArnmProcess));
+        if (h) {
+            h->pid = pid;
+            h->dist_node = node_id;
+            h->node = -1;
+            h->table_next = g_dist.handles[b];
+            g_dist.handles[b] = h;
+        }
+    }
+    pthread_mutex_unlock(&g_dist.lock);
+
+    return h;
+}
+
+uint32_t arnm_pid_node(ArnmProcess* proc) {
+    if (!proc) return 0;
+    return proc->dist_node ? proc->dist_node : g_dist.node_id;
+}
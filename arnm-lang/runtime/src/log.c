@@ -0,0 +1,365 @@
+/*
+ * ARNm Runtime - Structured Logging Implementation
+ */
+
+#include "../include/log.h"
+#include "../include/output.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/uio.h>
+
+/* ============================================================
+ * Logger State
+ * ============================================================ */
+
+static _Atomic(LogRing*) log_rings[LOG_RINGS];     /* Allocated on first use */
+static _Atomic int log_level = ARNM_LOG_INFO;
+static uint64_t log_start_ns;
+
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static const char* log_formats[LOG_MAX_FORMATS + 1];   /* [0] unused */
+static _Atomic uint32_t log_format_count;
+
+static char log_path[4096];                 /* Destination ("" = stderr) */
+static int log_fd = -1;
+static pthread_t log_thread;
+static atomic_bool log_running;             /* Flusher thread exists */
+static atomic_bool log_stopping;
+static uint64_t log_reported_drops;         /* Drops already written to the log (flusher only) */
+
+static const char* const level_names[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+
+static bool log_start(void);
+
+/* ============================================================
+ * Rings
+ * ============================================================ */
+
+static LogRing* ring_get(int idx) {
+    LogRing* ring = atomic_load(&log_rings[idx]);
+    if (ring) return ring;
+
+    LogRing* fresh = calloc(1, sizeof(LogRing));
+    if (!fresh) return NULL;
+    atomic_flag_clear(&fresh->lock);
+
+    LogRing* expected = NULL;
+    if (!atomic_compare_exchange_strong(&log_rings[idx], &expected, fresh)) {
+        free(fresh);
+        return expected;
+    }
+    return fresh;
+}
+
+/* Producer side; only the ring's owner (or the shared ring's lock holder) calls this */
+static void ring_push(LogRing* ring, const LogRecord* rec) {
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head >= LOG_RING_SIZE) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    ring->records[tail & (LOG_RING_SIZE - 1)] = *rec;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+/* ============================================================
+ * Producer API
+ * ============================================================ */
+
+uint32_t arnm_log_format(const char* fmt) {
+    if (!fmt) return 0;
+
+    pthread_mutex_lock(&log_lock);
+    uint32_t n = atomic_load(&log_format_count);
+    for (uint32_t i = 1; i <= n; i++) {
+        if (log_formats[i] == fmt) {
+            pthread_mutex_unlock(&log_lock);
+            return i;
+        }
+    }
+    uint32_t id = 0;
+    if (n < LOG_MAX_FORMATS) {
+        id = n + 1;
+        log_formats[id] = fmt;
+        atomic_store(&log_format_count, id);
+    }
+    pthread_mutex_unlock(&log_lock);
+    return id;
+}
+
+bool arnm_log_enabled(ArnmLogLevel level) {
+    return (int)level >= atomic_load_explicit(&log_level, memory_order_relaxed) &&
+           level < ARNM_LOG_OFF;
+}
+
+void arnm_log_set_level(ArnmLogLevel level) {
+    atomic_store(&log_level, (int)level);
+}
+
+void arnm_log_write(ArnmLogLevel level, uint32_t format, const int64_t* args, size_t nargs) {
+    if (!arnm_log_enabled(level) || format == 0) return;
+    if (!atomic_load_explicit(&log_running, memory_order_acquire) && !log_start()) return;
+
+    ArnmWorker* worker = sched_current_worker();
+    int idx = worker ? (int)worker->id : LOG_RINGS - 1;
+    LogRing* ring = ring_get(idx);
+    if (!ring) return;
+
+    LogRecord rec;
+    rec.time = sched_clock_ns() - log_start_ns;
+    ArnmProcess* proc = proc_current();
+    rec.pid = proc ? proc->pid : 0;
+    rec.format = format;
+    rec.level = (uint8_t)level;
+    rec.nargs = (uint8_t)(nargs < ARNM_LOG_MAX_ARGS ? nargs : ARNM_LOG_MAX_ARGS);
+    rec.reserved = 0;
+    memcpy(rec.args, args, rec.nargs * sizeof(int64_t));
+
+    if (worker) {
+        ring_push(ring, &rec);
+    } else {
+        while (atomic_flag_test_and_set_explicit(&ring->lock, memory_order_acquire)) {
+            /* spin */
+        }
+        ring_push(ring, &rec);
+        atomic_flag_clear_explicit(&ring->lock, memory_order_release);
+    }
+}
+
+uint64_t arnm_log_dropped(void) {
+    uint64_t total = 0;
+    for (int i = 0; i < LOG_RINGS; i++) {
+        LogRing* ring = atomic_load(&log_rings[i]);
+        if (ring) total += atomic_load(&ring->dropped);
+    }
+    return total;
+}
+
+/* ============================================================
+ * Flusher
+ * ============================================================ */
+
+typedef struct {
+    char*       data;
+    size_t      used;
+} Staging;
+
+static void put(Staging* st, const char* s, size_t n) {
+    if (st->used + n > LOG_STAGING_SIZE) n = LOG_STAGING_SIZE - st->used;
+    memcpy(st->data + st->used, s, n);
+    st->used += n;
+}
+
+static void put_i64(Staging* st, int64_t v) {
+    if (LOG_STAGING_SIZE - st->used < 24) return;
+    st->used += output_format_i64(st->data + st->used, v);
+}
+
+/* "<sec>.<usec> LEVEL <pid> message\n" */
+static void format_record(Staging* st, const LogRecord* rec) {
+    char frac[8];
+    uint64_t usec = (rec->time / 1000) % 1000000;
+    for (int i = 5; i >= 0; i--) {
+        frac[i] = (char)('0' + usec % 10);
+        usec /= 10;
+    }
+    put_i64(st, (int64_t)(rec->time / 1000000000ull));
+    put(st, ".", 1);
+    put(st, frac, 6);
+    put(st, " ", 1);
+    put(st, level_names[rec->level < ARNM_LOG_OFF ? rec->level : ARNM_LOG_ERROR], 5);
+    put(st, " <", 2);
+    put_i64(st, (int64_t)rec->pid);
+    put(st, "> ", 2);
+
+    const char* fmt = rec->format <= atomic_load(&log_format_count) ? log_formats[rec->format] : NULL;
+    if (!fmt) fmt = "(unknown format)";
+
+    uint32_t arg = 0;
+    const char* p = fmt;
+    for (;;) {
+        const char* hole = strstr(p, "{}");
+        if (!hole) break;
+        put(st, p, (size_t)(hole - p));
+        if (arg < rec->nargs) {
+            put_i64(st, rec->args[arg++]);
+        } else {
+            put(st, "{}", 2);
+        }
+        p = hole + 2;
+    }
+    put(st, p, strlen(p));
+    put(st, "\n", 1);
+}
+
+static bool write_iov(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+
+        size_t done = (size_t)n;
+        while (count > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return true;
+}
+
+/* One pass over every ring; returns the number of records written */
+static size_t flush_pass(Staging* staging, char* notice) {
+    struct iovec iov[LOG_RINGS + 1];
+    int count = 0;
+    size_t records = 0;
+
+    for (int i = 0; i < LOG_RINGS; i++) {
+        LogRing* ring = atomic_load(&log_rings[i]);
+        if (!ring) continue;
+
+        Staging* st = &staging[i];
+        st->used = 0;
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+        /* Stop early rather than truncate a line in the staging buffer */
+        while (head != tail && st->used + 512 <= LOG_STAGING_SIZE) {
+            format_record(st, &ring->records[head & (LOG_RING_SIZE - 1)]);
+            head++;
+            records++;
+        }
+        atomic_store_explicit(&ring->head, head, memory_order_release);
+
+        if (st->used) {
+            iov[count].iov_base = st->data;
+            iov[count].iov_len = st->used;
+            count++;
+        }
+    }
+
+    uint64_t dropped = arnm_log_dropped();
+    if (dropped != log_reported_drops) {
+        Staging st = { notice, 0 };
+        put(&st, "[arnm log] ", 11);
+        put_i64(&st, (int64_t)(dropped - log_reported_drops));
+        put(&st, " records dropped\n", 17);
+        iov[count].iov_base = notice;
+        iov[count].iov_len = st.used;
+        count++;
+        log_reported_drops = dropped;
+    }
+
+    int fd = log_fd >= 0 ? log_fd : STDERR_FILENO;
+    if (count > 0) write_iov(fd, iov, count);
+    return records;
+}
+
+static void* log_flusher(void* arg) {
+    (void)arg;
+    Staging staging[LOG_RINGS];
+    char* data = malloc((size_t)LOG_RINGS * LOG_STAGING_SIZE);
+    char notice[64];
+    if (!data) return NULL;
+    for (int i = 0; i < LOG_RINGS; i++) {
+        staging[i].data = data + (size_t)i * LOG_STAGING_SIZE;
+        staging[i].used = 0;
+    }
+
+    while (!atomic_load(&log_stopping)) {
+        if (flush_pass(staging, notice) == 0) {
+            usleep(LOG_IDLE_US);
+        }
+    }
+
+    /* Final drain */
+    while (flush_pass(staging, notice) > 0) { }
+
+    free(data);
+    return NULL;
+}
+
+/* Start the flusher for the configured destination (false on error) */
+static bool log_start(void) {
+    pthread_mutex_lock(&log_lock);
+    if (atomic_load(&log_running)) {
+        pthread_mutex_unlock(&log_lock);
+        return true;
+    }
+
+    if (log_path[0]) {
+        log_fd = open(log_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (log_fd < 0) {
+            pthread_mutex_unlock(&log_lock);
+            return false;
+        }
+    }
+
+    if (!log_start_ns) log_start_ns = sched_clock_ns();
+    atomic_store(&log_stopping, false);
+    if (pthread_create(&log_thread, NULL, log_flusher, NULL) != 0) {
+        if (log_fd >= 0) close(log_fd);
+        log_fd = -1;
+        pthread_mutex_unlock(&log_lock);
+        return false;
+    }
+    atomic_store_explicit(&log_running, true, memory_order_release);
+    pthread_mutex_unlock(&log_lock);
+    return true;
+}
+
+/* ============================================================
+ * Lifecycle
+ * ============================================================ */
+
+int arnm_log_open(const char* path) {
+    arnm_log_close();
+
+    pthread_mutex_lock(&log_lock);
+    if (path && strlen(path) >= sizeof(log_path)) {
+        pthread_mutex_unlock(&log_lock);
+        return -1;
+    }
+    strcpy(log_path, path ? path : "");
+    pthread_mutex_unlock(&log_lock);
+
+    return log_start() ? 0 : -1;
+}
+
+void arnm_log_close(void) {
+    pthread_mutex_lock(&log_lock);
+    if (!atomic_load(&log_running)) {
+        pthread_mutex_unlock(&log_lock);
+        return;
+    }
+    atomic_store(&log_stopping, true);
+    pthread_join(log_thread, NULL);
+    atomic_store(&log_running, false);
+    if (log_fd >= 0) {
+        close(log_fd);
+        log_fd = -1;
+    }
+    pthread_mutex_unlock(&log_lock);
+}
+
+void log_configure(const ArnmConfig* config) {
+    arnm_log_set_level((ArnmLogLevel)config->log_level);
+
+    pthread_mutex_lock(&log_lock);
+    if (config->log_path && strlen(config->log_path) < sizeof(log_path)) {
+        strcpy(log_path, config->log_path);
+    }
+    pthread_mutex_unlock(&log_lock);
+}
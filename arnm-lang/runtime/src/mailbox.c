@@ -5,6 +5,8 @@
 #include "../include/mailbox.h"
 #include "../include/process.h"
 #include "../include/scheduler.h"
+#include "../include/memory.h"
+#include "../include/trace.h"
 #include "../include/arnm.h"
 #include <stdlib.h>
 #include <string.h>
@@ -15,17 +17,22 @@
  * ============================================================ */
 
 ArnmMessage* message_create(uint64_t tag, void* data, size_t size) {
-    ArnmMessage* msg = (ArnmMessage*)malloc(sizeof(ArnmMessage));
+    return message_create_on(tag, data, size, -1);
+}
+
+ArnmMessage* message_create_on(uint64_t tag, void* data, size_t size, int node) {
+    ArnmMessage* msg = (ArnmMessage*)node_alloc(sizeof(ArnmMessage), node);
     if (!msg) return NULL;
     
     msg->tag = tag;
     msg->size = size;
+    msg->sent_at = 0;
     msg->next = NULL;
     
     if (size > 0 && data) {
-        msg->data = malloc(size);
+        msg->data = node_alloc(size, node_of(msg));
         if (!msg->data) {
-            free(msg);
+            node_free(msg);
             return NULL;
         }
         memcpy(msg->data, data, size);
@@ -41,9 +48,9 @@ void message_free(ArnmMessage* msg) {
     if (!msg) return;
     
     if (msg->data && msg->size > 0) {
-        free(msg->data);
+        node_free(msg->data);
     }
-    free(msg);
+    node_free(msg);
 }
 
 /* ============================================================
@@ -122,8 +129,11 @@ bool mailbox_send_ex(ArnmMailbox* mbox, uint64_t tag, void* data, size_t size, i
         }
     }
     
-    ArnmMessage* msg = message_create(tag, data, size);
+    /* Allocate on the receiver's node: it is the one that reads the payload */
+    int node = mbox->owner ? mbox->owner->node : -1;
+    ArnmMessage* msg = message_create_on(tag, data, size, node);
     if (!msg) return false;
+    if (trace_stamping()) msg->sent_at = sched_clock_ns();
     
     /* Lock-free enqueue at tail */
     ArnmMessage* prev = atomic_exchange(&mbox->tail, msg);
@@ -131,8 +141,11 @@ bool mailbox_send_ex(ArnmMailbox* mbox, uint64_t tag, void* data, size_t size, i
     
     atomic_fetch_add(&mbox->count, 1);
     
-    /* Wake up waiting process if any */
-    if (mbox->owner && mbox->owner->state == PROC_STATE_WAITING) {
+    sched_note_send(mbox->owner);
+    
+    /* Wake the owner only if it actually parked; a running owner drains us itself */
+    if (mbox->owner && atomic_load(&mbox->owner->parked) &&
+        atomic_load(&mbox->owner->mailbox_wait)) {
         sched_wake(mbox->owner);
     }
     
@@ -162,32 +175,42 @@ ArnmMessage* mailbox_try_receive(ArnmMailbox* mbox) {
     // fprintf(stderr, "[DEBUG] Dequeue next=%p tag=%lu\n", next, next->tag);
     atomic_fetch_sub(&mbox->count, 1);
     
-    /* Free the old dummy node */
-    message_free(head);
-    
-    /* Return message data (next becomes the new dummy) */
-    ArnmMessage* msg = message_create(next->tag, NULL, 0);
-    if (msg) {
-        msg->tag = next->tag;
-        msg->data = next->data;
-        msg->size = next->size;
-        next->data = NULL;  /* Prevent double free */
-        next->size = 0;
-    }
-    
-    return msg;
+    /*
+     * The retired dummy becomes the returned message and next becomes
+     * the new dummy, so a receive costs no allocation.
+     */
+    head->tag = next->tag;
+    head->data = next->data;
+    head->size = next->size;
+    head->sent_at = next->sent_at;
+    head->next = NULL;
+    next->data = NULL;  /* Prevent double free */
+    next->size = 0;
+    
+    return head;
 }
 
 ArnmMessage* mailbox_receive(ArnmMailbox* mbox) {
     if (!mbox) return NULL;
     
+    ArnmProcess* proc = proc_current();
     ArnmMessage* msg;
     
-    /* Spin/yield until message available */
-    while ((msg = mailbox_try_receive(mbox)) == NULL) {
-        /* Mark current process as waiting */
-        ArnmProcess* proc = proc_current();
+    for (;;) {
+        /* Quantum used up: give the worker back but stay runnable */
+        if (proc && proc->reductions == 0) {
+            arnm_sched_yield();
+        }
+        
+        /* Fast path: while messages are queued, no park/wake round trip */
+        msg = mailbox_try_receive(mbox);
+        if (msg) {
+            if (proc) proc->reductions--;
+            return msg;
+        }
+        
         if (proc) {
+            /* Switch out; the worker parks us once our context is saved */
             proc_wait(proc);
             arnm_sched_yield();
         } else {
@@ -195,8 +218,6 @@ ArnmMessage* mailbox_receive(ArnmMailbox* mbox) {
             for (volatile int i = 0; i < 1000; i++) { }
         }
     }
-    
-    return msg;
 }
 
 bool mailbox_empty(ArnmMailbox* mbox) {
@@ -206,3 +227,15 @@ bool mailbox_empty(ArnmMailbox* mbox) {
 size_t mailbox_count(ArnmMailbox* mbox) {
     return mbox ? atomic_load(&mbox->count) : 0;
 }
+
+size_t mailbox_visit(ArnmMailbox* mbox, void (*fn)(const ArnmMessage* msg, void* ctx), void* ctx) {
+    if (!mbox) return 0;
+    
+    size_t n = 0;
+    ArnmMessage* head = atomic_load(&mbox->head);
+    for (ArnmMessage* msg = atomic_load(&head->next); msg; msg = atomic_load(&msg->next)) {
+        fn(msg, ctx);
+        n++;
+    }
+    return n;
+}
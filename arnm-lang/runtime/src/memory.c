@@ -3,8 +3,10 @@
  */
 
 #include "../include/memory.h"
+#include "../include/topology.h"
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include <sys/mman.h>
 
 /* ============================================================
@@ -144,6 +146,119 @@ void pool_free(MemoryPool* pool, void* ptr) {
     pool->allocated--;
 }
 
+/* ============================================================
+ * Node-Local Heap Implementation
+ * ============================================================ */
+
+#define NODE_HEAP_MIN_SHIFT     5                   /* 32-byte smallest class */
+#define NODE_HEAP_CLASSES       8                   /* 32 .. 4096 bytes */
+#define NODE_HEAP_LARGE         0xFFFFu             /* Fallback to malloc */
+#define NODE_HEAP_CHUNK         (256 * 1024)
+
+typedef struct {
+    uint16_t    node;       /* Home node */
+    uint16_t    cls;        /* Size class or NODE_HEAP_LARGE */
+    uint32_t    reserved;
+    uint64_t    pad;        /* Keep payload 16-byte aligned */
+} NodeBlockHeader;
+
+typedef struct NodeHeap {
+    pthread_spinlock_t  lock;
+    PoolBlock*          free_list[NODE_HEAP_CLASSES];
+    char*               bump;           /* Unused tail of current chunk */
+    size_t              bump_left;
+} NodeHeap;
+
+static NodeHeap g_node_heaps[TOPO_MAX_NODES];
+static pthread_once_t g_node_heap_once = PTHREAD_ONCE_INIT;
+
+static void node_heap_init(void) {
+    topo_init();
+    for (uint32_t i = 0; i < TOPO_MAX_NODES; i++) {
+        pthread_spin_init(&g_node_heaps[i].lock, PTHREAD_PROCESS_PRIVATE);
+    }
+}
+
+static inline uint16_t node_heap_class(size_t total) {
+    for (uint16_t cls = 0; cls < NODE_HEAP_CLASSES; cls++) {
+        if (total <= ((size_t)1 << (cls + NODE_HEAP_MIN_SHIFT))) {
+            return cls;
+        }
+    }
+    return NODE_HEAP_LARGE;
+}
+
+void* node_alloc(size_t size, int node) {
+    pthread_once(&g_node_heap_once, node_heap_init);
+    
+    if (node < 0 || (uint32_t)node >= topo_num_nodes()) {
+        node = (int)topo_current_node();
+    }
+    
+    size_t total = size + sizeof(NodeBlockHeader);
+    uint16_t cls = node_heap_class(total);
+    NodeBlockHeader* header;
+    
+    if (cls == NODE_HEAP_LARGE) {
+        header = (NodeBlockHeader*)malloc(total);
+        if (!header) return NULL;
+    } else {
+        NodeHeap* heap = &g_node_heaps[node];
+        size_t block_size = (size_t)1 << (cls + NODE_HEAP_MIN_SHIFT);
+        
+        pthread_spin_lock(&heap->lock);
+        PoolBlock* block = heap->free_list[cls];
+        if (block) {
+            heap->free_list[cls] = block->next;
+        } else {
+            if (heap->bump_left < block_size) {
+                /* Remainder of the old chunk is abandoned; chunks are never unmapped */
+                char* chunk = (char*)topo_alloc_pages(NODE_HEAP_CHUNK, node);
+                if (!chunk) {
+                    pthread_spin_unlock(&heap->lock);
+                    return NULL;
+                }
+                heap->bump = chunk;
+                heap->bump_left = NODE_HEAP_CHUNK;
+            }
+            block = (PoolBlock*)heap->bump;
+            heap->bump += block_size;
+            heap->bump_left -= block_size;
+        }
+        pthread_spin_unlock(&heap->lock);
+        header = (NodeBlockHeader*)block;
+    }
+    
+    header->node = (uint16_t)node;
+    header->cls = cls;
+    return (char*)header + sizeof(NodeBlockHeader);
+}
+
+void node_free(void* ptr) {
+    if (!ptr) return;
+    
+    NodeBlockHeader* header = (NodeBlockHeader*)((char*)ptr - sizeof(NodeBlockHeader));
+    if (header->cls == NODE_HEAP_LARGE) {
+        free(header);
+        return;
+    }
+    
+    NodeHeap* heap = &g_node_heaps[header->node];
+    PoolBlock* block = (PoolBlock*)header;
+    uint16_t cls = header->cls;
+    
+    pthread_spin_lock(&heap->lock);
+    block->next = heap->free_list[cls];
+    heap->free_list[cls] = block;
+    pthread_spin_unlock(&heap->lock);
+}
+
+int node_of(void* ptr) {
+    if (!ptr) return -1;
+    NodeBlockHeader* header = (NodeBlockHeader*)((char*)ptr - sizeof(NodeBlockHeader));
+    return header->node;
+}
+
 /* ============================================================
  * Stack Allocation
  * ============================================================ */
@@ -151,18 +266,18 @@ void pool_free(MemoryPool* pool, void* ptr) {
 #define PAGE_SIZE 4096
 
 void* stack_alloc(size_t size) {
+    return stack_alloc_on(size, -1);
+}
+
+void* stack_alloc_on(size_t size, int node) {
     /* Round up to page size */
     size = (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
     
     /* Add guard page */
     size_t total_size = size + PAGE_SIZE;
     
-    void* mem = mmap(NULL, total_size, 
-                     PROT_READ | PROT_WRITE,
-                     MAP_PRIVATE | MAP_ANONYMOUS,
-                     -1, 0);
-    
-    if (mem == MAP_FAILED) {
+    void* mem = topo_alloc_pages(total_size, node);
+    if (!mem) {
         return NULL;
     }
     
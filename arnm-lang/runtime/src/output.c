@@ -0,0 +1,236 @@
+/*
+ * ARNm Runtime - Buffered Output Implementation
+ */
+
+#include "../include/output.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/* ============================================================
+ * Buffers
+ * ============================================================
+ * Only the owning worker appends, so its lock is uncontended except
+ * while another thread writes the buffer out (migration, shutdown).
+ */
+
+typedef struct {
+    atomic_flag     lock;
+    size_t          used;
+    uint64_t        written;        /* Bytes of this buffer's stream already on stdout */
+    char            data[OUTPUT_BUFFER_SIZE];
+} OutBuffer;
+
+static OutBuffer out_buffers[OUTPUT_BUFFERS];
+static bool out_line_atomic = false;
+static pthread_once_t out_once = PTHREAD_ONCE_INIT;
+
+static inline void buf_lock(OutBuffer* buf) {
+    while (atomic_flag_test_and_set_explicit(&buf->lock, memory_order_acquire)) {
+        /* spin */
+    }
+}
+
+static inline void buf_unlock(OutBuffer* buf) {
+    atomic_flag_clear_explicit(&buf->lock, memory_order_release);
+}
+
+static void write_all(const char* p, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;     /* stdout is gone; nothing sensible to do */
+        p += n;
+        len -= (size_t)n;
+    }
+}
+
+/* Write out buffered bytes; a partial flush stops after the last newline */
+static void flush_locked(OutBuffer* buf, bool partial) {
+    size_t n = buf->used;
+    if (partial && out_line_atomic) {
+        const char* nl = memrchr(buf->data, '\n', buf->used);
+        n = nl ? (size_t)(nl - buf->data) + 1 : 0;
+    }
+    if (n == 0) return;
+
+    write_all(buf->data, n);
+    memmove(buf->data, buf->data + n, buf->used - n);
+    buf->used -= n;
+    buf->written += n;
+}
+
+static void flush_all(void) {
+    for (int i = 0; i < OUTPUT_BUFFERS; i++) {
+        OutBuffer* buf = &out_buffers[i];
+        buf_lock(buf);
+        flush_locked(buf, false);
+        buf_unlock(buf);
+    }
+}
+
+static void output_init(void) {
+    atexit(flush_all);
+}
+
+static void out_append(const char* s, size_t len) {
+    pthread_once(&out_once, output_init);
+
+    ArnmWorker* worker = sched_current_worker();
+    int32_t idx = worker ? (int32_t)worker->id : OUTPUT_BUFFERS - 1;
+    OutBuffer* buf = &out_buffers[idx];
+    ArnmProcess* proc = proc_current();
+
+    /* Our earlier output is still sitting in another worker's buffer */
+    if (proc && proc->out_buffer >= 0 && proc->out_buffer != idx) {
+        OutBuffer* prev = &out_buffers[proc->out_buffer];
+        buf_lock(prev);
+        if (prev->written < proc->out_mark) flush_locked(prev, false);
+        buf_unlock(prev);
+    }
+
+    buf_lock(buf);
+    if (buf->used + len > OUTPUT_BUFFER_SIZE) {
+        flush_locked(buf, true);
+        /* A partial line that still leaves no room has to go out as is */
+        if (buf->used + len > OUTPUT_BUFFER_SIZE) flush_locked(buf, false);
+    }
+    if (len > OUTPUT_BUFFER_SIZE) {
+        write_all(s, len);
+        buf->written += len;
+    } else {
+        memcpy(buf->data + buf->used, s, len);
+        buf->used += len;
+    }
+    if (proc) {
+        proc->out_buffer = idx;
+        proc->out_mark = buf->written + buf->used;
+    }
+    buf_unlock(buf);
+}
+
+/* ============================================================
+ * Formatting
+ * ============================================================ */
+
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+size_t output_format_i64(char* out, int64_t v) {
+    char tmp[20];
+    char* p = tmp + sizeof(tmp);
+    uint64_t u = v < 0 ? 0 - (uint64_t)v : (uint64_t)v;
+
+    /* Two digits per division */
+    while (u >= 100) {
+        unsigned r = (unsigned)(u % 100);
+        u /= 100;
+        p -= 2;
+        memcpy(p, &digit_pairs[r * 2], 2);
+    }
+    if (u >= 10) {
+        p -= 2;
+        memcpy(p, &digit_pairs[u * 2], 2);
+    } else {
+        *--p = (char)('0' + u);
+    }
+
+    size_t n = 0;
+    if (v < 0) out[n++] = '-';
+    size_t digits = (size_t)(tmp + sizeof(tmp) - p);
+    memcpy(out + n, p, digits);
+    return n + digits;
+}
+
+size_t output_format_f64(char* out, double v) {
+    /* Shortest of %.15g..%.17g that reads back exactly */
+    int n = 0;
+    for (int prec = 15; prec <= 17; prec++) {
+        n = snprintf(out, 32, "%.*g", prec, v);
+        if (strtod(out, NULL) == v) break;
+    }
+    return (size_t)n;
+}
+
+/* ============================================================
+ * Runtime Hooks
+ * ============================================================ */
+
+void output_configure(const ArnmConfig* config) {
+    out_line_atomic = config->line_atomic;
+}
+
+void output_flush_worker(uint32_t worker_id) {
+    if (worker_id >= ARNM_MAX_WORKERS) return;
+
+    OutBuffer* buf = &out_buffers[worker_id];
+    buf_lock(buf);
+    flush_locked(buf, false);
+    buf_unlock(buf);
+}
+
+/* ============================================================
+ * Public API
+ * ============================================================ */
+
+void arnm_print_int(int32_t val) {
+    char line[24];
+    size_t n = output_format_i64(line, val);
+    line[n++] = '\n';
+    out_append(line, n);
+}
+
+void arnm_print_i64(int64_t val) {
+    char line[24];
+    size_t n = output_format_i64(line, val);
+    line[n++] = '\n';
+    out_append(line, n);
+}
+
+void arnm_print_f64(double val) {
+    char line[40];
+    size_t n = output_format_f64(line, val);
+    line[n++] = '\n';
+    out_append(line, n);
+}
+
+void arnm_print_str(const char* s, size_t len) {
+    if (len + 1 <= 256) {
+        char line[256];
+        memcpy(line, s, len);
+        line[len] = '\n';
+        out_append(line, len + 1);
+        return;
+    }
+
+    /* Long string: keep it one line in line-atomic mode */
+    char* line = malloc(len + 1);
+    if (!line) return;
+    memcpy(line, s, len);
+    line[len] = '\n';
+    out_append(line, len + 1);
+    free(line);
+}
+
+void arnm_write(const char* s, size_t len) {
+    if (s && len) out_append(s, len);
+}
+
+void arnm_flush(void) {
+    flush_all();
+}
@@ -0,0 +1,191 @@
+/*
+ * ARNm Runtime - Fork-Join Data Parallelism Implementation
+ */
+
+#include "../include/parallel.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ============================================================
+ * Job List
+ * ============================================================ */
+
+_Atomic uint32_t g_parallel_jobs;
+
+static ParallelJob* job_list;
+static atomic_flag job_lock = ATOMIC_FLAG_INIT;
+
+static void job_lock_acquire(void) {
+    while (atomic_flag_test_and_set_explicit(&job_lock, memory_order_acquire)) {
+        /* spin */
+    }
+}
+
+static void job_lock_release(void) {
+    atomic_flag_clear_explicit(&job_lock, memory_order_release);
+}
+
+/* Caller holds job_lock */
+static bool job_finished(ParallelJob* job) {
+    return atomic_load(&job->done) == job->chunks && job->helpers == 0;
+}
+
+/* ============================================================
+ * Chunks
+ * ============================================================ */
+
+static void run_chunks(ParallelJob* job) {
+    for (;;) {
+        uint32_t idx = atomic_fetch_add(&job->next, 1);
+        if (idx >= job->chunks) return;
+        
+        int64_t lo = job->begin + (int64_t)idx * job->chunk;
+        int64_t hi = lo + job->chunk < job->end ? lo + job->chunk : job->end;
+        if (job->reduce) {
+            job->partials[idx] = job->reduce(lo, hi, job->ctx);
+        } else {
+            job->body(lo, hi, job->ctx);
+        }
+        atomic_fetch_add(&job->done, 1);
+    }
+}
+
+void parallel_help(void) {
+    job_lock_acquire();
+    ParallelJob* job = job_list;
+    while (job && atomic_load(&job->next) >= job->chunks) {
+        job = job->next_job;
+    }
+    if (!job) {
+        job_lock_release();
+        return;
+    }
+    job->helpers++;
+    job_lock_release();
+    
+    run_chunks(job);
+    
+    /* Notify under the lock: the caller cannot return (and its job go away) before we are out */
+    job_lock_acquire();
+    job->helpers--;
+    if (job->waiter && job_finished(job)) {
+        sched_notify(job->waiter);
+    }
+    job_lock_release();
+}
+
+/* ============================================================
+ * Fork-Join
+ * ============================================================ */
+
+static void job_init(ParallelJob* job, int64_t begin, int64_t end, void* ctx) {
+    int64_t n = end - begin;
+    Scheduler* sched = sched_global();
+    uint32_t workers = sched && sched->num_workers ? sched->num_workers : 1;
+    int64_t chunks = (int64_t)workers * PARALLEL_CHUNKS_PER_WORKER;
+    if (chunks > n) chunks = n;
+    
+    job->body = NULL;
+    job->reduce = NULL;
+    job->ctx = ctx;
+    job->begin = begin;
+    job->end = end;
+    job->chunk = (n + chunks - 1) / chunks;
+    job->chunks = (uint32_t)((n + job->chunk - 1) / job->chunk);
+    job->partials = NULL;
+    atomic_init(&job->next, 0);
+    atomic_init(&job->done, 0);
+    job->helpers = 0;
+    job->waiter = proc_current();
+    job->next_job = NULL;
+}
+
+static void job_run(ParallelJob* job) {
+    /* Nothing to share it with: run it all here */
+    if (job->chunks == 1 || !sched_is_running()) {
+        run_chunks(job);
+        return;
+    }
+    
+    /* Keep workers up while a parked caller waits on chunks */
+    sched_hold();
+    job_lock_acquire();
+    job->next_job = job_list;
+    job_list = job;
+    job_lock_release();
+    atomic_fetch_add(&g_parallel_jobs, 1);
+    
+    run_chunks(job);
+    
+    /* No chunk left to claim: unlist it so no new helper arrives */
+    job_lock_acquire();
+    ParallelJob** link = &job_list;
+    while (*link != job) link = &(*link)->next_job;
+    *link = job->next_job;
+    job_lock_release();
+    atomic_fetch_sub(&g_parallel_jobs, 1);
+    
+    /* Join: wait for chunks still running on other workers */
+    ArnmProcess* self = job->waiter;
+    if (self) atomic_store(&self->mailbox_wait, false);
+    for (;;) {
+        if (self) atomic_store(&self->notified, false);
+        job_lock_acquire();
+        bool finished = job_finished(job);
+        job_lock_release();
+        if (finished) break;
+        
+        if (self) {
+            proc_wait(self);
+            arnm_sched_yield();
+        }
+    }
+    if (self) {
+        atomic_store(&self->notified, false);
+        atomic_store(&self->mailbox_wait, true);
+    }
+    sched_release();
+}
+
+void arnm_parallel_for(int64_t begin, int64_t end, ArnmForBody body, void* ctx) {
+    if (!body || end <= begin) return;
+    
+    ParallelJob job;
+    job_init(&job, begin, end, ctx);
+    job.body = body;
+    job_run(&job);
+}
+
+int64_t arnm_parallel_reduce(int64_t begin, int64_t end, int64_t identity,
+                             ArnmReduceBody body, ArnmCombine combine, void* ctx) {
+    if (!body || !combine || end <= begin) return identity;
+    
+    int64_t partials[PARALLEL_MAX_CHUNKS];
+    ParallelJob job;
+    job_init(&job, begin, end, ctx);
+    job.reduce = body;
+    job.partials = partials;
+    job_run(&job);
+    
+    int64_t acc = identity;
+    for (uint32_t i = 0; i < job.chunks; i++) {
+        acc = combine(acc, partials[i]);
+    }
+    return acc;
+}
+
+static int64_t combine_add(int64_t a, int64_t b) { return a + b; }
+static int64_t combine_mul(int64_t a, int64_t b) { return a * b; }
+
+int64_t arnm_parallel_reduce_op(int64_t begin, int64_t end, ArnmReduceBody body,
+                                void* ctx, int64_t op) {
+    switch (op) {
+        case ARNM_REDUCE_ADD: return arnm_parallel_reduce(begin, end, 0, body, combine_add, ctx);
+        case ARNM_REDUCE_MUL: return arnm_parallel_reduce(begin, end, 1, body, combine_mul, ctx);
+        default:
+            fprintf(stderr, "[ARNM PANIC] Unknown parallel reduce operator %ld\n", (long)op);
+            abort();
+    }
+}
@@ -6,10 +6,12 @@
 #include "../include/mailbox.h"
 #include "../include/memory.h"
 #include "../include/scheduler.h"
+#include "../include/trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdatomic.h>
+#include <sys/mman.h>
 
 /* ============================================================
  * Process ID Counter
@@ -21,6 +23,179 @@ uint64_t proc_next_pid(void) {
     return atomic_fetch_add(&next_pid, 1);
 }
 
+/* ============================================================
+ * Process Registry
+ * ============================================================ */
+
+#define PROC_TABLE_SHARDS   64
+#define PROC_TABLE_BUCKETS  256
+
+typedef struct {
+    atomic_flag     lock;
+    ArnmProcess*    buckets[PROC_TABLE_BUCKETS];
+} ProcShard;
+
+static ProcShard proc_table[PROC_TABLE_SHARDS];
+
+/* Consecutive pids land in different shards */
+static inline ProcShard* proc_shard(uint64_t pid) {
+    return &proc_table[pid % PROC_TABLE_SHARDS];
+}
+
+static inline ArnmProcess** proc_bucket(ProcShard* shard, uint64_t pid) {
+    return &shard->buckets[(pid / PROC_TABLE_SHARDS) % PROC_TABLE_BUCKETS];
+}
+
+static inline void shard_lock(ProcShard* shard) {
+    while (atomic_flag_test_and_set_explicit(&shard->lock, memory_order_acquire)) {
+        /* spin */
+    }
+}
+
+static inline void shard_unlock(ProcShard* shard) {
+    atomic_flag_clear_explicit(&shard->lock, memory_order_release);
+}
+
+void proc_table_insert(ArnmProcess* proc) {
+    ProcShard* shard = proc_shard(proc->pid);
+    ArnmProcess** bucket = proc_bucket(shard, proc->pid);
+
+    shard_lock(shard);
+    proc->table_next = *bucket;
+    *bucket = proc;
+    shard_unlock(shard);
+}
+
+void proc_table_remove(ArnmProcess* proc) {
+    ProcShard* shard = proc_shard(proc->pid);
+
+    shard_lock(shard);
+    for (ArnmProcess** link = proc_bucket(shard, proc->pid); *link; link = &(*link)->table_next) {
+        if (*link == proc) {
+            *link = proc->table_next;
+            break;
+        }
+    }
+    shard_unlock(shard);
+}
+
+bool proc_send_pid(uint64_t pid, uint64_t tag, void* data, size_t size) {
+    ProcShard* shard = proc_shard(pid);
+    bool sent = false;
+
+    /* Hold the shard across the send so the process can't be freed under us */
+    shard_lock(shard);
+    for (ArnmProcess* p = *proc_bucket(shard, pid); p; p = p->table_next) {
+        if (p->pid == pid) {
+            sent = p->state != PROC_STATE_DEAD && mailbox_send(p->mailbox, tag, data, size);
+            if (sent) trace_send(pid, tag, data, size);
+            break;
+        }
+    }
+    shard_unlock(shard);
+
+    return sent;
+}
+
+void proc_table_foreach(void (*fn)(ArnmProcess* proc, void* ctx), void* ctx) {
+    for (int i = 0; i < PROC_TABLE_SHARDS; i++) {
+        ProcShard* shard = &proc_table[i];
+        shard_lock(shard);
+        for (int b = 0; b < PROC_TABLE_BUCKETS; b++) {
+            for (ArnmProcess* p = shard->buckets[b]; p; p = p->table_next) {
+                fn(p, ctx);
+            }
+        }
+        shard_unlock(shard);
+    }
+}
+
+/* ============================================================
+ * Exit Watchers
+ * ============================================================ */
+
+/* Registered process with this pid, dead or not; caller holds its shard */
+static ArnmProcess* shard_find(ProcShard* shard, uint64_t pid) {
+    for (ArnmProcess* p = *proc_bucket(shard, pid); p; p = p->table_next) {
+        if (p->pid == pid) return p;
+    }
+    return NULL;
+}
+
+bool proc_watch(uint64_t pid, ArnmWatcher* watcher) {
+    ProcShard* shard = proc_shard(pid);
+
+    shard_lock(shard);
+    ArnmProcess* p = shard_find(shard, pid);
+    bool live = p && p->state != PROC_STATE_DEAD;
+    if (live) {
+        watcher->listed = true;
+        watcher->next = p->watchers;
+        p->watchers = watcher;
+    }
+    shard_unlock(shard);
+    return live;
+}
+
+bool proc_unwatch(uint64_t pid, ArnmWatcher* watcher) {
+    ProcShard* shard = proc_shard(pid);
+
+    shard_lock(shard);
+    bool listed = watcher->listed;
+    if (listed) {
+        /* Still listed means the exit hasn't detached the list yet */
+        ArnmProcess* p = shard_find(shard, pid);
+        for (ArnmWatcher** link = p ? &p->watchers : NULL; link && *link; link = &(*link)->next) {
+            if (*link == watcher) {
+                *link = watcher->next;
+                break;
+            }
+        }
+        watcher->listed = false;
+    }
+    shard_unlock(shard);
+    return listed;
+}
+
+int proc_monitor(uint64_t pid, uint64_t watcher_pid) {
+    ArnmWatcher* watcher = malloc(sizeof(ArnmWatcher));
+    if (!watcher) return -1;
+    watcher->joiner = NULL;
+    watcher->pid = watcher_pid;
+
+    if (!proc_watch(pid, watcher)) {
+        free(watcher);
+        return 1;
+    }
+    return 0;
+}
+
+void proc_demonitor(uint64_t pid, uint64_t watcher_pid) {
+    ProcShard* shard = proc_shard(pid);
+    ArnmWatcher* dropped = NULL;
+
+    shard_lock(shard);
+    ArnmProcess* p = shard_find(shard, pid);
+    ArnmWatcher** link = p ? &p->watchers : NULL;
+    while (link && *link) {
+        ArnmWatcher* w = *link;
+        if (!w->joiner && w->pid == watcher_pid) {
+            *link = w->next;
+            w->next = dropped;
+            dropped = w;
+        } else {
+            link = &w->next;
+        }
+    }
+    shard_unlock(shard);
+
+    while (dropped) {
+        ArnmWatcher* next = dropped->next;
+        free(dropped);
+        dropped = next;
+    }
+}
+
 /* ============================================================
  * Thread-Local Current Process
  * ============================================================ */
@@ -40,20 +215,27 @@ void proc_set_current(ArnmProcess* proc) {
  * ============================================================ */
 
 ArnmProcess* proc_create(void (*entry)(void*), void* arg, size_t stack_size, size_t state_size) {
-    ArnmProcess* proc = (ArnmProcess*)malloc(sizeof(ArnmProcess));
+    return proc_create_on(entry, arg, stack_size, state_size, -1);
+}
+
+ArnmProcess* proc_create_on(void (*entry)(void*), void* arg, size_t stack_size,
+                            size_t state_size, int node) {
+    ArnmProcess* proc = (ArnmProcess*)node_alloc(sizeof(ArnmProcess), node);
     if (!proc) return NULL;
     
     memset(proc, 0, sizeof(ArnmProcess));
+    proc->node = node_of(proc);
     
     /* Allocate actor state if requested */
     if (state_size > 0) {
-        proc->actor_state = malloc(state_size);
+        proc->actor_state = node_alloc(state_size, proc->node);
         if (!proc->actor_state) {
-            free(proc);
+            node_free(proc);
             return NULL;
         }
         memset(proc->actor_state, 0, state_size);
     }
+    proc->state_size = state_size;
     
     /* Assign PID */
     proc->pid = proc_next_pid();
@@ -61,9 +243,10 @@ ArnmProcess* proc_create(void (*entry)(void*), void* arg, size_t stack_size, siz
     
     /* Allocate stack */
     proc->stack_size = stack_size;
-    proc->stack_base = stack_alloc(stack_size);
+    proc->stack_base = stack_alloc_on(stack_size, proc->node);
     if (!proc->stack_base) {
-        free(proc);
+        node_free(proc->actor_state);
+        node_free(proc);
         return NULL;
     }
     
@@ -77,36 +260,66 @@ ArnmProcess* proc_create(void (*entry)(void*), void* arg, size_t stack_size, siz
     proc->mailbox = mailbox_create();
     if (!proc->mailbox) {
         stack_free(proc->stack_base, proc->stack_size);
-        free(proc);
+        node_free(proc->actor_state);
+        node_free(proc);
         return NULL;
     }
     mailbox_set_owner(proc->mailbox, proc);
     
     /* Scheduling state */
     proc->next = NULL;
+    atomic_init(&proc->parked, false);
+    atomic_init(&proc->notified, false);
+    atomic_init(&proc->mailbox_wait, true);
+    proc->reductions = 0;
+    proc->restart_entry = NULL;
+    atomic_init(&proc->idle_worker, -1);
+    proc->hibernation = PROC_AWAKE;
     proc->worker_id = 0;
-    proc->spawn_time = 0;  /* TODO: get current time */
+    atomic_init(&proc->affinity, 0);
+    proc->migrate_run = 0;
+    proc->priority = ARNM_PRIO_NORMAL;
+    proc->deadline = 0;
+    proc->spawn_time = sched_clock_ns();
     proc->run_count = 0;
     
+    proc->out_buffer = -1;
+    proc->watchers = NULL;
+    atomic_init(&proc->shell_refs, 1);
+    proc->dist_node = 0;
+    proc_table_insert(proc);
+    
     return proc;
 }
 
 void proc_destroy(ArnmProcess* proc) {
     if (!proc) return;
     
+    proc_table_remove(proc);
+    
     if (proc->mailbox) {
         mailbox_destroy(proc->mailbox);
+        proc->mailbox = NULL;
     }
     
     if (proc->actor_state) {
-        free(proc->actor_state);
+        node_free(proc->actor_state);
+        proc->actor_state = NULL;
     }
     
     if (proc->stack_base) {
         stack_free(proc->stack_base, proc->stack_size);
+        proc->stack_base = NULL;
     }
     
-    free(proc);
+    /* An unjoined joinable handle keeps the shell (pid, state) readable */
+    proc_release_shell(proc);
+}
+
+void proc_release_shell(ArnmProcess* proc) {
+    if (atomic_fetch_sub(&proc->shell_refs, 1) == 1) {
+        node_free(proc);
+    }
 }
 
 void proc_ready(ArnmProcess* proc) {
@@ -122,15 +335,84 @@ void proc_wait(ArnmProcess* proc) {
 }
 
 void proc_exit(ArnmProcess* proc) {
-    if (proc) {
-        proc->state = PROC_STATE_DEAD;
+    if (!proc) return;
+    proc->state = PROC_STATE_DEAD;
+    
+    /* Hand off every watcher in one pass; nobody can list after this */
+    ProcShard* shard = proc_shard(proc->pid);
+    ArnmWatcher* downs = NULL;
+    
+    shard_lock(shard);
+    ArnmWatcher* w = proc->watchers;
+    proc->watchers = NULL;
+    while (w) {
+        ArnmWatcher* next = w->next;
+        w->listed = false;
+        if (w->joiner) {
+            /* Under the shard: the joiner can't return (and drop w) before this */
+            sched_notify(w->joiner);
+        } else {
+            w->next = downs;
+            downs = w;
+        }
+        w = next;
+    }
+    shard_unlock(shard);
+    
+    /* DOWN sends take the monitors' shards; do them unlocked */
+    uint64_t pid = proc->pid;
+    while (downs) {
+        ArnmWatcher* next = downs->next;
+        proc_send_pid(downs->pid, ARNM_TAG_DOWN, &pid, sizeof(pid));
+        free(downs);
+        downs = next;
     }
 }
 
 /* ============================================================
- * Exit Handler (called from assembly)
+ * Hibernation
  * ============================================================ */
 
+#define PROC_PAGE_SIZE 4096
+
+void proc_hibernate(ArnmProcess* proc) {
+    if (!proc || !proc->stack_base || proc->hibernation != PROC_AWAKE) return;
+    
+    if (proc->restart_entry) {
+        /* Parked at the loop head: all live state is in actor_state */
+        stack_free(proc->stack_base, proc->stack_size);
+        proc->stack_base = NULL;
+        proc->hibernation = PROC_STACK_FREED;
+        return;
+    }
+    
+    /* Everything below the saved stack pointer (minus red zone) is dead */
+    uintptr_t base = (uintptr_t)proc->stack_base;
+    uintptr_t sp = (uintptr_t)ARNM_CONTEXT_SP(&proc->context) - ARNM_RED_ZONE;
+    uintptr_t limit = sp & ~(uintptr_t)(PROC_PAGE_SIZE - 1);
+    
+    if (limit > base) {
+        madvise((void*)base, limit - base, MADV_DONTNEED);
+    }
+    proc->hibernation = PROC_TRIMMED;
+}
+
+bool proc_thaw(ArnmProcess* proc) {
+    if (!proc) return false;
+    
+    if (proc->hibernation == PROC_STACK_FREED) {
+        proc->stack_base = stack_alloc_on(proc->stack_size, proc->node);
+        if (!proc->stack_base) return false;
+        
+        void* stack_top = (char*)proc->stack_base + proc->stack_size;
+        arnm_context_init(&proc->context, stack_top, proc->restart_entry, NULL);
+    }
+    
+    /* Trimmed pages fault back in zero-filled on demand */
+    proc->hibernation = PROC_AWAKE;
+    return true;
+}
+
 /* ============================================================
  * Exit Handler (called from assembly)
  * ============================================================ */
@@ -148,8 +430,3 @@ void arnm_process_exit_handler(void) {
     while (1) { }
 }
 
-/* ============================================================ */
-
-void arnm_print_int(int32_t val) {
-    printf("%d\n", val);
-}
@@ -7,22 +7,92 @@
 #include "../include/scheduler.h"
 #include "../include/mailbox.h"
 #include "../include/memory.h"
+#include "../include/dist.h"
+#include "../include/trace.h"
+#include "../include/output.h"
+#include "../include/log.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+/* ============================================================
+ * Runtime Configuration
+ * ============================================================ */
+
+static bool env_flag(const char* name) {
+    const char* v = getenv(name);
+    return v && *v && strcmp(v, "0") != 0;
+}
+
+void arnm_config_default(ArnmConfig* config) {
+    if (!config) return;
+    
+    memset(config, 0, sizeof(*config));
+    
+    const char* workers = getenv("ARNM_WORKERS");
+    config->num_workers = workers ? atoi(workers) : 0;
+    config->pin_workers = env_flag("ARNM_PIN_WORKERS");
+    
+    const char* batch = getenv("ARNM_BATCH");
+    config->max_batch = batch ? atoi(batch) : ARNM_DEFAULT_BATCH;
+    
+    const char* hibernate = getenv("ARNM_HIBERNATE_MS");
+    config->hibernate_ms = hibernate ? atoi(hibernate) : ARNM_DEFAULT_HIBERNATE_MS;
+    
+    const char* trace = getenv("ARNM_TRACE");
+    config->trace_path = trace && *trace ? trace : NULL;
+    config->line_atomic = env_flag("ARNM_LINE_ATOMIC");
+    
+    static const char* const levels[] = { "debug", "info", "warn", "error", "off" };
+    const char* level = getenv("ARNM_LOG_LEVEL");
+    config->log_level = ARNM_LOG_INFO;
+    for (int i = 0; level && i <= ARNM_LOG_OFF; i++) {
+        if (strcmp(level, levels[i]) == 0) config->log_level = i;
+    }
+    
+    const char* log = getenv("ARNM_LOG");
+    config->log_path = log && *log ? log : NULL;
+}
 
 /* ============================================================
  * Runtime Lifecycle
  * ============================================================ */
 
 int arnm_init(int num_workers) {
-    return sched_init(num_workers > 0 ? num_workers : 0);
+    ArnmConfig config;
+    arnm_config_default(&config);
+    if (num_workers > 0) {
+        config.num_workers = num_workers;
+    }
+    return arnm_init_ex(&config);
+}
+
+int arnm_init_ex(const ArnmConfig* config) {
+    ArnmConfig defaults;
+    if (!config) {
+        arnm_config_default(&defaults);
+        config = &defaults;
+    }
+    if (sched_init(config) != 0) return -1;
+    output_configure(config);
+    log_configure(config);
+    
+    if (config->trace_path && arnm_trace_start(config->trace_path) != 0) {
+        fprintf(stderr, "[ARNM WARNING] Could not open trace file %s\n", config->trace_path);
+    }
+    return 0;
 }
 
 void arnm_shutdown(void) {
+    arnm_trace_stop();
     sched_shutdown();
+    arnm_flush();
+    arnm_log_close();
 }
 
 void arnm_run(void) {
+    /* Output printed before the workers start comes out first */
+    arnm_flush();
     sched_run();
 }
 
@@ -30,14 +100,54 @@ void arnm_run(void) {
  * Process API
  * ============================================================ */
 
+void arnm_spawn_options_default(ArnmSpawnOptions* options) {
+    if (!options) return;
+    memset(options, 0, sizeof(*options));
+    options->priority = ARNM_PRIO_NORMAL;
+}
+
 ArnmProcess* arnm_spawn(void (*entry)(void*), void* arg, size_t state_size) {
-    ArnmProcess* proc = proc_create(entry, arg, ARNM_DEFAULT_STACK_SIZE, state_size);
+    return arnm_spawn_ex(entry, arg, state_size, NULL);
+}
+
+ArnmProcess* arnm_spawn_ex(void (*entry)(void*), void* arg, size_t state_size,
+                           const ArnmSpawnOptions* options) {
+    ArnmSpawnOptions defaults;
+    if (!options) {
+        arnm_spawn_options_default(&defaults);
+        options = &defaults;
+    }
+    
+    /* Allocate on the target worker's node (the spawner's, by default) */
+    int target = sched_place(options->placement, options->worker);
+    int node = target >= 0 ? sched_global()->workers[target].node : -1;
+    
+    ArnmProcess* proc = proc_create_on(entry, arg, ARNM_DEFAULT_STACK_SIZE, state_size, node);
     if (proc) {
-        sched_enqueue(proc);
+        proc->priority = options->priority < ARNM_PRIO_COUNT ? options->priority : ARNM_PRIO_NORMAL;
+        if (options->joinable) {
+            atomic_store(&proc->shell_refs, 2);
+        }
+        if (options->deadline_ns) {
+            proc->deadline = sched_clock_ns() + options->deadline_ns;
+        }
+        trace_spawn(proc->pid);
+        if (target >= 0) {
+            sched_enqueue_local(proc, (uint32_t)target);
+        } else {
+            sched_enqueue(proc);
+        }
     }
     return proc;
 }
 
+void arnm_set_deadline(uint64_t deadline_ns) {
+    ArnmProcess* proc = proc_current();
+    if (proc) {
+        proc->deadline = deadline_ns ? sched_clock_ns() + deadline_ns : 0;
+    }
+}
+
 ArnmProcess* arnm_self(void) {
     return proc_current();
 }
@@ -46,6 +156,10 @@ uint64_t arnm_pid(ArnmProcess* proc) {
     return proc ? proc->pid : 0;
 }
 
+void* arnm_actor_state(ArnmProcess* proc) {
+    return proc ? proc->actor_state : NULL;
+}
+
 void arnm_yield(void) {
     arnm_sched_yield();
 }
@@ -58,26 +172,109 @@ void arnm_exit(void) {
     }
 }
 
+/* ============================================================
+ * Monitors and Join
+ * ============================================================ */
+
+int arnm_monitor(uint64_t pid) {
+    ArnmProcess* self = proc_current();
+    if (!self) return -1;
+
+    int listed = proc_monitor(pid, self->pid);
+    if (listed < 0) {
+        fprintf(stderr, "[ARNM PANIC] Out of memory adding a monitor\n");
+        abort();
+    }
+    if (listed == 1) {
+        mailbox_send(self->mailbox, ARNM_TAG_DOWN, &pid, sizeof(pid));
+    }
+    return 0;
+}
+
+void arnm_demonitor(uint64_t pid) {
+    ArnmProcess* self = proc_current();
+    if (self) proc_demonitor(pid, self->pid);
+}
+
+int arnm_join(uint64_t pid) {
+    ArnmProcess* self = proc_current();
+    if (!self) return -1;
+    if (pid == self->pid) return 0;
+
+    ArnmWatcher watcher = { .joiner = self };
+
+    /* Only the exit's notify may end the park; messages wait their turn */
+    atomic_store(&self->notified, false);
+    atomic_store(&self->mailbox_wait, false);
+    if (proc_watch(pid, &watcher)) {
+        for (;;) {
+            proc_wait(self);
+            arnm_sched_yield();
+            if (!proc_unwatch(pid, &watcher)) break;   /* Unlisted by the exit */
+
+            /* Woken by something else: list again unless it exited meanwhile */
+            atomic_store(&self->notified, false);
+            if (!proc_watch(pid, &watcher)) break;
+        }
+    }
+    atomic_store(&self->mailbox_wait, true);
+    atomic_store(&self->notified, false);
+    return 0;
+}
+
+ArnmProcess* arnm_spawn_joinable(void (*entry)(void*), void* arg, size_t state_size) {
+    ArnmSpawnOptions opts;
+    arnm_spawn_options_default(&opts);
+    opts.joinable = true;
+    return arnm_spawn_ex(entry, arg, state_size, &opts);
+}
+
+int arnm_join_proc(ArnmProcess* proc) {
+    if (!proc) return 0;
+    if (arnm_join(proc->pid) < 0) return -1;
+    proc_release_shell(proc);
+    return 0;
+}
+
 /* ============================================================
  * Message Passing API
  * ============================================================ */
 
 int arnm_send(ArnmProcess* target, uint64_t tag, void* data, size_t size) {
-    if (!target || !target->mailbox) return -1;
-    return mailbox_send(target->mailbox, tag, data, size) ? 0 : -1;
+    if (!target) return -1;
+    if (target->dist_node) return dist_send(target, tag, data, size);
+    if (!target->mailbox) return -1;
+    if (!mailbox_send(target->mailbox, tag, data, size)) return -1;
+    trace_send(target->pid, tag, data, size);
+    return 0;
 }
 
 ArnmMessage* arnm_receive(void) {
     ArnmProcess* proc = proc_current();
     if (!proc) return NULL;
     if (!proc->mailbox) return NULL;
-    return mailbox_receive(proc->mailbox);
+    ArnmMessage* msg = mailbox_receive(proc->mailbox);
+    trace_recv(msg);
+    return msg;
+}
+
+ArnmMessage* arnm_receive_idle(void (*restart)(void*)) {
+    ArnmProcess* proc = proc_current();
+    if (!proc || !proc->mailbox) return NULL;
+    
+    proc->restart_entry = restart;
+    ArnmMessage* msg = mailbox_receive(proc->mailbox);
+    proc->restart_entry = NULL;
+    trace_recv(msg);
+    return msg;
 }
 
 ArnmMessage* arnm_try_receive(void) {
     ArnmProcess* proc = proc_current();
     if (!proc || !proc->mailbox) return NULL;
-    return mailbox_try_receive(proc->mailbox);
+    ArnmMessage* msg = mailbox_try_receive(proc->mailbox);
+    trace_recv(msg);
+    return msg;
 }
 
 void arnm_message_free(ArnmMessage* msg) {
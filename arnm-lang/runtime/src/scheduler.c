@@ -5,11 +5,16 @@
 #include "../include/scheduler.h"
 #include "../include/process.h"
 #include "../include/memory.h"
+#include "../include/mailbox.h"
+#include "../include/topology.h"
+#include "../include/output.h"
+#include "../include/parallel.h"
 #include "../include/arnm.h"
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <time.h>
 #include <assert.h>
 
 /* ============================================================
@@ -27,6 +32,18 @@
     RUNTIME_ASSERT((proc)->state >= PROC_STATE_READY && (proc)->state <= PROC_STATE_DEAD, \
                    "process has invalid state")
 
+/* Picks between forced polls of the global queue (prime, as in Go) */
+#define SCHED_GLOBAL_POLL 61
+
+/* Communication-aware placement */
+#define SCHED_EDGE_SAMPLE       16      /* Sample one send in N per worker (power of 2) */
+#define SCHED_AFFINITY_MAX      64      /* Vote saturation */
+#define SCHED_MIGRATE_THRESHOLD 8       /* Votes needed before moving a process */
+#define SCHED_MIGRATE_COOLDOWN  16      /* Quanta a process stays put after moving */
+
+/* Picks between hibernation scans on a busy worker (power of 2) */
+#define SCHED_HIBERNATE_SCAN    1024
+
 /* ============================================================
  * Global Scheduler State
  * ============================================================ */
@@ -98,95 +115,131 @@ static size_t runqueue_count(RunQueue* rq) {
     return atomic_load(&rq->count);
 }
 
+/* Insert ordered by deadline (EDF); processes without one go last */
+static void runqueue_push_edf(RunQueue* rq, ArnmProcess* proc) {
+    pthread_spin_lock(&rq->lock);
+    
+    ArnmProcess* prev = NULL;
+    ArnmProcess* cur = rq->head;
+    while (cur && cur->deadline != 0 && cur->deadline <= proc->deadline) {
+        prev = cur;
+        cur = cur->next;
+    }
+    
+    proc->next = cur;
+    if (prev) {
+        prev->next = proc;
+    } else {
+        rq->head = proc;
+    }
+    if (!cur) {
+        rq->tail = proc;
+    }
+    atomic_fetch_add(&rq->count, 1);
+    
+    pthread_spin_unlock(&rq->lock);
+}
+
 /* ============================================================
- * Wait Queue Operations (for parked processes)
+ * Priority Queues
  * ============================================================ */
 
-static void waitqueue_init(WaitQueue* wq) {
-    wq->head = NULL;
-    wq->tail = NULL;
-    atomic_init(&wq->count, 0);
-    pthread_spin_init(&wq->lock, PTHREAD_PROCESS_PRIVATE);
+static void prio_init(RunQueue* queues) {
+    for (int c = 0; c < ARNM_PRIO_COUNT; c++) {
+        runqueue_init(&queues[c]);
+    }
 }
 
-static void waitqueue_destroy(WaitQueue* wq) {
-    pthread_spin_destroy(&wq->lock);
+static void prio_destroy(RunQueue* queues) {
+    for (int c = 0; c < ARNM_PRIO_COUNT; c++) {
+        runqueue_destroy(&queues[c]);
+    }
 }
 
-static void waitqueue_push(WaitQueue* wq, ArnmProcess* proc) {
-    pthread_spin_lock(&wq->lock);
+static void prio_push(RunQueue* queues, ArnmProcess* proc) {
+    uint8_t cls = proc->priority < ARNM_PRIO_COUNT ? proc->priority : ARNM_PRIO_NORMAL;
     
-    proc->next = NULL;
-    if (wq->tail) {
-        wq->tail->next = proc;
+    if (cls == ARNM_PRIO_HIGH && proc->deadline != 0) {
+        runqueue_push_edf(&queues[cls], proc);
     } else {
-        wq->head = proc;
+        runqueue_push(&queues[cls], proc);
     }
-    wq->tail = proc;
-    atomic_fetch_add(&wq->count, 1);
-    
-    pthread_spin_unlock(&wq->lock);
 }
 
-static ArnmProcess* waitqueue_pop(WaitQueue* wq) {
-    pthread_spin_lock(&wq->lock);
-    
-    ArnmProcess* proc = wq->head;
-    if (proc) {
-        wq->head = proc->next;
-        if (!wq->head) {
-            wq->tail = NULL;
-        }
-        proc->next = NULL;
-        atomic_fetch_sub(&wq->count, 1);
+static size_t prio_count(RunQueue* queues) {
+    size_t total = 0;
+    for (int c = 0; c < ARNM_PRIO_COUNT; c++) {
+        total += runqueue_count(&queues[c]);
     }
-    
-    pthread_spin_unlock(&wq->lock);
-    return proc;
+    return total;
+}
+
+static bool class_ready(ArnmWorker* worker, int cls) {
+    return runqueue_count(&worker->local_queues[cls]) > 0 ||
+           runqueue_count(&g_scheduler.global_queues[cls]) > 0;
+}
+
+/* ============================================================
+ * Idle List Operations
+ * ============================================================ */
+
+static void idle_init(IdleList* list) {
+    list->head = NULL;
+    list->tail = NULL;
+    pthread_spin_init(&list->lock, PTHREAD_PROCESS_PRIVATE);
 }
 
-static ArnmProcess* waitqueue_remove(WaitQueue* wq, ArnmProcess* target) {
-    pthread_spin_lock(&wq->lock);
+static void idle_push(ArnmWorker* worker, ArnmProcess* proc) {
+    IdleList* list = &worker->idle;
+    pthread_spin_lock(&list->lock);
     
-    ArnmProcess* prev = NULL;
-    ArnmProcess* proc = wq->head;
-    
-    while (proc) {
-        if (proc == target) {
-            if (prev) {
-                prev->next = proc->next;
-            } else {
-                wq->head = proc->next;
-            }
-            if (wq->tail == proc) {
-                wq->tail = prev;
-            }
-            proc->next = NULL;
-            atomic_fetch_sub(&wq->count, 1);
-            pthread_spin_unlock(&wq->lock);
-            return proc;
-        }
-        prev = proc;
-        proc = proc->next;
+    proc->idle_next = NULL;
+    proc->idle_prev = list->tail;
+    if (list->tail) {
+        list->tail->idle_next = proc;
+    } else {
+        list->head = proc;
     }
+    list->tail = proc;
+    atomic_store(&proc->idle_worker, (int32_t)worker->id);
     
-    pthread_spin_unlock(&wq->lock);
-    return NULL;
+    pthread_spin_unlock(&list->lock);
 }
 
-static size_t waitqueue_count(WaitQueue* wq) {
-    return atomic_load(&wq->count);
+static void idle_unlink(IdleList* list, ArnmProcess* proc) {
+    if (proc->idle_prev) {
+        proc->idle_prev->idle_next = proc->idle_next;
+    } else {
+        list->head = proc->idle_next;
+    }
+    if (proc->idle_next) {
+        proc->idle_next->idle_prev = proc->idle_prev;
+    } else {
+        list->tail = proc->idle_prev;
+    }
+    proc->idle_next = NULL;
+    proc->idle_prev = NULL;
+    atomic_store(&proc->idle_worker, -1);
+}
+
+static void idle_remove(ArnmProcess* proc) {
+    int32_t owner = atomic_load(&proc->idle_worker);
+    if (owner < 0) return;
+    
+    IdleList* list = &g_scheduler.workers[owner].idle;
+    pthread_spin_lock(&list->lock);
+    /* The hibernation scan may have taken it off meanwhile */
+    if (atomic_load(&proc->idle_worker) == owner) {
+        idle_unlink(list, proc);
+    }
+    pthread_spin_unlock(&list->lock);
 }
 
 /* ============================================================
  * Work Stealing
  * ============================================================ */
 
-static ArnmProcess* steal_from(ArnmWorker* victim) {
-    return runqueue_pop(&victim->local_queue);
-}
-
-static ArnmProcess* try_steal(ArnmWorker* worker) {
+static ArnmProcess* try_steal_pass(ArnmWorker* worker, int cls, bool same_node) {
     uint32_t num_workers = g_scheduler.num_workers;
     uint32_t start = worker->id;
     
@@ -194,10 +247,15 @@ static ArnmProcess* try_steal(ArnmWorker* worker) {
         uint32_t victim_id = (start + i) % num_workers;
         ArnmWorker* victim = &g_scheduler.workers[victim_id];
         
-        if (runqueue_count(&victim->local_queue) > 1) {
-            ArnmProcess* proc = steal_from(victim);
+        if ((victim->node == worker->node) != same_node) continue;
+        
+        /* Leave the victim at least one process to run */
+        if (runqueue_count(&victim->local_queues[cls]) > 0 &&
+            prio_count(victim->local_queues) > 1) {
+            ArnmProcess* proc = runqueue_pop(&victim->local_queues[cls]);
             if (proc) {
                 worker->steal_count++;
+                if (!same_node) worker->remote_steal_count++;
                 return proc;
             }
         }
@@ -206,24 +264,75 @@ static ArnmProcess* try_steal(ArnmWorker* worker) {
     return NULL;
 }
 
+static ArnmProcess* try_steal(ArnmWorker* worker) {
+    /* Highest class anywhere wins; within a class, same-node victims first */
+    for (int cls = 0; cls < ARNM_PRIO_COUNT; cls++) {
+        ArnmProcess* proc = try_steal_pass(worker, cls, true);
+        if (proc) return proc;
+        
+        if (g_scheduler.num_nodes > 1) {
+            proc = try_steal_pass(worker, cls, false);
+            if (proc) return proc;
+        }
+    }
+    
+    return NULL;
+}
+
 /* ============================================================
  * Scheduler Core
  * ============================================================ */
 
+static ArnmProcess* pop_class(ArnmWorker* worker, int cls) {
+    /*
+     * Local first for locality, but poll the global queue first every
+     * SCHED_GLOBAL_POLL picks: processes that keep yielding would
+     * otherwise hold the local queue forever and starve it.
+     */
+    bool global_first = (worker->run_count % SCHED_GLOBAL_POLL) == 0;
+    ArnmProcess* proc;
+    
+    if (global_first) {
+        proc = runqueue_pop(&g_scheduler.global_queues[cls]);
+        if (proc) return proc;
+    }
+    proc = runqueue_pop(&worker->local_queues[cls]);
+    if (proc || global_first) return proc;
+    return runqueue_pop(&g_scheduler.global_queues[cls]);
+}
+
 ArnmProcess* sched_next(ArnmWorker* worker) {
     ArnmProcess* proc = NULL;
+    int picked = -1;
+    
+    /*
+     * Starvation protection: a class passed over ARNM_STARVATION_LIMIT
+     * times while runnable gets one pick ahead of the higher classes.
+     */
+    for (int cls = ARNM_PRIO_COUNT - 1; cls > 0 && !proc; cls--) {
+        if (worker->skipped[cls] >= ARNM_STARVATION_LIMIT) {
+            proc = pop_class(worker, cls);
+            if (proc) picked = cls;
+            else worker->skipped[cls] = 0;
+        }
+    }
     
-    /* Try local queue first */
-    proc = runqueue_pop(&worker->local_queue);
-    if (proc) return proc;
+    /* Strict priority order: local queue, then global, per class */
+    for (int cls = 0; cls < ARNM_PRIO_COUNT && !proc; cls++) {
+        proc = pop_class(worker, cls);
+        if (proc) picked = cls;
+    }
     
-    /* Try global queue */
-    proc = runqueue_pop(&g_scheduler.global_queue);
-    if (proc) return proc;
+    if (proc) {
+        worker->skipped[picked] = 0;
+        for (int cls = picked + 1; cls < ARNM_PRIO_COUNT; cls++) {
+            if (class_ready(worker, cls)) worker->skipped[cls]++;
+        }
+        return proc;
+    }
     
     /* Try work stealing */
-    proc = try_steal(worker);
-    return proc;
+    return try_steal(worker);
 }
 
 void sched_enqueue(ArnmProcess* proc) {
@@ -235,9 +344,10 @@ void sched_enqueue(ArnmProcess* proc) {
     /* Prefer local queue if we're on a worker */
     ArnmWorker* worker = sched_current_worker();
     if (worker) {
-        runqueue_push(&worker->local_queue, proc);
+        proc->worker_id = worker->id;
+        prio_push(worker->local_queues, proc);
     } else {
-        runqueue_push(&g_scheduler.global_queue, proc);
+        prio_push(g_scheduler.global_queues, proc);
     }
 }
 
@@ -245,8 +355,9 @@ void sched_enqueue_local(ArnmProcess* proc, uint32_t worker_id) {
     if (!proc || worker_id >= g_scheduler.num_workers) return;
     
     proc_ready(proc);
+    proc->worker_id = worker_id;
     atomic_fetch_add(&g_scheduler.active_procs, 1);
-    runqueue_push(&g_scheduler.workers[worker_id].local_queue, proc);
+    prio_push(g_scheduler.workers[worker_id].local_queues, proc);
 }
 
 void arnm_sched_yield(void) {
@@ -259,7 +370,7 @@ void arnm_sched_yield(void) {
     if (current->state == PROC_STATE_READY || 
         current->state == PROC_STATE_RUNNING) {
         current->state = PROC_STATE_READY;
-        runqueue_push(&worker->local_queue, current);
+        prio_push(worker->local_queues, current);
     } else if (current->state == PROC_STATE_DEAD) {
         /* Process exited, decrement active count */
         atomic_fetch_sub(&g_scheduler.active_procs, 1);
@@ -269,6 +380,128 @@ void arnm_sched_yield(void) {
     arnm_context_switch(&current->context, &worker->scheduler_ctx);
 }
 
+/* ============================================================
+ * Placement and Affinity
+ * ============================================================ */
+
+int sched_place(ArnmPlacement placement, uint32_t explicit_worker) {
+    uint32_t n = g_scheduler.num_workers;
+    if (n == 0) return -1;
+    
+    switch (placement) {
+        case ARNM_PLACE_ROUND_ROBIN:
+            return (int)(atomic_fetch_add(&g_scheduler.rr_next, 1) % n);
+            
+        case ARNM_PLACE_LEAST_LOADED: {
+            uint32_t best = 0;
+            size_t best_load = (size_t)-1;
+            for (uint32_t i = 0; i < n; i++) {
+                ArnmWorker* w = &g_scheduler.workers[i];
+                size_t load = prio_count(w->local_queues) + (w->current ? 1 : 0);
+                if (load < best_load) {
+                    best = i;
+                    best_load = load;
+                }
+            }
+            return (int)best;
+        }
+            
+        case ARNM_PLACE_WORKER:
+            return (int)(explicit_worker % n);
+            
+        case ARNM_PLACE_LOCAL:
+        default: {
+            ArnmWorker* worker = sched_current_worker();
+            return worker ? (int)worker->id : -1;
+        }
+    }
+}
+
+/*
+ * Each receiver keeps a Boyer-Moore majority vote over the workers its
+ * sampled senders ran on: the candidate worker in the high 16 bits and
+ * its vote count in the low 16. Updates are relaxed load/store; losing
+ * an occasional sample to a race is fine for a heuristic.
+ */
+void sched_note_send(ArnmProcess* receiver) {
+    ArnmWorker* worker = sched_current_worker();
+    if (!worker || !receiver) return;
+    
+    if ((++worker->send_seq & (SCHED_EDGE_SAMPLE - 1)) != 0) return;
+    worker->edge_samples++;
+    
+    uint32_t a = atomic_load_explicit(&receiver->affinity, memory_order_relaxed);
+    uint32_t peer = a >> 16;
+    uint32_t votes = a & 0xFFFF;
+    
+    if (votes == 0) {
+        peer = worker->id;
+        votes = 1;
+    } else if (peer == worker->id) {
+        if (votes < SCHED_AFFINITY_MAX) votes++;
+    } else {
+        votes--;
+    }
+    
+    atomic_store_explicit(&receiver->affinity, (peer << 16) | votes, memory_order_relaxed);
+}
+
+/* Worker a woken process should run on: home, unless its peers clearly live elsewhere */
+static uint32_t wake_target(ArnmProcess* proc) {
+    uint32_t home = proc->worker_id < g_scheduler.num_workers ? proc->worker_id : 0;
+    uint32_t a = atomic_load_explicit(&proc->affinity, memory_order_relaxed);
+    uint32_t peer = a >> 16;
+    uint32_t votes = a & 0xFFFF;
+    
+    if (peer == home || peer >= g_scheduler.num_workers) return home;
+    if (votes < SCHED_MIGRATE_THRESHOLD) return home;
+    if (proc->run_count - proc->migrate_run < SCHED_MIGRATE_COOLDOWN) return home;
+    
+    /* Move, and halve the vote so the next move needs fresh evidence */
+    proc->migrate_run = proc->run_count;
+    atomic_store_explicit(&proc->affinity, (peer << 16) | (votes / 2), memory_order_relaxed);
+    atomic_fetch_add(&g_scheduler.workers[peer].migrations, 1);
+    return peer;
+}
+
+/* ============================================================
+ * Hibernation
+ * ============================================================ */
+
+/*
+ * Release stacks of processes parked on this worker for longer than
+ * hibernate_ns. Runs only when the worker has nothing else to do. The
+ * scan claims a process (sched_claim) the same way a waker does, so it
+ * can never hibernate a process that is being resumed; afterwards it
+ * re-parks it and, like sched_park, rechecks the mailbox.
+ */
+static void hibernate_idle(ArnmWorker* worker) {
+    if (!g_scheduler.hibernate_ns) return;
+    
+    IdleList* list = &worker->idle;
+    uint64_t now = sched_clock_ns();
+    
+    for (;;) {
+        pthread_spin_lock(&list->lock);
+        ArnmProcess* proc = list->head;
+        if (!proc || now - proc->park_time < g_scheduler.hibernate_ns) {
+            pthread_spin_unlock(&list->lock);
+            return;
+        }
+        idle_unlink(list, proc);
+        pthread_spin_unlock(&list->lock);
+        
+        if (!sched_claim(proc)) {
+            continue;   /* A waker got there first */
+        }
+        
+        proc_hibernate(proc);
+        worker->hibernations++;
+        
+        sched_unclaim(proc);
+    }
+}
+
 /* ============================================================
  * Worker Thread
  * ============================================================ */
@@ -277,7 +510,17 @@ static void* worker_main(void* arg) {
     ArnmWorker* worker = (ArnmWorker*)arg;
     tls_worker = worker;
     
+    if (worker->cpu >= 0 && !topo_pin_thread(worker->cpu)) {
+        fprintf(stderr, "[ARNM WARNING] Could not pin worker %u to CPU %d\n",
+                worker->id, worker->cpu);
+    }
+    
     while (!atomic_load(&g_scheduler.shutdown)) {
+        /* Parallel loop chunks go first: their caller is waiting on them */
+        if (atomic_load_explicit(&g_parallel_jobs, memory_order_relaxed)) {
+            parallel_help();
+        }
+        
         ArnmProcess* proc = sched_next(worker);
         
         if (proc) {
@@ -285,11 +528,17 @@ static void* worker_main(void* arg) {
             RUNTIME_ASSERT(proc->state == PROC_STATE_READY || proc->state == PROC_STATE_WAITING,
                           "process popped from queue should be ready or waiting");
             
+            if (proc->hibernation != PROC_AWAKE && !proc_thaw(proc)) {
+                fprintf(stderr, "[ARNM PANIC] Out of memory resuming hibernated process %lu\n",
+                        (unsigned long)proc->pid);
+                abort();
+            }
+            
             worker->current = proc;
             proc->state = PROC_STATE_RUNNING;
+            proc->reductions = g_scheduler.max_batch;
             proc->run_count++;
             proc->worker_id = worker->id;
-            proc->worker_id = worker->id;
             proc_set_current(proc);
             worker->run_count++;
             
@@ -303,18 +552,40 @@ static void* worker_main(void* arg) {
             /* Handle dead processes */
             if (proc->state == PROC_STATE_DEAD) {
                 proc_destroy(proc);
+            } else if (proc->state == PROC_STATE_WAITING) {
+                sched_park(proc);
+            }
+            
+            /* Busy workers still release long-idle stacks now and then */
+            if ((worker->run_count & (SCHED_HIBERNATE_SCAN - 1)) == 0) {
+                hibernate_idle(worker);
             }
         } else {
             /* No work - check if done */
-            if (atomic_load(&g_scheduler.active_procs) == 0) {
+            size_t active = atomic_load(&g_scheduler.active_procs);
+            bool held = atomic_load(&g_scheduler.holds) > 0;
+            if (active == 0 && !held) {
                 break;
             }
             
+            /* Everyone is parked: nothing left can ever send a message */
+            if (active == atomic_load(&g_scheduler.waiting_procs) && !held) {
+                break;
+            }
+            
+            hibernate_idle(worker);
+            output_flush_worker(worker->id);
+            
             /* Yield to other threads */
             usleep(100);  /* 100 microseconds */
         }
     }
     
+    output_flush_worker(worker->id);
+    
+    /* Worker 0 is the main thread: don't leave it looking like a worker */
+    tls_worker = NULL;
+    
     /* atomic_store(&worker->running, false); - moved inside if to be safe? No, just before return. */
     atomic_store(&worker->running, false);
     return NULL;
@@ -324,7 +595,8 @@ static void* worker_main(void* arg) {
  * Scheduler Lifecycle
  * ============================================================ */
 
-int sched_init(uint32_t num_workers) {
+int sched_init(const ArnmConfig* config) {
+    uint32_t num_workers = config->num_workers > 0 ? (uint32_t)config->num_workers : 0;
     if (num_workers == 0) {
         num_workers = sysconf(_SC_NPROCESSORS_ONLN);
         if (num_workers < 1) num_workers = 1;
@@ -337,18 +609,37 @@ int sched_init(uint32_t num_workers) {
     if (!g_scheduler.workers) return -1;
     
     g_scheduler.num_workers = num_workers;
+    g_scheduler.pin_workers = config->pin_workers;
+    g_scheduler.max_batch = config->max_batch > 0 ? (uint32_t)config->max_batch : ARNM_DEFAULT_BATCH;
+    g_scheduler.hibernate_ns = config->hibernate_ms > 0 ? (uint64_t)config->hibernate_ms * 1000000ull : 0;
+    g_scheduler.num_nodes = 1;
+    atomic_init(&g_scheduler.rr_next, 0);
     atomic_init(&g_scheduler.shutdown, false);
     atomic_init(&g_scheduler.active_procs, 0);
     atomic_init(&g_scheduler.waiting_procs, 0);
+    atomic_init(&g_scheduler.holds, 0);
     
-    runqueue_init(&g_scheduler.global_queue);
-    waitqueue_init(&g_scheduler.wait_queue);
+    prio_init(g_scheduler.global_queues);
     
     for (uint32_t i = 0; i < num_workers; i++) {
         g_scheduler.workers[i].id = i;
         g_scheduler.workers[i].current = NULL;
+        g_scheduler.workers[i].node = -1;
+        g_scheduler.workers[i].cpu = -1;
         atomic_init(&g_scheduler.workers[i].running, false);
-        runqueue_init(&g_scheduler.workers[i].local_queue);
+        prio_init(g_scheduler.workers[i].local_queues);
+        idle_init(&g_scheduler.workers[i].idle);
+    }
+    
+    /* Unpinned workers float across nodes, so they are all treated as one */
+    if (config->pin_workers) {
+        topo_init();
+        g_scheduler.num_nodes = topo_num_nodes() < num_workers ? topo_num_nodes() : num_workers;
+        for (uint32_t i = 0; i < num_workers; i++) {
+            uint32_t node = 0;
+            g_scheduler.workers[i].cpu = topo_cpu_for_worker(i, &node);
+            g_scheduler.workers[i].node = (int32_t)node;
+        }
     }
     
     return 0;
@@ -383,10 +674,10 @@ void sched_shutdown(void) {
     }
     
     /* Cleanup */
-    runqueue_destroy(&g_scheduler.global_queue);
-    waitqueue_destroy(&g_scheduler.wait_queue);
+    prio_destroy(g_scheduler.global_queues);
     for (uint32_t i = 0; i < g_scheduler.num_workers; i++) {
-        runqueue_destroy(&g_scheduler.workers[i].local_queue);
+        prio_destroy(g_scheduler.workers[i].local_queues);
+        pthread_spin_destroy(&g_scheduler.workers[i].idle.lock);
     }
     
     free(g_scheduler.workers);
@@ -397,31 +688,88 @@ void sched_shutdown(void) {
  * Process Parking/Waking
  * ============================================================ */
 
+/* Something arrived that a parking process must not sleep through */
+static bool wake_pending(ArnmProcess* proc) {
+    return (atomic_load(&proc->mailbox_wait) && !mailbox_empty(proc->mailbox)) ||
+           atomic_load(&proc->notified);
+}
+
 void sched_park(ArnmProcess* proc) {
     if (!proc) return;
     
-    /* Mark process as waiting */
-    proc->state = PROC_STATE_WAITING;
-    
-    /* Add to wait queue */
-    waitqueue_push(&g_scheduler.wait_queue, proc);
     atomic_fetch_add(&g_scheduler.waiting_procs, 1);
+    
+    /* List before the flag goes up: a waker must find us to unlist us */
+    ArnmWorker* worker = sched_current_worker();
+    if (g_scheduler.hibernate_ns && worker) {
+        proc->park_time = sched_clock_ns();
+        idle_push(worker, proc);
+    }
+    
+    atomic_store(&proc->parked, true);
+    
+    /*
+     * A sender that enqueued before the flag went up saw parked == false
+     * and skipped the wake; pick its message up here. Both sides use
+     * seq_cst, so at least one of them observes the other.
+     */
+    if (wake_pending(proc)) {
+        sched_wake(proc);
+    }
 }
 
 void sched_wake(ArnmProcess* proc) {
     if (!proc) return;
     
-    /* Try to remove from wait queue */
-    ArnmProcess* found = waitqueue_remove(&g_scheduler.wait_queue, proc);
-    if (found) {
-        atomic_fetch_sub(&g_scheduler.waiting_procs, 1);
-        
-        /* Re-enqueue to run queue */
-        found->state = PROC_STATE_READY;
-        runqueue_push(&g_scheduler.global_queue, found);
+    /* Exactly one waker wins the flag */
+    bool expected = true;
+    if (!atomic_compare_exchange_strong(&proc->parked, &expected, false)) {
+        return;
+    }
+    atomic_fetch_sub(&g_scheduler.waiting_procs, 1);
+    idle_remove(proc);
+    
+    /* Back to its home worker, or toward its dominant peer (see wake_target) */
+    proc->state = PROC_STATE_READY;
+    uint32_t target = wake_target(proc);
+    proc->worker_id = target;
+    prio_push(g_scheduler.workers[target].local_queues, proc);
+}
+
+void sched_notify(ArnmProcess* proc) {
+    atomic_store(&proc->notified, true);
+    if (atomic_load(&proc->parked)) {
+        sched_wake(proc);
     }
 }
 
+bool sched_claim(ArnmProcess* proc) {
+    bool expected = true;
+    return atomic_compare_exchange_strong(&proc->parked, &expected, false);
+}
+
+void sched_unclaim(ArnmProcess* proc) {
+    atomic_store(&proc->parked, true);
+    if (wake_pending(proc)) {
+        sched_wake(proc);
+    }
+}
+
+bool sched_is_running(void) {
+    for (uint32_t i = 0; i < g_scheduler.num_workers; i++) {
+        if (atomic_load(&g_scheduler.workers[i].running)) return true;
+    }
+    return false;
+}
+
+void sched_hold(void) {
+    atomic_fetch_add(&g_scheduler.holds, 1);
+}
+
+void sched_release(void) {
+    atomic_fetch_sub(&g_scheduler.holds, 1);
+}
+
 bool sched_check_deadlock(void) {
     size_t active = atomic_load(&g_scheduler.active_procs);
     size_t waiting = atomic_load(&g_scheduler.waiting_procs);
@@ -437,3 +785,13 @@ bool sched_check_deadlock(void) {
     
     return false;
 }
+
+/* ============================================================
+ * Clock
+ * ============================================================ */
+
+uint64_t sched_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,335 @@
+/*
+ * ARNm Runtime - Shared-Memory Transport Implementation
+ */
+
+#include "../include/shm.h"
+#include "../include/dist.h"
+#include "../include/process.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+static pthread_mutex_t shm_lock = PTHREAD_MUTEX_INITIALIZER;
+static ShmLink* shm_links[DIST_MAX_NODES];
+
+/* ============================================================
+ * Futex
+ * ============================================================
+ * Shared (non-private) futex ops, so the word can live in a
+ * mapping used by two processes.
+ */
+
+static void futex_wait(_Atomic uint32_t* word, uint32_t expected, int timeout_ms) {
+    struct timespec ts = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT, expected, &ts, NULL, 0);
+}
+
+static void futex_wake(_Atomic uint32_t* word) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/* ============================================================
+ * Ring Access
+ * ============================================================ */
+
+static inline _Atomic uint64_t* slot_seq(ShmRing* ring, uint64_t pos) {
+    return (_Atomic uint64_t*)&ring->slots[(pos % SHM_RING_SLOTS) * SHM_SLOT_SIZE];
+}
+
+static inline uint8_t* slot_bytes(ShmRing* ring, uint64_t pos) {
+    return &ring->slots[(pos % SHM_RING_SLOTS) * SHM_SLOT_SIZE];
+}
+
+/* Copy into the ring at byte offset off, wrapping at the end */
+static void ring_write(ShmRing* ring, size_t off, const void* src, size_t len) {
+    const size_t cap = sizeof(ring->slots);
+    off %= cap;
+    size_t first = len < cap - off ? len : cap - off;
+    memcpy(&ring->slots[off], src, first);
+    memcpy(&ring->slots[0], (const uint8_t*)src + first, len - first);
+}
+
+static void ring_read(ShmRing* ring, size_t off, void* dst, size_t len) {
+    const size_t cap = sizeof(ring->slots);
+    off %= cap;
+    size_t first = len < cap - off ? len : cap - off;
+    memcpy(dst, &ring->slots[off], first);
+    memcpy((uint8_t*)dst + first, &ring->slots[0], len - first);
+}
+
+static inline uint32_t record_slots(size_t size) {
+    return (uint32_t)((SHM_RECORD_HEADER + size + SHM_SLOT_SIZE - 1) / SHM_SLOT_SIZE);
+}
+
+/* ============================================================
+ * Producer
+ * ============================================================ */
+
+int shm_send(ShmLink* link, uint64_t pid, uint64_t tag, const void* data, size_t size) {
+    if (size > SHM_MAX_PAYLOAD) return -1;
+
+    ShmRing* ring = &link->seg->rings[1 - link->side];
+    uint32_t k = record_slots(size);
+
+    /* Reserve k slots; when the ring is full, let the consumer catch up */
+    uint64_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    for (;;) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (pos + k - head > SHM_RING_SLOTS) {
+            if (proc_current()) {
+                arnm_yield();
+            } else {
+                sched_yield();
+            }
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            continue;
+        }
+        if (atomic_compare_exchange_weak_explicit(&ring->tail, &pos, pos + k,
+                                                  memory_order_acq_rel,
+                                                  memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    /* Header fits in the first slot; the payload may wrap */
+    uint8_t* rec = slot_bytes(ring, pos);
+    uint32_t size32 = (uint32_t)size;
+    memcpy(rec + 8, &tag, 8);
+    memcpy(rec + 16, &pid, 8);
+    memcpy(rec + 24, &size32, 4);
+    memcpy(rec + 28, &k, 4);
+    if (size) {
+        ring_write(ring, (pos % SHM_RING_SLOTS) * SHM_SLOT_SIZE + SHM_RECORD_HEADER, data, size);
+    }
+
+    /* Publish, then wake the consumer only if it went to sleep */
+    atomic_store(slot_seq(ring, pos), pos + 1);
+    if (atomic_load(&ring->parked) && atomic_exchange(&ring->parked, 0)) {
+        futex_wake(&ring->parked);
+        atomic_fetch_add(&link->wakeups, 1);
+    }
+
+    atomic_fetch_add(&link->sent, 1);
+    return 0;
+}
+
+/* ============================================================
+ * Consumer
+ * ============================================================ */
+
+static void* consumer_main(void* arg) {
+    ShmLink* link = (ShmLink*)arg;
+    ShmRing* ring = &link->seg->rings[link->side];
+    uint8_t* scratch = NULL;
+    size_t scratch_cap = 0;
+    int idle = 0;
+
+    while (!atomic_load(&link->stopping)) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        uint64_t seq = atomic_load(slot_seq(ring, head));
+
+        if (seq != head + 1) {
+            if (++idle < SHM_SPIN) continue;
+
+            /* Announce we're parking, then recheck before sleeping */
+            atomic_store(&ring->parked, 1);
+            if (atomic_load(slot_seq(ring, head)) != head + 1) {
+                futex_wait(&ring->parked, 1, SHM_PARK_MS);
+            }
+            atomic_store(&ring->parked, 0);
+            idle = 0;
+            continue;
+        }
+        idle = 0;
+
+        uint8_t* rec = slot_bytes(ring, head);
+        uint64_t tag, pid;
+        uint32_t size, k;
+        memcpy(&tag, rec + 8, 8);
+        memcpy(&pid, rec + 16, 8);
+        memcpy(&size, rec + 24, 4);
+        memcpy(&k, rec + 28, 4);
+
+        /* Unwrapped payloads are handed to the mailbox straight from the ring */
+        void* payload = NULL;
+        size_t off = (head % SHM_RING_SLOTS) * SHM_SLOT_SIZE + SHM_RECORD_HEADER;
+        if (size && off + size <= sizeof(ring->slots)) {
+            payload = &ring->slots[off];
+        } else if (size) {
+            if (size > scratch_cap) {
+                uint8_t* grown = realloc(scratch, size);
+                if (!grown) {
+                    fprintf(stderr, "[ARNM PANIC] Out of memory reading shared-memory ring\n");
+                    abort();
+                }
+                scratch = grown;
+                scratch_cap = size;
+            }
+            ring_read(ring, off, scratch, size);
+            payload = scratch;
+        }
+
+        if (proc_send_pid(pid, tag, payload, size)) {
+            atomic_fetch_add(&link->received, 1);
+        } else {
+            atomic_fetch_add(&link->dropped, 1);
+        }
+
+        /* Clear sequence words so stale payload bytes never look published */
+        for (uint32_t i = 0; i < k; i++) {
+            atomic_store_explicit(slot_seq(ring, head + i), 0, memory_order_relaxed);
+        }
+        atomic_store_explicit(&ring->head, head + k, memory_order_release);
+    }
+
+    free(scratch);
+    return NULL;
+}
+
+/* ============================================================
+ * Link Management
+ * ============================================================ */
+
+ShmLink* shm_link(uint32_t node_id) {
+    if (node_id == 0 || node_id >= DIST_MAX_NODES) return NULL;
+
+    pthread_mutex_lock(&shm_lock);
+    ShmLink* link = shm_links[node_id];
+    pthread_mutex_unlock(&shm_lock);
+    return link;
+}
+
+/* Create the segment, or attach if the peer created it first */
+static ShmSegment* segment_open(const char* name, uint32_t self, uint32_t peer, int* side) {
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    *side = 0;
+    if (fd < 0 && errno == EEXIST) {
+        fd = shm_open(name, O_RDWR, 0600);
+        *side = 1;
+    }
+    if (fd < 0) return NULL;
+
+    if (*side == 0 && ftruncate(fd, sizeof(ShmSegment)) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    /* The creator may not have sized the segment yet */
+    for (int tries = 0; *side == 1 && lseek(fd, 0, SEEK_END) < (off_t)sizeof(ShmSegment); tries++) {
+        if (tries > 1000) {
+            close(fd);
+            return NULL;
+        }
+        usleep(1000);
+    }
+
+    ShmSegment* seg = mmap(NULL, sizeof(ShmSegment), PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+        if (*side == 0) shm_unlink(name);
+        return NULL;
+    }
+
+    if (*side == 0) {
+        /* Fresh pages from ftruncate are already zero */
+        seg->magic = SHM_MAGIC;
+        seg->version = SHM_VERSION;
+        seg->nodes[0] = self;
+        seg->nodes[1] = peer;
+        atomic_store(&seg->ready, 1);
+        return seg;
+    }
+
+    for (int tries = 0; !atomic_load(&seg->ready); tries++) {
+        if (tries > 1000) {
+            munmap(seg, sizeof(ShmSegment));
+            return NULL;
+        }
+        usleep(1000);
+    }
+    if (seg->magic != SHM_MAGIC || seg->version != SHM_VERSION ||
+        seg->nodes[0] != peer || seg->nodes[1] != self) {
+        munmap(seg, sizeof(ShmSegment));
+        return NULL;
+    }
+
+    /* Both sides are mapped; the name is no longer needed */
+    atomic_store(&seg->attached, 1);
+    shm_unlink(name);
+    return seg;
+}
+
+int arnm_node_link_shm(const char* name, uint32_t peer_node) {
+    uint32_t self = arnm_node_id();
+    if (self == 0 || peer_node == 0 || peer_node >= DIST_MAX_NODES || peer_node == self) {
+        return -1;
+    }
+    if (strlen(name) >= sizeof(((ShmLink*)0)->name) || shm_link(peer_node)) return -1;
+
+    ShmLink* link = calloc(1, sizeof(ShmLink));
+    if (!link) return -1;
+
+    link->seg = segment_open(name, self, peer_node, &link->side);
+    if (!link->seg) {
+        free(link);
+        return -1;
+    }
+    link->peer_node = peer_node;
+    strcpy(link->name, name);
+    atomic_init(&link->stopping, false);
+
+    pthread_mutex_lock(&shm_lock);
+    bool taken = shm_links[peer_node] != NULL;
+    if (!taken) {
+        shm_links[peer_node] = link;
+    }
+    pthread_mutex_unlock(&shm_lock);
+
+    if (taken || pthread_create(&link->consumer, NULL, consumer_main, link) != 0) {
+        pthread_mutex_lock(&shm_lock);
+        if (shm_links[peer_node] == link) shm_links[peer_node] = NULL;
+        pthread_mutex_unlock(&shm_lock);
+        if (link->side == 0) shm_unlink(name);
+        munmap(link->seg, sizeof(ShmSegment));
+        free(link);
+        return -1;
+    }
+    return 0;
+}
+
+void shm_stop_all(void) {
+    ShmLink* links[DIST_MAX_NODES];
+
+    pthread_mutex_lock(&shm_lock);
+    memcpy(links, shm_links, sizeof(links));
+    memset(shm_links, 0, sizeof(shm_links));
+    pthread_mutex_unlock(&shm_lock);
+
+    for (int i = 0; i < DIST_MAX_NODES; i++) {
+        ShmLink* link = links[i];
+        if (!link) continue;
+
+        atomic_store(&link->stopping, true);
+        ShmRing* inbound = &link->seg->rings[link->side];
+        atomic_store(&inbound->parked, 0);
+        futex_wake(&inbound->parked);
+        pthread_join(link->consumer, NULL);
+
+        /* Records we wrote stay in the segment until the peer reads them */
+        if (link->side == 0 && !atomic_load(&link->seg->attached)) {
+            shm_unlink(link->name);
+        }
+        munmap(link->seg, sizeof(ShmSegment));
+        free(link);
+    }
+}
@@ -0,0 +1,467 @@
+/*
+ * ARNm Runtime - SIMD Vector Kernels
+ *
+ * Every entry point has an AVX2 kernel, built with a target attribute
+ * so the library itself still loads on any x86-64, and an SSE2 kernel
+ * for the baseline. Operations SSE2 has no instruction for (32-bit
+ * multiply, integer min/max, variable shuffles, integer division) use
+ * the scalar loops, which are also all other architectures get.
+ */
+
+#include "../include/arnm.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#else
+#define SIMD_X86 0
+#endif
+
+uint8_t arnm_simd_avx2;
+
+static ArnmSimdLevel simd_cpu_level;    /* Best the CPU supports */
+static ArnmSimdLevel simd_level;
+
+/* ============================================================
+ * Scalar Kernels
+ * ============================================================ */
+
+/* x86-64 always has SSE2 for the float kernels */
+#if !SIMD_X86
+
+static float f32_apply(float a, float b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_SUB: return a - b;
+        case ARNM_VEC_MUL: return a * b;
+        case ARNM_VEC_DIV: return a / b;
+        default:           return a + b;
+    }
+}
+
+static double f64_apply(double a, double b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_SUB: return a - b;
+        case ARNM_VEC_MUL: return a * b;
+        case ARNM_VEC_DIV: return a / b;
+        default:           return a + b;
+    }
+}
+
+static float f32_fold(float a, float b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_MIN: return a < b ? a : b;
+        case ARNM_VEC_MAX: return a > b ? a : b;
+        default:           return a + b;
+    }
+}
+
+static double f64_fold(double a, double b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_MIN: return a < b ? a : b;
+        case ARNM_VEC_MAX: return a > b ? a : b;
+        default:           return a + b;
+    }
+}
+
+static void f32x8_op_scalar(float* d, const float* a, const float* b, int64_t op) {
+    for (int i = 0; i < 8; i++) d[i] = f32_apply(a[i], b[i], op);
+}
+
+static void f64x4_op_scalar(double* d, const double* a, const double* b, int64_t op) {
+    for (int i = 0; i < 4; i++) d[i] = f64_apply(a[i], b[i], op);
+}
+
+static float f32x8_reduce_scalar(const float* v, int64_t op) {
+    float t[8];
+    memcpy(t, v, sizeof(t));
+    for (int w = 4; w >= 1; w /= 2) {
+        for (int i = 0; i < w; i++) t[i] = f32_fold(t[i], t[i + w], op);
+    }
+    return t[0];
+}
+
+static double f64x4_reduce_scalar(const double* v, int64_t op) {
+    double t[4];
+    memcpy(t, v, sizeof(t));
+    for (int w = 2; w >= 1; w /= 2) {
+        for (int i = 0; i < w; i++) t[i] = f64_fold(t[i], t[i + w], op);
+    }
+    return t[0];
+}
+
+#endif /* !SIMD_X86 */
+
+static int32_t i32_apply(int32_t a, int32_t b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_SUB: return (int32_t)((uint32_t)a - (uint32_t)b);
+        case ARNM_VEC_MUL: return (int32_t)((uint32_t)a * (uint32_t)b);
+        case ARNM_VEC_DIV:
+            if (b == 0) return 0;
+            if (a == INT32_MIN && b == -1) return a;
+            return a / b;
+        default:           return (int32_t)((uint32_t)a + (uint32_t)b);
+    }
+}
+
+/* Folds match minps/maxps: the first operand unless the second wins */
+static int32_t i32_fold(int32_t a, int32_t b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_MIN: return a < b ? a : b;
+        case ARNM_VEC_MAX: return a > b ? a : b;
+        default:           return (int32_t)((uint32_t)a + (uint32_t)b);
+    }
+}
+
+static void i32x8_op_scalar(int32_t* d, const int32_t* a, const int32_t* b, int64_t op) {
+    for (int i = 0; i < 8; i++) d[i] = i32_apply(a[i], b[i], op);
+}
+
+/* Pairwise tree: lane i with lane i + 4, then i + 2, then i + 1 */
+static int32_t i32x8_reduce_scalar(const int32_t* v, int64_t op) {
+    int32_t t[8];
+    memcpy(t, v, sizeof(t));
+    for (int w = 4; w >= 1; w /= 2) {
+        for (int i = 0; i < w; i++) t[i] = i32_fold(t[i], t[i + w], op);
+    }
+    return t[0];
+}
+
+/* ============================================================
+ * SSE2 Kernels
+ * ============================================================ */
+
+#if SIMD_X86
+
+static __m128 f32_apply_sse2(__m128 a, __m128 b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_SUB: return _mm_sub_ps(a, b);
+        case ARNM_VEC_MUL: return _mm_mul_ps(a, b);
+        case ARNM_VEC_DIV: return _mm_div_ps(a, b);
+        default:           return _mm_add_ps(a, b);
+    }
+}
+
+static __m128d f64_apply_sse2(__m128d a, __m128d b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_SUB: return _mm_sub_pd(a, b);
+        case ARNM_VEC_MUL: return _mm_mul_pd(a, b);
+        case ARNM_VEC_DIV: return _mm_div_pd(a, b);
+        default:           return _mm_add_pd(a, b);
+    }
+}
+
+static __m128 f32_fold_sse2(__m128 a, __m128 b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_MIN: return _mm_min_ps(a, b);
+        case ARNM_VEC_MAX: return _mm_max_ps(a, b);
+        default:           return _mm_add_ps(a, b);
+    }
+}
+
+static __m128d f64_fold_sse2(__m128d a, __m128d b, int64_t op) {
+    switch (op) {
+        case ARNM_VEC_MIN: return _mm_min_pd(a, b);
+        case ARNM_VEC_MAX: return _mm_max_pd(a, b);
+        default:           return _mm_add_pd(a, b);
+    }
+}
+
+/* The last two steps of the tree, on the folded halves */
+static float f32_finish_sse2(__m128 s, int64_t op) {
+    s = f32_fold_sse2(s, _mm_movehl_ps(s, s), op);
+    s = f32_fold_sse2(s, _mm_shuffle_ps(s, s, 1), op);
+    return _mm_cvtss_f32(s);
+}
+
+static double f64_finish_sse2(__m128d s, int64_t op) {
+    s = f64_fold_sse2(s, _mm_unpackhi_pd(s, s), op);
+    return _mm_cvtsd_f64(s);
+}
+
+static int32_t i32_sum_finish_sse2(__m128i s) {
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+static void f32x8_op_sse2(float* d, const float* a, const float* b, int64_t op) {
+    __m128 lo = f32_apply_sse2(_mm_loadu_ps(a), _mm_loadu_ps(b), op);
+    __m128 hi = f32_apply_sse2(_mm_loadu_ps(a + 4), _mm_loadu_ps(b + 4), op);
+    _mm_storeu_ps(d, lo);
+    _mm_storeu_ps(d + 4, hi);
+}
+
+static void f64x4_op_sse2(double* d, const double* a, const double* b, int64_t op) {
+    __m128d lo = f64_apply_sse2(_mm_loadu_pd(a), _mm_loadu_pd(b), op);
+    __m128d hi = f64_apply_sse2(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2), op);
+    _mm_storeu_pd(d, lo);
+    _mm_storeu_pd(d + 2, hi);
+}
+
+static void i32x8_op_sse2(int32_t* d, const int32_t* a, const int32_t* b, int64_t op) {
+    if (op != ARNM_VEC_ADD && op != ARNM_VEC_SUB) {
+        i32x8_op_scalar(d, a, b, op);
+        return;
+    }
+    __m128i a0 = _mm_loadu_si128((const __m128i*)a), a1 = _mm_loadu_si128((const __m128i*)(a + 4));
+    __m128i b0 = _mm_loadu_si128((const __m128i*)b), b1 = _mm_loadu_si128((const __m128i*)(b + 4));
+    __m128i lo = op == ARNM_VEC_ADD ? _mm_add_epi32(a0, b0) : _mm_sub_epi32(a0, b0);
+    __m128i hi = op == ARNM_VEC_ADD ? _mm_add_epi32(a1, b1) : _mm_sub_epi32(a1, b1);
+    _mm_storeu_si128((__m128i*)d, lo);
+    _mm_storeu_si128((__m128i*)(d + 4), hi);
+}
+
+static float f32x8_reduce_sse2(const float* v, int64_t op) {
+    return f32_finish_sse2(f32_fold_sse2(_mm_loadu_ps(v), _mm_loadu_ps(v + 4), op), op);
+}
+
+static double f64x4_reduce_sse2(const double* v, int64_t op) {
+    return f64_finish_sse2(f64_fold_sse2(_mm_loadu_pd(v), _mm_loadu_pd(v + 2), op), op);
+}
+
+static int32_t i32x8_reduce_sse2(const int32_t* v, int64_t op) {
+    if (op != ARNM_VEC_SUM) return i32x8_reduce_scalar(v, op);
+    __m128i s = _mm_add_epi32(_mm_loadu_si128((const __m128i*)v),
+                              _mm_loadu_si128((const __m128i*)(v + 4)));
+    return i32_sum_finish_sse2(s);
+}
+
+/* ============================================================
+ * AVX2 Kernels
+ * ============================================================ */
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static void f32x8_op_avx2(float* d, const float* a, const float* b, int64_t op) {
+    __m256 x = _mm256_loadu_ps(a), y = _mm256_loadu_ps(b), r;
+    switch (op) {
+        case ARNM_VEC_SUB: r = _mm256_sub_ps(x, y); break;
+        case ARNM_VEC_MUL: r = _mm256_mul_ps(x, y); break;
+        case ARNM_VEC_DIV: r = _mm256_div_ps(x, y); break;
+        default:           r = _mm256_add_ps(x, y); break;
+    }
+    _mm256_storeu_ps(d, r);
+}
+
+AVX2 static void f64x4_op_avx2(double* d, const double* a, const double* b, int64_t op) {
+    __m256d x = _mm256_loadu_pd(a), y = _mm256_loadu_pd(b), r;
+    switch (op) {
+        case ARNM_VEC_SUB: r = _mm256_sub_pd(x, y); break;
+        case ARNM_VEC_MUL: r = _mm256_mul_pd(x, y); break;
+        case ARNM_VEC_DIV: r = _mm256_div_pd(x, y); break;
+        default:           r = _mm256_add_pd(x, y); break;
+    }
+    _mm256_storeu_pd(d, r);
+}
+
+AVX2 static void i32x8_op_avx2(int32_t* d, const int32_t* a, const int32_t* b, int64_t op) {
+    if (op == ARNM_VEC_DIV) {
+        i32x8_op_scalar(d, a, b, op);
+        return;
+    }
+    __m256i x = _mm256_loadu_si256((const __m256i*)a), y = _mm256_loadu_si256((const __m256i*)b), r;
+    switch (op) {
+        case ARNM_VEC_SUB: r = _mm256_sub_epi32(x, y); break;
+        case ARNM_VEC_MUL: r = _mm256_mullo_epi32(x, y); break;
+        default:           r = _mm256_add_epi32(x, y); break;
+    }
+    _mm256_storeu_si256((__m256i*)d, r);
+}
+
+AVX2 static float f32x8_reduce_avx2(const float* v, int64_t op) {
+    __m256 x = _mm256_loadu_ps(v);
+    __m128 s = f32_fold_sse2(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1), op);
+    return f32_finish_sse2(s, op);
+}
+
+AVX2 static double f64x4_reduce_avx2(const double* v, int64_t op) {
+    __m256d x = _mm256_loadu_pd(v);
+    __m128d s = f64_fold_sse2(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1), op);
+    return f64_finish_sse2(s, op);
+}
+
+AVX2 static int32_t i32x8_reduce_avx2(const int32_t* v, int64_t op) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)v);
+    __m128i lo = _mm256_castsi256_si128(x), hi = _mm256_extracti128_si256(x, 1);
+    __m128i s;
+    switch (op) {
+        case ARNM_VEC_MIN: s = _mm_min_epi32(lo, hi); break;
+        case ARNM_VEC_MAX: s = _mm_max_epi32(lo, hi); break;
+        default:           return i32_sum_finish_sse2(_mm_add_epi32(lo, hi));
+    }
+    __m128i t = _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2));
+    s = op == ARNM_VEC_MIN ? _mm_min_epi32(s, t) : _mm_max_epi32(s, t);
+    t = _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1));
+    s = op == ARNM_VEC_MIN ? _mm_min_epi32(s, t) : _mm_max_epi32(s, t);
+    return _mm_cvtsi128_si32(s);
+}
+
+AVX2 static void f32x8_shuffle_avx2(float* d, const float* v, const int32_t* idx) {
+    __m256i k = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)idx), _mm256_set1_epi32(7));
+    _mm256_storeu_ps(d, _mm256_permutevar8x32_ps(_mm256_loadu_ps(v), k));
+}
+
+AVX2 static void i32x8_shuffle_avx2(int32_t* d, const int32_t* v, const int32_t* idx) {
+    __m256i k = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)idx), _mm256_set1_epi32(7));
+    __m256i x = _mm256_loadu_si256((const __m256i*)v);
+    _mm256_storeu_si256((__m256i*)d, _mm256_permutevar8x32_epi32(x, k));
+}
+
+/* Lane k of a f64x4 is 32-bit lanes 2k and 2k + 1 */
+AVX2 static void f64x4_shuffle_avx2(double* d, const double* v, const int32_t* idx) {
+    __m128i k = _mm_and_si128(_mm_loadu_si128((const __m128i*)idx), _mm_set1_epi32(3));
+    __m256i k2 = _mm256_slli_epi64(_mm256_cvtepi32_epi64(k), 1);
+    __m256i pair = _mm256_or_si256(k2, _mm256_slli_epi64(_mm256_add_epi64(k2, _mm256_set1_epi64x(1)), 32));
+    __m256 x = _mm256_castpd_ps(_mm256_loadu_pd(v));
+    _mm256_storeu_pd(d, _mm256_castps_pd(_mm256_permutevar8x32_ps(x, pair)));
+}
+
+#endif /* SIMD_X86 */
+
+/* ============================================================
+ * Dispatch
+ * ============================================================ */
+
+#if SIMD_X86
+#define DISPATCH(avx2, sse2, scalar, ...) \
+    (arnm_simd_avx2 ? avx2(__VA_ARGS__) : sse2(__VA_ARGS__))
+#else
+#define DISPATCH(avx2, sse2, scalar, ...) scalar(__VA_ARGS__)
+#endif
+
+__attribute__((constructor))
+static void simd_init(void) {
+#if SIMD_X86
+    __builtin_cpu_init();
+    simd_cpu_level = __builtin_cpu_supports("avx2") ? ARNM_SIMD_AVX2 : ARNM_SIMD_SSE2;
+#else
+    simd_cpu_level = ARNM_SIMD_SCALAR;
+#endif
+    const char* force = getenv("ARNM_SIMD");
+    arnm_simd_select(force && strcmp(force, "sse2") == 0 ? ARNM_SIMD_SSE2 : simd_cpu_level);
+}
+
+ArnmSimdLevel arnm_simd_level(void) {
+    return simd_level;
+}
+
+ArnmSimdLevel arnm_simd_select(ArnmSimdLevel level) {
+    /* SSE2 is part of x86-64: there is no slower path to fall to */
+    if (SIMD_X86 && level < ARNM_SIMD_SSE2) level = ARNM_SIMD_SSE2;
+    simd_level = level < simd_cpu_level ? level : simd_cpu_level;
+    arnm_simd_avx2 = simd_level == ARNM_SIMD_AVX2;
+    return simd_level;
+}
+
+/* ============================================================
+ * f32x8
+ * ============================================================ */
+
+void arnm_f32x8_splat(ArnmF32x8* dst, double x) {
+    for (int i = 0; i < 8; i++) dst->lane[i] = (float)x;
+}
+
+double arnm_f32x8_get(const ArnmF32x8* v, int32_t i) {
+    return v->lane[i & 7];
+}
+
+void arnm_f32x8_set(ArnmF32x8* dst, const ArnmF32x8* v, int32_t i, double x) {
+    memmove(dst, v, sizeof(*dst));
+    dst->lane[i & 7] = (float)x;
+}
+
+void arnm_f32x8_op(ArnmF32x8* dst, const ArnmF32x8* a, const ArnmF32x8* b, int64_t op) {
+    DISPATCH(f32x8_op_avx2, f32x8_op_sse2, f32x8_op_scalar, dst->lane, a->lane, b->lane, op);
+}
+
+double arnm_f32x8_reduce(const ArnmF32x8* v, int64_t op) {
+    return DISPATCH(f32x8_reduce_avx2, f32x8_reduce_sse2, f32x8_reduce_scalar, v->lane, op);
+}
+
+void arnm_f32x8_shuffle(ArnmF32x8* dst, const ArnmF32x8* v, const ArnmI32x8* idx) {
+#if SIMD_X86
+    if (arnm_simd_avx2) {
+        f32x8_shuffle_avx2(dst->lane, v->lane, idx->lane);
+        return;
+    }
+#endif
+    ArnmF32x8 r;
+    for (int i = 0; i < 8; i++) r.lane[i] = v->lane[idx->lane[i] & 7];
+    *dst = r;
+}
+
+/* ============================================================
+ * i32x8
+ * ============================================================ */
+
+void arnm_i32x8_splat(ArnmI32x8* dst, int32_t x) {
+    for (int i = 0; i < 8; i++) dst->lane[i] = x;
+}
+
+int32_t arnm_i32x8_get(const ArnmI32x8* v, int32_t i) {
+    return v->lane[i & 7];
+}
+
+void arnm_i32x8_set(ArnmI32x8* dst, const ArnmI32x8* v, int32_t i, int32_t x) {
+    memmove(dst, v, sizeof(*dst));
+    dst->lane[i & 7] = x;
+}
+
+void arnm_i32x8_op(ArnmI32x8* dst, const ArnmI32x8* a, const ArnmI32x8* b, int64_t op) {
+    DISPATCH(i32x8_op_avx2, i32x8_op_sse2, i32x8_op_scalar, dst->lane, a->lane, b->lane, op);
+}
+
+int32_t arnm_i32x8_reduce(const ArnmI32x8* v, int64_t op) {
+    return DISPATCH(i32x8_reduce_avx2, i32x8_reduce_sse2, i32x8_reduce_scalar, v->lane, op);
+}
+
+void arnm_i32x8_shuffle(ArnmI32x8* dst, const ArnmI32x8* v, const ArnmI32x8* idx) {
+#if SIMD_X86
+    if (arnm_simd_avx2) {
+        i32x8_shuffle_avx2(dst->lane, v->lane, idx->lane);
+        return;
+    }
+#endif
+    ArnmI32x8 r;
+    for (int i = 0; i < 8; i++) r.lane[i] = v->lane[idx->lane[i] & 7];
+    *dst = r;
+}
+
+/* ============================================================
+ * f64x4
+ * ============================================================ */
+
+void arnm_f64x4_splat(ArnmF64x4* dst, double x) {
+    for (int i = 0; i < 4; i++) dst->lane[i] = x;
+}
+
+double arnm_f64x4_get(const ArnmF64x4* v, int32_t i) {
+    return v->lane[i & 3];
+}
+
+void arnm_f64x4_set(ArnmF64x4* dst, const ArnmF64x4* v, int32_t i, double x) {
+    memmove(dst, v, sizeof(*dst));
+    dst->lane[i & 3] = x;
+}
+
+void arnm_f64x4_op(ArnmF64x4* dst, const ArnmF64x4* a, const ArnmF64x4* b, int64_t op) {
+    DISPATCH(f64x4_op_avx2, f64x4_op_sse2, f64x4_op_scalar, dst->lane, a->lane, b->lane, op);
+}
+
+double arnm_f64x4_reduce(const ArnmF64x4* v, int64_t op) {
+    return DISPATCH(f64x4_reduce_avx2, f64x4_reduce_sse2, f64x4_reduce_scalar, v->lane, op);
+}
+
+void arnm_f64x4_shuffle(ArnmF64x4* dst, const ArnmF64x4* v, const ArnmI32x8* idx) {
+#if SIMD_X86
+    if (arnm_simd_avx2) {
+        f64x4_shuffle_avx2(dst->lane, v->lane, idx->lane);
+        return;
+    }
+#endif
+    ArnmF64x4 r;
+    for (int i = 0; i < 4; i++) r.lane[i] = v->lane[idx->lane[i] & 3];
+    *dst = r;
+}
@@ -0,0 +1,390 @@
+/*
+ * ARNm Runtime - Actor Snapshot Implementation
+ */
+
+#include "../include/snapshot.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
+#include "../include/mailbox.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* ============================================================
+ * Writer State
+ * ============================================================
+ * The file stays open and mapped between calls so consecutive
+ * snapshots to one path only append the actors that changed. Each
+ * time a file is (re)opened it gets a new generation; processes
+ * whose snap_gen doesn't match are written in full.
+ */
+
+typedef struct {
+    char        path[PATH_MAX];
+    int         fd;
+    uint8_t*    map;
+    size_t      map_size;
+    size_t      used;           /* Append position */
+    uint32_t    gen;
+} SnapWriter;
+
+static pthread_mutex_t snap_lock = PTHREAD_MUTEX_INITIALIZER;
+static SnapWriter g_writer = { .fd = -1 };
+static uint32_t g_next_gen = 1;
+
+static void writer_close(void) {
+    if (g_writer.map) munmap(g_writer.map, g_writer.map_size);
+    if (g_writer.fd >= 0) close(g_writer.fd);
+    g_writer.map = NULL;
+    g_writer.map_size = 0;
+    g_writer.fd = -1;
+    g_writer.path[0] = '\0';
+}
+
+static bool writer_open(const char* path) {
+    if (g_writer.fd >= 0 && strcmp(g_writer.path, path) == 0) return true;
+    writer_close();
+    if (strlen(path) >= sizeof(g_writer.path)) return false;
+
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    bool fresh = st.st_size == 0;
+    size_t size = fresh ? SNAP_GROW : (size_t)st.st_size;
+    if (fresh && ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return false;
+    }
+
+    uint8_t* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    SnapHeader* hdr = (SnapHeader*)map;
+    if (fresh) {
+        memset(hdr, 0, SNAP_HEADER_SIZE);
+        hdr->magic = SNAP_MAGIC;
+        hdr->version = SNAP_VERSION;
+        hdr->committed = SNAP_HEADER_SIZE;
+        hdr->epochs = 0;
+    } else if (size < SNAP_HEADER_SIZE || hdr->magic != SNAP_MAGIC ||
+               hdr->version != SNAP_VERSION || hdr->committed > size) {
+        fprintf(stderr, "[ARNM WARNING] %s is not a snapshot file\n", path);
+        munmap(map, size);
+        close(fd);
+        return false;
+    }
+
+    strcpy(g_writer.path, path);
+    g_writer.fd = fd;
+    g_writer.map = map;
+    g_writer.map_size = size;
+    g_writer.used = hdr->committed;     /* Drops any uncommitted tail */
+    g_writer.gen = g_next_gen++;
+    return true;
+}
+
+/* Make room for n more bytes at the append position */
+static bool writer_reserve(size_t n) {
+    if (g_writer.used + n <= g_writer.map_size) return true;
+
+    size_t size = g_writer.map_size;
+    while (size < g_writer.used + n) size += SNAP_GROW;
+
+    if (ftruncate(g_writer.fd, (off_t)size) != 0) return false;
+    uint8_t* map = mremap(g_writer.map, g_writer.map_size, size, MREMAP_MAYMOVE);
+    if (map == MAP_FAILED) return false;
+
+    g_writer.map = map;
+    g_writer.map_size = size;
+    return true;
+}
+
+static void writer_put(const void* src, size_t n) {
+    memcpy(g_writer.map + g_writer.used, src, n);
+    memset(g_writer.map + g_writer.used + n, 0, snap_pad(n) - n);
+    g_writer.used += snap_pad(n);
+}
+
+/* ============================================================
+ * Capturing Actors
+ * ============================================================ */
+
+static inline uint64_t fnv1a(uint64_t h, const void* data, size_t n) {
+    const uint8_t* p = data;
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ p[i]) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+typedef struct {
+    uint64_t    epoch;
+    uint32_t    written;
+    uint32_t    skipped;        /* Running or runnable, caught next time */
+    bool        failed;
+
+    /* Per-actor scratch */
+    uint64_t    hash;
+    size_t      bytes;
+    uint32_t    messages;
+    uint32_t    remaining;
+} SnapCtx;
+
+static void measure_message(const ArnmMessage* msg, void* arg) {
+    SnapCtx* ctx = arg;
+    uint64_t meta[2] = { msg->tag, msg->size };
+    ctx->hash = fnv1a(ctx->hash, meta, sizeof(meta));
+    ctx->hash = fnv1a(ctx->hash, msg->data, msg->size);
+    ctx->bytes += sizeof(SnapMessage) + snap_pad(msg->size);
+    ctx->messages++;
+}
+
+static void write_message(const ArnmMessage* msg, void* arg) {
+    SnapCtx* ctx = arg;
+    if (ctx->remaining == 0) return;    /* Arrived after we measured */
+    ctx->remaining--;
+
+    SnapMessage m = { msg->tag, msg->size };
+    writer_put(&m, sizeof(m));
+    if (msg->size) writer_put(msg->data, msg->size);
+}
+
+static void capture(ArnmProcess* proc, void* arg) {
+    SnapCtx* ctx = arg;
+    if (ctx->failed || proc->state == PROC_STATE_DEAD) return;
+
+    /* While workers run, only parked actors hold still long enough */
+    bool claimed = false;
+    if (sched_is_running()) {
+        if (!sched_claim(proc)) {
+            ctx->skipped++;
+            return;
+        }
+        claimed = true;
+    }
+
+    ctx->hash = fnv1a(0xcbf29ce484222325ull, &proc->state_size, sizeof(proc->state_size));
+    ctx->hash = fnv1a(ctx->hash, proc->actor_state, proc->state_size);
+    ctx->bytes = sizeof(SnapRecord) + snap_pad(proc->state_size);
+    ctx->messages = 0;
+    mailbox_visit(proc->mailbox, measure_message, ctx);
+    ctx->hash |= 1;     /* Never 0, so a fresh process always differs */
+
+    if (proc->snap_gen != g_writer.gen || proc->snap_hash != ctx->hash) {
+        if (writer_reserve(ctx->bytes)) {
+            SnapRecord rec = {
+                .kind = SNAP_ACTOR,
+                .messages = ctx->messages,
+                .pid = proc->pid,
+                .epoch = ctx->epoch,
+                .state_size = proc->state_size,
+                .length = ctx->bytes,
+            };
+            writer_put(&rec, sizeof(rec));
+            if (proc->state_size) writer_put(proc->actor_state, proc->state_size);
+            ctx->remaining = ctx->messages;
+            mailbox_visit(proc->mailbox, write_message, ctx);
+
+            proc->snap_hash = ctx->hash;
+            proc->snap_gen = g_writer.gen;
+            ctx->written++;
+        } else {
+            ctx->failed = true;
+        }
+    }
+
+    if (claimed) sched_unclaim(proc);
+}
+
+int arnm_snapshot(const char* path) {
+    if (!path) return -1;
+
+    pthread_mutex_lock(&snap_lock);
+    if (!writer_open(path)) {
+        pthread_mutex_unlock(&snap_lock);
+        return -1;
+    }
+
+    SnapHeader* hdr = (SnapHeader*)g_writer.map;
+    SnapCtx ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.epoch = hdr->epochs + 1;
+
+    size_t start = g_writer.used;
+    proc_table_foreach(capture, &ctx);
+
+    if (ctx.failed || (ctx.written > 0 && !writer_reserve(sizeof(SnapRecord)))) {
+        g_writer.used = start;
+        pthread_mutex_unlock(&snap_lock);
+        return -1;
+    }
+
+    if (ctx.written > 0) {
+        SnapRecord commit = {
+            .kind = SNAP_COMMIT,
+            .messages = ctx.written,
+            .epoch = ctx.epoch,
+            .length = sizeof(SnapRecord),
+        };
+        writer_put(&commit, sizeof(commit));
+
+        /* Records reach the file before the header points past them */
+        hdr = (SnapHeader*)g_writer.map;
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t from = start & ~(page - 1);
+        msync(g_writer.map + from, g_writer.used - from, MS_SYNC);
+
+        hdr->committed = g_writer.used;
+        hdr->epochs = ctx.epoch;
+        msync(g_writer.map, page, MS_SYNC);
+    }
+
+    pthread_mutex_unlock(&snap_lock);
+    return (int)ctx.written;
+}
+
+/* ============================================================
+ * Restoring
+ * ============================================================ */
+
+struct ArnmSnapshot {
+    uint8_t*    map;
+    size_t      size;
+    uint64_t*   keys;           /* Open-addressed pid -> record offset */
+    uint64_t*   offsets;
+    size_t      slots;          /* Power of two */
+    uint64_t*   pids;           /* Distinct pids, first-seen order */
+    size_t      count;
+};
+
+static size_t index_find(ArnmSnapshot* snap, uint64_t pid) {
+    size_t i = (size_t)(pid * 0x9E3779B97F4A7C15ull) & (snap->slots - 1);
+    while (snap->keys[i] != 0 && snap->keys[i] != pid) {
+        i = (i + 1) & (snap->slots - 1);
+    }
+    return i;
+}
+
+ArnmSnapshot* arnm_snapshot_open(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < SNAP_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+
+    uint8_t* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    const SnapHeader* hdr = (const SnapHeader*)map;
+    if (hdr->magic != SNAP_MAGIC || hdr->version != SNAP_VERSION ||
+        hdr->committed > (uint64_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+
+    ArnmSnapshot* snap = calloc(1, sizeof(ArnmSnapshot));
+    if (!snap) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    snap->map = map;
+    snap->size = (size_t)st.st_size;
+
+    /* Sized for the worst case: every record a distinct actor */
+    size_t records = (hdr->committed - SNAP_HEADER_SIZE) / sizeof(SnapRecord);
+    snap->slots = 16;
+    while (snap->slots < records * 2) snap->slots <<= 1;
+    snap->keys = calloc(snap->slots, sizeof(uint64_t));
+    snap->offsets = calloc(snap->slots, sizeof(uint64_t));
+    snap->pids = calloc(records + 1, sizeof(uint64_t));
+    if (!snap->keys || !snap->offsets || !snap->pids) {
+        arnm_snapshot_close(snap);
+        return NULL;
+    }
+
+    /* Later records overwrite earlier ones for the same pid */
+    size_t pos = SNAP_HEADER_SIZE;
+    while (pos + sizeof(SnapRecord) <= hdr->committed) {
+        const SnapRecord* rec = (const SnapRecord*)(map + pos);
+        if (rec->length < sizeof(SnapRecord) || rec->length > hdr->committed - pos) break;
+
+        if (rec->kind == SNAP_ACTOR && rec->pid != 0) {
+            size_t i = index_find(snap, rec->pid);
+            if (snap->keys[i] == 0) {
+                snap->keys[i] = rec->pid;
+                snap->pids[snap->count++] = rec->pid;
+            }
+            snap->offsets[i] = pos;
+        }
+        pos += rec->length;
+    }
+
+    return snap;
+}
+
+void arnm_snapshot_close(ArnmSnapshot* snap) {
+    if (!snap) return;
+    munmap(snap->map, snap->size);
+    free(snap->keys);
+    free(snap->offsets);
+    free(snap->pids);
+    free(snap);
+}
+
+size_t arnm_snapshot_count(ArnmSnapshot* snap) {
+    return snap ? snap->count : 0;
+}
+
+uint64_t arnm_snapshot_pid(ArnmSnapshot* snap, size_t index) {
+    return snap && index < snap->count ? snap->pids[index] : 0;
+}
+
+ArnmProcess* arnm_snapshot_restore(ArnmSnapshot* snap, uint64_t pid,
+                                   void (*entry)(void*), void* arg) {
+    if (!snap || pid == 0) return NULL;
+
+    size_t i = index_find(snap, pid);
+    if (snap->keys[i] != pid) return NULL;
+
+    const uint8_t* p = snap->map + snap->offsets[i];
+    const SnapRecord* rec = (const SnapRecord*)p;
+    p += sizeof(SnapRecord);
+
+    ArnmProcess* proc = proc_create_on(entry, arg, ARNM_DEFAULT_STACK_SIZE,
+                                       rec->state_size, -1);
+    if (!proc) return NULL;
+
+    /* State and messages are copied straight out of the mapping */
+    if (rec->state_size) {
+        memcpy(proc->actor_state, p, rec->state_size);
+        p += snap_pad(rec->state_size);
+    }
+    for (uint32_t m = 0; m < rec->messages; m++) {
+        const SnapMessage* msg = (const SnapMessage*)p;
+        p += sizeof(SnapMessage);
+        mailbox_send(proc->mailbox, msg->tag, msg->size ? (void*)p : NULL, msg->size);
+        p += snap_pad(msg->size);
+    }
+
+    sched_enqueue(proc);
+    return proc;
+}
@@ -5,10 +5,95 @@
 #include "../include/sync.h"
 #include "../include/process.h"
 #include "../include/scheduler.h"
+#include "../include/mailbox.h"
+#include "../include/trace.h"
 #include "../include/arnm.h"
 #include <stdlib.h>
 #include <stdio.h>
 
+/* ============================================================
+ * Wait Queues
+ * ============================================================ */
+
+/* Caller holds the owning lock */
+static void waitq_push(ArnmWaitQueue* q, ArnmWaiter* w) {
+    w->next = NULL;
+    w->prev = q->tail;
+    if (q->tail) q->tail->next = w;
+    else q->head = w;
+    q->tail = w;
+    atomic_store(&w->listed, true);
+}
+
+static void waitq_remove(ArnmWaitQueue* q, ArnmWaiter* w) {
+    if (w->prev) w->prev->next = w->next;
+    else q->head = w->next;
+    if (w->next) w->next->prev = w->prev;
+    else q->tail = w->prev;
+    atomic_store(&w->listed, false);
+}
+
+/* Unlist and notify the oldest waiter, or all of them */
+static void waitq_wake(ArnmWaitQueue* q, bool all) {
+    while (q->head) {
+        ArnmWaiter* w = q->head;
+        waitq_remove(q, w);
+        sched_notify(w->proc);
+        if (!all) break;
+    }
+}
+
+/*
+ * Park the calling process until attempt(obj) succeeds. The process
+ * lists itself, retries once (a wake before it was listed reached no
+ * one), then parks; a waker unlists what it wakes, so a process that
+ * still fails lists itself again at the back.
+ */
+static void park_until(pthread_spinlock_t* lock, ArnmWaitQueue* q,
+                       bool (*attempt)(void*), void* obj) {
+    ArnmProcess* self = proc_current();
+    ArnmWaiter w = { .proc = self };
+    atomic_init(&w.listed, false);
+    bool waited = false;
+    
+    for (;;) {
+        if (self) atomic_store(&self->notified, false);
+        if (attempt(obj)) break;
+        
+        if (!self) {
+            /* Not in a process context, spin wait */
+            for (volatile int i = 0; i < 1000; i++) { }
+            continue;
+        }
+        
+        if (!atomic_load(&w.listed)) {
+            pthread_spin_lock(lock);
+            waitq_push(q, &w);
+            pthread_spin_unlock(lock);
+            atomic_store(&self->mailbox_wait, false);
+            waited = true;
+            continue;
+        }
+        
+        /* Switch out; the worker parks us once our context is saved */
+        proc_wait(self);
+        arnm_sched_yield();
+    }
+    
+    if (!waited) return;
+    
+    pthread_spin_lock(lock);
+    if (atomic_load(&w.listed)) {
+        waitq_remove(q, &w);
+    } else {
+        /* A wake meant for us may have been for a release we did not need: pass it on */
+        waitq_wake(q, false);
+    }
+    pthread_spin_unlock(lock);
+    atomic_store(&self->notified, false);
+    atomic_store(&self->mailbox_wait, true);
+}
+
 /* ============================================================
  * Mutex Implementation
  * ============================================================ */
@@ -102,6 +187,7 @@ ArnmChannel* arnm_channel_create(size_t capacity) {
     atomic_init(&chan->tail, 0);
     atomic_init(&chan->count, 0);
     atomic_init(&chan->closed, false);
+    chan->waiters = NULL;
     pthread_spin_init(&chan->lock, PTHREAD_PROCESS_PRIVATE);
     
     return chan;
@@ -110,18 +196,29 @@ ArnmChannel* arnm_channel_create(size_t capacity) {
 void arnm_channel_destroy(ArnmChannel* chan) {
     if (!chan) return;
     
+    if (chan->waiters) {
+        fprintf(stderr, "[ARNM WARNING] Destroying channel with blocked processes\n");
+    }
+    
     pthread_spin_destroy(&chan->lock);
     free(chan->buffer);
     free(chan);
 }
 
+/* Wake every process blocked on the channel; caller holds chan->lock */
+static void chan_notify(ArnmChannel* chan) {
+    for (ArnmWaiter* w = chan->waiters; w; w = w->next) {
+        sched_notify(w->proc);
+    }
+}
+
 bool arnm_channel_try_send(ArnmChannel* chan, void* data) {
     if (!chan || atomic_load(&chan->closed)) return false;
     
     pthread_spin_lock(&chan->lock);
     
     size_t count = atomic_load(&chan->count);
-    if (count >= chan->capacity) {
+    if (count >= chan->capacity || atomic_load(&chan->closed)) {
         pthread_spin_unlock(&chan->lock);
         return false;
     }
@@ -130,63 +227,64 @@ bool arnm_channel_try_send(ArnmChannel* chan, void* data) {
     chan->buffer[tail] = data;
     atomic_store(&chan->tail, (tail + 1) % chan->capacity);
     atomic_fetch_add(&chan->count, 1);
+    chan_notify(chan);
     
     pthread_spin_unlock(&chan->lock);
     return true;
 }
 
-bool arnm_channel_send(ArnmChannel* chan, void* data) {
-    if (!chan) return false;
-    
-    while (!arnm_channel_try_send(chan, data)) {
-        if (atomic_load(&chan->closed)) {
-            return false;
-        }
-        arnm_yield();
-    }
-    
-    return true;
-}
-
-void* arnm_channel_try_receive(ArnmChannel* chan) {
-    if (!chan) return NULL;
-    
+/* Take one value: 1 = taken, 0 = empty, -1 = closed and drained */
+static int chan_take(ArnmChannel* chan, void** out) {
     pthread_spin_lock(&chan->lock);
     
     size_t count = atomic_load(&chan->count);
     if (count == 0) {
+        bool closed = atomic_load(&chan->closed);
         pthread_spin_unlock(&chan->lock);
-        return NULL;
+        *out = NULL;
+        return closed ? -1 : 0;
     }
     
     size_t head = atomic_load(&chan->head);
-    void* data = chan->buffer[head];
+    *out = chan->buffer[head];
     chan->buffer[head] = NULL;
     atomic_store(&chan->head, (head + 1) % chan->capacity);
     atomic_fetch_sub(&chan->count, 1);
+    chan_notify(chan);
     
     pthread_spin_unlock(&chan->lock);
-    return data;
+    return 1;
 }
 
-void* arnm_channel_receive(ArnmChannel* chan) {
+void* arnm_channel_try_receive(ArnmChannel* chan) {
     if (!chan) return NULL;
     
     void* data;
-    while ((data = arnm_channel_try_receive(chan)) == NULL) {
-        if (atomic_load(&chan->closed)) {
-            return NULL;
-        }
-        arnm_yield();
-    }
-    
+    chan_take(chan, &data);
     return data;
 }
 
+bool arnm_channel_send(ArnmChannel* chan, void* data) {
+    if (!chan) return false;
+    
+    ArnmSelectCase c = { .kind = ARNM_SELECT_SEND, .chan = chan, .data = data };
+    return arnm_select(&c, 1) == 0;
+}
+
+void* arnm_channel_receive(ArnmChannel* chan) {
+    if (!chan) return NULL;
+    
+    ArnmSelectCase c = { .kind = ARNM_SELECT_RECV, .chan = chan };
+    return arnm_select(&c, 1) == 0 ? c.data : NULL;
+}
+
 void arnm_channel_close(ArnmChannel* chan) {
-    if (chan) {
-        atomic_store(&chan->closed, true);
-    }
+    if (!chan) return;
+    
+    pthread_spin_lock(&chan->lock);
+    atomic_store(&chan->closed, true);
+    chan_notify(chan);
+    pthread_spin_unlock(&chan->lock);
 }
 
 bool arnm_channel_is_closed(ArnmChannel* chan) {
@@ -197,6 +295,369 @@ size_t arnm_channel_count(ArnmChannel* chan) {
     return chan ? atomic_load(&chan->count) : 0;
 }
 
+/* ============================================================
+ * Select Implementation
+ * ============================================================ */
+
+static _Thread_local uint32_t select_rotor;    /* Rotating poll start */
+static _Thread_local int64_t select_value;     /* For arnm_select_value */
+
+/*
+ * Complete the first ready case, polling from a rotating start.
+ * Returns its index, or -1 with *live telling whether any case could
+ * still become ready later.
+ */
+static int select_poll(ArnmProcess* self, ArnmSelectCase* cases, size_t count, bool* live) {
+    size_t start = select_rotor++ % count;
+    *live = false;
+    
+    for (size_t k = 0; k < count; k++) {
+        size_t i = start + k;
+        if (i >= count) i -= count;
+        ArnmSelectCase* c = &cases[i];
+        
+        switch (c->kind) {
+            case ARNM_SELECT_RECV: {
+                if (!c->chan) break;
+                *live = true;
+                int r = chan_take(c->chan, &c->data);
+                if (r != 0) {
+                    c->ok = r > 0;
+                    return (int)i;
+                }
+                break;
+            }
+            case ARNM_SELECT_SEND:
+                if (!c->chan || atomic_load(&c->chan->closed)) break;
+                *live = true;
+                if (arnm_channel_try_send(c->chan, c->data)) return (int)i;
+                break;
+            case ARNM_SELECT_MAILBOX:
+                if (!self || !self->mailbox) break;
+                *live = true;
+                c->msg = mailbox_try_receive(self->mailbox);
+                if (c->msg) {
+                    trace_recv(c->msg);
+                    return (int)i;
+                }
+                break;
+        }
+    }
+    return -1;
+}
+
+/* List (or unlist) self as a waiter on every channel in the set */
+static void select_register(ArnmProcess* self, ArnmSelectCase* cases, size_t count,
+                            ArnmWaiter* waiters, bool add) {
+    for (size_t i = 0; i < count; i++) {
+        ArnmChannel* chan = cases[i].chan;
+        if (cases[i].kind == ARNM_SELECT_MAILBOX || !chan) continue;
+        
+        ArnmWaiter* w = &waiters[i];
+        pthread_spin_lock(&chan->lock);
+        if (add) {
+            w->proc = self;
+            w->prev = NULL;
+            w->next = chan->waiters;
+            if (w->next) w->next->prev = w;
+            chan->waiters = w;
+        } else {
+            if (w->prev) w->prev->next = w->next;
+            else chan->waiters = w->next;
+            if (w->next) w->next->prev = w->prev;
+        }
+        pthread_spin_unlock(&chan->lock);
+    }
+}
+
+static int select_run(ArnmSelectCase* cases, size_t count, bool block) {
+    if (!cases || count == 0 || count > ARNM_SELECT_MAX) return -1;
+    
+    ArnmProcess* self = proc_current();
+    ArnmWaiter waiters[ARNM_SELECT_MAX];
+    bool registered = false;
+    bool live;
+    int ready;
+    
+    /* Quantum used up: give the worker back but stay runnable */
+    if (self && self->reductions == 0) {
+        arnm_sched_yield();
+    }
+    
+    bool with_mailbox = false;
+    for (size_t i = 0; i < count; i++) {
+        if (cases[i].kind == ARNM_SELECT_MAILBOX) with_mailbox = true;
+    }
+    
+    for (;;) {
+        if (self) atomic_store(&self->notified, false);
+        ready = select_poll(self, cases, count, &live);
+        if (ready >= 0 || !live || !block) break;
+        
+        if (!self) {
+            /* Not in a process context, spin wait */
+            for (volatile int i = 0; i < 1000; i++) { }
+            continue;
+        }
+        
+        if (!registered) {
+            /* Poll once more once listed: a change before that notified no one */
+            atomic_store(&self->mailbox_wait, with_mailbox);
+            select_register(self, cases, count, waiters, true);
+            registered = true;
+            continue;
+        }
+        
+        /* Switch out; the worker parks us once our context is saved */
+        proc_wait(self);
+        arnm_sched_yield();
+    }
+    
+    if (registered) {
+        /* Unlisted first: after this no one can raise notified again */
+        select_register(self, cases, count, waiters, false);
+        atomic_store(&self->notified, false);
+        atomic_store(&self->mailbox_wait, true);
+    }
+    if (self && ready >= 0 && self->reductions > 0) {
+        self->reductions--;
+    }
+    return ready;
+}
+
+int arnm_select(ArnmSelectCase* cases, size_t count) {
+    return select_run(cases, count, true);
+}
+
+int arnm_select_try(ArnmSelectCase* cases, size_t count) {
+    return select_run(cases, count, false);
+}
+
+int64_t arnm_select_recv4(ArnmChannel* c0, ArnmChannel* c1, ArnmChannel* c2,
+                          ArnmChannel* c3, int64_t with_mailbox) {
+    ArnmChannel* chans[4] = { c0, c1, c2, c3 };
+    ArnmSelectCase cases[5];
+    int64_t arms[5];
+    size_t n = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        if (!chans[i]) continue;
+        cases[n] = (ArnmSelectCase){ .kind = ARNM_SELECT_RECV, .chan = chans[i] };
+        arms[n++] = i;
+    }
+    if (with_mailbox) {
+        cases[n] = (ArnmSelectCase){ .kind = ARNM_SELECT_MAILBOX };
+        arms[n++] = 4;
+    }
+    
+    for (;;) {
+        int ready = arnm_select(cases, n);
+        if (ready < 0) return -1;
+        
+        ArnmSelectCase* c = &cases[ready];
+        if (c->kind == ARNM_SELECT_MAILBOX) {
+            select_value = (int64_t)c->msg->tag;
+            message_free(c->msg);
+        } else if (!c->ok) {
+            /* Closed and drained: that arm can never fire again */
+            c->chan = NULL;
+            continue;
+        } else {
+            select_value = (int64_t)(intptr_t)c->data;
+        }
+        return arms[ready];
+    }
+}
+
+int64_t arnm_select_value(void) {
+    return select_value;
+}
+
+/* ============================================================
+ * Reader-Writer Lock Implementation
+ * ============================================================ */
+
+ArnmRwLock* arnm_rwlock_create(void) {
+    ArnmRwLock* rw = (ArnmRwLock*)aligned_alloc(64, sizeof(ArnmRwLock));
+    if (!rw) return NULL;
+    
+    for (int i = 0; i < ARNM_RWLOCK_SLOTS; i++) {
+        atomic_init(&rw->slots[i].readers, 0);
+    }
+    atomic_init(&rw->writer, false);
+    pthread_spin_init(&rw->lock, PTHREAD_PROCESS_PRIVATE);
+    rw->read_waiters = (ArnmWaitQueue){ NULL, NULL };
+    rw->write_waiters = (ArnmWaitQueue){ NULL, NULL };
+    rw->drain_waiters = (ArnmWaitQueue){ NULL, NULL };
+    
+    return rw;
+}
+
+void arnm_rwlock_destroy(ArnmRwLock* rw) {
+    if (!rw) return;
+    
+    if (atomic_load(&rw->writer)) {
+        fprintf(stderr, "[ARNM WARNING] Destroying write-locked rwlock\n");
+    }
+    
+    pthread_spin_destroy(&rw->lock);
+    free(rw);
+}
+
+static atomic_long* rw_slot(ArnmRwLock* rw) {
+    ArnmWorker* worker = sched_current_worker();
+    return &rw->slots[worker ? worker->id : ARNM_RWLOCK_SLOTS - 1].readers;
+}
+
+static long rw_reader_count(ArnmRwLock* rw) {
+    long sum = 0;
+    for (int i = 0; i < ARNM_RWLOCK_SLOTS; i++) {
+        sum += atomic_load(&rw->slots[i].readers);
+    }
+    return sum;
+}
+
+/* Tell a draining writer the reader count dropped */
+static void rw_reader_left(ArnmRwLock* rw) {
+    if (!atomic_load(&rw->writer)) return;
+    pthread_spin_lock(&rw->lock);
+    waitq_wake(&rw->drain_waiters, true);
+    pthread_spin_unlock(&rw->lock);
+}
+
+static bool rw_try_read(void* obj) {
+    ArnmRwLock* rw = (ArnmRwLock*)obj;
+    if (atomic_load(&rw->writer)) return false;
+    
+    /*
+     * Count ourselves, then look for a writer again. The writer raises
+     * its flag before summing the slots (both seq_cst), so either it
+     * sees our count or we see its flag and back out.
+     */
+    atomic_long* slot = rw_slot(rw);
+    atomic_fetch_add(slot, 1);
+    if (!atomic_load(&rw->writer)) return true;
+    
+    atomic_fetch_sub(slot, 1);
+    rw_reader_left(rw);
+    return false;
+}
+
+static bool rw_try_claim(void* obj) {
+    ArnmRwLock* rw = (ArnmRwLock*)obj;
+    bool expected = false;
+    return atomic_compare_exchange_strong(&rw->writer, &expected, true);
+}
+
+static bool rw_drained(void* obj) {
+    return rw_reader_count((ArnmRwLock*)obj) == 0;
+}
+
+void arnm_rwlock_read_lock(ArnmRwLock* rw) {
+    if (!rw) return;
+    if (rw_try_read(rw)) return;
+    park_until(&rw->lock, &rw->read_waiters, rw_try_read, rw);
+}
+
+bool arnm_rwlock_try_read_lock(ArnmRwLock* rw) {
+    return rw ? rw_try_read(rw) : false;
+}
+
+void arnm_rwlock_read_unlock(ArnmRwLock* rw) {
+    if (!rw) return;
+    atomic_fetch_sub(rw_slot(rw), 1);
+    rw_reader_left(rw);
+}
+
+void arnm_rwlock_write_lock(ArnmRwLock* rw) {
+    if (!rw) return;
+    
+    /* The flag first: from here on new readers wait */
+    if (!rw_try_claim(rw)) {
+        park_until(&rw->lock, &rw->write_waiters, rw_try_claim, rw);
+    }
+    if (!rw_drained(rw)) {
+        park_until(&rw->lock, &rw->drain_waiters, rw_drained, rw);
+    }
+}
+
+bool arnm_rwlock_try_write_lock(ArnmRwLock* rw) {
+    if (!rw || !rw_try_claim(rw)) return false;
+    if (rw_drained(rw)) return true;
+    arnm_rwlock_write_unlock(rw);
+    return false;
+}
+
+void arnm_rwlock_write_unlock(ArnmRwLock* rw) {
+    if (!rw) return;
+    
+    atomic_store(&rw->writer, false);
+    pthread_spin_lock(&rw->lock);
+    waitq_wake(&rw->read_waiters, true);
+    waitq_wake(&rw->write_waiters, false);
+    pthread_spin_unlock(&rw->lock);
+}
+
+/* ============================================================
+ * Semaphore Implementation
+ * ============================================================ */
+
+ArnmSemaphore* arnm_semaphore_create(long permits) {
+    if (permits < 0) return NULL;
+    
+    ArnmSemaphore* sem = (ArnmSemaphore*)malloc(sizeof(ArnmSemaphore));
+    if (!sem) return NULL;
+    
+    atomic_init(&sem->permits, permits);
+    pthread_spin_init(&sem->lock, PTHREAD_PROCESS_PRIVATE);
+    sem->waiters = (ArnmWaitQueue){ NULL, NULL };
+    
+    return sem;
+}
+
+void arnm_semaphore_destroy(ArnmSemaphore* sem) {
+    if (!sem) return;
+    
+    if (sem->waiters.head) {
+        fprintf(stderr, "[ARNM WARNING] Destroying semaphore with blocked processes\n");
+    }
+    
+    pthread_spin_destroy(&sem->lock);
+    free(sem);
+}
+
+static bool sem_try_take(void* obj) {
+    ArnmSemaphore* sem = (ArnmSemaphore*)obj;
+    long n = atomic_load(&sem->permits);
+    while (n > 0) {
+        if (atomic_compare_exchange_weak(&sem->permits, &n, n - 1)) return true;
+    }
+    return false;
+}
+
+void arnm_semaphore_acquire(ArnmSemaphore* sem) {
+    if (!sem) return;
+    if (sem_try_take(sem)) return;
+    park_until(&sem->lock, &sem->waiters, sem_try_take, sem);
+}
+
+bool arnm_semaphore_try_acquire(ArnmSemaphore* sem) {
+    return sem ? sem_try_take(sem) : false;
+}
+
+void arnm_semaphore_release(ArnmSemaphore* sem) {
+    if (!sem) return;
+    
+    atomic_fetch_add(&sem->permits, 1);
+    pthread_spin_lock(&sem->lock);
+    waitq_wake(&sem->waiters, false);
+    pthread_spin_unlock(&sem->lock);
+}
+
+long arnm_semaphore_available(ArnmSemaphore* sem) {
+    return sem ? atomic_load(&sem->permits) : 0;
+}
+
 /* ============================================================
  * Barrier Implementation
  * ============================================================ */
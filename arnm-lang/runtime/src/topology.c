@@ -0,0 +1,192 @@
+/*
+ * ARNm Runtime - CPU/NUMA Topology Implementation
+ */
+
+#include "../include/topology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/* mbind(2) policy; defined here so we don't depend on libnuma headers */
+#define TOPO_MPOL_PREFERRED 1
+
+/* ============================================================
+ * Discovery
+ * ============================================================ */
+
+static ArnmTopology g_topo;
+static bool g_topo_ready = false;
+
+/* Parse a sysfs cpulist ("0-3,8,10-11") and tag each CPU with node */
+static uint32_t parse_cpulist(const char* list, int16_t node) {
+    uint32_t count = 0;
+    const char* p = list;
+
+    while (*p) {
+        char* end;
+        long lo = strtol(p, &end, 10);
+        if (end == p) break;
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long cpu = lo; cpu <= hi && cpu < TOPO_MAX_CPUS; cpu++) {
+            if (cpu >= 0 && g_topo.cpu_node[cpu] < 0) {
+                g_topo.cpu_node[cpu] = node;
+                count++;
+            }
+        }
+        if (*p == ',') p++;
+        else break;
+    }
+
+    return count;
+}
+
+static void topo_single_node(void) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) ncpu = 1;
+    if (ncpu > TOPO_MAX_CPUS) ncpu = TOPO_MAX_CPUS;
+
+    for (long i = 0; i < ncpu; i++) {
+        g_topo.cpu_node[i] = 0;
+    }
+    g_topo.num_nodes = 1;
+    g_topo.num_cpus = (uint32_t)ncpu;
+    g_topo.node_cpu_count[0] = (uint32_t)ncpu;
+    g_topo.node_id[0] = 0;
+}
+
+void topo_init(void) {
+    if (g_topo_ready) return;
+
+    memset(&g_topo, 0, sizeof(g_topo));
+    for (int i = 0; i < TOPO_MAX_CPUS; i++) {
+        g_topo.cpu_node[i] = -1;
+    }
+
+    /* Node ids may be sparse; compact them into dense indices */
+    char path[96];
+    char buf[4096];
+    for (int id = 0; id < TOPO_MAX_NODES; id++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", id);
+        FILE* f = fopen(path, "r");
+        if (!f) continue;
+
+        size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+        fclose(f);
+        buf[n] = '\0';
+
+        uint32_t dense = g_topo.num_nodes;
+        uint32_t cpus = parse_cpulist(buf, (int16_t)dense);
+        if (cpus == 0) continue;    /* Memory-only node */
+
+        g_topo.node_id[dense] = id;
+        g_topo.node_cpu_count[dense] = cpus;
+        g_topo.num_cpus += cpus;
+        g_topo.num_nodes++;
+    }
+
+    if (g_topo.num_nodes == 0) {
+        topo_single_node();
+    }
+
+    g_topo_ready = true;
+}
+
+const ArnmTopology* topo_get(void) {
+    topo_init();
+    return &g_topo;
+}
+
+uint32_t topo_num_nodes(void) {
+    topo_init();
+    return g_topo.num_nodes;
+}
+
+uint32_t topo_node_of_cpu(int cpu) {
+    topo_init();
+    if (cpu < 0 || cpu >= TOPO_MAX_CPUS || g_topo.cpu_node[cpu] < 0) {
+        return 0;
+    }
+    return (uint32_t)g_topo.cpu_node[cpu];
+}
+
+uint32_t topo_current_node(void) {
+    if (g_topo.num_nodes <= 1) return 0;
+    return topo_node_of_cpu(sched_getcpu());
+}
+
+/* ============================================================
+ * Worker Placement
+ * ============================================================ */
+
+int topo_cpu_for_worker(uint32_t worker_id, uint32_t* node) {
+    topo_init();
+
+    uint32_t n = worker_id % g_topo.num_nodes;
+    uint32_t nth = (worker_id / g_topo.num_nodes) % g_topo.node_cpu_count[n];
+    if (node) *node = n;
+
+    for (int cpu = 0; cpu < TOPO_MAX_CPUS; cpu++) {
+        if (g_topo.cpu_node[cpu] == (int16_t)n) {
+            if (nth == 0) return cpu;
+            nth--;
+        }
+    }
+
+    return -1;
+}
+
+bool topo_pin_thread(int cpu) {
+    if (cpu < 0) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+/* ============================================================
+ * Node-Local Pages
+ * ============================================================ */
+
+void topo_bind_pages(void* ptr, size_t size, int node) {
+    if (!ptr || node < 0 || g_topo.num_nodes <= 1) return;
+    if ((uint32_t)node >= g_topo.num_nodes) return;
+
+    unsigned long mask[TOPO_MAX_NODES / (8 * sizeof(unsigned long)) + 1];
+    memset(mask, 0, sizeof(mask));
+    int id = g_topo.node_id[node];
+    mask[id / (8 * sizeof(unsigned long))] |= 1UL << (id % (8 * sizeof(unsigned long)));
+
+    /* Best effort: containers commonly deny mbind, first-touch still applies */
+    syscall(SYS_mbind, ptr, size, TOPO_MPOL_PREFERRED, mask,
+            (unsigned long)(sizeof(mask) * 8), 0);
+}
+
+void* topo_alloc_pages(size_t size, int node) {
+    void* mem = mmap(NULL, size,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS,
+                     -1, 0);
+    if (mem == MAP_FAILED) {
+        return NULL;
+    }
+
+    topo_bind_pages(mem, size, node);
+    return mem;
+}
+
+void topo_free_pages(void* ptr, size_t size) {
+    if (ptr) {
+        munmap(ptr, size);
+    }
+}
@@ -0,0 +1,607 @@
+/*
+ * ARNm Runtime - Message Tracing Implementation
+ */
+
+#include "../include/trace.h"
+#include "../include/process.h"
+#include "../include/scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+atomic_bool g_trace_capture = false;
+atomic_bool g_trace_stamp = false;
+
+/* ============================================================
+ * Capture Buffers
+ * ============================================================
+ * A thread gets a buffer on its first record and keeps it for the
+ * rest of the capture. Buffers are also chained on a list so that
+ * arnm_trace_stop can write out whatever is left in each of them.
+ * A new capture bumps trace_gen, which makes threads drop the
+ * buffer they cached from the previous one.
+ */
+
+typedef struct TraceBuffer {
+    uint8_t             data[TRACE_BUFFER_SIZE];
+    size_t              used;
+    struct TraceBuffer* next;       /* All buffers of this capture */
+} TraceBuffer;
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static int trace_fd = -1;
+static uint64_t trace_start_ns;
+static TraceBuffer* trace_buffers;
+static _Atomic uint32_t trace_gen;
+static atomic_uint_fast64_t outside_seq;     /* Event order for pid 0 */
+
+static _Thread_local TraceBuffer* tls_buffer = NULL;
+static _Thread_local uint32_t tls_gen = 0;
+
+static bool write_all(int fd, const void* buf, size_t len) {
+    const uint8_t* p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static TraceBuffer* thread_buffer(void) {
+    uint32_t gen = atomic_load(&trace_gen);
+    if (tls_buffer && tls_gen == gen) return tls_buffer;
+
+    TraceBuffer* buf = calloc(1, sizeof(TraceBuffer));
+    if (!buf) return NULL;
+
+    pthread_mutex_lock(&trace_lock);
+    buf->next = trace_buffers;
+    trace_buffers = buf;
+    pthread_mutex_unlock(&trace_lock);
+
+    tls_buffer = buf;
+    tls_gen = gen;
+    return buf;
+}
+
+/* Caller holds trace_lock */
+static void buffer_write_locked(TraceBuffer* buf) {
+    if (buf->used && trace_fd >= 0 && !write_all(trace_fd, buf->data, buf->used)) {
+        fprintf(stderr, "[ARNM WARNING] Trace write failed, capture truncated\n");
+        close(trace_fd);
+        trace_fd = -1;
+    }
+    buf->used = 0;
+}
+
+static void trace_put(const TraceRecord* rec, const void* payload) {
+    TraceBuffer* buf = thread_buffer();
+    if (!buf) return;
+
+    size_t extra = payload ? trace_pad(rec->size) : 0;
+    size_t need = sizeof(TraceRecord) + extra;
+
+    if (buf->used + need > TRACE_BUFFER_SIZE) {
+        pthread_mutex_lock(&trace_lock);
+        buffer_write_locked(buf);
+        pthread_mutex_unlock(&trace_lock);
+    }
+
+    if (need > TRACE_BUFFER_SIZE) {
+        /* Oversized payload: straight to the file after the buffered records */
+        static const uint8_t zeros[8];
+        pthread_mutex_lock(&trace_lock);
+        if (trace_fd >= 0) {
+            write_all(trace_fd, rec, sizeof(TraceRecord));
+            write_all(trace_fd, payload, rec->size);
+            write_all(trace_fd, zeros, extra - rec->size);
+        }
+        pthread_mutex_unlock(&trace_lock);
+        return;
+    }
+
+    memcpy(buf->data + buf->used, rec, sizeof(TraceRecord));
+    if (extra) {
+        memcpy(buf->data + buf->used + sizeof(TraceRecord), payload, rec->size);
+        memset(buf->data + buf->used + sizeof(TraceRecord) + rec->size, 0, extra - rec->size);
+    }
+    buf->used += need;
+}
+
+/* Fill in who is recording and when */
+static void trace_stamp(TraceRecord* rec) {
+    ArnmProcess* proc = proc_current();
+    if (proc) {
+        rec->pid = proc->pid;
+        rec->seq = proc->trace_seq++;
+    } else {
+        rec->pid = 0;
+        rec->seq = atomic_fetch_add(&outside_seq, 1);
+    }
+    rec->time = sched_clock_ns() - trace_start_ns;
+}
+
+/* ============================================================
+ * Capture Hooks
+ * ============================================================ */
+
+void trace_spawn(uint64_t child) {
+    if (!trace_capturing()) return;
+
+    TraceRecord rec = { .kind = TRACE_SPAWN, .peer = child };
+    trace_stamp(&rec);
+    trace_put(&rec, NULL);
+}
+
+void trace_send(uint64_t target, uint64_t tag, const void* data, size_t size) {
+    if (!trace_capturing()) return;
+
+    TraceRecord rec = {
+        .kind = TRACE_SEND,
+        .size = (uint32_t)size,
+        .peer = target,
+        .tag = tag,
+    };
+    trace_stamp(&rec);
+    trace_put(&rec, data && size ? data : NULL);
+}
+
+void trace_recv(const ArnmMessage* msg) {
+    if (!trace_capturing() || !msg) return;
+
+    TraceRecord rec = {
+        .kind = TRACE_RECV,
+        .size = (uint32_t)msg->size,
+        .tag = msg->tag,
+    };
+    trace_stamp(&rec);
+    rec.peer = msg->sent_at ? rec.time + trace_start_ns - msg->sent_at : 0;
+    trace_put(&rec, NULL);
+}
+
+/* ============================================================
+ * Capture Lifecycle
+ * ============================================================ */
+
+int arnm_trace_start(const char* path) {
+    if (!path) return -1;
+
+    pthread_mutex_lock(&trace_lock);
+    if (trace_fd >= 0) {
+        pthread_mutex_unlock(&trace_lock);
+        return -1;
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        pthread_mutex_unlock(&trace_lock);
+        return -1;
+    }
+
+    trace_start_ns = sched_clock_ns();
+    TraceHeader hdr = {
+        .magic = TRACE_MAGIC,
+        .version = TRACE_VERSION,
+        .start_ns = trace_start_ns,
+    };
+    if (!write_all(fd, &hdr, sizeof(hdr))) {
+        close(fd);
+        pthread_mutex_unlock(&trace_lock);
+        return -1;
+    }
+
+    trace_fd = fd;
+    atomic_store(&outside_seq, 0);
+    atomic_fetch_add(&trace_gen, 1);
+    pthread_mutex_unlock(&trace_lock);
+
+    atomic_store(&g_trace_stamp, true);
+    atomic_store(&g_trace_capture, true);
+    return 0;
+}
+
+void arnm_trace_stop(void) {
+    if (!atomic_exchange(&g_trace_capture, false)) return;
+    atomic_store(&g_trace_stamp, false);
+
+    pthread_mutex_lock(&trace_lock);
+    TraceBuffer* buf = trace_buffers;
+    trace_buffers = NULL;
+    while (buf) {
+        TraceBuffer* next = buf->next;
+        buffer_write_locked(buf);
+        free(buf);
+        buf = next;
+    }
+    if (trace_fd >= 0) {
+        fsync(trace_fd);
+        close(trace_fd);
+        trace_fd = -1;
+    }
+    atomic_fetch_add(&trace_gen, 1);
+    pthread_mutex_unlock(&trace_lock);
+}
+
+/* ============================================================
+ * Reading Traces
+ * ============================================================ */
+
+typedef struct {
+    const TraceRecord*  rec;
+    int64_t             peer;       /* Actor index of child/target (-1 = not replayable) */
+} TraceEvent;
+
+typedef struct {
+    uint64_t            pid;        /* Recorded pid (0 = outside any process) */
+    TraceEvent*         events;     /* In recorded order */
+    size_t              count;
+    size_t              receives;
+    bool                spawned;    /* Some recorded actor spawns this one */
+
+    /* Replay state */
+    _Atomic uint64_t    live_pid;   /* Pid of the replaying process (0 = not yet) */
+    uint64_t*           latencies;  /* One per received message */
+    size_t              received;
+} TraceActor;
+
+struct ArnmTrace {
+    uint8_t*            map;
+    size_t              size;
+    TraceActor*         actors;
+    size_t              count;
+    size_t              capacity;
+    uint64_t*           keys;       /* Open-addressed pid + 1 -> actor index + 1 */
+    uint64_t*           values;
+    size_t              slots;      /* Power of two */
+    uint64_t            messages;   /* Recorded receives */
+};
+
+static size_t trace_slot(ArnmTrace* trace, uint64_t pid) {
+    size_t i = (size_t)((pid + 1) * 0x9E3779B97F4A7C15ull) & (trace->slots - 1);
+    while (trace->keys[i] != 0 && trace->keys[i] != pid + 1) {
+        i = (i + 1) & (trace->slots - 1);
+    }
+    return i;
+}
+
+static int64_t trace_find(ArnmTrace* trace, uint64_t pid) {
+    size_t i = trace_slot(trace, pid);
+    return trace->keys[i] ? (int64_t)trace->values[i] - 1 : -1;
+}
+
+/* Actor index for pid, adding it if new (-1 on OOM) */
+static int64_t trace_intern(ArnmTrace* trace, uint64_t pid) {
+    size_t i = trace_slot(trace, pid);
+    if (trace->keys[i]) return (int64_t)trace->values[i] - 1;
+
+    if (trace->count == trace->capacity) {
+        size_t cap = trace->capacity ? trace->capacity * 2 : 64;
+        TraceActor* actors = realloc(trace->actors, cap * sizeof(TraceActor));
+        if (!actors) return -1;
+        trace->actors = actors;
+        trace->capacity = cap;
+    }
+
+    TraceActor* actor = &trace->actors[trace->count];
+    memset(actor, 0, sizeof(*actor));
+    actor->pid = pid;
+    trace->keys[i] = pid + 1;
+    trace->values[i] = trace->count + 1;
+    return (int64_t)trace->count++;
+}
+
+static size_t record_length(const TraceRecord* rec) {
+    return sizeof(TraceRecord) + (rec->kind == TRACE_SEND ? trace_pad(rec->size) : 0);
+}
+
+static int event_cmp(const void* a, const void* b) {
+    uint64_t x = ((const TraceEvent*)a)->rec->seq;
+    uint64_t y = ((const TraceEvent*)b)->rec->seq;
+    return x < y ? -1 : x > y;
+}
+
+ArnmTrace* arnm_trace_open(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < TRACE_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+
+    uint8_t* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    const TraceHeader* hdr = (const TraceHeader*)map;
+    if (hdr->magic != TRACE_MAGIC || hdr->version != TRACE_VERSION) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+
+    ArnmTrace* trace = calloc(1, sizeof(ArnmTrace));
+    if (!trace) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    trace->map = map;
+    trace->size = (size_t)st.st_size;
+
+    /* Every record could name two actors */
+    size_t records = (trace->size - TRACE_HEADER_SIZE) / sizeof(TraceRecord);
+    trace->slots = 16;
+    while (trace->slots < records * 4 + 2) trace->slots <<= 1;
+    trace->keys = calloc(trace->slots, sizeof(uint64_t));
+    trace->values = calloc(trace->slots, sizeof(uint64_t));
+    if (!trace->keys || !trace->values) goto fail;
+
+    /* Pass 1: actors and event counts. A truncated tail is ignored. */
+    size_t end = TRACE_HEADER_SIZE;
+    while (end + sizeof(TraceRecord) <= trace->size) {
+        const TraceRecord* rec = (const TraceRecord*)(map + end);
+        size_t len = record_length(rec);
+        if (len > trace->size - end) break;
+
+        int64_t a = trace_intern(trace, rec->pid);
+        if (a < 0) goto fail;
+        trace->actors[a].count++;
+
+        if (rec->kind == TRACE_SPAWN) {
+            int64_t c = trace_intern(trace, rec->peer);
+            if (c < 0) goto fail;
+            trace->actors[c].spawned = true;
+        } else if (rec->kind == TRACE_RECV) {
+            trace->actors[a].receives++;
+            trace->messages++;
+        }
+        end += len;
+    }
+
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceActor* actor = &trace->actors[i];
+        actor->events = calloc(actor->count + 1, sizeof(TraceEvent));
+        actor->latencies = calloc(actor->receives + 1, sizeof(uint64_t));
+        if (!actor->events || !actor->latencies) goto fail;
+        actor->count = 0;
+    }
+
+    /* Pass 2: fill and order each actor's events */
+    for (size_t pos = TRACE_HEADER_SIZE; pos < end; ) {
+        const TraceRecord* rec = (const TraceRecord*)(map + pos);
+        TraceActor* actor = &trace->actors[trace_find(trace, rec->pid)];
+        TraceEvent* ev = &actor->events[actor->count++];
+        ev->rec = rec;
+        ev->peer = rec->kind == TRACE_RECV ? -1 : trace_find(trace, rec->peer);
+        pos += record_length(rec);
+    }
+
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceActor* actor = &trace->actors[i];
+        qsort(actor->events, actor->count, sizeof(TraceEvent), event_cmp);
+
+        /* Only actors that will exist during replay can be sent to */
+        for (size_t e = 0; e < actor->count; e++) {
+            TraceEvent* ev = &actor->events[e];
+            if (ev->rec->kind == TRACE_SEND && ev->peer >= 0) {
+                TraceActor* target = &trace->actors[ev->peer];
+                if (!target->spawned && target->count == 0) ev->peer = -1;
+            }
+        }
+    }
+
+    return trace;
+
+fail:
+    arnm_trace_close(trace);
+    return NULL;
+}
+
+void arnm_trace_close(ArnmTrace* trace) {
+    if (!trace) return;
+    for (size_t i = 0; i < trace->count; i++) {
+        free(trace->actors[i].events);
+        free(trace->actors[i].latencies);
+    }
+    free(trace->actors);
+    free(trace->keys);
+    free(trace->values);
+    munmap(trace->map, trace->size);
+    free(trace);
+}
+
+size_t arnm_trace_actor_count(ArnmTrace* trace) {
+    if (!trace) return 0;
+
+    /* pid 0 stands for code outside any process, not an actor */
+    int64_t outside = trace_find(trace, 0);
+    return trace->count - (outside >= 0 ? 1 : 0);
+}
+
+uint64_t arnm_trace_message_count(ArnmTrace* trace) {
+    return trace ? trace->messages : 0;
+}
+
+/* ============================================================
+ * Replay
+ * ============================================================
+ * Each recorded actor becomes a process that walks its own events:
+ * a spawn starts the child's process, a send goes to the target's
+ * replaying process by pid, a receive blocks for the next message,
+ * whichever sender it comes from. Actors that were running before
+ * the capture started (no spawn record) and pid 0 start up front.
+ */
+
+typedef struct {
+    ArnmTrace*          trace;
+    ArnmSpawnOptions    spawn;
+    void              (*on_message)(uint64_t pid, ArnmMessage* msg, void* ctx);
+    void*               ctx;
+    atomic_uint_fast64_t dropped;
+} ReplayRun;
+
+static ReplayRun g_replay;
+
+static void replay_actor(void* arg);
+
+static bool replay_spawn(TraceActor* actor) {
+    ArnmProcess* proc = arnm_spawn_ex(replay_actor, actor, 0, &g_replay.spawn);
+    if (!proc) return false;
+    atomic_store(&actor->live_pid, proc->pid);
+    return true;
+}
+
+static void replay_send(TraceActor* target, const TraceRecord* rec) {
+    /* The target's spawner may not have got there yet in this run */
+    uint64_t pid = atomic_load(&target->live_pid);
+    uint64_t give_up = 0;
+    while (pid == 0) {
+        uint64_t now = sched_clock_ns();
+        if (!give_up) give_up = now + TRACE_REPLAY_WAIT_NS;
+        if (now > give_up) break;
+        arnm_yield();
+        pid = atomic_load(&target->live_pid);
+    }
+
+    void* payload = rec->size ? (void*)(rec + 1) : NULL;
+    if (!pid || !proc_send_pid(pid, rec->tag, payload, rec->size)) {
+        atomic_fetch_add(&g_replay.dropped, 1);
+    }
+}
+
+static void replay_actor(void* arg) {
+    TraceActor* actor = (TraceActor*)arg;
+    ArnmTrace* trace = g_replay.trace;
+
+    for (size_t i = 0; i < actor->count; i++) {
+        const TraceEvent* ev = &actor->events[i];
+        const TraceRecord* rec = ev->rec;
+
+        switch (rec->kind) {
+            case TRACE_SPAWN:
+                if (ev->peer >= 0) replay_spawn(&trace->actors[ev->peer]);
+                break;
+
+            case TRACE_SEND:
+                if (ev->peer >= 0) {
+                    replay_send(&trace->actors[ev->peer], rec);
+                } else {
+                    atomic_fetch_add(&g_replay.dropped, 1);
+                }
+                break;
+
+            case TRACE_RECV: {
+                ArnmMessage* msg = arnm_receive();
+                if (!msg) break;
+                if (msg->sent_at) {
+                    actor->latencies[actor->received++] = sched_clock_ns() - msg->sent_at;
+                }
+                if (g_replay.on_message) {
+                    g_replay.on_message(actor->pid, msg, g_replay.ctx);
+                }
+                arnm_message_free(msg);
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+static int u64_cmp(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+void arnm_replay_options_default(ArnmReplayOptions* options) {
+    if (!options) return;
+    memset(options, 0, sizeof(*options));
+    arnm_config_default(&options->config);
+    arnm_spawn_options_default(&options->spawn);
+}
+
+int arnm_trace_replay(ArnmTrace* trace, const ArnmReplayOptions* options,
+                      ArnmReplayReport* report) {
+    if (!trace) return -1;
+
+    ArnmReplayOptions defaults;
+    if (!options) {
+        arnm_replay_options_default(&defaults);
+        options = &defaults;
+    }
+
+    for (size_t i = 0; i < trace->count; i++) {
+        atomic_store(&trace->actors[i].live_pid, 0);
+        trace->actors[i].received = 0;
+    }
+
+    /* Never record the replay itself */
+    ArnmConfig config = options->config;
+    config.trace_path = NULL;
+    if (arnm_init_ex(&config) != 0) return -1;
+
+    memset(&g_replay, 0, sizeof(g_replay));
+    g_replay.trace = trace;
+    g_replay.spawn = options->spawn;
+    g_replay.on_message = options->on_message;
+    g_replay.ctx = options->ctx;
+    atomic_store(&g_trace_stamp, true);
+
+    uint64_t start = sched_clock_ns();
+    int result = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceActor* actor = &trace->actors[i];
+        if (!actor->spawned && actor->count > 0 && !replay_spawn(actor)) {
+            result = -1;
+            break;
+        }
+    }
+    arnm_run();
+    uint64_t elapsed = sched_clock_ns() - start;
+
+    atomic_store(&g_trace_stamp, false);
+    arnm_shutdown();
+
+    /* Merge per-actor latencies */
+    size_t total = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        total += trace->actors[i].received;
+    }
+    uint64_t* all = calloc(total + 1, sizeof(uint64_t));
+    if (!all) return -1;
+    size_t n = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceActor* actor = &trace->actors[i];
+        memcpy(all + n, actor->latencies, actor->received * sizeof(uint64_t));
+        n += actor->received;
+    }
+    qsort(all, n, sizeof(uint64_t), u64_cmp);
+
+    if (report) {
+        memset(report, 0, sizeof(*report));
+        report->actors = arnm_trace_actor_count(trace);
+        report->messages = n;
+        report->dropped = atomic_load(&g_replay.dropped);
+        report->elapsed_ns = elapsed;
+        report->throughput = elapsed ? (double)n * 1e9 / (double)elapsed : 0.0;
+        if (n > 0) {
+            report->latency_p50_ns = all[n / 2];
+            report->latency_p99_ns = all[(n * 99) / 100];
+            report->latency_max_ns = all[n - 1];
+        }
+    }
+
+    free(all);
+    return result;
+}
@@ -0,0 +1,89 @@
+/*
+ * ARNm Runtime - Array Test
+ *
+ * Tests array creation and slicing: zero-filled elements, slices that
+ * share storage with their parent (including slices of slices and
+ * empty ones), the alias test vectorized loops rely on, and that bad
+ * lengths, slice ranges and bounds checks abort instead of returning.
+ */
+
+#include "../include/arnm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <assert.h>
+#include <sys/wait.h>
+
+#define N 1000
+
+/* Run fn in a child with stderr closed; true if it died of SIGABRT */
+static bool aborts(void (*fn)(void)) {
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        close(STDERR_FILENO);
+        fn();
+        _exit(0);
+    }
+    int status;
+    assert(waitpid(child, &status, 0) == child);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+static void negative_length(void) { arnm_array_new(-1); }
+static void huge_length(void) { arnm_array_new((int64_t)ARNM_ARRAY_MAX_LEN + 1); }
+static void bounds_fail(void) { arnm_panic_bounds(5, 5); }
+
+static void slice_past_end(void) {
+    arnm_array_slice(arnm_array_new(4), 2, 5);
+}
+
+static void slice_reversed(void) {
+    arnm_array_slice(arnm_array_new(4), 3, 2);
+}
+
+int main(void) {
+    printf("Testing arrays...\n");
+
+    ArnmArray* arr = arnm_array_new(N);
+    assert(arr && arr->len == N);
+    int64_t* data = arr->data;
+    for (int i = 0; i < N; i++) assert(data[i] == 0);
+    for (int i = 0; i < N; i++) data[i] = i;
+
+    ArnmArray* mid = arnm_array_slice(arr, 100, 200);
+    assert(mid->len == 100);
+    assert(((int64_t*)mid->data)[0] == 100);
+    ((int64_t*)mid->data)[99] = -1;
+    assert(data[199] == -1);
+
+    ArnmArray* inner = arnm_array_slice(mid, 10, 20);
+    assert(inner->len == 10 && ((int64_t*)inner->data)[0] == 110);
+
+    ArnmArray* empty = arnm_array_slice(arr, N, N);
+    assert(empty->len == 0);
+    ArnmArray* none = arnm_array_new(0);
+    assert(none->len == 0 && none->data != NULL);
+    printf("  Creation and slicing: ok\n");
+
+    /* Overlap only counts when the same slot has two different indexes */
+    assert(!arnm_array_aliased(arr, arr));
+    assert(!arnm_array_aliased(arr, arnm_array_slice(arr, 0, 10)));
+    assert(arnm_array_aliased(mid, arnm_array_slice(arr, 150, 160)));
+    assert(arnm_array_aliased(arnm_array_slice(arr, 150, 160), mid));
+    assert(!arnm_array_aliased(mid, arnm_array_slice(arr, 200, 300)));
+    assert(!arnm_array_aliased(mid, none));
+    assert(!arnm_array_aliased(empty, arr));
+    printf("  Aliasing: ok\n");
+
+    assert(aborts(negative_length));
+    assert(aborts(huge_length));
+    assert(aborts(slice_past_end));
+    assert(aborts(slice_reversed));
+    assert(aborts(bounds_fail));
+    printf("  Panics: ok\n");
+
+    printf("Array test passed!\n");
+    return 0;
+}
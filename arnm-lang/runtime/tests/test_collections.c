@@ -0,0 +1,133 @@
+/*
+ * ARNm Runtime - Collections Test
+ *
+ * Tests the vector, map and deque: growth keeps every element, map
+ * lookups survive rehashing and tombstones from heavy removal, the
+ * deque's ring wraps and unwraps correctly from either end, and empty
+ * pops, bad indexes and missing keys abort instead of returning.
+ */
+
+#include "../include/arnm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <assert.h>
+#include <sys/wait.h>
+
+#define N 100000
+
+/* Run fn in a child with stderr closed; true if it died of SIGABRT */
+static bool aborts(void (*fn)(void)) {
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        close(STDERR_FILENO);
+        fn();
+        _exit(0);
+    }
+    int status;
+    assert(waitpid(child, &status, 0) == child);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+static void vec_pop_empty(void) { arnm_vec_pop(arnm_vec_new()); }
+static void vec_index(void) { arnm_vec_at(arnm_vec_new(), 0); }
+static void map_missing(void) { arnm_map_at(arnm_map_new(), 7); }
+static void deque_pop_empty(void) { arnm_deque_pop_front(arnm_deque_new()); }
+
+static void deque_index(void) {
+    ArnmDeque* d = arnm_deque_new();
+    *arnm_deque_push_back(d) = 1;
+    arnm_deque_at(d, -1);
+}
+
+static void test_vec(void) {
+    ArnmVec* v = arnm_vec_new();
+    assert(arnm_vec_len(v) == 0);
+    for (int64_t i = 0; i < N; i++) *arnm_vec_push(v) = i * 3;
+    assert(arnm_vec_len(v) == N);
+    for (int64_t i = 0; i < N; i++) assert(*arnm_vec_at(v, i) == i * 3);
+
+    *arnm_vec_at(v, 5) = -1;
+    assert(v->data[5] == -1);
+    for (int64_t i = N - 1; i >= N / 2; i--) assert(*arnm_vec_pop(v) == i * 3);
+    assert(arnm_vec_len(v) == N / 2);
+    assert(*arnm_vec_push(v) == 0);    /* Reused slots start zeroed */
+    printf("  Vector: ok\n");
+}
+
+static void test_map(void) {
+    ArnmMap* m = arnm_map_new();
+    assert(arnm_map_len(m) == 0 && !arnm_map_has(m, 0) && !arnm_map_find(m, 0));
+
+    /* Spread-out and negative keys, through several doublings */
+    for (int64_t i = 0; i < N; i++) *arnm_map_slot(m, i * 7919 - N) = i;
+    assert(arnm_map_len(m) == N);
+    assert(m->cap >= N && (m->cap & (m->cap - 1)) == 0);
+    for (int64_t i = 0; i < N; i++) assert(*arnm_map_at(m, i * 7919 - N) == i);
+    assert(!arnm_map_has(m, 1));
+
+    /* Updating an existing key does not add one */
+    *arnm_map_slot(m, -N) += 100;
+    assert(*arnm_map_at(m, -N) == 100 && arnm_map_len(m) == N);
+
+    /* Remove the even ones, then churn to exercise tombstone reuse and cleanup */
+    for (int64_t i = 0; i < N; i += 2) assert(arnm_map_remove(m, i * 7919 - N));
+    assert(!arnm_map_remove(m, -N));
+    assert(arnm_map_len(m) == N / 2);
+    int64_t cap = m->cap;
+    for (int round = 0; round < 4; round++) {
+        for (int64_t i = 0; i < N / 4; i++) *arnm_map_slot(m, INT64_MAX - i) = i;
+        for (int64_t i = 0; i < N / 4; i++) assert(arnm_map_remove(m, INT64_MAX - i));
+    }
+    assert(m->cap == cap);
+    for (int64_t i = 0; i < N; i++) {
+        assert(arnm_map_has(m, i * 7919 - N) == (i % 2 == 1));
+    }
+    printf("  Map: ok\n");
+}
+
+static void test_deque(void) {
+    ArnmDeque* d = arnm_deque_new();
+
+    /* Alternate ends so the ring wraps before every growth */
+    for (int64_t i = 0; i < 1000; i++) {
+        if (i % 2) *arnm_deque_push_back(d) = i;
+        else *arnm_deque_push_front(d) = i;
+    }
+    assert(arnm_deque_len(d) == 1000);
+    assert(*arnm_deque_at(d, 0) == 998 && *arnm_deque_at(d, 999) == 999);
+    for (int64_t i = 0; i < 500; i++) assert(*arnm_deque_at(d, i) == 998 - 2 * i);
+    for (int64_t i = 500; i < 1000; i++) assert(*arnm_deque_at(d, i) == 2 * (i - 500) + 1);
+
+    /* As a queue, in steady state: the ring turns without growing */
+    int64_t cap = d->cap;
+    for (int64_t i = 0; i < N; i++) {
+        int64_t front = *arnm_deque_at(d, 0);
+        *arnm_deque_push_back(d) = N + i;
+        assert(*arnm_deque_pop_front(d) == front);
+    }
+    assert(d->cap == cap && arnm_deque_len(d) == 1000);
+    assert(*arnm_deque_at(d, 0) == 2 * N - 1000);
+    assert(*arnm_deque_pop_back(d) == 2 * N - 1);
+    printf("  Deque: ok\n");
+}
+
+int main(void) {
+    printf("Testing collections...\n");
+
+    test_vec();
+    test_map();
+    test_deque();
+
+    assert(aborts(vec_pop_empty));
+    assert(aborts(vec_index));
+    assert(aborts(map_missing));
+    assert(aborts(deque_pop_empty));
+    assert(aborts(deque_index));
+    printf("  Panics: ok\n");
+
+    printf("Collections test passed!\n");
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * ARNm Runtime - Distribution Test
+ *
+ * Two nodes on localhost: a forked child runs an echo server as
+ * node 2, the parent runs a client as node 1 and exchanges pings
+ * with it through a remote handle.
+ */
+
+#include "../include/arnm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#define NUM_PINGS   1000
+#define TAG_PING    1
+#define TAG_PONG    2
+#define TAG_STOP    3
+
+typedef struct {
+    uint64_t    reply_pid;
+    uint32_t    reply_node;
+    int64_t     value;
+} Ping;
+
+static uint64_t server_pid;
+static int64_t pong_sum = 0;
+static int pong_count = 0;
+
+/* ============================================================
+ * Node 2: echo server
+ * ============================================================ */
+
+static void echo_server(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        ArnmMessage* msg = arnm_receive();
+        uint64_t tag = arnm_message_tag(msg);
+
+        if (tag == TAG_PING) {
+            assert(arnm_message_size(msg) == sizeof(Ping));
+            Ping ping;
+            memcpy(&ping, arnm_message_data(msg), sizeof(ping));
+            arnm_message_free(msg);
+
+            int64_t value = ping.value + 1;
+            ArnmProcess* client = arnm_remote(ping.reply_node, ping.reply_pid);
+            assert(arnm_send(client, TAG_PONG, &value, sizeof(value)) == 0);
+        } else {
+            arnm_message_free(msg);
+            assert(tag == TAG_STOP);
+            arnm_node_stop();
+            return;
+        }
+    }
+}
+
+static uint16_t free_port(void) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    assert(bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+    assert(getsockname(fd, (struct sockaddr*)&addr, &len) == 0);
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
+static int run_server(int ready_fd) {
+    assert(arnm_init(1) == 0);
+
+    uint16_t port = free_port();
+    assert(arnm_node_start(2, port) == 0);
+
+    ArnmProcess* server = arnm_spawn(echo_server, NULL, 0);
+    assert(server);
+    assert(arnm_pid_node(server) == 2);
+
+    uint64_t info[2] = { port, arnm_pid(server) };
+    assert(write(ready_fd, info, sizeof(info)) == sizeof(info));
+    close(ready_fd);
+
+    arnm_run();
+    arnm_shutdown();
+    return 0;
+}
+
+/* ============================================================
+ * Node 1: client
+ * ============================================================ */
+
+static void client(void* arg) {
+    (void)arg;
+
+    ArnmProcess* server = arnm_remote(2, server_pid);
+    assert(server);
+    assert(arnm_pid_node(server) == 2);
+    assert(arnm_pid(server) == server_pid);
+
+    /* Burst all pings first so the writer batches them */
+    Ping ping = { arnm_pid(arnm_self()), arnm_node_id(), 0 };
+    for (int i = 0; i < NUM_PINGS; i++) {
+        ping.value = i;
+        assert(arnm_send(server, TAG_PING, &ping, sizeof(ping)) == 0);
+    }
+
+    /* Per node pair ordering: pongs come back in send order */
+    for (int i = 0; i < NUM_PINGS; i++) {
+        ArnmMessage* msg = arnm_receive();
+        assert(arnm_message_tag(msg) == TAG_PONG);
+        int64_t value;
+        memcpy(&value, arnm_message_data(msg), sizeof(value));
+        assert(value == i + 1);
+        pong_sum += value;
+        pong_count++;
+        arnm_message_free(msg);
+    }
+
+    /* Nodes we are not connected to are unreachable */
+    assert(arnm_send(arnm_remote(3, 1), TAG_PING, &ping, sizeof(ping)) == -1);
+
+    assert(arnm_send(server, TAG_STOP, NULL, 0) == 0);
+    arnm_node_stop();
+}
+
+int main(void) {
+    printf("Testing distribution...\n");
+
+    int pipefd[2];
+    assert(pipe(pipefd) == 0);
+
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        close(pipefd[0]);
+        _exit(run_server(pipefd[1]));
+    }
+    close(pipefd[1]);
+
+    uint64_t info[2];
+    assert(read(pipefd[0], info, sizeof(info)) == sizeof(info));
+    close(pipefd[0]);
+    server_pid = info[1];
+
+    assert(arnm_init(2) == 0);
+    assert(arnm_node_start(1, 0) == 0);
+    assert(arnm_node_connect("127.0.0.1", (uint16_t)info[0]) == 2);
+
+    /* A second connection to the same node is refused */
+    assert(arnm_node_connect("127.0.0.1", (uint16_t)info[0]) == -1);
+
+    assert(arnm_spawn(client, NULL, 0));
+    arnm_run();
+    arnm_shutdown();
+
+    int status;
+    assert(waitpid(child, &status, 0) == child);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    printf("  Pongs: %d (sum %lld)\n", pong_count, (long long)pong_sum);
+    assert(pong_count == NUM_PINGS);
+    assert(pong_sum == (int64_t)NUM_PINGS * (NUM_PINGS + 1) / 2);
+
+    printf("Distribution test passed!\n");
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * ARNm Runtime - Hibernation Test
+ * 
+ * Tests that an idle actor parked at its loop head loses its stack
+ * and restarts from the loop head when a message arrives.
+ */
+
+#include "../include/arnm.h"
+#include "../include/process.h"
+#include <stdio.h>
+#include <stdatomic.h>
+#include <assert.h>
+#include <unistd.h>
+
+#define MSG_PING 1
+#define MSG_STOP 2
+
+static atomic_int handled = 0;
+static atomic_int loop_entries = 0;
+static ArnmProcess* server_proc = NULL;
+
+static void server_loop(void* arg) {
+    (void)arg;
+    atomic_fetch_add(&loop_entries, 1);
+    
+    for (;;) {
+        ArnmMessage* msg = arnm_receive_idle(server_loop);
+        uint64_t tag = arnm_message_tag(msg);
+        arnm_message_free(msg);
+        
+        if (tag == MSG_STOP) return;
+        atomic_fetch_add(&handled, 1);
+    }
+}
+
+static void driver(void* arg) {
+    (void)arg;
+    
+    /* Wait for the server to hibernate */
+    int spins = 0;
+    while (server_proc->hibernation != PROC_STACK_FREED && spins < 20000) {
+        usleep(100);
+        arnm_yield();
+        spins++;
+    }
+    printf("  Server hibernated: %s (stack %p)\n",
+           server_proc->hibernation == PROC_STACK_FREED ? "yes" : "no",
+           server_proc->stack_base);
+    assert(server_proc->hibernation == PROC_STACK_FREED);
+    assert(server_proc->stack_base == NULL);
+    
+    arnm_send(server_proc, MSG_PING, NULL, 0);
+    arnm_send(server_proc, MSG_STOP, NULL, 0);
+}
+
+int main(void) {
+    printf("Testing hibernation...\n");
+    
+    ArnmConfig config;
+    arnm_config_default(&config);
+    config.num_workers = 1;
+    config.hibernate_ms = 1;
+    int ret = arnm_init_ex(&config);
+    assert(ret == 0);
+    
+    server_proc = arnm_spawn(server_loop, NULL, 0);
+    assert(server_proc != NULL);
+    assert(arnm_spawn(driver, NULL, 0) != NULL);
+    
+    arnm_run();
+    
+    printf("  Handled %d, loop entries %d\n", atomic_load(&handled), atomic_load(&loop_entries));
+    assert(atomic_load(&handled) == 1);
+    assert(atomic_load(&loop_entries) == 2);  /* Initial start + restart */
+    
+    arnm_shutdown();
+    printf("Hibernation test passed!\n");
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * ARNm Runtime - Monitor and Join Test
+ *
+ * Tests that joiners wake exactly when their target exits without
+ * polling, monitors get one DOWN per exit (at once for a process that
+ * is already gone), demonitor cancels, and joinable handles stay
+ * readable after exit.
+ */
+
+#include "../include/arnm.h"
+#include "../include/process.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+#define NUM_WORKERS     16
+#define WORK_YIELDS     200
+#define NUM_JOINERS     4
+
+static uint64_t worker_pids[NUM_WORKERS];
+static atomic_int workers_done;
+
+static void busy_worker(void* arg) {
+    (void)arg;
+    for (int i = 0; i < WORK_YIELDS; i++) arnm_yield();
+    atomic_fetch_add(&workers_done, 1);
+}
+
+/* Several joiners on the same targets: all must see every worker finished */
+static atomic_int joins_ok;
+static uint64_t joiner_runs[NUM_JOINERS];
+
+static void joiner(void* arg) {
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        assert(arnm_join(worker_pids[i]) == 0);
+    }
+    if (atomic_load(&workers_done) == NUM_WORKERS) atomic_fetch_add(&joins_ok, 1);
+    joiner_runs[id] = arnm_self()->run_count;
+}
+
+/* Monitors: a DOWN for a live target, one for a dead pid, none after demonitor */
+static uint64_t target_pid;
+static uint64_t cancelled_pid;
+static ArnmProcess* cancelled_target;      /* Parked in receive until told to go */
+static uint64_t down_pids[2];
+static int downs_seen;
+static bool stray_down;
+
+static void short_lived(void* arg) {
+    (void)arg;
+    for (int i = 0; i < 10; i++) arnm_yield();
+}
+
+static void wait_for_word(void* arg) {
+    (void)arg;
+    arnm_message_free(arnm_receive());
+}
+
+static void watcher(void* arg) {
+    (void)arg;
+    assert(arnm_monitor(target_pid) == 0);
+    assert(arnm_monitor(cancelled_pid) == 0);
+    arnm_demonitor(cancelled_pid);
+    assert(arnm_send(cancelled_target, 1, NULL, 0) == 0);
+    assert(arnm_monitor(worker_pids[0]) == 0);     /* Long gone: DOWN at once */
+
+    for (int i = 0; i < 2; i++) {
+        ArnmMessage* msg = arnm_receive();
+        assert(arnm_message_tag(msg) == ARNM_TAG_DOWN);
+        down_pids[downs_seen++] = *(uint64_t*)arnm_message_data(msg);
+        arnm_message_free(msg);
+    }
+
+    /* Make sure the cancelled target is gone before checking for strays */
+    assert(arnm_join(cancelled_pid) == 0);
+    ArnmMessage* msg = arnm_try_receive();
+    if (msg) {
+        stray_down = true;
+        arnm_message_free(msg);
+    }
+}
+
+/* Joinable handle: read after the process has long exited */
+static ArnmProcess* joinable;
+static bool joinable_ok;
+
+static void late_joiner(void* arg) {
+    (void)arg;
+    for (int i = 0; i < 100; i++) arnm_yield();
+    assert(joinable->state == PROC_STATE_DEAD);
+    assert(arnm_join_proc(joinable) == 0);
+    joinable_ok = true;
+}
+
+int main(void) {
+    printf("Testing monitors and join...\n");
+
+    assert(arnm_init(4) == 0);
+    assert(arnm_join(1) == -1);                     /* Not in a process */
+
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        ArnmProcess* p = arnm_spawn(busy_worker, NULL, 0);
+        assert(p);
+        worker_pids[i] = arnm_pid(p);
+    }
+    for (int i = 0; i < NUM_JOINERS; i++) {
+        assert(arnm_spawn(joiner, (void*)(intptr_t)i, 0));
+    }
+    arnm_run();
+
+    printf("  Joiners satisfied: %d, quanta used by joiner 0: %lu\n",
+           atomic_load(&joins_ok), (unsigned long)joiner_runs[0]);
+    assert(atomic_load(&joins_ok) == NUM_JOINERS);
+    for (int i = 0; i < NUM_JOINERS; i++) {
+        /* One park per live target at most, plus the first run */
+        assert(joiner_runs[i] <= NUM_WORKERS + 1);
+    }
+
+    ArnmProcess* target = arnm_spawn(short_lived, NULL, 0);
+    cancelled_target = arnm_spawn(wait_for_word, NULL, 0);
+    assert(target && cancelled_target);
+    target_pid = arnm_pid(target);
+    cancelled_pid = arnm_pid(cancelled_target);
+    assert(arnm_spawn(watcher, NULL, 0));
+    arnm_run();
+
+    assert(downs_seen == 2);
+    assert((down_pids[0] == target_pid && down_pids[1] == worker_pids[0]) ||
+           (down_pids[1] == target_pid && down_pids[0] == worker_pids[0]));
+    assert(!stray_down);
+
+    joinable = arnm_spawn_joinable(short_lived, NULL, 0);
+    assert(joinable);
+    assert(arnm_spawn(late_joiner, NULL, 0));
+    arnm_run();
+    assert(joinable_ok);
+
+    arnm_shutdown();
+
+    printf("Monitor and join test passed!\n");
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * ARNm Runtime - Output Test
+ *
+ * Tests buffered print: every line intact, each process's lines in
+ * the order it printed them even when it moves between workers.
+ */
+
+#include "../include/arnm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <assert.h>
+
+#define NUM_PRINTERS    8
+#define LINES_EACH      2000
+
+/* Even ids print whole lines, odd ids build theirs from raw pieces */
+static void printer(void* arg) {
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < LINES_EACH; i++) {
+        if (id % 2 == 0) {
+            arnm_print_int(id * 100000 + i);
+        } else {
+            char digits[16];
+            int n = snprintf(digits, sizeof(digits), "%d", id * 100000 + i);
+            arnm_write(digits, 1);
+            arnm_write(digits + 1, (size_t)n - 1);
+            arnm_write("\n", 1);
+        }
+        if (i % 16 == 0) arnm_yield();
+    }
+}
+
+int main(void) {
+    printf("Testing buffered output...\n");
+    fflush(stdout);
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/arnm-output-%d.txt", (int)getpid());
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    assert(fd >= 0);
+    int saved = dup(STDOUT_FILENO);
+    dup2(fd, STDOUT_FILENO);
+
+    /* Outside the scheduler: the shared buffer */
+    arnm_print_i64(INT64_MIN);
+    arnm_print_str("hello", 5);
+    arnm_print_f64(0.1 + 0.2);
+    arnm_print_f64(-2.5);
+
+    ArnmConfig config;
+    arnm_config_default(&config);
+    config.num_workers = 4;
+    config.line_atomic = true;
+    assert(arnm_init_ex(&config) == 0);
+
+    ArnmSpawnOptions opts;
+    arnm_spawn_options_default(&opts);
+    opts.placement = ARNM_PLACE_ROUND_ROBIN;
+    for (int p = 0; p < NUM_PRINTERS; p++) {
+        assert(arnm_spawn_ex(printer, (void*)(intptr_t)p, 0, &opts));
+    }
+    arnm_run();
+    arnm_shutdown();
+
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+
+    FILE* in = fdopen(fd, "r");
+    assert(in);
+    rewind(in);
+
+    char line[64];
+    assert(fgets(line, sizeof(line), in) && strcmp(line, "-9223372036854775808\n") == 0);
+    assert(fgets(line, sizeof(line), in) && strcmp(line, "hello\n") == 0);
+    assert(fgets(line, sizeof(line), in) && strcmp(line, "0.30000000000000004\n") == 0);
+    assert(fgets(line, sizeof(line), in) && strcmp(line, "-2.5\n") == 0);
+
+    int next[NUM_PRINTERS] = {0};
+    int total = 0;
+    while (fgets(line, sizeof(line), in)) {
+        char* end;
+        long v = strtol(line, &end, 10);
+        assert(*end == '\n');
+        int id = (int)(v / 100000);
+        assert(id >= 0 && id < NUM_PRINTERS);
+        assert(v % 100000 == next[id]);
+        next[id]++;
+        total++;
+    }
+    fclose(in);
+    unlink(path);
+
+    printf("  Lines: %d\n", total);
+    assert(total == NUM_PRINTERS * LINES_EACH);
+
+    printf("Output test passed!\n");
+    return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * ARNm Runtime - Placement Test
+ * 
+ * Tests spawn placement options of arnm_spawn_ex.
+ */
+
+#include "../include/arnm.h"
+#include "../include/process.h"
+#include <stdio.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+static atomic_int ran = 0;
+
+static void worker(void* arg) {
+    (void)arg;
+    atomic_fetch_add(&ran, 1);
+}
+
+static ArnmProcess* spawn_placed(ArnmPlacement placement, uint32_t target) {
+    ArnmSpawnOptions opts;
+    arnm_spawn_options_default(&opts);
+    opts.placement = placement;
+    opts.worker = target;
+    return arnm_spawn_ex(worker, NULL, 0, &opts);
+}
+
+int main(void) {
+    printf("Testing spawn placement...\n");
+    
+    int ret = arnm_init(4);
+    assert(ret == 0);
+    
+    /* Explicit worker */
+    ArnmProcess* p = spawn_placed(ARNM_PLACE_WORKER, 2);
+    assert(p && p->worker_id == 2);
+    
+    /* Round-robin cycles through all workers */
+    uint32_t seen = 0;
+    for (int i = 0; i < 4; i++) {
+        p = spawn_placed(ARNM_PLACE_ROUND_ROBIN, 0);
+        assert(p);
+        seen |= 1u << p->worker_id;
+    }
+    assert(seen == 0xF);
+    
+    /* Least-loaded avoids worker 2, which now holds two processes */
+    p = spawn_placed(ARNM_PLACE_LEAST_LOADED, 0);
+    assert(p && p->worker_id != 2);
+    
+    arnm_run();
+    
+    printf("  Ran %d processes\n", atomic_load(&ran));
+    assert(atomic_load(&ran) == 6);
+    
+    arnm_shutdown();
+    printf("Placement test passed!\n");
+    return 0;
+}
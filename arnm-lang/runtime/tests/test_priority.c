@@ -0,0 +1,65 @@
+/*
+ * ARNm Runtime - Priority Test
+ *
+ * Tests priority classes and EDF ordering within the high class.
+ */
+
+#include "../include/arnm.h"
+#include <stdio.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+static atomic_int order_idx = 0;
+static int order[16];
+
+static void worker(void* arg) {
+    int id = (int)(intptr_t)arg;
+    order[atomic_fetch_add(&order_idx, 1)] = id;
+}
+
+static ArnmProcess* spawn_with(int id, ArnmPriority prio, uint64_t deadline_ns) {
+    ArnmSpawnOptions opts;
+    arnm_spawn_options_default(&opts);
+    opts.priority = prio;
+    opts.deadline_ns = deadline_ns;
+    return arnm_spawn_ex(worker, (void*)(intptr_t)id, 0, &opts);
+}
+
+int main(void) {
+    printf("Testing priority classes...\n");
+
+    /* One worker so execution order is the pick order */
+    int ret = arnm_init(1);
+    assert(ret == 0);
+
+    /* ids: 0-1 low, 2-3 normal, 4 high (no deadline), 5-6 high with deadlines */
+    assert(spawn_with(0, ARNM_PRIO_LOW, 0));
+    assert(spawn_with(1, ARNM_PRIO_LOW, 0));
+    assert(spawn_with(2, ARNM_PRIO_NORMAL, 0));
+    assert(spawn_with(3, ARNM_PRIO_NORMAL, 0));
+    assert(spawn_with(4, ARNM_PRIO_HIGH, 0));
+    assert(spawn_with(5, ARNM_PRIO_HIGH, 2000000000ull));
+    assert(spawn_with(6, ARNM_PRIO_HIGH, 1000000000ull));
+
+    arnm_run();
+
+    int n = atomic_load(&order_idx);
+    printf("  Order:");
+    for (int i = 0; i < n; i++) printf(" %d", order[i]);
+    printf("\n");
+
+    assert(n == 7);
+
+    /* EDF inside HIGH: earliest deadline first, no-deadline last */
+    assert(order[0] == 6);
+    assert(order[1] == 5);
+    assert(order[2] == 4);
+
+    /* Then NORMAL, then LOW, FIFO within each */
+    assert(order[3] == 2 && order[4] == 3);
+    assert(order[5] == 0 && order[6] == 1);
+
+    arnm_shutdown();
+    printf("Priority test passed!\n");
+    return 0;
+}
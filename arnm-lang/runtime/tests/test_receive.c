@@ -0,0 +1,67 @@
+/*
+ * ARNm Runtime - Blocking Receive Test
+ * 
+ * Tests park/wake on blocking receive and per-quantum message batching.
+ */
+
+#include "../include/arnm.h"
+#include "../include/process.h"
+#include <stdio.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+#define NUM_MESSAGES 1000
+#define MSG_WORK 1
+
+static atomic_int received = 0;
+static uint64_t receiver_runs = 0;
+
+static void receiver(void* arg) {
+    (void)arg;
+    
+    for (int i = 0; i < NUM_MESSAGES; i++) {
+        ArnmMessage* msg = arnm_receive();
+        assert(arnm_message_tag(msg) == MSG_WORK);
+        assert(*(int*)arnm_message_data(msg) == i);
+        arnm_message_free(msg);
+        atomic_fetch_add(&received, 1);
+    }
+    
+    receiver_runs = arnm_self()->run_count;
+}
+
+static void sender(void* arg) {
+    ArnmProcess* target = (ArnmProcess*)arg;
+    
+    for (int i = 0; i < NUM_MESSAGES; i++) {
+        arnm_send(target, MSG_WORK, &i, sizeof(i));
+    }
+}
+
+int main(void) {
+    printf("Testing blocking receive...\n");
+    
+    ArnmConfig config;
+    arnm_config_default(&config);
+    config.num_workers = 1;
+    config.max_batch = 64;
+    int ret = arnm_init_ex(&config);
+    assert(ret == 0);
+    
+    ArnmProcess* recv_proc = arnm_spawn(receiver, NULL, 0);
+    assert(recv_proc != NULL);
+    assert(arnm_spawn(sender, recv_proc, 0) != NULL);
+    
+    arnm_run();
+    
+    int count = atomic_load(&received);
+    printf("  Received %d messages in %lu quanta\n", count, (unsigned long)receiver_runs);
+    assert(count == NUM_MESSAGES);
+    
+    /* Queued messages are drained in batches, not one switch per message */
+    assert(receiver_runs <= NUM_MESSAGES / 64 + 3);
+    
+    arnm_shutdown();
+    printf("Receive test passed!\n");
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * ARNm Runtime - Reader-Writer Lock and Semaphore Test
+ *
+ * Tests that readers never see a half-done write, writers exclude
+ * each other, and a semaphore never admits more holders than it has
+ * permits, with blocked processes parking rather than polling.
+ */
+
+#include "../include/arnm.h"
+#include "../include/sync.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+#define NUM_READERS     8
+#define NUM_WRITERS     2
+#define READS_EACH      2000
+#define WRITES_EACH     200
+
+#define NUM_CLIENTS     16
+#define PERMITS         3
+#define ROUNDS          50
+
+static ArnmRwLock* rw;
+static int64_t pair_a, pair_b;          /* Written together under the write lock */
+static atomic_int torn_reads;
+static atomic_int max_readers;
+static atomic_int active_readers;
+
+static void reader(void* arg) {
+    (void)arg;
+    for (int i = 0; i < READS_EACH; i++) {
+        arnm_rwlock_read_lock(rw);
+        int now = atomic_fetch_add(&active_readers, 1) + 1;
+        int seen = atomic_load(&max_readers);
+        while (now > seen && !atomic_compare_exchange_weak(&max_readers, &seen, now)) { }
+
+        int64_t a = pair_a;
+        if (i % 16 == 0) arnm_yield();     /* Hold it across a reschedule */
+        if (pair_b != a) atomic_fetch_add(&torn_reads, 1);
+
+        atomic_fetch_sub(&active_readers, 1);
+        arnm_rwlock_read_unlock(rw);
+    }
+}
+
+static void writer(void* arg) {
+    (void)arg;
+    for (int i = 0; i < WRITES_EACH; i++) {
+        arnm_rwlock_write_lock(rw);
+        assert(atomic_load(&active_readers) == 0);
+        pair_a++;
+        arnm_yield();
+        pair_b++;
+        arnm_rwlock_write_unlock(rw);
+        if (i % 4 == 0) arnm_yield();
+    }
+}
+
+static ArnmSemaphore* sem;
+static atomic_int holders;
+static atomic_int max_holders;
+static atomic_int rounds_done;
+
+static void client(void* arg) {
+    (void)arg;
+    for (int i = 0; i < ROUNDS; i++) {
+        arnm_semaphore_acquire(sem);
+        int now = atomic_fetch_add(&holders, 1) + 1;
+        int seen = atomic_load(&max_holders);
+        while (now > seen && !atomic_compare_exchange_weak(&max_holders, &seen, now)) { }
+
+        arnm_yield();
+
+        atomic_fetch_sub(&holders, 1);
+        arnm_semaphore_release(sem);
+        atomic_fetch_add(&rounds_done, 1);
+    }
+}
+
+int main(void) {
+    printf("Testing rwlock and semaphore...\n");
+
+    assert(arnm_init(4) == 0);
+
+    rw = arnm_rwlock_create();
+    assert(rw);
+
+    /* Uncontended fast paths */
+    assert(arnm_rwlock_try_read_lock(rw));
+    assert(!arnm_rwlock_try_write_lock(rw));
+    arnm_rwlock_read_unlock(rw);
+    assert(arnm_rwlock_try_write_lock(rw));
+    assert(!arnm_rwlock_try_read_lock(rw));
+    arnm_rwlock_write_unlock(rw);
+
+    ArnmSpawnOptions opts;
+    arnm_spawn_options_default(&opts);
+    opts.placement = ARNM_PLACE_ROUND_ROBIN;
+    for (int i = 0; i < NUM_READERS; i++) assert(arnm_spawn_ex(reader, NULL, 0, &opts));
+    for (int i = 0; i < NUM_WRITERS; i++) assert(arnm_spawn_ex(writer, NULL, 0, &opts));
+    arnm_run();
+
+    printf("  Writes: %ld, torn reads: %d, max concurrent readers: %d\n",
+           (long)pair_a, atomic_load(&torn_reads), atomic_load(&max_readers));
+    assert(pair_a == NUM_WRITERS * WRITES_EACH);
+    assert(pair_b == pair_a);
+    assert(atomic_load(&torn_reads) == 0);
+
+    sem = arnm_semaphore_create(PERMITS);
+    assert(sem);
+    for (int i = 0; i < NUM_CLIENTS; i++) assert(arnm_spawn_ex(client, NULL, 0, &opts));
+    arnm_run();
+
+    printf("  Rounds: %d, max holders: %d\n", atomic_load(&rounds_done), atomic_load(&max_holders));
+    assert(atomic_load(&rounds_done) == NUM_CLIENTS * ROUNDS);
+    assert(atomic_load(&max_holders) <= PERMITS);
+    assert(arnm_semaphore_available(sem) == PERMITS);
+
+    arnm_semaphore_destroy(sem);
+    arnm_rwlock_destroy(rw);
+    arnm_shutdown();
+
+    printf("Rwlock and semaphore test passed!\n");
+    return 0;
+}
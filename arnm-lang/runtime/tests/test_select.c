@@ -0,0 +1,188 @@
+/*
+ * ARNm Runtime - Select Test
+ *
+ * Tests select over several channels plus the mailbox: every value
+ * delivered exactly once, blocked selectors park instead of polling,
+ * send cases, closed channels and the compiled-select entry point.
+ */
+
+#include "../include/arnm.h"
+#include "../include/process.h"
+#include "../include/sync.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+#define NUM_PRODUCERS   2
+#define VALUES_EACH     500
+#define NUM_MESSAGES    100
+#define MSG_PING        7
+
+static ArnmChannel* chans[NUM_PRODUCERS];
+static ArnmProcess* consumer_proc;
+static int64_t chan_sum[NUM_PRODUCERS];
+static int chan_seen[NUM_PRODUCERS];
+static int mail_seen;
+static uint64_t consumer_runs;
+static atomic_int producers_done;
+
+static void producer(void* arg) {
+    int id = (int)(intptr_t)arg;
+    for (int64_t v = 1; v <= VALUES_EACH; v++) {
+        assert(arnm_channel_send(chans[id], (void*)(intptr_t)v));
+        if (v % 8 == 0) arnm_yield();
+    }
+    atomic_fetch_add(&producers_done, 1);
+}
+
+static void mailer(void* arg) {
+    (void)arg;
+    for (int i = 0; i < NUM_MESSAGES; i++) {
+        assert(arnm_send(consumer_proc, MSG_PING, &i, sizeof(i)) == 0);
+        arnm_yield();
+    }
+}
+
+static void consumer(void* arg) {
+    (void)arg;
+    int total = NUM_PRODUCERS * VALUES_EACH + NUM_MESSAGES;
+
+    for (int n = 0; n < total; n++) {
+        ArnmSelectCase cases[NUM_PRODUCERS + 1] = {
+            { .kind = ARNM_SELECT_RECV, .chan = chans[0] },
+            { .kind = ARNM_SELECT_RECV, .chan = chans[1] },
+            { .kind = ARNM_SELECT_MAILBOX },
+        };
+        int ready = arnm_select(cases, NUM_PRODUCERS + 1);
+        assert(ready >= 0 && ready <= NUM_PRODUCERS);
+
+        if (ready == NUM_PRODUCERS) {
+            assert(arnm_message_tag(cases[ready].msg) == MSG_PING);
+            assert(*(int*)arnm_message_data(cases[ready].msg) == mail_seen);
+            arnm_message_free(cases[ready].msg);
+            mail_seen++;
+        } else {
+            assert(cases[ready].ok);
+            chan_sum[ready] += (int64_t)(intptr_t)cases[ready].data;
+            chan_seen[ready]++;
+        }
+    }
+    consumer_runs = arnm_self()->run_count;
+}
+
+/* Send case: blocks on a full channel until the drainer makes room */
+static ArnmChannel* small;
+static int sent_into_small;
+
+static void filler(void* arg) {
+    (void)arg;
+    for (int i = 1; i <= 10; i++) {
+        ArnmSelectCase c = { .kind = ARNM_SELECT_SEND, .chan = small, .data = (void*)(intptr_t)i };
+        assert(arnm_select(&c, 1) == 0);
+        sent_into_small++;
+    }
+    arnm_channel_close(small);
+}
+
+static void drainer(void* arg) {
+    (void)arg;
+    int64_t expect = 1;
+    for (;;) {
+        ArnmSelectCase c = { .kind = ARNM_SELECT_RECV, .chan = small };
+        assert(arnm_select(&c, 1) == 0);
+        if (!c.ok) break;
+        assert((int64_t)(intptr_t)c.data == expect);
+        expect++;
+    }
+    assert(expect == 11);
+}
+
+/* Compiled select: channel arm by index, mailbox arm is 4 with the tag */
+static ArnmChannel* lang_chan;
+static int64_t lang_results[3];
+
+static void lang_selector(void* arg) {
+    (void)arg;
+    for (int i = 0; i < 3; i++) {
+        int64_t arm = arnm_select_recv4(NULL, lang_chan, NULL, NULL, 1);
+        lang_results[i] = arm * 1000 + arnm_select_value();
+    }
+    /* Only a closed channel left and no mailbox: nothing can ever fire */
+    assert(arnm_select_recv4(NULL, lang_chan, NULL, NULL, 0) == -1);
+}
+
+static void lang_feeder(void* arg) {
+    ArnmProcess* target = (ArnmProcess*)arg;
+    arnm_channel_send(lang_chan, (void*)(intptr_t)42);
+    arnm_yield();
+    arnm_send(target, 9, NULL, 0);
+    arnm_yield();
+    arnm_channel_send(lang_chan, (void*)(intptr_t)43);
+    arnm_channel_close(lang_chan);
+}
+
+int main(void) {
+    printf("Testing select...\n");
+
+    assert(arnm_init(2) == 0);
+
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        chans[i] = arnm_channel_create(4);
+        assert(chans[i]);
+    }
+
+    /* Nothing ready: a non-blocking select reports so */
+    ArnmSelectCase probe = { .kind = ARNM_SELECT_RECV, .chan = chans[0] };
+    assert(arnm_select_try(&probe, 1) == -1);
+
+    consumer_proc = arnm_spawn(consumer, NULL, 0);
+    assert(consumer_proc);
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        assert(arnm_spawn(producer, (void*)(intptr_t)i, 0));
+    }
+    assert(arnm_spawn(mailer, NULL, 0));
+    arnm_run();
+
+    int64_t expect_sum = (int64_t)VALUES_EACH * (VALUES_EACH + 1) / 2;
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        printf("  Channel %d: %d values\n", i, chan_seen[i]);
+        assert(chan_seen[i] == VALUES_EACH);
+        assert(chan_sum[i] == expect_sum);
+    }
+    printf("  Mailbox: %d messages, consumer quanta: %lu\n", mail_seen, (unsigned long)consumer_runs);
+    assert(mail_seen == NUM_MESSAGES);
+    assert(atomic_load(&producers_done) == NUM_PRODUCERS);
+
+    /* A polling consumer would be scheduled far more often than it has items */
+    assert(consumer_runs <= 2 * (NUM_PRODUCERS * VALUES_EACH + NUM_MESSAGES));
+
+    small = arnm_channel_create(2);
+    assert(arnm_spawn(filler, NULL, 0));
+    assert(arnm_spawn(drainer, NULL, 0));
+    arnm_run();
+    assert(sent_into_small == 10);
+
+    lang_chan = arnm_channel_create(1);
+    ArnmProcess* sel = arnm_spawn(lang_selector, NULL, 0);
+    assert(sel);
+    assert(arnm_spawn(lang_feeder, sel, 0));
+    arnm_run();
+
+    int64_t total = 0;
+    bool saw_tag = false;
+    for (int i = 0; i < 3; i++) {
+        total += lang_results[i];
+        if (lang_results[i] == 4009) saw_tag = true;
+    }
+    assert(saw_tag);
+    assert(total == 1042 + 1043 + 4009);
+
+    for (int i = 0; i < NUM_PRODUCERS; i++) arnm_channel_destroy(chans[i]);
+    arnm_channel_destroy(small);
+    arnm_channel_destroy(lang_chan);
+    arnm_shutdown();
+
+    printf("Select test passed!\n");
+    return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * ARNm Runtime - Shared-Memory Transport Test
+ *
+ * Two nodes on one host linked through a shared-memory segment, no
+ * TCP. Enough traffic to wrap the ring several times, with some
+ * payloads spanning many slots.
+ */
+
+#include "../include/arnm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include <sys/wait.h>
+
+#define NUM_PINGS   50000
+#define BIG_EVERY   97
+#define BIG_SIZE    3000
+#define TAG_PING    1
+#define TAG_PONG    2
+#define TAG_STOP    3
+
+typedef struct {
+    uint64_t    reply_pid;
+    uint32_t    reply_node;
+    int64_t     value;
+} Ping;
+
+static char segment[64];
+static uint64_t server_pid;
+static int64_t pong_sum = 0;
+static int pong_count = 0;
+
+/* ============================================================
+ * Node 2: echo server
+ * ============================================================ */
+
+static void echo_server(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        ArnmMessage* msg = arnm_receive();
+        uint64_t tag = arnm_message_tag(msg);
+
+        if (tag == TAG_STOP) {
+            arnm_message_free(msg);
+            arnm_node_stop();
+            return;
+        }
+
+        assert(tag == TAG_PING);
+        size_t size = arnm_message_size(msg);
+        const uint8_t* data = arnm_message_data(msg);
+        Ping ping;
+        memcpy(&ping, data, sizeof(ping));
+
+        /* Large payloads carry a byte pattern derived from the value */
+        if (size != sizeof(Ping)) {
+            assert(size == sizeof(Ping) + BIG_SIZE);
+            for (int i = 0; i < BIG_SIZE; i++) {
+                assert(data[sizeof(Ping) + i] == (uint8_t)(ping.value + i));
+            }
+        }
+        arnm_message_free(msg);
+
+        int64_t value = ping.value + 1;
+        ArnmProcess* client = arnm_remote(ping.reply_node, ping.reply_pid);
+        assert(arnm_send(client, TAG_PONG, &value, sizeof(value)) == 0);
+    }
+}
+
+static int run_server(int ready_fd) {
+    assert(arnm_init(1) == 0);
+    assert(arnm_node_start(2, 0) == 0);
+    assert(arnm_node_link_shm(segment, 1) == 0);
+
+    ArnmProcess* server = arnm_spawn(echo_server, NULL, 0);
+    assert(server);
+
+    uint64_t pid = arnm_pid(server);
+    assert(write(ready_fd, &pid, sizeof(pid)) == sizeof(pid));
+    close(ready_fd);
+
+    arnm_run();
+    arnm_shutdown();
+    return 0;
+}
+
+/* ============================================================
+ * Node 1: client
+ * ============================================================ */
+
+static void client(void* arg) {
+    (void)arg;
+
+    ArnmProcess* server = arnm_remote(2, server_pid);
+    assert(server);
+
+    static uint8_t buf[sizeof(Ping) + BIG_SIZE];
+    Ping ping = { arnm_pid(arnm_self()), arnm_node_id(), 0 };
+    int received = 0;
+
+    for (int i = 0; i < NUM_PINGS; i++) {
+        ping.value = i;
+        memcpy(buf, &ping, sizeof(ping));
+        size_t size = sizeof(Ping);
+        if (i % BIG_EVERY == 0) {
+            for (int j = 0; j < BIG_SIZE; j++) buf[sizeof(Ping) + j] = (uint8_t)(i + j);
+            size += BIG_SIZE;
+        }
+        assert(arnm_send(server, TAG_PING, buf, size) == 0);
+
+        /* Drain as we go so neither ring stays full */
+        ArnmMessage* msg;
+        while ((msg = arnm_try_receive()) != NULL) {
+            int64_t value;
+            memcpy(&value, arnm_message_data(msg), sizeof(value));
+            assert(value == received + 1);
+            pong_sum += value;
+            received++;
+            arnm_message_free(msg);
+        }
+    }
+
+    while (received < NUM_PINGS) {
+        ArnmMessage* msg = arnm_receive();
+        assert(arnm_message_tag(msg) == TAG_PONG);
+        int64_t value;
+        memcpy(&value, arnm_message_data(msg), sizeof(value));
+        assert(value == received + 1);
+        pong_sum += value;
+        received++;
+        arnm_message_free(msg);
+    }
+    pong_count = received;
+
+    assert(arnm_send(server, TAG_STOP, NULL, 0) == 0);
+    arnm_node_stop();
+}
+
+int main(void) {
+    printf("Testing shared-memory transport...\n");
+
+    snprintf(segment, sizeof(segment), "/arnm-test-%d", (int)getpid());
+
+    int pipefd[2];
+    assert(pipe(pipefd) == 0);
+
+    pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        close(pipefd[0]);
+        _exit(run_server(pipefd[1]));
+    }
+    close(pipefd[1]);
+
+    assert(read(pipefd[0], &server_pid, sizeof(server_pid)) == sizeof(server_pid));
+    close(pipefd[0]);
+
+    assert(arnm_init(2) == 0);
+    assert(arnm_node_start(1, 0) == 0);
+    assert(arnm_node_link_shm(segment, 2) == 0);
+
+    /* One link per peer */
+    assert(arnm_node_link_shm(segment, 2) == -1);
+
+    assert(arnm_spawn(client, NULL, 0));
+    arnm_run();
+    arnm_shutdown();
+
+    int status;
+    assert(waitpid(child, &status, 0) == child);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    printf("  Pongs: %d (sum %lld)\n", pong_count, (long long)pong_sum);
+    assert(pong_count == NUM_PINGS);
+    assert(pong_sum == (int64_t)NUM_PINGS * (NUM_PINGS + 1) / 2);
+
+    printf("Shared-memory transport test passed!\n");
+    return 0;
+}
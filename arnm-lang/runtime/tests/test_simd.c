@@ -0,0 +1,161 @@
+/*
+ * ARNm Runtime - SIMD Vector Test
+ *
+ * Runs every vector kernel at each level the CPU supports and checks
+ * it against plain C: element-wise operators (including a dst that is
+ * an operand), reductions, shuffles, lane access, and that a
+ * reduction gives bit-identical results at every level.
+ */
+
+#include "../include/arnm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+static double f32_sum;
+
+static void check_f32x8(void) {
+    ArnmF32x8 a, b, r;
+    for (int i = 0; i < 8; i++) {
+        a.lane[i] = (float)(i + 1) * 0.5f;
+        b.lane[i] = (float)(8 - i);
+    }
+
+    for (int op = ARNM_VEC_ADD; op <= ARNM_VEC_DIV; op++) {
+        arnm_f32x8_op(&r, &a, &b, op);
+        for (int i = 0; i < 8; i++) {
+            float x = a.lane[i], y = b.lane[i];
+            float want = op == ARNM_VEC_ADD ? x + y : op == ARNM_VEC_SUB ? x - y :
+                         op == ARNM_VEC_MUL ? x * y : x / y;
+            assert(r.lane[i] == want);
+        }
+    }
+
+    /* dst aliases an operand */
+    r = a;
+    arnm_f32x8_op(&r, &r, &r, ARNM_VEC_ADD);
+    for (int i = 0; i < 8; i++) assert(r.lane[i] == 2 * a.lane[i]);
+
+    assert(arnm_f32x8_reduce(&a, ARNM_VEC_SUM) == 18.0);
+    assert(arnm_f32x8_reduce(&b, ARNM_VEC_MIN) == 1.0);
+    assert(arnm_f32x8_reduce(&b, ARNM_VEC_MAX) == 8.0);
+
+    ArnmF32x8 odd;
+    for (int i = 0; i < 8; i++) odd.lane[i] = 1.0f / (float)(i + 3);
+    f32_sum = arnm_f32x8_reduce(&odd, ARNM_VEC_SUM);
+
+    ArnmI32x8 rev;
+    for (int i = 0; i < 8; i++) rev.lane[i] = 7 - i + (i == 0 ? 8 : 0);   /* 15 wraps to 7 */
+    arnm_f32x8_shuffle(&r, &a, &rev);
+    for (int i = 0; i < 8; i++) assert(r.lane[i] == a.lane[7 - i]);
+
+    arnm_f32x8_splat(&r, 2.25);
+    arnm_f32x8_set(&r, &r, 10, -1.5);
+    assert(arnm_f32x8_get(&r, 2) == -1.5);
+    assert(arnm_f32x8_get(&r, 3) == 2.25);
+}
+
+static void check_i32x8(void) {
+    ArnmI32x8 a, b, r;
+    for (int i = 0; i < 8; i++) {
+        a.lane[i] = (i - 4) * 1000;
+        b.lane[i] = i - 2;
+    }
+
+    for (int op = ARNM_VEC_ADD; op <= ARNM_VEC_DIV; op++) {
+        arnm_i32x8_op(&r, &a, &b, op);
+        for (int i = 0; i < 8; i++) {
+            int32_t x = a.lane[i], y = b.lane[i];
+            int32_t want = op == ARNM_VEC_ADD ? x + y : op == ARNM_VEC_SUB ? x - y :
+                           op == ARNM_VEC_MUL ? x * y : (y ? x / y : 0);
+            assert(r.lane[i] == want);
+        }
+    }
+
+    /* Lanes wrap */
+    arnm_i32x8_splat(&a, INT32_MAX);
+    arnm_i32x8_splat(&b, 1);
+    arnm_i32x8_op(&r, &a, &b, ARNM_VEC_ADD);
+    assert(arnm_i32x8_get(&r, 5) == INT32_MIN);
+
+    for (int i = 0; i < 8; i++) a.lane[i] = (i * 37) % 11 - 5;
+    int32_t sum = 0, lo = a.lane[0], hi = a.lane[0];
+    for (int i = 0; i < 8; i++) {
+        sum += a.lane[i];
+        if (a.lane[i] < lo) lo = a.lane[i];
+        if (a.lane[i] > hi) hi = a.lane[i];
+    }
+    assert(arnm_i32x8_reduce(&a, ARNM_VEC_SUM) == sum);
+    assert(arnm_i32x8_reduce(&a, ARNM_VEC_MIN) == lo);
+    assert(arnm_i32x8_reduce(&a, ARNM_VEC_MAX) == hi);
+
+    ArnmI32x8 idx;
+    for (int i = 0; i < 8; i++) idx.lane[i] = (i * 3) % 8;
+    arnm_i32x8_shuffle(&r, &a, &idx);
+    for (int i = 0; i < 8; i++) assert(r.lane[i] == a.lane[(i * 3) % 8]);
+
+    /* In place */
+    r = a;
+    arnm_i32x8_shuffle(&r, &r, &idx);
+    for (int i = 0; i < 8; i++) assert(r.lane[i] == a.lane[(i * 3) % 8]);
+}
+
+static void check_f64x4(void) {
+    ArnmF64x4 a, b, r;
+    for (int i = 0; i < 4; i++) {
+        a.lane[i] = 0.1 * (i + 1);
+        b.lane[i] = 3.0 - i;
+    }
+
+    for (int op = ARNM_VEC_ADD; op <= ARNM_VEC_DIV; op++) {
+        arnm_f64x4_op(&r, &a, &b, op);
+        for (int i = 0; i < 4; i++) {
+            double x = a.lane[i], y = b.lane[i];
+            double want = op == ARNM_VEC_ADD ? x + y : op == ARNM_VEC_SUB ? x - y :
+                          op == ARNM_VEC_MUL ? x * y : x / y;
+            assert(r.lane[i] == want);
+        }
+    }
+
+    /* Tree order: (l0 + l2) + (l1 + l3) */
+    assert(arnm_f64x4_reduce(&a, ARNM_VEC_SUM) == (a.lane[0] + a.lane[2]) + (a.lane[1] + a.lane[3]));
+    assert(arnm_f64x4_reduce(&b, ARNM_VEC_MIN) == 0.0);
+    assert(arnm_f64x4_reduce(&b, ARNM_VEC_MAX) == 3.0);
+
+    ArnmI32x8 idx;
+    for (int i = 0; i < 8; i++) idx.lane[i] = i < 4 ? 3 - i + 4 : 99;   /* Only lanes 0-3 count */
+    arnm_f64x4_shuffle(&r, &a, &idx);
+    for (int i = 0; i < 4; i++) assert(r.lane[i] == a.lane[3 - i]);
+
+    arnm_f64x4_splat(&r, 1e300);
+    arnm_f64x4_set(&r, &r, -1, 4.5);
+    assert(arnm_f64x4_get(&r, 3) == 4.5);
+    assert(arnm_f64x4_get(&r, 0) == 1e300);
+}
+
+int main(void) {
+    printf("Testing SIMD vectors...\n");
+
+    ArnmSimdLevel best = arnm_simd_level();
+    double first_sum = 0;
+    int runs = 0;
+    for (int level = ARNM_SIMD_SCALAR; level <= ARNM_SIMD_AVX2; level++) {
+        if (level > (int)best) break;
+        ArnmSimdLevel used = arnm_simd_select(level);
+        if ((int)used != level) continue;
+        assert(arnm_simd_avx2 == (used == ARNM_SIMD_AVX2));
+        check_f32x8();
+        check_i32x8();
+        check_f64x4();
+        printf("  Level %d: ok\n", level);
+        if (runs++ == 0) first_sum = f32_sum;
+        assert(f32_sum == first_sum);
+    }
+    assert(runs > 0);
+    arnm_simd_select(best);
+
+    printf("SIMD test passed!\n");
+    return 0;
+}
@@ -12,13 +12,17 @@
  * - String literal support
  * - Actor operation simulation (spawn, send, receive, self)
  * - Control flow support (if, while, loop, for)
+ * - Compilation to a standalone wasm module (arnm_compile_wasm), run by
+ *   wasm/arnm_runtime.js instead of the interpreter
  */
 
+#define _POSIX_C_SOURCE 200809L
 #include "../compiler/include/lexer.h"
 #include "../compiler/include/parser.h"
 #include "../compiler/include/sema.h"
 #include "../compiler/include/ir.h"
 #include "../compiler/include/irgen.h"
+#include "../compiler/include/codegen_wasm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -512,26 +516,14 @@ static void report_sema_errors(SemaContext* sema) {
     }
 }
 
-/* ============================================================
- * Public WASM API
- * ============================================================ */
-
 /*
- * Compile and execute ARNm source code.
- * 
- * @param source    The ARNm source code to compile
- * @return          0 on success, non-zero error code on failure
- *                  1 = Empty source
- *                  2 = Parse error
- *                  3 = Semantic error
- *                  4 = IR generation error
+ * Run the front end and IR generation over `source`. On success the
+ * caller owns `arena`, `sema` and `ir_mod`; on failure they have
+ * already been released and the error is in the output buffer.
+ *
+ * @return  0 on success, or the arnm_compile_string error code
  */
-WASM_EXPORT
-int arnm_compile_string(const char* source) {
-    init_output();
-    clear_output();
-    interp_init();
-    
+static int compile_to_ir(const char* source, AstArena* arena, SemaContext* sema, IrModule* ir_mod) {
     /* Validate input */
     if (!source || !*source) {
         append_output("[Error] Empty source code\n");
@@ -549,14 +541,13 @@ int arnm_compile_string(const char* source) {
     /* ========================================
      * Stage 2: AST Arena Setup
      * ======================================== */
-    AstArena arena;
-    ast_arena_init(&arena, 2 * 1024 * 1024); /* 2MB arena */
+    ast_arena_init(arena, 2 * 1024 * 1024); /* 2MB arena */
     
     /* ========================================
      * Stage 3: Parsing
      * ======================================== */
     Parser parser;
-    parser_init(&parser, &lexer, &arena);
+    parser_init(&parser, &lexer, arena);
     
     AstProgram* ast = parser_parse_program(&parser);
     
@@ -568,43 +559,70 @@ int arnm_compile_string(const char* source) {
             append_output(buf);
             report_parse_errors(&parser);
         }
-        ast_arena_destroy(&arena);
+        ast_arena_destroy(arena);
         return 2;
     }
     
     /* ========================================
      * Stage 4: Semantic Analysis
      * ======================================== */
-    SemaContext sema;
-    sema_init(&sema);
+    sema_init(sema);
     
-    if (!sema_analyze(&sema, ast)) {
+    if (!sema_analyze(sema, ast)) {
         append_output("[Semantic Error] Type checking failed\n");
-        if (sema.error_count > 0) {
+        if (sema->error_count > 0) {
             char buf[128];
-            snprintf(buf, sizeof(buf), "  %zu error(s) found:\n", sema.error_count);
+            snprintf(buf, sizeof(buf), "  %zu error(s) found:\n", sema->error_count);
             append_output(buf);
-            report_sema_errors(&sema);
+            report_sema_errors(sema);
         }
-        sema_destroy(&sema);
-        ast_arena_destroy(&arena);
+        sema_destroy(sema);
+        ast_arena_destroy(arena);
         return 3;
     }
     
     /* ========================================
      * Stage 5: IR Generation
      * ======================================== */
-    IrModule ir_mod;
-    ir_module_init(&ir_mod);
+    ir_module_init(ir_mod);
     
-    if (!ir_generate(&sema, ast, &ir_mod)) {
+    if (!ir_generate(sema, ast, ir_mod)) {
         append_output("[IR Error] Failed to generate intermediate representation\n");
-        ir_module_destroy(&ir_mod);
-        sema_destroy(&sema);
-        ast_arena_destroy(&arena);
+        ir_module_destroy(ir_mod);
+        sema_destroy(sema);
+        ast_arena_destroy(arena);
         return 4;
     }
     
+    return 0;
+}
+
+/* ============================================================
+ * Public WASM API
+ * ============================================================ */
+
+/*
+ * Compile and execute ARNm source code.
+ * 
+ * @param source    The ARNm source code to compile
+ * @return          0 on success, non-zero error code on failure
+ *                  1 = Empty source
+ *                  2 = Parse error
+ *                  3 = Semantic error
+ *                  4 = IR generation error
+ */
+WASM_EXPORT
+int arnm_compile_string(const char* source) {
+    init_output();
+    clear_output();
+    interp_init();
+    
+    AstArena arena;
+    SemaContext sema;
+    IrModule ir_mod;
+    int status = compile_to_ir(source, &arena, &sema, &ir_mod);
+    if (status != 0) return status;
+    
     /* ========================================
      * Stage 6: Execution
      * ======================================== */
@@ -638,6 +656,58 @@ int arnm_compile_string(const char* source) {
     return 0;
 }
 
+/* Module produced by the last arnm_compile_wasm */
+static char* module_buffer = NULL;
+static size_t module_size = 0;
+
+/*
+ * Compile ARNm source code to a WebAssembly module without running it.
+ * The module is read with arnm_get_module / arnm_get_module_size and
+ * instantiated by ArnmRuntime.run; errors go to the output buffer.
+ *
+ * @param source    The ARNm source code to compile
+ * @return          0 on success, the arnm_compile_string error codes,
+ *                  or 5 = wasm code generation error
+ */
+WASM_EXPORT
+int arnm_compile_wasm(const char* source) {
+    init_output();
+    clear_output();
+    free(module_buffer);
+    module_buffer = NULL;
+    module_size = 0;
+    
+    AstArena arena;
+    SemaContext sema;
+    IrModule ir_mod;
+    int status = compile_to_ir(source, &arena, &sema, &ir_mod);
+    if (status != 0) return status;
+    
+    FILE* mem = open_memstream(&module_buffer, &module_size);
+    if (!mem || !wasm_emit(&ir_mod, mem)) {
+        append_output("[Codegen Error] Failed to generate WebAssembly\n");
+        status = 5;
+    }
+    if (mem) fclose(mem);
+    
+    ir_module_destroy(&ir_mod);
+    sema_destroy(&sema);
+    ast_arena_destroy(&arena);
+    
+    return status;
+}
+
+/* The module from the last successful arnm_compile_wasm */
+WASM_EXPORT
+const char* arnm_get_module(void) {
+    return module_buffer;
+}
+
+WASM_EXPORT
+size_t arnm_get_module_size(void) {
+    return module_buffer ? module_size : 0;
+}
+
 /*
  * Get the output from the last compilation/execution.
  * 
@@ -654,6 +724,10 @@ const char* arnm_get_output(void) {
  */
 WASM_EXPORT
 void arnm_free_output(void) {
+    free(module_buffer);
+    module_buffer = NULL;
+    module_size = 0;
+    
     if (output_buffer) {
         free(output_buffer);
         output_buffer = NULL;